@@ -245,6 +245,8 @@ public:
     return static_cast<u32>((*m_ptr_current) - previous_pointer);
   }
 
+  u8* GetCurrentPosition() const { return *m_ptr_current; }
+
   void Do(Common::Flag& flag)
   {
     bool s = flag.IsSet();
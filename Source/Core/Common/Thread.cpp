@@ -8,6 +8,7 @@
 #include <processthreadsapi.h>
 #else
 #include <pthread.h>
+#include <time.h>
 #include <unistd.h>
 #endif
 
@@ -116,6 +117,19 @@ void SetCurrentThreadName(const char* name)
   SetCurrentThreadNameViaApi(name);
 }
 
+std::chrono::nanoseconds GetCurrentThreadCPUTime()
+{
+  FILETIME creation_time, exit_time, kernel_time, user_time;
+  if (!GetThreadTimes(GetCurrentThread(), &creation_time, &exit_time, &kernel_time, &user_time))
+    return {};
+
+  const auto to_u64 = [](const FILETIME& time) {
+    return (static_cast<u64>(time.dwHighDateTime) << 32) | time.dwLowDateTime;
+  };
+  // FILETIME is in units of 100 nanoseconds.
+  return std::chrono::nanoseconds((to_u64(kernel_time) + to_u64(user_time)) * 100);
+}
+
 #else  // !WIN32, so must be POSIX threads
 
 void SetThreadAffinity(std::thread::native_handle_type thread, u32 mask)
@@ -186,6 +200,15 @@ void SetCurrentThreadName(const char* name)
 #endif
 }
 
+std::chrono::nanoseconds GetCurrentThreadCPUTime()
+{
+  timespec time;
+  if (clock_gettime(CLOCK_THREAD_CPUTIME_ID, &time) != 0)
+    return {};
+
+  return std::chrono::seconds(time.tv_sec) + std::chrono::nanoseconds(time.tv_nsec);
+}
+
 std::tuple<void*, size_t> GetCurrentThreadStack()
 {
   void* stack_addr;
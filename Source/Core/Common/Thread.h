@@ -3,6 +3,7 @@
 
 #pragma once
 
+#include <chrono>
 #include <thread>
 
 #ifndef _WIN32
@@ -39,6 +40,9 @@ inline void YieldCPU()
 
 void SetCurrentThreadName(const char* name);
 
+// Returns the CPU time consumed by the current thread so far, in user and kernel mode.
+std::chrono::nanoseconds GetCurrentThreadCPUTime();
+
 #ifndef _WIN32
 // Returns the lowest address of the stack and the size of the stack
 std::tuple<void*, size_t> GetCurrentThreadStack();
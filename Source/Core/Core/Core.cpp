@@ -59,6 +59,7 @@
 #include "Core/HW/GCKeyboard.h"
 #include "Core/HW/GCPad.h"
 #include "Core/HW/HW.h"
+#include "Core/HW/Memmap.h"
 #include "Core/HW/SystemTimers.h"
 #include "Core/HW/VideoInterface.h"
 #include "Core/HW/Wiimote.h"
@@ -388,7 +389,10 @@ static void CpuThread(Core::System& system, const std::optional<std::string>& sa
   // The JIT need to be able to intercept faults, both for fastmem and for the BLR optimization.
   const bool exception_handler = EMM::IsExceptionHandlerSupported();
   if (exception_handler)
+  {
     EMM::InstallExceptionHandler();
+    system.GetMemory().SetExceptionHandlerInstalled(true);
+  }
 
 #ifdef USE_MEMORYWATCHER
   s_memory_watcher = std::make_unique<MemoryWatcher>();
@@ -436,7 +440,10 @@ static void CpuThread(Core::System& system, const std::optional<std::string>& sa
   s_is_started = false;
 
   if (exception_handler)
+  {
+    system.GetMemory().SetExceptionHandlerInstalled(false);
     EMM::UninstallExceptionHandler();
+  }
 
   if (GDBStub::IsActive())
   {
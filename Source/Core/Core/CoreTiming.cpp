@@ -4,6 +4,8 @@
 #include "Core/CoreTiming.h"
 
 #include <algorithm>
+#include <bit>
+#include <functional>
 #include <mutex>
 #include <string>
 #include <unordered_map>
@@ -44,6 +46,155 @@ static bool operator<(const Event& left, const Event& right)
 
 static constexpr int MAX_SLICE_LENGTH = 20000;
 
+void EventQueue::Push(const Event& event)
+{
+  ++m_size;
+  if ((event.time >> SLOT_SHIFT) <= m_cursor)
+  {
+    m_current.push_back(event);
+    std::push_heap(m_current.begin(), m_current.end(), std::greater<Event>());
+  }
+  else
+  {
+    PushToWheel(event);
+  }
+}
+
+void EventQueue::PushToWheel(const Event& event)
+{
+  const s64 slot = event.time >> SLOT_SHIFT;
+  if (slot - m_cursor < static_cast<s64>(SLOT_COUNT))
+  {
+    const size_t index = static_cast<size_t>(slot) & (SLOT_COUNT - 1);
+    m_slots[index].push_back(event);
+    m_occupied_slots[index / 64] |= u64(1) << (index % 64);
+  }
+  else
+  {
+    m_overflow.push_back(event);
+    std::push_heap(m_overflow.begin(), m_overflow.end(), std::greater<Event>());
+  }
+}
+
+const Event& EventQueue::Top()
+{
+  if (m_current.empty())
+    AdvanceCursor();
+  return m_current.front();
+}
+
+void EventQueue::Pop()
+{
+  if (m_current.empty())
+    AdvanceCursor();
+  std::pop_heap(m_current.begin(), m_current.end(), std::greater<Event>());
+  m_current.pop_back();
+  --m_size;
+}
+
+// Returns the distance from the cursor to the next slot with events in it, or SLOT_COUNT if the
+// wheel is empty.
+size_t EventQueue::FindNextOccupiedSlot() const
+{
+  for (size_t distance = 1; distance < SLOT_COUNT;)
+  {
+    const size_t index = (static_cast<size_t>(m_cursor) + distance) & (SLOT_COUNT - 1);
+    const u64 occupied = m_occupied_slots[index / 64] >> (index % 64);
+    if (occupied != 0)
+      return distance + std::countr_zero(occupied);
+    distance += 64 - index % 64;
+  }
+  return SLOT_COUNT;
+}
+
+// Moves the cursor to the next slot with events in it. Must only be called when m_current is empty
+// and the queue isn't.
+void EventQueue::AdvanceCursor()
+{
+  const size_t distance = FindNextOccupiedSlot();
+  if (distance != SLOT_COUNT)
+    m_cursor += distance;
+  else
+    m_cursor = m_overflow.front().time >> SLOT_SHIFT;
+
+  const size_t index = static_cast<size_t>(m_cursor) & (SLOT_COUNT - 1);
+  std::swap(m_current, m_slots[index]);
+  m_occupied_slots[index / 64] &= ~(u64(1) << (index % 64));
+  std::make_heap(m_current.begin(), m_current.end(), std::greater<Event>());
+
+  // Bring in the events from the overflow heap which the wheel reaches now.
+  while (!m_overflow.empty() &&
+         (m_overflow.front().time >> SLOT_SHIFT) - m_cursor < static_cast<s64>(SLOT_COUNT))
+  {
+    const Event event = m_overflow.front();
+    std::pop_heap(m_overflow.begin(), m_overflow.end(), std::greater<Event>());
+    m_overflow.pop_back();
+
+    if ((event.time >> SLOT_SHIFT) == m_cursor)
+    {
+      m_current.push_back(event);
+      std::push_heap(m_current.begin(), m_current.end(), std::greater<Event>());
+    }
+    else
+    {
+      PushToWheel(event);
+    }
+  }
+}
+
+void EventQueue::RemoveEvents(const EventType* event_type)
+{
+  const auto matches = [event_type](const Event& e) { return e.type == event_type; };
+
+  // Removing random items from a heap breaks the invariant so we have to re-establish it.
+  const auto remove_from_heap = [&](std::vector<Event>& heap) {
+    const auto itr = std::remove_if(heap.begin(), heap.end(), matches);
+    if (itr != heap.end())
+    {
+      m_size -= heap.end() - itr;
+      heap.erase(itr, heap.end());
+      std::make_heap(heap.begin(), heap.end(), std::greater<Event>());
+    }
+  };
+  remove_from_heap(m_current);
+  remove_from_heap(m_overflow);
+
+  for (size_t index = 0; index < SLOT_COUNT; ++index)
+  {
+    if (!(m_occupied_slots[index / 64] & (u64(1) << (index % 64))))
+      continue;
+
+    Slot& slot = m_slots[index];
+    const auto itr = std::remove_if(slot.begin(), slot.end(), matches);
+    m_size -= slot.end() - itr;
+    slot.erase(itr, slot.end());
+    if (slot.empty())
+      m_occupied_slots[index / 64] &= ~(u64(1) << (index % 64));
+  }
+}
+
+void EventQueue::Clear(s64 time)
+{
+  m_current.clear();
+  for (Slot& slot : m_slots)
+    slot.clear();
+  m_occupied_slots.fill(0);
+  m_overflow.clear();
+  m_cursor = time >> SLOT_SHIFT;
+  m_size = 0;
+}
+
+std::vector<Event> EventQueue::GetEvents() const
+{
+  std::vector<Event> events;
+  events.reserve(m_size);
+  events.insert(events.end(), m_current.begin(), m_current.end());
+  for (const Slot& slot : m_slots)
+    events.insert(events.end(), slot.begin(), slot.end());
+  events.insert(events.end(), m_overflow.begin(), m_overflow.end());
+  return events;
+}
+
 static void EmptyTimedCallback(Core::System& system, u64 userdata, s64 cyclesLate)
 {
 }
@@ -169,7 +320,10 @@ void CoreTimingManager::DoState(PointerWrap& p)
   p.DoMarker("CoreTimingData");
 
   MoveEvents();
-  p.DoEachElement(m_event_queue, [this](PointerWrap& pw, Event& ev) {
+  std::vector<Event> events;
+  if (!p.IsReadMode())
+    events = m_event_queue.GetEvents();
+  p.DoEachElement(events, [this](PointerWrap& pw, Event& ev) {
     pw.Do(ev.time);
     pw.Do(ev.fifo_order);
 
@@ -205,9 +359,10 @@ void CoreTimingManager::DoState(PointerWrap& p)
   if (p.IsReadMode())
   {
     // When loading from a save state, we must assume the Event order is random and meaningless.
-    // The exact layout of the heap in memory is implementation defined, therefore it is platform
-    // and library version specific.
-    std::make_heap(m_event_queue.begin(), m_event_queue.end(), std::greater<Event>());
+    // Older versions saved the layout of a heap, which is implementation defined.
+    m_event_queue.Clear(m_globals.global_timer);
+    for (const Event& ev : events)
+      m_event_queue.Push(ev);
 
     // The stave state has changed the time, so our previous Throttle targets are invalid.
     // Especially when global_time goes down; So we create a fake throttle update.
@@ -235,7 +390,7 @@ u64 CoreTimingManager::GetIdleTicks() const
 
 void CoreTimingManager::ClearPendingEvents()
 {
-  m_event_queue.clear();
+  m_event_queue.Clear(m_globals.global_timer);
 }
 
 void CoreTimingManager::ScheduleEvent(s64 cycles_into_future, EventType* event_type, u64 userdata,
@@ -264,8 +419,7 @@ void CoreTimingManager::ScheduleEvent(s64 cycles_into_future, EventType* event_t
     if (!m_is_global_timer_sane)
       ForceExceptionCheck(cycles_into_future);
 
-    m_event_queue.emplace_back(Event{timeout, m_event_fifo_id++, userdata, event_type});
-    std::push_heap(m_event_queue.begin(), m_event_queue.end(), std::greater<Event>());
+    m_event_queue.Push(Event{timeout, m_event_fifo_id++, userdata, event_type});
   }
   else
   {
@@ -284,15 +438,7 @@ void CoreTimingManager::ScheduleEvent(s64 cycles_into_future, EventType* event_t
 
 void CoreTimingManager::RemoveEvent(EventType* event_type)
 {
-  auto itr = std::remove_if(m_event_queue.begin(), m_event_queue.end(),
-                            [&](const Event& e) { return e.type == event_type; });
-
-  // Removing random items breaks the invariant so we have to re-establish it.
-  if (itr != m_event_queue.end())
-  {
-    m_event_queue.erase(itr, m_event_queue.end());
-    std::make_heap(m_event_queue.begin(), m_event_queue.end(), std::greater<Event>());
-  }
+  m_event_queue.RemoveEvents(event_type);
 }
 
 void CoreTimingManager::RemoveAllEvents(EventType* event_type)
@@ -319,8 +465,7 @@ void CoreTimingManager::MoveEvents()
   for (Event ev; m_ts_queue.Pop(ev);)
   {
     ev.fifo_order = m_event_fifo_id++;
-    m_event_queue.emplace_back(std::move(ev));
-    std::push_heap(m_event_queue.begin(), m_event_queue.end(), std::greater<Event>());
+    m_event_queue.Push(ev);
   }
 }
 
@@ -341,11 +486,10 @@ void CoreTimingManager::Advance()
 
   m_is_global_timer_sane = true;
 
-  while (!m_event_queue.empty() && m_event_queue.front().time <= m_globals.global_timer)
+  while (!m_event_queue.empty() && m_event_queue.Top().time <= m_globals.global_timer)
   {
-    Event evt = std::move(m_event_queue.front());
-    std::pop_heap(m_event_queue.begin(), m_event_queue.end(), std::greater<Event>());
-    m_event_queue.pop_back();
+    const Event evt = m_event_queue.Top();
+    m_event_queue.Pop();
 
     Throttle(evt.time);
     evt.type->callback(m_system, evt.userdata, m_globals.global_timer - evt.time);
@@ -357,7 +501,7 @@ void CoreTimingManager::Advance()
   if (!m_event_queue.empty())
   {
     m_globals.slice_length = static_cast<int>(
-        std::min<s64>(m_event_queue.front().time - m_globals.global_timer, MAX_SLICE_LENGTH));
+        std::min<s64>(m_event_queue.Top().time - m_globals.global_timer, MAX_SLICE_LENGTH));
   }
 
   ppc_state.downcount = CyclesToDowncount(m_globals.slice_length);
@@ -442,7 +586,7 @@ bool CoreTimingManager::UseSyncOnSkipIdle() const
 
 void CoreTimingManager::LogPendingEvents() const
 {
-  auto clone = m_event_queue;
+  auto clone = m_event_queue.GetEvents();
   std::sort(clone.begin(), clone.end());
   for (const Event& ev : clone)
   {
@@ -457,10 +601,13 @@ void CoreTimingManager::AdjustEventQueueTimes(u32 new_ppc_clock, u32 old_ppc_clo
   m_throttle_clock_per_sec = new_ppc_clock;
   m_throttle_min_clock_per_sleep = new_ppc_clock / 1200;
 
-  for (Event& ev : m_event_queue)
+  std::vector<Event> events = m_event_queue.GetEvents();
+  m_event_queue.Clear(m_globals.global_timer);
+  for (Event& ev : events)
   {
     const s64 ticks = (ev.time - m_globals.global_timer) * new_ppc_clock / old_ppc_clock;
     ev.time = m_globals.global_timer + ticks;
+    m_event_queue.Push(ev);
   }
 }
 
@@ -485,7 +632,7 @@ std::string CoreTimingManager::GetScheduledEventsSummary() const
   std::string text = "Scheduled events\n";
   text.reserve(1000);
 
-  auto clone = m_event_queue;
+  auto clone = m_event_queue.GetEvents();
   std::sort(clone.begin(), clone.end());
   for (const Event& ev : clone)
   {
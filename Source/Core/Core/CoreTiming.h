@@ -16,6 +16,8 @@
 // inside callback:
 //   ScheduleEvent(periodInCycles - cyclesLate, callback, "whatever")
 
+#include <array>
+#include <cstddef>
 #include <mutex>
 #include <string>
 #include <unordered_map>
@@ -60,6 +62,52 @@ struct Event
   EventType* type;
 };
 
+// A priority queue of events, ordered by time and then by fifo_order.
+//
+// This is a single-level timing wheel: events in the near future are bucketed into slots by their
+// time, so scheduling them and moving on to the next slot is constant time. Rather than cascading
+// through coarser wheels, events further in the future wait in an overflow heap until the wheel
+// gets close to them (about 262k cycles ahead). The events of the current slot are
+// kept in a small heap of their own, which is also where events scheduled before the current slot
+// end up, so the order is exactly the same as with a single heap.
+class EventQueue
+{
+public:
+  static constexpr int SLOT_SHIFT = 10;
+  static constexpr size_t SLOT_COUNT = 256;
+
+  bool empty() const { return m_size == 0; }
+  size_t size() const { return m_size; }
+
+  void Push(const Event& event);
+  // The earliest event. Must not be called if the queue is empty.
+  const Event& Top();
+  void Pop();
+
+  void RemoveEvents(const EventType* event_type);
+  // Empties the queue and moves the wheel to the given time.
+  void Clear(s64 time);
+
+  // All events, in no particular order.
+  std::vector<Event> GetEvents() const;
+
+private:
+  using Slot = std::vector<Event>;
+
+  void PushToWheel(const Event& event);
+  void AdvanceCursor();
+  size_t FindNextOccupiedSlot() const;
+
+  std::vector<Event> m_current;
+  std::array<Slot, SLOT_COUNT> m_slots;
+  std::array<u64, SLOT_COUNT / 64> m_occupied_slots{};
+  std::vector<Event> m_overflow;
+
+  // The absolute slot number (time >> SLOT_SHIFT) that m_current covers.
+  s64 m_cursor = 0;
+  size_t m_size = 0;
+};
+
 enum class FromThread
 {
   CPU,
@@ -163,11 +211,7 @@ private:
   std::unordered_map<std::string, EventType> m_event_types;
 
   // STATE_TO_SAVE
-  // The queue is a min-heap using std::make_heap/push_heap/pop_heap.
-  // We don't use std::priority_queue because we need to be able to serialize, unserialize and
-  // erase arbitrary events (RemoveEvent()) regardless of the queue order. These aren't accomodated
-  // by the standard adaptor class.
-  std::vector<Event> m_event_queue;
+  EventQueue m_event_queue;
   u64 m_event_fifo_id = 0;
   std::mutex m_ts_write_lock;
   Common::SPSCQueue<Event, false> m_ts_queue;
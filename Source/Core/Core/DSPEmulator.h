@@ -28,6 +28,9 @@ public:
   virtual void DSP_WriteMailBoxLow(bool cpu_mailbox, u16 value) = 0;
   virtual u16 DSP_ReadMailBoxHigh(bool cpu_mailbox) = 0;
   virtual u16 DSP_ReadMailBoxLow(bool cpu_mailbox) = 0;
+  // Returns the storage of the CPU mailbox if the CPU can read it without any side effects, which
+  // allows polling it from JIT code without calling into the emulator. Returns nullptr otherwise.
+  virtual const u32* GetCPUMailboxStorage() const { return nullptr; }
   virtual u16 DSP_ReadControlRegister() = 0;
   virtual u16 DSP_WriteControlRegister(u16 value) = 0;
   virtual void DSP_Update(int cycles) = 0;
@@ -0,0 +1,434 @@
+// Copyright 2024 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "Core/Debugger/SamplingProfiler.h"
+
+#include <algorithm>
+#include <cstring>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+
+#include <fmt/format.h>
+
+#include "Common/CommonTypes.h"
+#include "Common/IOFile.h"
+#include "Common/Logging/Log.h"
+#include "Common/Swap.h"
+#include "Common/SymbolDB.h"
+#include "Common/Thread.h"
+#include "Core/ConfigManager.h"
+#include "Core/HW/CPU.h"
+#include "Core/HW/Memmap.h"
+#include "Core/PowerPC/PPCSymbolDB.h"
+#include "Core/PowerPC/PowerPC.h"
+#include "Core/System.h"
+
+namespace Core
+{
+namespace
+{
+std::string GetFrameName(PPCSymbolDB& symbol_db, u32 address)
+{
+  const Common::Symbol* symbol = symbol_db.GetSymbolFromAddr(address);
+  if (!symbol || symbol->name.empty())
+    return fmt::format("{:08x}", address);
+
+  // Semicolons separate frames in the folded format.
+  std::string name = symbol->name;
+  std::replace(name.begin(), name.end(), ';', ':');
+  return name;
+}
+
+// Just enough of the protobuf wire format to serialize a perftools.profiles.Profile.
+class ProtoWriter
+{
+public:
+  void UInt(u32 field, u64 value)
+  {
+    Key(field, WIRE_VARINT);
+    Varint(value);
+  }
+
+  void Bytes(u32 field, std::string_view bytes)
+  {
+    Key(field, WIRE_LENGTH_DELIMITED);
+    Varint(bytes.size());
+    m_data.append(bytes);
+  }
+
+  void Message(u32 field, const ProtoWriter& message) { Bytes(field, message.m_data); }
+
+  void PackedUInts(u32 field, const std::vector<u64>& values)
+  {
+    ProtoWriter packed;
+    for (const u64 value : values)
+      packed.Varint(value);
+    Bytes(field, packed.m_data);
+  }
+
+  const std::string& GetData() const { return m_data; }
+
+private:
+  static constexpr u32 WIRE_VARINT = 0;
+  static constexpr u32 WIRE_LENGTH_DELIMITED = 2;
+
+  void Key(u32 field, u32 wire_type) { Varint((u64(field) << 3) | wire_type); }
+
+  void Varint(u64 value)
+  {
+    while (value >= 0x80)
+    {
+      m_data.push_back(static_cast<char>((value & 0x7f) | 0x80));
+      value >>= 7;
+    }
+    m_data.push_back(static_cast<char>(value));
+  }
+
+  std::string m_data;
+};
+
+// Symbol lookups aren't safe on the sampling thread, so this part of the stack cleanup is done when
+// exporting: a function that has already returned from a call of its own has a stale LR pointing
+// into itself, which would otherwise show up as a bogus recursive call.
+SamplingProfiler::Stack GetSymbolizedStack(const SamplingProfiler::Stack& stack,
+                                           PPCSymbolDB& symbol_db)
+{
+  SamplingProfiler::Stack result = stack;
+  if (result.size() >= 2)
+  {
+    const Common::Symbol* pc_symbol = symbol_db.GetSymbolFromAddr(result[0]);
+    if (pc_symbol && pc_symbol == symbol_db.GetSymbolFromAddr(result[1]))
+      result.erase(result.begin() + 1);
+  }
+  return result;
+}
+
+class StringTable
+{
+public:
+  StringTable() { Intern(""); }
+
+  u64 Intern(const std::string& str)
+  {
+    const auto [it, inserted] = m_indices.try_emplace(str, m_strings.size());
+    if (inserted)
+      m_strings.push_back(str);
+    return it->second;
+  }
+
+  const std::vector<std::string>& GetStrings() const { return m_strings; }
+
+private:
+  std::vector<std::string> m_strings;
+  std::unordered_map<std::string, u64> m_indices;
+};
+}  // namespace
+
+SamplingProfiler::SamplingProfiler(System& system) : m_system(system)
+{
+}
+
+SamplingProfiler::~SamplingProfiler()
+{
+  Stop();
+}
+
+void SamplingProfiler::Start(std::chrono::microseconds interval)
+{
+  if (!m_running.TestAndSet())
+    return;
+
+  m_interval = std::max(interval, std::chrono::microseconds{1});
+  m_stop_event.Reset();
+  m_thread = std::thread(&SamplingProfiler::SamplingThread, this);
+}
+
+void SamplingProfiler::Stop()
+{
+  if (!m_running.TestAndClear())
+    return;
+
+  m_stop_event.Set();
+  m_thread.join();
+}
+
+void SamplingProfiler::Clear()
+{
+  std::lock_guard lk(m_samples_lock);
+  m_samples.clear();
+  m_sample_count = 0;
+}
+
+void SamplingProfiler::AddSample(const Stack& stack, u64 count)
+{
+  if (stack.empty())
+    return;
+
+  std::lock_guard lk(m_samples_lock);
+  m_samples[stack] += count;
+  m_sample_count += count;
+}
+
+std::size_t SamplingProfiler::GetSampleCount() const
+{
+  std::lock_guard lk(m_samples_lock);
+  return m_sample_count;
+}
+
+void SamplingProfiler::SamplingThread()
+{
+  Common::SetCurrentThreadName("Sampling Profiler");
+
+  while (!m_stop_event.WaitFor(m_interval))
+  {
+    // Don't attribute time spent paused or stepping in the debugger to whatever the PC points at.
+    if (m_system.GetCPU().GetState() == CPU::State::Running)
+      TakeSample();
+  }
+}
+
+bool SamplingProfiler::ReadGuestU32(u32 address, u32* value) const
+{
+  // Going through the MMU would require the CPU thread, so this only follows the default BAT
+  // mapping, which is where the stack lives for practically all titles.
+  if ((address & 3) != 0)
+    return false;
+
+  auto& memory = m_system.GetMemory();
+  const u32 physical_address = address & 0x3FFFFFFF;
+  const u8* pointer = nullptr;
+  if (physical_address + sizeof(u32) <= memory.GetRamSizeReal())
+  {
+    pointer = memory.GetRAM() + physical_address;
+  }
+  else if (memory.GetEXRAM() && (physical_address >> 28) == 0x1 &&
+           (physical_address & 0x0fffffff) + sizeof(u32) <= memory.GetExRamSizeReal())
+  {
+    pointer = memory.GetEXRAM() + (physical_address & memory.GetExRamMask());
+  }
+
+  if (!pointer)
+    return false;
+
+  u32 data;
+  std::memcpy(&data, pointer, sizeof(data));
+  *value = Common::swap32(data);
+  return true;
+}
+
+void SamplingProfiler::TakeSample()
+{
+  const auto& ppc_state = m_system.GetPPCState();
+  const u32 pc = ppc_state.pc;
+  const u32 lr = LR(ppc_state);
+  const u32 sp = ppc_state.gpr[1];
+
+  Stack stack;
+  stack.reserve(16);
+  stack.push_back(pc);
+
+  // Return addresses point past the bl, so subtract 4 to attribute them to the call site.
+  std::vector<u32> walked;
+  u32 frame;
+  if (ReadGuestU32(sp, &frame))
+  {
+    while (frame != 0 && walked.size() < MAX_STACK_DEPTH)
+    {
+      u32 return_address;
+      if (!ReadGuestU32(frame + 4, &return_address) || return_address == 0)
+        break;
+      walked.push_back(return_address - 4);
+
+      u32 next_frame;
+      // The stack grows downwards, so anything else is garbage.
+      if (!ReadGuestU32(frame, &next_frame) || next_frame <= frame)
+        break;
+      frame = next_frame;
+    }
+  }
+
+  // A function that has set up its stack frame has saved LR into its caller's frame, so LR
+  // duplicates the first walked entry. Otherwise, the PC is in a leaf function that hasn't set up
+  // a frame and LR is its caller, or LR is stale (see GetSymbolizedStack).
+  if (lr != 0 && (walked.empty() || walked.front() != lr - 4))
+    stack.push_back(lr - 4);
+  stack.insert(stack.end(), walked.begin(), walked.end());
+
+  AddSample(stack);
+}
+
+std::string SamplingProfiler::ExportFoldedStacks(PPCSymbolDB& symbol_db) const
+{
+  std::map<std::string, u64> folded;
+  {
+    std::lock_guard lk(m_samples_lock);
+    for (const auto& [raw_stack, count] : m_samples)
+    {
+      const Stack stack = GetSymbolizedStack(raw_stack, symbol_db);
+      std::string line;
+      for (auto it = stack.rbegin(); it != stack.rend(); ++it)
+      {
+        if (!line.empty())
+          line += ';';
+        line += GetFrameName(symbol_db, *it);
+      }
+      folded[line] += count;
+    }
+  }
+
+  std::string result;
+  for (const auto& [line, count] : folded)
+    result += fmt::format("{} {}\n", line, count);
+  return result;
+}
+
+std::string SamplingProfiler::ExportPprof(PPCSymbolDB& symbol_db) const
+{
+  // Field numbers from https://github.com/google/pprof/blob/main/proto/profile.proto
+  enum : u32
+  {
+    PROFILE_SAMPLE_TYPE = 1,
+    PROFILE_SAMPLE = 2,
+    PROFILE_MAPPING = 3,
+    PROFILE_LOCATION = 4,
+    PROFILE_FUNCTION = 5,
+    PROFILE_STRING_TABLE = 6,
+    PROFILE_DURATION_NANOS = 10,
+    PROFILE_PERIOD_TYPE = 11,
+    PROFILE_PERIOD = 12,
+
+    VALUE_TYPE_TYPE = 1,
+    VALUE_TYPE_UNIT = 2,
+
+    SAMPLE_LOCATION_ID = 1,
+    SAMPLE_VALUE = 2,
+
+    MAPPING_ID = 1,
+    MAPPING_MEMORY_START = 2,
+    MAPPING_MEMORY_LIMIT = 3,
+    MAPPING_FILENAME = 5,
+    MAPPING_HAS_FUNCTIONS = 7,
+
+    LOCATION_ID = 1,
+    LOCATION_MAPPING_ID = 2,
+    LOCATION_ADDRESS = 3,
+    LOCATION_LINE = 4,
+
+    LINE_FUNCTION_ID = 1,
+
+    FUNCTION_ID = 1,
+    FUNCTION_NAME = 2,
+    FUNCTION_SYSTEM_NAME = 3,
+  };
+
+  StringTable strings;
+  ProtoWriter profile;
+
+  const auto write_value_type = [&](u32 field, const std::string& type, const std::string& unit) {
+    ProtoWriter value_type;
+    value_type.UInt(VALUE_TYPE_TYPE, strings.Intern(type));
+    value_type.UInt(VALUE_TYPE_UNIT, strings.Intern(unit));
+    profile.Message(field, value_type);
+  };
+
+  const u64 period_ns = std::chrono::nanoseconds(m_interval).count();
+  write_value_type(PROFILE_SAMPLE_TYPE, "samples", "count");
+  write_value_type(PROFILE_SAMPLE_TYPE, "cpu", "nanoseconds");
+
+  std::unordered_map<u32, u64> location_ids;
+  std::unordered_map<std::string, u64> function_ids;
+  std::vector<std::pair<u32, u64>> locations;  // (address, function id)
+  u64 total_samples = 0;
+
+  {
+    std::lock_guard lk(m_samples_lock);
+    for (const auto& [raw_stack, count] : m_samples)
+    {
+      const Stack stack = GetSymbolizedStack(raw_stack, symbol_db);
+      std::vector<u64> sample_locations;
+      sample_locations.reserve(stack.size());
+      for (const u32 address : stack)
+      {
+        auto [it, inserted] = location_ids.try_emplace(address, location_ids.size() + 1);
+        if (inserted)
+        {
+          const std::string name = GetFrameName(symbol_db, address);
+          const auto function = function_ids.try_emplace(name, function_ids.size() + 1).first;
+          locations.emplace_back(address, function->second);
+        }
+        sample_locations.push_back(it->second);
+      }
+
+      ProtoWriter sample;
+      sample.PackedUInts(SAMPLE_LOCATION_ID, sample_locations);
+      sample.PackedUInts(SAMPLE_VALUE, {count, count * period_ns});
+      profile.Message(PROFILE_SAMPLE, sample);
+      total_samples += count;
+    }
+  }
+
+  ProtoWriter mapping;
+  mapping.UInt(MAPPING_ID, 1);
+  mapping.UInt(MAPPING_MEMORY_START, 0);
+  mapping.UInt(MAPPING_MEMORY_LIMIT, u64{0xFFFFFFFF} + 1);
+  mapping.UInt(MAPPING_FILENAME, strings.Intern(SConfig::GetInstance().GetGameID()));
+  mapping.UInt(MAPPING_HAS_FUNCTIONS, 1);
+  profile.Message(PROFILE_MAPPING, mapping);
+
+  for (std::size_t i = 0; i < locations.size(); ++i)
+  {
+    ProtoWriter line;
+    line.UInt(LINE_FUNCTION_ID, locations[i].second);
+
+    ProtoWriter location;
+    location.UInt(LOCATION_ID, i + 1);
+    location.UInt(LOCATION_MAPPING_ID, 1);
+    location.UInt(LOCATION_ADDRESS, locations[i].first);
+    location.Message(LOCATION_LINE, line);
+    profile.Message(PROFILE_LOCATION, location);
+  }
+
+  for (const auto& [name, id] : function_ids)
+  {
+    ProtoWriter function;
+    function.UInt(FUNCTION_ID, id);
+    function.UInt(FUNCTION_NAME, strings.Intern(name));
+    function.UInt(FUNCTION_SYSTEM_NAME, strings.Intern(name));
+    profile.Message(PROFILE_FUNCTION, function);
+  }
+
+  profile.UInt(PROFILE_DURATION_NANOS, total_samples * period_ns);
+  write_value_type(PROFILE_PERIOD_TYPE, "cpu", "nanoseconds");
+  profile.UInt(PROFILE_PERIOD, period_ns);
+
+  // The string table has to come last, as it's only complete once everything else is written.
+  for (const std::string& str : strings.GetStrings())
+    profile.Bytes(PROFILE_STRING_TABLE, str);
+
+  return profile.GetData();
+}
+
+bool SamplingProfiler::WriteFoldedStacks(const std::string& filename,
+                                         PPCSymbolDB& symbol_db) const
+{
+  File::IOFile f(filename, "w");
+  if (!f)
+  {
+    ERROR_LOG_FMT(POWERPC, "Failed to open {} for writing", filename);
+    return false;
+  }
+  return f.WriteString(ExportFoldedStacks(symbol_db));
+}
+
+bool SamplingProfiler::WritePprof(const std::string& filename, PPCSymbolDB& symbol_db) const
+{
+  File::IOFile f(filename, "wb");
+  if (!f)
+  {
+    ERROR_LOG_FMT(POWERPC, "Failed to open {} for writing", filename);
+    return false;
+  }
+  return f.WriteString(ExportPprof(symbol_db));
+}
+}  // namespace Core
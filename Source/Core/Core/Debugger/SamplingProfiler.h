@@ -0,0 +1,82 @@
+// Copyright 2024 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Common/CommonTypes.h"
+#include "Common/Event.h"
+#include "Common/Flag.h"
+
+class PPCSymbolDB;
+
+namespace Core
+{
+class System;
+
+// A low-overhead profiler for guest code. Unlike the JIT block profiler (see Profiler.h), this
+// doesn't require any instrumentation of the emitted code: a timer thread periodically captures
+// the guest PC, LR and the back chain of stack frames, and the resulting call stacks are
+// aggregated. This means it works with every CPU core and in release builds.
+//
+// The sampler reads the guest state without synchronizing with the CPU thread, so an individual
+// sample can be torn (e.g. captured in the middle of a function prologue). This is fine for a
+// statistical profiler.
+class SamplingProfiler final
+{
+public:
+  // Guest addresses, innermost frame first.
+  using Stack = std::vector<u32>;
+
+  static constexpr std::chrono::microseconds DEFAULT_INTERVAL{1000};
+  static constexpr std::size_t MAX_STACK_DEPTH = 64;
+
+  explicit SamplingProfiler(System& system);
+  SamplingProfiler(const SamplingProfiler&) = delete;
+  SamplingProfiler(SamplingProfiler&&) = delete;
+  SamplingProfiler& operator=(const SamplingProfiler&) = delete;
+  SamplingProfiler& operator=(SamplingProfiler&&) = delete;
+  ~SamplingProfiler();
+
+  void Start(std::chrono::microseconds interval = DEFAULT_INTERVAL);
+  void Stop();
+  bool IsRunning() const { return m_running.IsSet(); }
+  void Clear();
+
+  void AddSample(const Stack& stack, u64 count = 1);
+  std::size_t GetSampleCount() const;
+  std::chrono::microseconds GetInterval() const { return m_interval; }
+
+  // Brendan Gregg's "folded stacks" format, as consumed by flamegraph.pl, speedscope and others.
+  // One line per unique symbolized call stack, outermost frame first.
+  std::string ExportFoldedStacks(PPCSymbolDB& symbol_db) const;
+  // An uncompressed perftools.profiles.Profile protobuf, as consumed by `go tool pprof`.
+  std::string ExportPprof(PPCSymbolDB& symbol_db) const;
+
+  bool WriteFoldedStacks(const std::string& filename, PPCSymbolDB& symbol_db) const;
+  bool WritePprof(const std::string& filename, PPCSymbolDB& symbol_db) const;
+
+private:
+  void SamplingThread();
+  void TakeSample();
+  bool ReadGuestU32(u32 address, u32* value) const;
+
+  System& m_system;
+
+  std::thread m_thread;
+  Common::Event m_stop_event;
+  Common::Flag m_running;
+  std::chrono::microseconds m_interval = DEFAULT_INTERVAL;
+
+  mutable std::mutex m_samples_lock;
+  std::map<Stack, u64> m_samples;
+  std::size_t m_sample_count = 0;
+};
+}  // namespace Core
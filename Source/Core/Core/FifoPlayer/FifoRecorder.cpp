@@ -269,6 +269,8 @@ void FifoRecorder::StartRecording(s32 numFrames, CallbackFunc finishedCb)
 
         if (!was_recording)
         {
+          // The shadows were cleared, so nothing is known to be up to date anymore.
+          m_watched_memory.clear();
           RecordInitialVideoMemory();
         }
 
@@ -371,6 +373,21 @@ void FifoRecorder::UseMemory(u32 address, u32 size, MemoryUpdate::Type type, boo
     newData = &memory.GetRAM()[address & memory.GetRamMask()];
   }
 
+  const u64 key = (static_cast<u64>(address) << 32) | size;
+  std::optional<u64> write_generation;
+  bool was_watched = false;
+  if (!dynamicUpdate)
+  {
+    const auto watched = m_watched_memory.find(key);
+    was_watched = watched != m_watched_memory.end() && watched->second.has_value();
+    if (was_watched && memory.IsUnwrittenSince(address, size, *watched->second))
+      return;
+
+    // Writes have to be watched for before comparing, so that none are missed in between.
+    if (watched == m_watched_memory.end() || was_watched)
+      write_generation = memory.WatchForWrites(address, size);
+  }
+
   if (!dynamicUpdate && memcmp(curData, newData, size) != 0)
   {
     // Update current memory
@@ -385,12 +402,17 @@ void FifoRecorder::UseMemory(u32 address, u32 size, MemoryUpdate::Type type, boo
     std::copy(newData, newData + size, memUpdate.data.begin());
 
     m_CurrentFrame.memoryUpdates.push_back(std::move(memUpdate));
+    m_watched_memory[key] = write_generation;
   }
   else if (dynamicUpdate)
   {
     // Shadow the data so it won't be recorded as changed by a future UseMemory
     memcpy(curData, newData, size);
   }
+  else
+  {
+    m_watched_memory[key] = was_watched ? std::nullopt : write_generation;
+  }
 }
 
 void FifoRecorder::EndFrame(u32 fifoStart, u32 fifoEnd)
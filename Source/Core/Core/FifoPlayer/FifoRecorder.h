@@ -6,6 +6,8 @@
 #include <functional>
 #include <memory>
 #include <mutex>
+#include <optional>
+#include <unordered_map>
 #include <vector>
 
 #include "Common/Assert.h"
@@ -84,6 +86,10 @@ private:
   std::vector<u8> m_FifoData;
   std::vector<u8> m_Ram;
   std::vector<u8> m_ExRam;
+  // The write generation since which each used range (address << 32 | size) has been watched for
+  // writes, as its shadow is known to be up to date until then. Not set for ranges whose pages
+  // were written without the range changing, as they hold other data which is written to.
+  std::unordered_map<u64, std::optional<u64>> m_watched_memory;
 
   Common::EventHook m_end_of_frame_event;
 
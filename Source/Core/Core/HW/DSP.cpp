@@ -120,6 +120,8 @@ void DSPManager::Reinit(bool hle)
 {
   m_dsp_emulator = CreateDSPEmulator(m_system, hle);
   m_is_lle = m_dsp_emulator->IsLLE();
+  const u32* cpu_mailbox = m_dsp_emulator->GetCPUMailboxStorage();
+  m_cpu_mailbox_high = cpu_mailbox ? MMIO::Utils::HighPart(cpu_mailbox) : nullptr;
 
   if (m_system.IsWii())
   {
@@ -157,6 +159,7 @@ void DSPManager::Shutdown()
     m_aram.ptr = nullptr;
   }
 
+  m_cpu_mailbox_high = nullptr;
   m_dsp_emulator->Shutdown();
   m_dsp_emulator.reset();
 }
@@ -210,16 +213,21 @@ void DSPManager::RegisterMMIO(MMIO::Mapping* mmio, u32 base)
                        MMIO::InvalidWrite<u16>());
   }
 
-  // DSP mail MMIOs call DSP emulator functions to get results or write data.
-  mmio->Register(base | DSP_MAIL_TO_DSP_HI, MMIO::ComplexRead<u16>([](Core::System& system, u32) {
-                   auto& dsp = system.GetDSP();
-                   if (dsp.m_dsp_slice > DSP_MAIL_SLICE && dsp.m_is_lle)
-                   {
-                     dsp.m_dsp_emulator->DSP_Update(DSP_MAIL_SLICE);
-                     dsp.m_dsp_slice -= DSP_MAIL_SLICE;
-                   }
-                   return dsp.m_dsp_emulator->DSP_ReadMailBoxHigh(true);
-                 }),
+  // DSP mail MMIOs call DSP emulator functions to get results or write data. Games poll the high
+  // half of the CPU mailbox waiting for the DSP to take their mail, so it is read directly when the
+  // DSP emulator allows it.
+  mmio->Register(base | DSP_MAIL_TO_DSP_HI,
+                 MMIO::DirectReadWithFallback<u16>(
+                     &m_cpu_mailbox_high, 0xFFFF,
+                     [](Core::System& system, u32) {
+                       auto& dsp = system.GetDSP();
+                       if (dsp.m_dsp_slice > DSP_MAIL_SLICE && dsp.m_is_lle)
+                       {
+                         dsp.m_dsp_emulator->DSP_Update(DSP_MAIL_SLICE);
+                         dsp.m_dsp_slice -= DSP_MAIL_SLICE;
+                       }
+                       return dsp.m_dsp_emulator->DSP_ReadMailBoxHigh(true);
+                     }),
                  MMIO::ComplexWrite<u16>([](Core::System& system, u32, u16 val) {
                    auto& dsp = system.GetDSP();
                    dsp.m_dsp_emulator->DSP_WriteMailBoxHigh(true, val);
@@ -476,6 +484,8 @@ void DSPManager::Do_ARAM_DMA()
     m_aram_dma.ARAddr &= 0x3ffffff;
     m_aram_dma.MMAddr &= 0x3ffffff;
 
+    memory.PrepareHostWrite(m_aram_dma.MMAddr, m_aram_dma.Cnt.count);
+
     if (m_aram_dma.ARAddr < m_aram.size)
     {
       while (m_aram_dma.Cnt.count)
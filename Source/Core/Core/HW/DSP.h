@@ -183,6 +183,8 @@ private:
   std::unique_ptr<DSPEmulator> m_dsp_emulator;
 
   bool m_is_lle = false;
+  // High half of the CPU mailbox if the DSP emulator allows reading it directly, nullptr otherwise.
+  const u16* m_cpu_mailbox_high = nullptr;
 
   CoreTiming::EventType* m_event_type_generate_dsp_interrupt = nullptr;
   CoreTiming::EventType* m_event_type_complete_aram = nullptr;
@@ -40,6 +40,7 @@ public:
   void DSP_WriteMailBoxLow(bool cpu_mailbox, u16 value) override;
   u16 DSP_ReadMailBoxHigh(bool cpu_mailbox) override;
   u16 DSP_ReadMailBoxLow(bool cpu_mailbox) override;
+  const u32* GetCPUMailboxStorage() const override { return &m_dsp_state.cpu_mailbox; }
   u16 DSP_ReadControlRegister() override;
   u16 DSP_WriteControlRegister(u16 value) override;
   void DSP_Update(int cycles) override;
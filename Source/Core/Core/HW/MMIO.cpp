@@ -3,6 +3,8 @@
 
 #include "Core/HW/MMIO.h"
 
+#include <bit>
+#include <cstdint>
 #include <functional>
 
 #include "Common/Assert.h"
@@ -167,6 +169,36 @@ WriteHandlingMethod<T>* ComplexWrite(std::function<void(Core::System&, u32, T)>
   return new ComplexHandlingMethod<T>(lambda);
 }
 
+// DirectWithFallback: holds a pointer to the pointer to read the data from, as
+// well as a lambda that is called instead whenever that pointer is null. This
+// is a read only handling method.
+template <typename T>
+class DirectWithFallbackHandlingMethod : public ReadHandlingMethod<T>
+{
+public:
+  DirectWithFallbackHandlingMethod(const T* const* addr_ptr, u32 mask,
+                                   std::function<T(Core::System&, u32)> fallback)
+      : addr_ptr_(addr_ptr), mask_(mask), fallback_(std::move(fallback))
+  {
+  }
+  virtual ~DirectWithFallbackHandlingMethod() = default;
+  void AcceptReadVisitor(ReadHandlingMethodVisitor<T>& v) const override
+  {
+    v.VisitDirectWithFallback(addr_ptr_, mask_, &fallback_);
+  }
+
+private:
+  const T* const* addr_ptr_;
+  u32 mask_;
+  std::function<T(Core::System&, u32)> fallback_;
+};
+template <typename T>
+ReadHandlingMethod<T>* DirectReadWithFallback(const T* const* addr_ptr, u32 mask,
+                                              std::function<T(Core::System&, u32)> fallback)
+{
+  return new DirectWithFallbackHandlingMethod<T>(addr_ptr, mask, std::move(fallback));
+}
+
 // Invalid: specialization of the complex handling type with lambdas that
 // display error messages.
 template <typename T>
@@ -220,15 +252,91 @@ struct LargerAccessSize<u16>
   typedef u32 value;
 };
 
+// Visitors used by the converters to find out whether the underlying handlers
+// are simple enough to be merged into a single Constant/Direct/Nop handler,
+// which the JITs can then inline instead of calling a chain of lambdas.
+template <typename T>
+struct ReadMethodInspector : public ReadHandlingMethodVisitor<T>
+{
+  virtual ~ReadMethodInspector() = default;
+
+  bool is_constant = false;
+  bool is_direct = false;
+  T value = 0;
+  const T* addr = nullptr;
+  u32 mask = 0;
+
+  void VisitConstant(T v) override
+  {
+    is_constant = true;
+    value = v;
+  }
+  void VisitDirect(const T* a, u32 m) override
+  {
+    is_direct = true;
+    addr = a;
+    mask = m;
+  }
+  void VisitComplex(const std::function<T(Core::System&, u32)>*) override {}
+  void VisitDirectWithFallback(const T* const*, u32,
+                               const std::function<T(Core::System&, u32)>*) override
+  {
+  }
+};
+
+template <typename T>
+struct WriteMethodInspector : public WriteHandlingMethodVisitor<T>
+{
+  virtual ~WriteMethodInspector() = default;
+
+  bool is_nop = false;
+  bool is_direct = false;
+  T* addr = nullptr;
+  u32 mask = 0;
+
+  void VisitNop() override { is_nop = true; }
+  void VisitDirect(T* a, u32 m) override
+  {
+    is_direct = true;
+    addr = a;
+    mask = m;
+  }
+  void VisitComplex(const std::function<void(Core::System&, u32, T)>*) override {}
+};
+
+// Two Direct halves can only be merged if the host stores them exactly where
+// the halves of a naturally aligned larger value would be.
+template <typename T, typename ST>
+static bool AreMergeableHalves(const ST* high, const ST* low)
+{
+  return std::endian::native == std::endian::little && high == low + 1 &&
+         reinterpret_cast<std::uintptr_t>(low) % sizeof(T) == 0;
+}
+
 template <typename T>
 ReadHandlingMethod<T>* ReadToSmaller(Mapping* mmio, u32 high_part_addr, u32 low_part_addr)
 {
   typedef typename SmallerAccessSize<T>::value ST;
+  constexpr u32 small_bits = 8 * sizeof(ST);
+  constexpr u32 small_mask = (1U << small_bits) - 1;
 
   ReadHandler<ST>* high_part = &mmio->GetHandlerForRead<ST>(high_part_addr);
   ReadHandler<ST>* low_part = &mmio->GetHandlerForRead<ST>(low_part_addr);
 
-  // TODO(delroth): optimize
+  ReadMethodInspector<ST> high;
+  ReadMethodInspector<ST> low;
+  high_part->Visit(high);
+  low_part->Visit(low);
+
+  if (high.is_constant && low.is_constant)
+    return Constant<T>(static_cast<T>((T(high.value) << small_bits) | low.value));
+
+  if (high.is_direct && low.is_direct && AreMergeableHalves<T>(high.addr, low.addr))
+  {
+    return DirectRead<T>(reinterpret_cast<const T*>(low.addr),
+                         ((high.mask & small_mask) << small_bits) | (low.mask & small_mask));
+  }
+
   return ComplexRead<T>([=](Core::System& system, u32 addr) {
     return ((T)high_part->Read(system, high_part_addr) << (8 * sizeof(ST))) |
            low_part->Read(system, low_part_addr);
@@ -239,11 +347,26 @@ template <typename T>
 WriteHandlingMethod<T>* WriteToSmaller(Mapping* mmio, u32 high_part_addr, u32 low_part_addr)
 {
   typedef typename SmallerAccessSize<T>::value ST;
+  constexpr u32 small_bits = 8 * sizeof(ST);
+  constexpr u32 small_mask = (1U << small_bits) - 1;
 
   WriteHandler<ST>* high_part = &mmio->GetHandlerForWrite<ST>(high_part_addr);
   WriteHandler<ST>* low_part = &mmio->GetHandlerForWrite<ST>(low_part_addr);
 
-  // TODO(delroth): optimize
+  WriteMethodInspector<ST> high;
+  WriteMethodInspector<ST> low;
+  high_part->Visit(high);
+  low_part->Visit(low);
+
+  if (high.is_nop && low.is_nop)
+    return Nop<T>();
+
+  if (high.is_direct && low.is_direct && AreMergeableHalves<T>(high.addr, low.addr))
+  {
+    return DirectWrite<T>(reinterpret_cast<T*>(low.addr),
+                          ((high.mask & small_mask) << small_bits) | (low.mask & small_mask));
+  }
+
   return ComplexWrite<T>([=](Core::System& system, u32 addr, T val) {
     high_part->Write(system, high_part_addr, val >> (8 * sizeof(ST)));
     low_part->Write(system, low_part_addr, (ST)val);
@@ -257,7 +380,20 @@ ReadHandlingMethod<T>* ReadToLarger(Mapping* mmio, u32 larger_addr, u32 shift)
 
   ReadHandler<LT>* large = &mmio->GetHandlerForRead<LT>(larger_addr);
 
-  // TODO(delroth): optimize
+  ReadMethodInspector<LT> inspector;
+  large->Visit(inspector);
+
+  if (inspector.is_constant)
+    return Constant<T>(static_cast<T>(inspector.value >> shift));
+
+  // On a little endian host, the bits selected by the shift are simply stored
+  // shift / 8 bytes further than the larger value.
+  if (inspector.is_direct && std::endian::native == std::endian::little && shift % 8 == 0)
+  {
+    const u8* base = reinterpret_cast<const u8*>(inspector.addr);
+    return DirectRead<T>(reinterpret_cast<const T*>(base + shift / 8), inspector.mask >> shift);
+  }
+
   return ComplexRead<T>([large, shift](Core::System& system, u32 addr) {
     return large->Read(system, addr & ~(sizeof(LT) - 1)) >> shift;
   });
@@ -328,6 +464,16 @@ void ReadHandler<T>::ResetMethod(ReadHandlingMethod<T>* method)
     {
       ret = *lambda;
     }
+
+    void VisitDirectWithFallback(const T* const* addr_ptr, u32 mask,
+                                 const std::function<T(Core::System&, u32)>* fallback) override
+    {
+      ret = [addr_ptr, mask, fallback](Core::System& system, u32 addr) -> T {
+        if (const T* ptr = *addr_ptr)
+          return *ptr & mask;
+        return (*fallback)(system, addr);
+      };
+    }
   };
 
   FuncCreatorVisitor v;
@@ -94,6 +94,10 @@ inline u16* HighPart(u32* ptr)
 {
   return LowPart(ptr) + 1;
 }
+inline const u16* HighPart(const u32* ptr)
+{
+  return reinterpret_cast<const u16*>(ptr) + 1;
+}
 inline u16* HighPart(std::atomic<u32>* ptr)
 {
   static_assert(std::atomic<u32>::is_always_lock_free && sizeof(std::atomic<u32>) == sizeof(u32));
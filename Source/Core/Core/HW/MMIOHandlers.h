@@ -59,6 +59,17 @@ ReadHandlingMethod<T>* ComplexRead(std::function<T(Core::System&, u32)>);
 template <typename T>
 WriteHandlingMethod<T>* ComplexWrite(std::function<void(Core::System&, u32, T)>);
 
+// DirectWithFallback: use for registers that are polled in tight loops and that
+// can usually be read directly from a variable, but not always (for example
+// because the backing storage belongs to an object that can be swapped out, or
+// because reading it sometimes has side effects). While *addr_ptr is non-null,
+// reads return (**addr_ptr & mask) and can be inlined by the JITs; otherwise
+// the lambda is called like a Complex read. The pointer itself must stay valid
+// for the lifetime of the mapping.
+template <typename T>
+ReadHandlingMethod<T>* DirectReadWithFallback(const T* const* addr_ptr, u32 mask,
+                                              std::function<T(Core::System&, u32)> fallback);
+
 // Invalid: log an error and return -1 in case of a read. These are the default
 // handlers set for all MMIO types.
 template <typename T>
@@ -102,6 +113,8 @@ public:
   virtual void VisitConstant(T value) = 0;
   virtual void VisitDirect(const T* addr, u32 mask) = 0;
   virtual void VisitComplex(const std::function<T(Core::System&, u32)>* lambda) = 0;
+  virtual void VisitDirectWithFallback(const T* const* addr_ptr, u32 mask,
+                                       const std::function<T(Core::System&, u32)>* fallback) = 0;
 };
 template <typename T>
 class WriteHandlingMethodVisitor
@@ -190,6 +203,8 @@ private:
       std::function<T(Core::System&, u32)>);                                                       \
   MaybeExtern template WriteHandlingMethod<T>* ComplexWrite<T>(                                    \
       std::function<void(Core::System&, u32, T)>);                                                 \
+  MaybeExtern template ReadHandlingMethod<T>* DirectReadWithFallback<T>(                           \
+      const T* const* addr_ptr, u32 mask, std::function<T(Core::System&, u32)>);                   \
   MaybeExtern template ReadHandlingMethod<T>* InvalidRead<T>();                                    \
   MaybeExtern template WriteHandlingMethod<T>* InvalidWrite<T>();                                  \
   MaybeExtern template class ReadHandler<T>;                                                       \
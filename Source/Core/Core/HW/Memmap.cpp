@@ -12,12 +12,16 @@
 #include <array>
 #include <cstring>
 #include <memory>
+#include <optional>
+#include <thread>
 #include <tuple>
 
+#include "Common/Align.h"
 #include "Common/ChunkFile.h"
 #include "Common/CommonTypes.h"
 #include "Common/Logging/Log.h"
 #include "Common/MemArena.h"
+#include "Common/MemoryUtil.h"
 #include "Common/MsgHandler.h"
 #include "Common/Swap.h"
 #include "Core/Config/MainSettings.h"
@@ -32,6 +36,7 @@
 #include "Core/HW/SI/SI.h"
 #include "Core/HW/VideoInterface.h"
 #include "Core/HW/WII_IPC.h"
+#include "Core/MemTools.h"
 #include "Core/PowerPC/JitCommon/JitBase.h"
 #include "Core/PowerPC/PowerPC.h"
 #include "Core/System.h"
@@ -122,6 +127,24 @@ void MemoryManager::Init()
   }
   m_arena.GrabSHMSegment(mem_size, "dolphin-emu");
 
+  m_shm_size = mem_size;
+  // Shutdown waited for the last snapshot to be done with, so nothing reads it anymore.
+  m_snapshot_block_count = (mem_size + SNAPSHOT_BLOCK_SIZE - 1) / SNAPSHOT_BLOCK_SIZE;
+  m_snapshot_blocks = std::make_unique<std::atomic<SnapshotBlock>[]>(m_snapshot_block_count);
+  m_snapshot_memory.Release();
+  m_snapshot_base = static_cast<u8*>(m_snapshot_memory.Create(mem_size));
+  const u32 page_count = (mem_size + PROTECTION_PAGE_SIZE - 1) / PROTECTION_PAGE_SIZE;
+  m_gpu_resident_pages = std::make_unique<std::atomic<u32>[]>(page_count);
+  m_gpu_resident_page_count.store(0, std::memory_order_relaxed);
+  m_watched_pages = std::make_unique<std::atomic<bool>[]>(page_count);
+  m_page_write_generations = std::make_unique<std::atomic<u64>[]>(page_count);
+  m_watched_page_count.store(0, std::memory_order_relaxed);
+  // Every page counts as written now, so that a generation from before doesn't match it even once
+  // it's watched again.
+  const u64 init_generation = ++m_write_generation;
+  for (u32 page = 0; page < page_count; ++page)
+    m_page_write_generations[page].store(init_generation, std::memory_order_relaxed);
+
   m_physical_page_mappings.fill(nullptr);
 
   // Create an anonymous view of the physical memory
@@ -225,6 +248,20 @@ bool MemoryManager::InitFastmemArena()
                     region.physical_address, region.size);
       return false;
     }
+
+    std::lock_guard lk(m_protection_lock);
+    if (IsProtectionActive())
+    {
+      ForEachProtectionRun(
+          region.shm_position, region.size,
+          [&](u32 position, u32 run_size, bool write_protect, bool gpu_resident) {
+            if (write_protect || gpu_resident)
+            {
+              ApplyProtection(view + (position - region.shm_position), run_size, true,
+                              write_protect, gpu_resident);
+            }
+          });
+    }
   }
 
   m_is_fastmem_arena_initialized = true;
@@ -234,6 +271,8 @@ bool MemoryManager::InitFastmemArena()
 
 void MemoryManager::UpdateLogicalMemory(const PowerPC::BatTable& dbat_table)
 {
+  std::lock_guard lk(m_protection_lock);
+
   for (auto& entry : m_logical_mapped_entries)
   {
     m_arena.UnmapFromMemoryRegion(entry.mapped_pointer, entry.mapped_size);
@@ -278,7 +317,22 @@ void MemoryManager::UpdateLogicalMemory(const PowerPC::BatTable& dbat_table)
                   intersection_start, mapped_size, logical_address);
               exit(0);
             }
-            m_logical_mapped_entries.push_back({mapped_pointer, mapped_size});
+            m_logical_mapped_entries.push_back({mapped_pointer, mapped_size, position});
+
+            // New views have to honor the protection of the existing ones.
+            if (IsProtectionActive())
+            {
+              u8* view = static_cast<u8*>(mapped_pointer);
+              ForEachProtectionRun(
+                  position, mapped_size,
+                  [&](u32 run_position, u32 run_size, bool write_protect, bool gpu_resident) {
+                    if (write_protect || gpu_resident)
+                    {
+                      ApplyProtection(view + (run_position - position), run_size, true,
+                                      write_protect, gpu_resident);
+                    }
+                  });
+            }
           }
 
           m_logical_page_mappings[i] =
@@ -327,19 +381,829 @@ void MemoryManager::DoState(PointerWrap& p)
     return;
   }
 
-  p.DoArray(m_ram, current_ram_size);
-  p.DoArray(m_l1_cache, current_l1_cache_size);
+  // Both saving and loading need the GPU to be done with guest memory.
+  if (m_gpu_resident_page_count.load(std::memory_order_acquire) != 0)
+  {
+    const u32 last_page = (m_shm_size - 1) / PROTECTION_PAGE_SIZE;
+    CallWriteBackFunction(0, last_page);
+    std::lock_guard lk(m_protection_lock);
+    ClearGPUResidentPages(0, last_page);
+  }
+
+  if (m_state_memory_buffer)
+  {
+    if (p.IsReadMode() || p.IsWriteMode())
+      DoStateMemoryBuffer(p.IsReadMode());
+    p.DoMarker("Memory RAM");
+    p.DoMarker("Memory FakeVMEM");
+    p.DoMarker("Memory EXRAM");
+    return;
+  }
+
+  const bool snapshot = p.IsWriteMode() && m_snapshot_requested;
+  if (snapshot)
+  {
+    // The blocks have to be frozen before anything can fault on them.
+    std::lock_guard lk(m_protection_lock);
+    for (u32 i = 0; i < m_snapshot_block_count; ++i)
+      m_snapshot_blocks[i].store(SnapshotBlock::Frozen, std::memory_order_relaxed);
+    m_snapshot_active.store(true, std::memory_order_release);
+    ++m_protection_sequence;
+    UpdateProtection(0, m_shm_size);
+    m_snapshot_requested = false;
+  }
+
+  const auto do_region = [&](PhysicalMemoryRegion& region) {
+    if (snapshot)
+    {
+      m_snapshot_hole_positions.emplace_back(p.GetCurrentPosition(), &region);
+      return;
+    }
+
+    if (p.IsReadMode() && IsWriteProtectionActive())
+    {
+      // Saves taking a write fault for every page.
+      std::lock_guard lk(m_protection_lock);
+      MarkPagesWritten(region.shm_position, region.size);
+    }
+    p.DoArray(*region.out_pointer, region.size);
+  };
+
+  do_region(m_physical_regions[0]);
+  do_region(m_physical_regions[1]);
   p.DoMarker("Memory RAM");
   if (current_have_fake_vmem)
-    p.DoArray(m_fake_vmem, current_fake_vmem_size);
+    do_region(m_physical_regions[2]);
   p.DoMarker("Memory FakeVMEM");
   if (current_have_exram)
-    p.DoArray(m_exram, current_exram_size);
+    do_region(m_physical_regions[3]);
   p.DoMarker("Memory EXRAM");
 }
 
+bool MemoryManager::RequestSnapshot()
+{
+  if (!m_is_initialized || !m_write_protection_supported)
+    return false;
+
+  // The previous snapshot might still be read by a save state.
+  if (m_snapshot_active.load(std::memory_order_acquire))
+    return false;
+
+  m_snapshot_requested = true;
+  return true;
+}
+
+u32 MemoryManager::GetSnapshotSize() const
+{
+  return m_shm_size;
+}
+
+std::vector<SnapshotHole> MemoryManager::TakeSnapshotHoles(const u8* state_begin)
+{
+  std::vector<SnapshotHole> holes;
+  holes.reserve(m_snapshot_hole_positions.size());
+  for (const auto& [position, region] : m_snapshot_hole_positions)
+  {
+    holes.push_back(SnapshotHole{static_cast<size_t>(position - state_begin), region->shm_position,
+                                 region->size});
+  }
+
+  m_snapshot_hole_positions.clear();
+  m_snapshot_requested = false;
+  return holes;
+}
+
+void MemoryManager::ReadSnapshot(u8* dest, u32 shm_position, u32 size)
+{
+  while (size != 0)
+  {
+    const u32 copy_size =
+        std::min<u32>(size, SNAPSHOT_BLOCK_SIZE - shm_position % SNAPSHOT_BLOCK_SIZE);
+
+    // Guest memory stays write-protected, and faults from now on don't need to copy the block.
+    PreserveSnapshotBlock(shm_position / SNAPSHOT_BLOCK_SIZE);
+    std::memcpy(dest, m_snapshot_base + shm_position, copy_size);
+    dest += copy_size;
+    shm_position += copy_size;
+    size -= copy_size;
+  }
+}
+
+void MemoryManager::EndSnapshot()
+{
+  std::lock_guard lk(m_protection_lock);
+  if (!m_snapshot_active.load(std::memory_order_relaxed))
+    return;
+
+  // Blocks which are still being copied by a fault handler have to be waited for. Once no block is
+  // frozen, nothing can start writing to the snapshot memory anymore.
+  for (u32 i = 0; i < m_snapshot_block_count; ++i)
+  {
+    std::atomic<SnapshotBlock>& block = m_snapshot_blocks[i];
+    SnapshotBlock state = block.load(std::memory_order_acquire);
+    while (state != SnapshotBlock::Live)
+    {
+      if (state != SnapshotBlock::Preserving)
+      {
+        if (block.compare_exchange_weak(state, SnapshotBlock::Live, std::memory_order_acq_rel))
+          break;
+        continue;
+      }
+
+      std::this_thread::yield();
+      state = block.load(std::memory_order_acquire);
+    }
+  }
+  ++m_protection_sequence;
+  UpdateProtection(0, m_shm_size);
+
+  m_snapshot_active.store(false, std::memory_order_release);
+  m_snapshot_memory.Clear();
+  m_snapshot_end_cvar.notify_all();
+}
+
+void MemoryManager::SetExceptionHandlerInstalled(bool installed)
+{
+  {
+    std::lock_guard lk(m_protection_lock);
+    // Guest memory can be written to from any thread, so the fault handler has to see all of them.
+    // Write protection also doesn't work on macOS on ARM.
+#if defined(_M_ARM_64) && defined(__APPLE__)
+    m_write_protection_supported = false;
+#else
+    m_write_protection_supported = installed && EMM::IsExceptionHandlerProcessWide();
+#endif
+    if (!installed && m_is_initialized)
+      UnwatchAllPages();
+  }
+  if (installed)
+    return;
+
+  WaitForSnapshotEnd();
+}
+
+// Waits for the save state worker to be done with the current snapshot. It preserves whatever it
+// still has to read itself.
+void MemoryManager::WaitForSnapshotEnd()
+{
+  std::unique_lock lk(m_protection_lock);
+  m_snapshot_end_cvar.wait(lk,
+                           [this] { return !m_snapshot_active.load(std::memory_order_relaxed); });
+}
+
+std::optional<u64> MemoryManager::WatchForWrites(u32 address, u32 size)
+{
+  std::lock_guard lk(m_protection_lock);
+  if (!m_is_initialized || !m_write_protection_supported || size == 0)
+    return std::nullopt;
+
+  const std::optional<u32> position = GetPhysicalSHMPosition(address, size);
+  if (!position)
+    return std::nullopt;
+
+  return WatchPages(*position / PROTECTION_PAGE_SIZE, (*position + size - 1) / PROTECTION_PAGE_SIZE);
+}
+
+std::optional<u64> MemoryManager::WatchAllForWrites()
+{
+  std::lock_guard lk(m_protection_lock);
+  if (!m_is_initialized || !m_write_protection_supported)
+    return std::nullopt;
+
+  return WatchPages(0, (m_shm_size - 1) / PROTECTION_PAGE_SIZE);
+}
+
+// Expects the lock to be held.
+std::optional<u64> MemoryManager::WatchPages(u32 first_page, u32 last_page)
+{
+  // The caller looks at the contents afterwards, so a write before the pages are protected is
+  // already in them.
+  const u64 generation = m_write_generation.load(std::memory_order_acquire);
+  bool changed = false;
+  for (u32 page = first_page; page <= last_page; ++page)
+  {
+    if (!m_watched_pages[page].exchange(true, std::memory_order_acq_rel))
+    {
+      m_watched_page_count.fetch_add(1, std::memory_order_release);
+      changed = true;
+    }
+  }
+
+  if (changed)
+  {
+    ++m_protection_sequence;
+    const u32 start = first_page * PROTECTION_PAGE_SIZE;
+    UpdateProtection(start, std::min((last_page + 1) * PROTECTION_PAGE_SIZE, m_shm_size) - start);
+  }
+  return generation;
+}
+
+bool MemoryManager::IsUnwrittenSince(u32 address, u32 size, u64 generation) const
+{
+  if (!m_is_initialized || size == 0)
+    return false;
+
+  const std::optional<u32> position = GetPhysicalSHMPosition(address, size);
+  if (!position)
+    return false;
+
+  const u32 first_page = *position / PROTECTION_PAGE_SIZE;
+  const u32 last_page = (*position + size - 1) / PROTECTION_PAGE_SIZE;
+  for (u32 page = first_page; page <= last_page; ++page)
+  {
+    // Pages which aren't watched could have been written without anyone noticing.
+    if (!m_watched_pages[page].load(std::memory_order_acquire) ||
+        m_page_write_generations[page].load(std::memory_order_acquire) > generation)
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Calls func with each active region and the offset and size of every run of pages in it which was
+// written since the generation. Without a generation, the whole region counts as written.
+template <typename F>
+void MemoryManager::ForEachWrittenRun(std::optional<u64> generation, F func) const
+{
+  const auto is_written = [&](u32 page) {
+    return !generation || !m_watched_pages[page].load(std::memory_order_acquire) ||
+           m_page_write_generations[page].load(std::memory_order_acquire) > *generation;
+  };
+
+  for (const PhysicalMemoryRegion& region : m_physical_regions)
+  {
+    if (!region.active)
+      continue;
+
+    const u32 region_end = region.shm_position + region.size;
+    u32 position = region.shm_position;
+    while (position < region_end)
+    {
+      u32 run_end = position;
+      while (run_end < region_end && is_written(run_end / PROTECTION_PAGE_SIZE))
+        run_end = std::min(Common::AlignUp(run_end + 1, PROTECTION_PAGE_SIZE), region_end);
+
+      if (run_end != position)
+      {
+        func(region, position - region.shm_position, run_end - position);
+        position = run_end;
+      }
+      else
+      {
+        position = std::min(Common::AlignUp(position + 1, PROTECTION_PAGE_SIZE), region_end);
+      }
+    }
+  }
+}
+
+std::vector<WrittenRange> MemoryManager::GetWrittenRangesSince(u64 generation) const
+{
+  std::vector<WrittenRange> ranges;
+  if (!m_is_initialized)
+    return ranges;
+
+  ForEachWrittenRun(generation, [&](const PhysicalMemoryRegion& region, u32 offset, u32 size) {
+    ranges.push_back(WrittenRange{region.physical_address + offset, size});
+  });
+  return ranges;
+}
+
+void MemoryManager::DoStateMemoryBuffer(bool load)
+{
+  StateMemoryBuffer& buffer = *m_state_memory_buffer;
+  buffer.restored_ranges.clear();
+
+  // A buffer without a generation, or one from before Init, has to be copied as a whole.
+  std::optional<u64> generation = buffer.write_generation;
+  if (buffer.data.size() != m_shm_size)
+  {
+    if (load)
+    {
+      PanicAlertFmt("The state's guest memory doesn't fit the current memory settings");
+      return;
+    }
+    buffer.data.resize(m_shm_size);
+    generation.reset();
+  }
+
+  if (!load)
+  {
+    // Writes have to be watched for before copying, so that none are missed in between.
+    buffer.write_generation = WatchAllForWrites();
+    ForEachWrittenRun(generation, [&](const PhysicalMemoryRegion& region, u32 offset, u32 size) {
+      std::memcpy(buffer.data.data() + region.shm_position + offset, *region.out_pointer + offset,
+                  size);
+    });
+    return;
+  }
+
+  // Only the pages written since the buffer was saved differ from it.
+  ForEachWrittenRun(generation, [&](const PhysicalMemoryRegion& region, u32 offset, u32 size) {
+    const u32 shm_position = region.shm_position + offset;
+    if (IsWriteProtectionActive())
+    {
+      // Saves taking a write fault for every page.
+      std::lock_guard lk(m_protection_lock);
+      MarkPagesWritten(shm_position, size);
+    }
+    std::memcpy(*region.out_pointer + offset, buffer.data.data() + shm_position, size);
+    buffer.restored_ranges.push_back(WrittenRange{region.physical_address + offset, size});
+  });
+
+  // Guest memory matches the buffer again.
+  buffer.write_generation = WatchAllForWrites();
+}
+
+void MemoryManager::SetWriteBackFunction(WriteBackFunction function)
+{
+  std::lock_guard lk(m_protection_lock);
+  m_write_back_function.store(function, std::memory_order_release);
+  if (!function && m_shm_size != 0)
+    ClearGPUResidentPages(0, (m_shm_size - 1) / PROTECTION_PAGE_SIZE);
+}
+
+void MemoryManager::SetGPUResidencySupported(bool supported)
+{
+  m_gpu_residency_supported.store(supported, std::memory_order_release);
+  if (supported || m_gpu_resident_page_count.load(std::memory_order_acquire) == 0)
+    return;
+
+  // Memory which is already GPU resident has to be written back while the CPU can't see it yet.
+  const u32 last_page = (m_shm_size - 1) / PROTECTION_PAGE_SIZE;
+  CallWriteBackFunction(0, last_page);
+  std::lock_guard lk(m_protection_lock);
+  ClearGPUResidentPages(0, last_page);
+}
+
+bool MemoryManager::AddGPUResidentRange(u32 address, u32 size)
+{
+  if (size == 0 || !m_gpu_residency_supported.load(std::memory_order_acquire) ||
+      !m_write_back_function.load(std::memory_order_acquire))
+  {
+    return false;
+  }
+
+  const std::optional<u32> position = GetPhysicalSHMPosition(address, size);
+  if (!position)
+    return false;
+
+  std::lock_guard lk(m_protection_lock);
+  const u32 first_page = *position / PROTECTION_PAGE_SIZE;
+  const u32 last_page = (*position + size - 1) / PROTECTION_PAGE_SIZE;
+  bool changed = false;
+  for (u32 page = first_page; page <= last_page; ++page)
+  {
+    if (m_gpu_resident_pages[page].fetch_add(1, std::memory_order_relaxed) == 0)
+    {
+      m_gpu_resident_page_count.fetch_add(1, std::memory_order_release);
+      changed = true;
+    }
+  }
+
+  if (changed)
+  {
+    ++m_protection_sequence;
+    const u32 start = first_page * PROTECTION_PAGE_SIZE;
+    UpdateProtection(start, std::min((last_page + 1) * PROTECTION_PAGE_SIZE, m_shm_size) - start);
+  }
+  return true;
+}
+
+void MemoryManager::RemoveGPUResidentRange(u32 address, u32 size)
+{
+  const std::optional<u32> position = GetPhysicalSHMPosition(address, size);
+  if (size == 0 || !position)
+    return;
+
+  std::lock_guard lk(m_protection_lock);
+  const u32 first_page = *position / PROTECTION_PAGE_SIZE;
+  const u32 last_page = (*position + size - 1) / PROTECTION_PAGE_SIZE;
+  bool changed = false;
+  for (u32 page = first_page; page <= last_page; ++page)
+  {
+    // The count is already zero if the page was given back to the CPU without being written, which
+    // the fault handler can do at any time.
+    std::atomic<u32>& count = m_gpu_resident_pages[page];
+    u32 previous = count.load(std::memory_order_relaxed);
+    while (previous != 0 &&
+           !count.compare_exchange_weak(previous, previous - 1, std::memory_order_relaxed))
+    {
+    }
+    if (previous == 1)
+    {
+      m_gpu_resident_page_count.fetch_sub(1, std::memory_order_release);
+      changed = true;
+    }
+  }
+
+  if (changed)
+  {
+    ++m_protection_sequence;
+    const u32 start = first_page * PROTECTION_PAGE_SIZE;
+    UpdateProtection(start, std::min((last_page + 1) * PROTECTION_PAGE_SIZE, m_shm_size) - start);
+  }
+}
+
+bool MemoryManager::HandleAccessFault(uintptr_t address)
+{
+  if (!m_is_initialized)
+    return false;
+
+  // The views are always mapped, so any fault in them is caused by our protection, even if it was
+  // lifted in the meantime.
+  const std::optional<ViewPage> view_page = FindViewPage(reinterpret_cast<const u8*>(address));
+  if (!view_page)
+    return false;
+
+  const u32 page = view_page->shm_position / PROTECTION_PAGE_SIZE;
+  if (view_page->is_fastmem && IsGPUResident(view_page->shm_position))
+  {
+    // Waiting for the GPU thread in the fault handler is only known to be safe on the CPU thread,
+    // which residency being limited to dual core mode guarantees isn't the GPU thread as well.
+    // Any other thread should have written the memory back with PrepareHostAccess, so the fault
+    // isn't ours to handle.
+    if (!Core::IsCPUThread())
+      return false;
+
+    CallWriteBackFunction(page, page);
+
+    // If the page couldn't be written back, it has to be given back to the CPU anyway, as the
+    // access would fault forever otherwise.
+    if (m_gpu_resident_pages[page].exchange(0, std::memory_order_relaxed) != 0)
+    {
+      m_gpu_resident_page_count.fetch_sub(1, std::memory_order_release);
+      ++m_protection_sequence;
+    }
+  }
+  else
+  {
+    // Does nothing if another thread got to the block first, or the snapshot is over.
+    PreserveSnapshotBlock(view_page->shm_position / SNAPSHOT_BLOCK_SIZE);
+    UnwatchPage(page);
+  }
+
+  // If a snapshot still needs the page, a write to it faults again.
+  RefreshProtection(*view_page);
+  return true;
+}
+
+void MemoryManager::PrepareHostWrite(u32 address, size_t size)
+{
+  PrepareHostAccess(address, size);
+
+  if (size == 0 || !IsWriteProtectionActive())
+    return;
+
+  const std::optional<u32> position = GetPhysicalSHMPosition(address, size);
+  if (!position)
+    return;
+
+  std::lock_guard lk(m_protection_lock);
+  MarkPagesWritten(*position, static_cast<u32>(size));
+}
+
+void MemoryManager::WriteBackGPUResidentRange(u32 address, size_t size) const
+{
+  const std::optional<u32> position = GetPhysicalSHMPosition(address, size);
+  if (size == 0 || !position)
+    return;
+
+  const u32 first_page = *position / PROTECTION_PAGE_SIZE;
+  const u32 last_page = static_cast<u32>((*position + size - 1) / PROTECTION_PAGE_SIZE);
+  for (u32 page = first_page; page <= last_page; ++page)
+  {
+    if (m_gpu_resident_pages[page].load(std::memory_order_relaxed) != 0)
+    {
+      CallWriteBackFunction(first_page, last_page);
+      return;
+    }
+  }
+}
+
+// Calls the write-back function for the physical memory the given pages belong to.
+bool MemoryManager::CallWriteBackFunction(u32 first_page, u32 last_page) const
+{
+  const WriteBackFunction function = m_write_back_function.load(std::memory_order_acquire);
+  if (!function)
+    return false;
+
+  const u32 start = first_page * PROTECTION_PAGE_SIZE;
+  const u32 end = std::min((last_page + 1) * PROTECTION_PAGE_SIZE, m_shm_size);
+  for (const PhysicalMemoryRegion& region : m_physical_regions)
+  {
+    if (!region.active)
+      continue;
+
+    const u32 region_start = std::max(start, region.shm_position);
+    const u32 region_end = std::min(end, region.shm_position + region.size);
+    if (region_start < region_end)
+    {
+      function(region.physical_address + (region_start - region.shm_position),
+               region_end - region_start);
+    }
+  }
+  return true;
+}
+
+void MemoryManager::ClearGPUResidentPages(u32 first_page, u32 last_page)
+{
+  bool changed = false;
+  for (u32 page = first_page; page <= last_page; ++page)
+  {
+    if (m_gpu_resident_pages[page].exchange(0, std::memory_order_relaxed) != 0)
+    {
+      m_gpu_resident_page_count.fetch_sub(1, std::memory_order_release);
+      changed = true;
+    }
+  }
+
+  if (changed)
+  {
+    ++m_protection_sequence;
+    const u32 start = first_page * PROTECTION_PAGE_SIZE;
+    UpdateProtection(start, std::min((last_page + 1) * PROTECTION_PAGE_SIZE, m_shm_size) - start);
+  }
+}
+
+// Finds the protection page of the view the given host address is in. Only the physical views
+// are fixed, so the logical ones are only looked at on the CPU thread, which is the only thread
+// that accesses or changes them.
+std::optional<MemoryManager::ViewPage> MemoryManager::FindViewPage(const u8* address) const
+{
+  const auto page_in = [address](u8* view, u32 view_shm_position, u32 view_size,
+                                 bool is_fastmem) -> std::optional<ViewPage> {
+    if (!view || address < view || address >= view + view_size)
+      return std::nullopt;
+
+    const u32 position = view_shm_position + static_cast<u32>(address - view);
+    const u32 view_end = view_shm_position + view_size;
+    const u32 page_start = Common::AlignDown(position, PROTECTION_PAGE_SIZE);
+    const u32 start = std::max(page_start, view_shm_position);
+    const u32 end = std::min(Common::AlignUp(position + 1, PROTECTION_PAGE_SIZE), view_end);
+    return ViewPage{view + (start - view_shm_position), start, end - start, is_fastmem};
+  };
+
+  for (const PhysicalMemoryRegion& region : m_physical_regions)
+  {
+    if (!region.active)
+      continue;
+
+    if (const auto page = page_in(*region.out_pointer, region.shm_position, region.size, false))
+      return page;
+    if (m_is_fastmem_arena_initialized)
+    {
+      if (const auto page = page_in(m_physical_base + region.physical_address, region.shm_position,
+                                    region.size, true))
+      {
+        return page;
+      }
+    }
+  }
+
+  if (!Core::IsCPUThread())
+    return std::nullopt;
+
+  for (const LogicalMemoryView& entry : m_logical_mapped_entries)
+  {
+    if (const auto page = page_in(static_cast<u8*>(entry.mapped_pointer), entry.shm_position,
+                                  entry.mapped_size, true))
+    {
+      return page;
+    }
+  }
+
+  return std::nullopt;
+}
+
+// Returns the position of a range of physical memory in the shared memory segment.
+std::optional<u32> MemoryManager::GetPhysicalSHMPosition(u32 address, size_t size) const
+{
+  const u8* pointer = GetPointerForRange(address, size);
+  if (!pointer)
+    return std::nullopt;
+
+  for (const PhysicalMemoryRegion& region : m_physical_regions)
+  {
+    const u8* view = *region.out_pointer;
+    if (region.active && view && pointer >= view && pointer < view + region.size)
+      return region.shm_position + static_cast<u32>(pointer - view);
+  }
+  return std::nullopt;
+}
+
+// Calls func for every host mapping of the given part of the shared memory segment, and whether
+// it's one of the fastmem views, which are the only ones GPU resident memory is hidden from.
+template <typename F>
+void MemoryManager::ForEachView(u32 shm_position, u32 size, F func)
+{
+  const auto visit = [&](u8* view, u32 view_shm_position, u32 view_size, bool is_fastmem) {
+    const u32 start = std::max(shm_position, view_shm_position);
+    const u32 end = std::min(shm_position + size, view_shm_position + view_size);
+    if (view && start < end)
+      func(view + (start - view_shm_position), end - start, is_fastmem);
+  };
+
+  for (const PhysicalMemoryRegion& region : m_physical_regions)
+  {
+    if (!region.active)
+      continue;
+
+    visit(*region.out_pointer, region.shm_position, region.size, false);
+    if (m_is_fastmem_arena_initialized)
+      visit(m_physical_base + region.physical_address, region.shm_position, region.size, true);
+  }
+
+  for (const LogicalMemoryView& entry : m_logical_mapped_entries)
+    visit(static_cast<u8*>(entry.mapped_pointer), entry.shm_position, entry.mapped_size, true);
+}
+
+bool MemoryManager::IsWriteProtectionActive() const
+{
+  return m_snapshot_active.load(std::memory_order_acquire) ||
+         m_watched_page_count.load(std::memory_order_acquire) != 0;
+}
+
+bool MemoryManager::IsProtectionActive() const
+{
+  return IsWriteProtectionActive() || m_gpu_resident_page_count.load(std::memory_order_acquire);
+}
+
+bool MemoryManager::IsWriteProtected(u32 shm_position) const
+{
+  const SnapshotBlock state =
+      m_snapshot_blocks[shm_position / SNAPSHOT_BLOCK_SIZE].load(std::memory_order_acquire);
+  return state == SnapshotBlock::Frozen || state == SnapshotBlock::Preserving ||
+         m_watched_pages[shm_position / PROTECTION_PAGE_SIZE].load(std::memory_order_acquire);
+}
+
+bool MemoryManager::IsGPUResident(u32 shm_position) const
+{
+  const std::atomic<u32>& count = m_gpu_resident_pages[shm_position / PROTECTION_PAGE_SIZE];
+  return count.load(std::memory_order_acquire) != 0;
+}
+
+// Calls func for every run of pages in the given part of the shared memory segment which should
+// have the same protection.
+template <typename F>
+void MemoryManager::ForEachProtectionRun(u32 shm_position, u32 size, F func) const
+{
+  if (size == 0)
+    return;
+
+  const u32 end = shm_position + size;
+  u32 run_start = shm_position;
+  bool run_write_protected = IsWriteProtected(shm_position);
+  bool run_gpu_resident = IsGPUResident(shm_position);
+  for (u32 position = shm_position; position < end;)
+  {
+    const u32 next = std::min(Common::AlignUp(position + 1, PROTECTION_PAGE_SIZE), end);
+    if (next == end || IsWriteProtected(next) != run_write_protected ||
+        IsGPUResident(next) != run_gpu_resident)
+    {
+      func(run_start, next - run_start, run_write_protected, run_gpu_resident);
+      run_start = next;
+      if (next != end)
+      {
+        run_write_protected = IsWriteProtected(next);
+        run_gpu_resident = IsGPUResident(next);
+      }
+    }
+    position = next;
+  }
+}
+
+void MemoryManager::ApplyProtection(u8* view, u32 size, bool is_fastmem, bool write_protect,
+                                    bool gpu_resident)
+{
+  if (is_fastmem && gpu_resident)
+    Common::ReadProtectMemory(view, size);
+  else if (write_protect)
+    Common::WriteProtectMemory(view, size);
+  else
+    Common::UnWriteProtectMemory(view, size);
+}
+
+void MemoryManager::UpdateProtection(u32 shm_position, u32 size)
+{
+  ForEachProtectionRun(shm_position, size,
+                       [this](u32 position, u32 run_size, bool write_protect, bool gpu_resident) {
+                         ForEachView(position, run_size,
+                                     [&](u8* view, u32 view_size, bool is_fastmem) {
+                                       ApplyProtection(view, view_size, is_fastmem, write_protect,
+                                                       gpu_resident);
+                                     });
+                       });
+}
+
+// Applies the protection state to a single view, which is all the fault handler does. The state
+// may change while the protection is applied, in which case the new state wins.
+void MemoryManager::RefreshProtection(const ViewPage& view_page) const
+{
+  u32 sequence = m_protection_sequence;
+  while (true)
+  {
+    const u32 position = view_page.shm_position;
+    ApplyProtection(view_page.pointer, view_page.size, view_page.is_fastmem,
+                    IsWriteProtected(position), IsGPUResident(position));
+
+    const u32 new_sequence = m_protection_sequence;
+    if (new_sequence == sequence)
+      return;
+    sequence = new_sequence;
+  }
+}
+
+// Copies a frozen block to the snapshot memory before it's written to. Whichever thread gets to it
+// first claims the block, and the others wait for the copy instead of taking a lock, as this runs
+// in the fault handler. The protection of the views is left to the caller.
+void MemoryManager::PreserveSnapshotBlock(u32 block)
+{
+  std::atomic<SnapshotBlock>& state = m_snapshot_blocks[block];
+  SnapshotBlock expected = SnapshotBlock::Frozen;
+  if (!state.compare_exchange_strong(expected, SnapshotBlock::Preserving,
+                                     std::memory_order_acquire))
+  {
+    while (expected == SnapshotBlock::Preserving)
+    {
+      std::this_thread::yield();
+      expected = state.load(std::memory_order_acquire);
+    }
+    return;
+  }
+
+  // The views of the physical regions are never read-protected, unlike the fastmem ones.
+  const u32 start = block * SNAPSHOT_BLOCK_SIZE;
+  const u32 end = std::min(start + SNAPSHOT_BLOCK_SIZE, m_shm_size);
+  m_snapshot_memory.EnsureMemoryPageWritable(start);
+  for (const PhysicalMemoryRegion& region : m_physical_regions)
+  {
+    const u32 copy_start = std::max(start, region.shm_position);
+    const u32 copy_end = std::min(end, region.shm_position + region.size);
+    if (region.active && copy_start < copy_end)
+    {
+      std::memcpy(m_snapshot_base + copy_start,
+                  *region.out_pointer + (copy_start - region.shm_position), copy_end - copy_start);
+    }
+  }
+
+  state.store(SnapshotBlock::Preserved, std::memory_order_release);
+  ++m_protection_sequence;
+}
+
+// Records a write to a watched page, which stops being watched. Like PreserveSnapshotBlock, this
+// runs in the fault handler, and the protection of the views is left to the caller.
+bool MemoryManager::UnwatchPage(u32 page)
+{
+  if (!m_watched_pages[page].exchange(false, std::memory_order_acq_rel))
+    return false;
+
+  m_page_write_generations[page].store(++m_write_generation, std::memory_order_release);
+  m_watched_page_count.fetch_sub(1, std::memory_order_release);
+  ++m_protection_sequence;
+  return true;
+}
+
+void MemoryManager::UnwatchAllPages()
+{
+  if (m_watched_page_count.load(std::memory_order_acquire) == 0)
+    return;
+
+  const u32 page_count = (m_shm_size + PROTECTION_PAGE_SIZE - 1) / PROTECTION_PAGE_SIZE;
+  for (u32 page = 0; page < page_count; ++page)
+    UnwatchPage(page);
+  UpdateProtection(0, m_shm_size);
+}
+
+void MemoryManager::MarkPagesWritten(u32 shm_position, u32 size)
+{
+  const u32 first_block = shm_position / SNAPSHOT_BLOCK_SIZE;
+  const u32 last_block = (shm_position + size - 1) / SNAPSHOT_BLOCK_SIZE;
+  bool changed = false;
+  for (u32 block = first_block; block <= last_block; ++block)
+  {
+    if (m_snapshot_blocks[block].load(std::memory_order_acquire) != SnapshotBlock::Live)
+    {
+      PreserveSnapshotBlock(block);
+      changed = true;
+    }
+  }
+
+  const u32 last_page = (shm_position + size - 1) / PROTECTION_PAGE_SIZE;
+  for (u32 page = shm_position / PROTECTION_PAGE_SIZE; page <= last_page; ++page)
+    changed |= UnwatchPage(page);
+
+  if (changed)
+  {
+    const u32 start = first_block * SNAPSHOT_BLOCK_SIZE;
+    UpdateProtection(start, std::min((last_block + 1) * SNAPSHOT_BLOCK_SIZE, m_shm_size) - start);
+  }
+}
+
 void MemoryManager::Shutdown()
 {
+  WaitForSnapshotEnd();
+
   ShutdownFastmemArena();
 
   m_is_initialized = false;
@@ -429,6 +1293,7 @@ void MemoryManager::CopyFromEmu(void* data, u32 address, size_t size) const
     PanicAlertFmt("Invalid range in CopyFromEmu. {:x} bytes from {:#010x}", size, address);
     return;
   }
+  PrepareHostAccess(address, size);
   memcpy(data, pointer, size);
 }
 
@@ -443,6 +1308,7 @@ void MemoryManager::CopyToEmu(u32 address, const void* data, size_t size)
     PanicAlertFmt("Invalid range in CopyToEmu. {:x} bytes to {:#010x}", size, address);
     return;
   }
+  PrepareHostWrite(address, size);
   memcpy(pointer, data, size);
 }
 
@@ -457,6 +1323,7 @@ void MemoryManager::Memset(u32 address, u8 value, size_t size)
     PanicAlertFmt("Invalid range in Memset. {:x} bytes at {:#010x}", size, address);
     return;
   }
+  PrepareHostWrite(address, size);
   memset(pointer, value, size);
 }
 
@@ -4,7 +4,12 @@
 #pragma once
 
 #include <array>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
 #include <memory>
+#include <mutex>
+#include <optional>
 #include <string>
 #include <vector>
 
@@ -53,6 +58,32 @@ struct LogicalMemoryView
 {
   void* mapped_pointer;
   u32 mapped_size;
+  u32 shm_position;
+};
+
+// A part of a save state that DoState left out because it is covered by a memory snapshot.
+struct SnapshotHole
+{
+  size_t offset;
+  u32 shm_position;
+  u32 size;
+};
+
+// Physical memory which dirty page tracking found to be written.
+struct WrittenRange
+{
+  u32 physical_address;
+  u32 size;
+};
+
+// Guest memory kept apart from the rest of a save state, see MemoryManager::SetStateMemoryBuffer.
+struct StateMemoryBuffer
+{
+  std::vector<u8> data;
+  // The write generation at which data matched guest memory, if writes were watched for.
+  std::optional<u64> write_generation;
+  // The physical ranges which the last load copied to guest memory.
+  std::vector<WrittenRange> restored_ranges;
 };
 
 class MemoryManager
@@ -102,6 +133,83 @@ public:
 
   void Clear();
 
+  // Copy-on-write snapshots of guest memory, which let save states avoid copying all of it while
+  // the CPU thread is paused. If a snapshot was requested, the next DoState in write mode leaves
+  // guest memory out of the state and write-protects it instead. The first write to each block
+  // afterwards preserves the old contents from the fault handler, so ReadSnapshot can fill in the
+  // state from any thread while emulation keeps running.
+  bool RequestSnapshot();
+  // The number of bytes a snapshot leaves out of the state.
+  u32 GetSnapshotSize() const;
+  std::vector<SnapshotHole> TakeSnapshotHoles(const u8* state_begin);
+  void ReadSnapshot(u8* dest, u32 shm_position, u32 size);
+  void EndSnapshot();
+  // Snapshots need an exception handler which sees the faults of every thread, and nothing may be
+  // left write-protected once it's gone. Before it's uninstalled, this waits for the save state
+  // reading the current snapshot to be done with it.
+  void SetExceptionHandlerInstalled(bool installed);
+
+  // Dirty page tracking. WatchForWrites write-protects the pages of a physical range until they're
+  // written to, and returns the current write generation. While IsUnwrittenSince returns true for
+  // it, nothing has written to the range since, so the caller only has to look at its contents
+  // once. Pages are shared with the surrounding memory, so writes next to the range count too.
+  // Writes by the CPU are noticed through the first fault on a page, and writes by the host, like
+  // DVD, ARAM and EFB copy DMA, through PrepareHostWrite. Generations are never reused, so every
+  // user can keep its own and compare against it independently of the others.
+  // Like snapshots, this needs an exception handler which sees the faults of every thread, and
+  // nothing is returned without one.
+  std::optional<u64> WatchForWrites(u32 address, u32 size);
+  std::optional<u64> WatchAllForWrites();
+  bool IsUnwrittenSince(u32 address, u32 size, u64 generation) const;
+  // The physical ranges which might have been written since the given generation, merged per run
+  // of pages. Pages which aren't watched are always included.
+  std::vector<WrittenRange> GetWrittenRangesSince(u64 generation) const;
+
+  // While a buffer is set, DoState keeps guest memory in it instead of in the state. Buffers which
+  // are saved to and loaded from repeatedly, like the snapshots of the rollback network mode, then
+  // only have the pages written since their write generation copied, both ways.
+  void SetStateMemoryBuffer(StateMemoryBuffer* buffer) { m_state_memory_buffer = buffer; }
+
+  // Guest memory which the GPU has yet to write, such as lazily written EFB copies. While a page is
+  // GPU resident, the fastmem views of it can't be accessed at all, and the write-back function is
+  // called with the physical range of the pages before the CPU or the host gets to access them.
+  // The write-back function has to write the memory and remove the ranges before it returns.
+  //
+  // Only the CPU thread accesses the fastmem views, so only it can fault on GPU resident memory.
+  // The write-back function is then called from the fault handler, where it may block on the GPU
+  // thread the same way an EFB access does, but must not take any lock the CPU thread could
+  // already be holding. Other threads have to go through PrepareHostAccess, which writes the
+  // memory back eagerly outside of the fault handler.
+  using WriteBackFunction = void (*)(u32 address, u32 size);
+  void SetWriteBackFunction(WriteBackFunction function);
+  // Memory can only be left to the GPU while every access to it by the CPU either faults or goes
+  // through MMU.cpp, which isn't the case when the JIT uses the page mappings instead of fastmem.
+  // The faults also have to reach HandleAccessFault, and the write-back function must not render
+  // inside it, so this needs a process-wide exception handler and a separate GPU thread.
+  void SetGPUResidencySupported(bool supported);
+  // Returns false if the range can't be left to the GPU, in which case it has to be written now.
+  bool AddGPUResidentRange(u32 address, u32 size);
+  void RemoveGPUResidentRange(u32 address, u32 size);
+
+  // Handles faults caused by snapshots, dirty page tracking and GPU resident memory. Any thread can
+  // fault while holding any lock, so this doesn't take one: snapshot blocks and watched pages are
+  // claimed atomically, and only the protection of the view that faulted is lifted.
+  bool HandleAccessFault(uintptr_t address);
+  // Should be called before the host accesses guest memory outside of the CPU thread's fastmem
+  // accesses, so that GPU resident memory is written back first. This includes the GPU thread's
+  // own reads, as it only sees memory through the base views, which are never protected.
+  void PrepareHostAccess(u32 address, size_t size) const
+  {
+    if (m_gpu_resident_page_count.load(std::memory_order_acquire) != 0)
+      WriteBackGPUResidentRange(address, size);
+  }
+  // Should be called before the host writes to guest memory outside of the CPU thread's normal
+  // accesses, e.g. for DMA, and saves a fault per page. It's required before a system call writes
+  // to guest memory, as that fails with EFAULT on write-protected memory instead of faulting. The
+  // output buffers of IOS requests are prepared before the request is handled, so this is only
+  // needed for other memory, like buffers a request points to or writes that happen later.
+  void PrepareHostWrite(u32 address, size_t size);
+
   // Routines to access physically addressed memory, designed for use by
   // emulated hardware outside the CPU. Use "Device_" prefix.
   std::string GetString(u32 em_address, size_t size = 0);
@@ -243,8 +351,93 @@ private:
   std::array<void*, PowerPC::BAT_PAGE_COUNT> m_physical_page_mappings{};
   std::array<void*, PowerPC::BAT_PAGE_COUNT> m_logical_page_mappings{};
 
+  // Protection state for snapshots, dirty page tracking and GPU resident memory. Blocks and pages
+  // are indexed by their position in the shared memory segment. The state is atomic, as the fault
+  // handler updates it without a lock. It only ever lifts protection, while everything that adds
+  // protection holds m_protection_lock, which also guards m_logical_mapped_entries.
+  enum class SnapshotBlock : u8
+  {
+    Live,
+    Frozen,
+    // Being copied by the thread that claimed it.
+    Preserving,
+    Preserved,
+  };
+  static constexpr u32 SNAPSHOT_BLOCK_SIZE = 0x10000;
+  // Large enough for the page size of every supported host.
+  static constexpr u32 PROTECTION_PAGE_SIZE = 0x4000;
+  static_assert(SNAPSHOT_BLOCK_SIZE % PROTECTION_PAGE_SIZE == 0);
+
+  u32 m_shm_size = 0;
+  std::mutex m_protection_lock;
+  // Incremented after every change to the protection state, so the fault handler can tell if the
+  // protection it applied is already outdated.
+  std::atomic<u32> m_protection_sequence = 0;
+  bool m_write_protection_supported = false;
+  std::atomic<bool> m_snapshot_active = false;
+  std::condition_variable m_snapshot_end_cvar;
+  bool m_snapshot_requested = false;
+  std::unique_ptr<std::atomic<SnapshotBlock>[]> m_snapshot_blocks;
+  u32 m_snapshot_block_count = 0;
+  std::vector<std::pair<u8*, PhysicalMemoryRegion*>> m_snapshot_hole_positions;
+  Common::LazyMemoryRegion m_snapshot_memory;
+  u8* m_snapshot_base = nullptr;
+
+  // Which pages are watched for writes, and the write generation each page was last written in.
+  // The fault handler unwatches pages, everything else changes them with the lock held.
+  std::unique_ptr<std::atomic<bool>[]> m_watched_pages;
+  std::unique_ptr<std::atomic<u64>[]> m_page_write_generations;
+  std::atomic<u32> m_watched_page_count = 0;
+  // Never reset, so a generation from before Init can't match the new pages.
+  std::atomic<u64> m_write_generation = 0;
+
+  StateMemoryBuffer* m_state_memory_buffer = nullptr;
+
+  // The number of ranges which keep each page GPU resident, and the number of such pages. The fault
+  // handler may drop a page's count to zero, everything else changes them with the lock held.
+  std::unique_ptr<std::atomic<u32>[]> m_gpu_resident_pages;
+  std::atomic<u32> m_gpu_resident_page_count = 0;
+  std::atomic<WriteBackFunction> m_write_back_function = nullptr;
+  std::atomic<bool> m_gpu_residency_supported = false;
+
   Core::System& m_system;
 
   void InitMMIO(bool is_wii);
+
+  // A protection page as seen through one of the host mappings of guest memory.
+  struct ViewPage
+  {
+    u8* pointer;
+    u32 shm_position;
+    u32 size;
+    bool is_fastmem;
+  };
+
+  std::optional<ViewPage> FindViewPage(const u8* address) const;
+  std::optional<u32> GetPhysicalSHMPosition(u32 address, size_t size) const;
+  template <typename F>
+  void ForEachView(u32 shm_position, u32 size, F func);
+  bool IsWriteProtectionActive() const;
+  bool IsProtectionActive() const;
+  bool IsWriteProtected(u32 shm_position) const;
+  bool IsGPUResident(u32 shm_position) const;
+  template <typename F>
+  void ForEachProtectionRun(u32 shm_position, u32 size, F func) const;
+  static void ApplyProtection(u8* view, u32 size, bool is_fastmem, bool write_protect,
+                              bool gpu_resident);
+  void UpdateProtection(u32 shm_position, u32 size);
+  void RefreshProtection(const ViewPage& view_page) const;
+  void WriteBackGPUResidentRange(u32 address, size_t size) const;
+  bool CallWriteBackFunction(u32 first_page, u32 last_page) const;
+  void ClearGPUResidentPages(u32 first_page, u32 last_page);
+  void WaitForSnapshotEnd();
+  void PreserveSnapshotBlock(u32 block);
+  std::optional<u64> WatchPages(u32 first_page, u32 last_page);
+  bool UnwatchPage(u32 page);
+  void UnwatchAllPages();
+  void MarkPagesWritten(u32 shm_position, u32 size);
+  template <typename F>
+  void ForEachWrittenRun(std::optional<u64> generation, F func) const;
+  void DoStateMemoryBuffer(bool load);
 };
 }  // namespace Memory
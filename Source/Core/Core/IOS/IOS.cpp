@@ -720,6 +720,10 @@ std::optional<IPCReply> EmulationKernel::HandleIPCCommand(const Request& request
   std::optional<IPCReply> ret;
   const u64 wall_time_before = Common::Timer::NowUs();
 
+  // Devices may have the host write output straight into guest memory, e.g. when reading a file,
+  // which fails instead of faulting if the memory is write-protected for a save state snapshot.
+  auto& memory = GetSystem().GetMemory();
+
   switch (request.command)
   {
   case IPC_CMD_CLOSE:
@@ -729,8 +733,12 @@ std::optional<IPCReply> EmulationKernel::HandleIPCCommand(const Request& request
     ret = device->Close(request.fd);
     break;
   case IPC_CMD_READ:
-    ret = device->Read(ReadWriteRequest{GetSystem(), request.address});
+  {
+    const ReadWriteRequest read_request{GetSystem(), request.address};
+    memory.PrepareHostWrite(read_request.buffer, read_request.size);
+    ret = device->Read(read_request);
     break;
+  }
   case IPC_CMD_WRITE:
     ret = device->Write(ReadWriteRequest{GetSystem(), request.address});
     break;
@@ -738,11 +746,20 @@ std::optional<IPCReply> EmulationKernel::HandleIPCCommand(const Request& request
     ret = device->Seek(SeekRequest{GetSystem(), request.address});
     break;
   case IPC_CMD_IOCTL:
-    ret = device->IOCtl(IOCtlRequest{GetSystem(), request.address});
+  {
+    const IOCtlRequest ioctl_request{GetSystem(), request.address};
+    memory.PrepareHostWrite(ioctl_request.buffer_out, ioctl_request.buffer_out_size);
+    ret = device->IOCtl(ioctl_request);
     break;
+  }
   case IPC_CMD_IOCTLV:
-    ret = device->IOCtlV(IOCtlVRequest{GetSystem(), request.address});
+  {
+    const IOCtlVRequest ioctlv_request{GetSystem(), request.address};
+    for (const IOCtlVRequest::IOVector& vector : ioctlv_request.io_vectors)
+      memory.PrepareHostWrite(vector.address, vector.size);
+    ret = device->IOCtlV(ioctlv_request);
     break;
+  }
   default:
     ASSERT_MSG(IOS, false, "Unexpected command: {:#x}", Common::ToUnderlying(request.command));
     ret = IPCReply{IPC_EINVAL, 978_tbticks};
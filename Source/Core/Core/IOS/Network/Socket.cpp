@@ -661,6 +661,8 @@ void WiiSocket::Update(bool read, bool write, bool except)
             break;
           }
 #endif
+          // The kernel writes the received data straight into guest memory.
+          memory.PrepareHostWrite(BufferOut, BufferOutSize);
           socklen_t addrlen = sizeof(sockaddr_in);
           auto* from = BufferOutSize2 ? reinterpret_cast<sockaddr*>(&local_name) : nullptr;
           socklen_t* fromlen = BufferOutSize2 ? &addrlen : nullptr;
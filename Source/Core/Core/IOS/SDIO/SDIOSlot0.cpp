@@ -287,6 +287,8 @@ s32 SDIOSlot0Device::ExecuteCommand(const Request& request, u32 buffer_in, u32 b
       if (!m_card.Seek(address, File::SeekOrigin::Begin))
         ERROR_LOG_FMT(IOS_SD, "Seek failed");
 
+      // The host reads straight into guest memory, bypassing the snapshot fault handler.
+      memory.PrepareHostWrite(req.addr, size);
       if (m_card.ReadBytes(memory.GetPointer(req.addr), size))
       {
         DEBUG_LOG_FMT(IOS_SD, "Outbuffer size {} got {}", rw_buffer_size, size);
@@ -519,6 +519,7 @@ std::optional<IPCReply> WFSIDevice::IOCtl(const IOCtlRequest& request)
     }
     else
     {
+      memory.PrepareHostWrite(dol_addr, max_dol_size);
       fp.ReadBytes(memory.GetPointer(dol_addr), max_dol_size);
     }
     memory.Write_U32(real_dol_size, request.buffer_out);
@@ -569,6 +570,7 @@ u32 WFSIDevice::GetTmd(u16 group_id, u32 title_id, u64 subtitle_id, u32 address,
   {
     auto& system = GetSystem();
     auto& memory = system.GetMemory();
+    memory.PrepareHostWrite(address, fp.GetSize());
     fp.ReadBytes(memory.GetPointer(address), fp.GetSize());
   }
   *size = fp.GetSize();
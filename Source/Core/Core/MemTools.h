@@ -8,4 +8,6 @@ namespace EMM
 void InstallExceptionHandler();
 void UninstallExceptionHandler();
 bool IsExceptionHandlerSupported();
+// Whether faults from every thread reach the handler, not just those from the CPU thread.
+bool IsExceptionHandlerProcessWide();
 }  // namespace EMM
@@ -30,6 +30,7 @@
 #include "Common/QoSSession.h"
 #include "Common/SFMLHelper.h"
 #include "Common/StringUtil.h"
+#include "Common/Thread.h"
 #include "Common/Timer.h"
 #include "Common/Version.h"
 
@@ -40,6 +41,7 @@
 #include "Core/Config/SessionSettings.h"
 #include "Core/Config/WiimoteSettings.h"
 #include "Core/ConfigManager.h"
+#include "Core/Core.h"
 #include "Core/GeckoCode.h"
 #include "Core/HW/EXI/EXI.h"
 #include "Core/HW/EXI/EXI_DeviceIPL.h"
@@ -65,9 +67,11 @@
 #include "Core/Movie.h"
 #include "Core/NetPlayCommon.h"
 #include "Core/PowerPC/PowerPC.h"
+#include "Core/State.h"
 #include "Core/SyncIdentifier.h"
 #include "Core/System.h"
 #include "DiscIO/Blob.h"
+#include "DiscIO/Enums.h"
 
 #include "InputCommon/ControllerEmu/ControlGroup/Attachments.h"
 #include "InputCommon/GCAdapter.h"
@@ -91,6 +95,8 @@ NetPlayClient::~NetPlayClient()
   if (m_is_running.IsSet())
     StopGame();
 
+  StopRollbackThread();
+
   if (m_is_connected)
   {
     m_should_compute_game_digest = false;
@@ -926,6 +932,7 @@ void NetPlayClient::OnStartGame(sf::Packet& packet)
     packet >> m_net_settings.sync_codes;
 
     packet >> m_net_settings.golf_mode;
+    packet >> m_net_settings.rollback_frames;
     packet >> m_net_settings.use_fma;
     packet >> m_net_settings.hide_remote_gbas;
 
@@ -1532,6 +1539,17 @@ void NetPlayClient::DisplayPlayersPing()
 
   OSD::AddTypedMessage(OSD::MessageType::NetPlayPing, fmt::format("Ping: {}", GetPlayersMaxPing()),
                        OSD::Duration::SHORT, OSD::Color::CYAN);
+
+  const std::optional<RollbackSession::Stats> stats = GetRollbackStats();
+  if (!stats)
+    return;
+
+  OSD::AddTypedMessage(
+      OSD::MessageType::NetPlayRollback,
+      fmt::format("Rollbacks: {} last frame, {} total, {} frames at most, {:.1f} ms resimulating",
+                  stats->rollbacks_last_frame, stats->rollbacks, stats->max_rollback_frames,
+                  stats->last_resimulation_time.count() / 1000.0),
+      OSD::Duration::SHORT, OSD::Color::CYAN);
 }
 
 u32 NetPlayClient::GetPlayersMaxPing() const
@@ -1761,7 +1779,41 @@ bool NetPlayClient::StartGame(const std::string& path)
 
   m_first_pad_status_received.fill(false);
 
-  if (m_dialog->IsRecording())
+  StopRollbackThread();
+  m_rollback.reset();
+  SetFastForward(false);
+  if (m_net_settings.rollback_frames > 0 && !m_host_input_authority)
+  {
+    // Only the inputs of GameCube controllers are predicted, and the emulated GBAs run on their
+    // own threads, outside of the snapshots. Every client makes the same decision here.
+    const auto game = m_dialog->FindGameFile(m_selected_game);
+    if (!game || game->GetPlatform() != DiscIO::Platform::GameCubeDisc)
+    {
+      WARN_LOG_FMT(NETPLAY, "Rollback is only supported for GameCube games, falling back to "
+                            "delay-based netplay");
+    }
+    else if (std::any_of(m_gba_config.begin(), m_gba_config.end(),
+                         [](const GBAConfig& config) { return config.enabled; }))
+    {
+      WARN_LOG_FMT(NETPLAY, "Rollback is not supported with GBA controllers, falling back to "
+                            "delay-based netplay");
+    }
+    else
+    {
+      std::array<bool, 4> remote_pads;
+      for (size_t i = 0; i < remote_pads.size(); ++i)
+        remote_pads[i] = m_pad_map[i] > 0 && !IsLocalPlayer(m_pad_map[i]);
+
+      m_rollback = std::make_unique<RollbackSession>(m_net_settings.rollback_frames, remote_pads);
+      StartRollbackThread();
+    }
+  }
+
+  if (m_dialog->IsRecording() && m_rollback)
+  {
+    WARN_LOG_FMT(NETPLAY, "Input recording is not supported in the rollback network mode");
+  }
+  else if (m_dialog->IsRecording())
   {
     auto& movie = Core::System::GetInstance().GetMovie();
     if (movie.IsReadOnly())
@@ -2040,6 +2092,9 @@ bool NetPlayClient::GetNetPads(const int pad_nb, const bool batching, GCPadStatu
     m_wait_on_input_event.Wait();
   }
 
+  if (m_rollback)
+    return GetRollbackNetPads(pad_nb, batching, pad_status);
+
   if (IsFirstInGamePad(pad_nb) && batching)
   {
     sf::Packet packet;
@@ -2091,13 +2146,13 @@ bool NetPlayClient::GetNetPads(const int pad_nb, const bool batching, GCPadStatu
       if (time_diff.count() >= 1.0 || !buffer_over_target)
       {
         // run fast if the buffer is overfilled, otherwise run normal speed
-        Config::SetCurrent(Config::MAIN_EMULATION_SPEED, buffer_over_target ? 0.0f : 1.0f);
+        SetFastForward(buffer_over_target);
       }
     }
     else
     {
       // Set normal speed when we're the host, otherwise it can get stuck at unlimited
-      Config::SetCurrent(Config::MAIN_EMULATION_SPEED, 1.0f);
+      SetFastForward(false);
     }
   }
 
@@ -2129,6 +2184,150 @@ bool NetPlayClient::GetNetPads(const int pad_nb, const bool batching, GCPadStatu
   return true;
 }
 
+void NetPlayClient::SetFastForward(bool fast_forward)
+{
+  if (fast_forward == m_fast_forward)
+    return;
+
+  // Go back to the speed the user picked afterwards, rather than forcing the normal speed.
+  m_fast_forward = fast_forward;
+  if (fast_forward)
+  {
+    m_speed_before_fast_forward = Config::Get(Config::MAIN_EMULATION_SPEED);
+    Config::SetCurrent(Config::MAIN_EMULATION_SPEED, 0.0f);
+  }
+  else
+  {
+    Config::SetCurrent(Config::MAIN_EMULATION_SPEED, m_speed_before_fast_forward);
+  }
+}
+
+// called from ---CPU--- thread
+bool NetPlayClient::GetRollbackNetPads(const int pad_nb, const bool batching,
+                                       GCPadStatus* pad_status)
+{
+  // Every batched poll is a new frame of the rollback session. The inputs of remote players which
+  // weren't received yet are predicted, instead of waiting for them. Polls from MMIO return the
+  // inputs of the current frame.
+  if (IsFirstInGamePad(pad_nb) && batching)
+  {
+    ReceiveRollbackInputs();
+    while (m_rollback->MustWaitForInput())
+    {
+      if (!m_is_running.IsSet())
+      {
+        return false;
+      }
+
+      m_gc_pad_event.Wait();
+      ReceiveRollbackInputs();
+    }
+
+    m_rollback->BeginFrame();
+
+    // The local inputs of resimulated frames were already sent.
+    if (m_rollback->IsNewFrame())
+    {
+      sf::Packet packet;
+      packet << MessageID::PadData;
+
+      const int num_local_pads = NumLocalPads();
+      for (int local_pad = 0; local_pad < num_local_pads; local_pad++)
+      {
+        const int ingame_pad = LocalPadToInGamePad(local_pad);
+        const GCPadStatus status = GetLocalPadStatus(local_pad);
+        m_rollback->AddInput(ingame_pad, status);
+        AddPadStateToPacket(ingame_pad, status, packet);
+      }
+
+      if (num_local_pads > 0)
+        SendAsync(std::move(packet));
+    }
+
+    // Catch up with the other players as fast as possible after a rollback.
+    SetFastForward(m_rollback->IsResimulating());
+
+    if (m_rollback->HasMisprediction() || m_rollback->ShouldTakeSnapshot())
+      m_rollback_event.Set();
+  }
+
+  *pad_status = m_rollback->GetInput(pad_nb);
+  return true;
+}
+
+// called from ---CPU--- thread
+void NetPlayClient::ReceiveRollbackInputs()
+{
+  for (size_t pad = 0; pad < m_pad_buffer.size(); ++pad)
+  {
+    GCPadStatus status;
+    while (m_pad_buffer[pad].Pop(status))
+      m_rollback->AddInput(static_cast<int>(pad), status);
+  }
+}
+
+void NetPlayClient::StartRollbackThread()
+{
+  m_rollback_thread_running.Set();
+  m_rollback_thread = std::thread(&NetPlayClient::RollbackThreadFunc, this);
+}
+
+void NetPlayClient::StopRollbackThread()
+{
+  if (!m_rollback_thread.joinable())
+    return;
+
+  m_rollback_thread_running.Clear();
+  m_rollback_event.Set();
+  m_rollback_thread.join();
+}
+
+void NetPlayClient::RollbackThreadFunc()
+{
+  Common::SetCurrentThreadName("NetPlay Rollback");
+
+  // Snapshots can't be taken or restored in the middle of the poll, since CoreTiming is running
+  // an event. Instead, the CPU thread is asked to do it once it reaches a safe point.
+  while (true)
+  {
+    m_rollback_event.Wait();
+    if (!m_rollback_thread_running.IsSet())
+      return;
+
+    if (m_is_running.IsSet())
+      Core::RunOnCPUThread([this] { UpdateRollbackState(); }, true);
+  }
+}
+
+// called from ---CPU--- thread
+void NetPlayClient::UpdateRollbackState()
+{
+  // RunOnCPUThread runs the function right away if emulation has already stopped.
+  if (!Core::IsCPUThread() || !m_rollback)
+    return;
+
+  if (RollbackSession::SavedState* state = m_rollback->BeginRollback())
+    State::LoadFromBufferForNetPlayRollback(state->state, state->memory);
+
+  if (m_rollback->ShouldTakeSnapshot())
+  {
+    RollbackSession::SavedState state = m_rollback->TakeSnapshotBuffer();
+    State::SaveToBufferForNetPlayRollback(state.state, state.memory);
+    m_rollback->AddSnapshot(std::move(state));
+  }
+}
+
+// called from ---NETPLAY--- thread
+std::optional<RollbackSession::Stats> NetPlayClient::GetRollbackStats()
+{
+  // StartGame may replace the session on the GUI thread.
+  std::lock_guard lkg(m_crit.game);
+  if (!m_is_running.IsSet() || !m_rollback)
+    return std::nullopt;
+
+  return m_rollback->GetStats();
+}
+
 u64 NetPlayClient::GetInitialRTCValue() const
 {
   return m_initial_rtc;
@@ -2173,25 +2372,22 @@ bool NetPlayClient::WiimoteUpdate(const std::span<WiimoteDataBatchEntry>& entrie
   return true;
 }
 
+GCPadStatus NetPlayClient::GetLocalPadStatus(const int local_pad) const
+{
+  if (m_gba_config[LocalPadToInGamePad(local_pad)].enabled)
+    return Pad::GetGBAStatus(local_pad);
+
+  if (Config::Get(Config::GetInfoForSIDevice(local_pad)) == SerialInterface::SIDEVICE_WIIU_ADAPTER)
+    return GCAdapter::Input(local_pad);
+
+  return Pad::GetStatus(local_pad);
+}
+
 bool NetPlayClient::PollLocalPad(const int local_pad, sf::Packet& packet)
 {
   const int ingame_pad = LocalPadToInGamePad(local_pad);
   bool data_added = false;
-  GCPadStatus pad_status;
-
-  if (m_gba_config[ingame_pad].enabled)
-  {
-    pad_status = Pad::GetGBAStatus(local_pad);
-  }
-  else if (Config::Get(Config::GetInfoForSIDevice(local_pad)) ==
-           SerialInterface::SIDEVICE_WIIU_ADAPTER)
-  {
-    pad_status = GCAdapter::Input(local_pad);
-  }
-  else
-  {
-    pad_status = Pad::GetStatus(local_pad);
-  }
+  const GCPadStatus pad_status = GetLocalPadStatus(local_pad);
 
   if (m_host_input_authority)
   {
@@ -2324,6 +2520,7 @@ void NetPlayClient::InvokeStop()
   m_wii_pad_event.Set();
   m_first_pad_status_received_event.Set();
   m_wait_on_input_event.Set();
+  m_rollback_event.Set();
 }
 
 // called from ---GUI--- thread and ---NETPLAY--- thread (client side)
@@ -2331,7 +2528,18 @@ bool NetPlayClient::StopGame()
 {
   InvokeStop();
 
+  if (m_rollback)
+  {
+    const RollbackSession::Stats stats = m_rollback->GetStats();
+    INFO_LOG_FMT(NETPLAY,
+                 "Rollback: {} frames, {} rollbacks (at most {} frames), {} frames resimulated in "
+                 "{} ms",
+                 stats.frames, stats.rollbacks, stats.max_rollback_frames,
+                 stats.resimulated_frames, stats.total_resimulation_time.count() / 1000);
+  }
+
   NetPlay_Disable();
+  SetFastForward(false);
 
   // stop game
   m_dialog->StopGame();
@@ -9,6 +9,7 @@
 #include <map>
 #include <memory>
 #include <mutex>
+#include <optional>
 #include <span>
 #include <string>
 #include <thread>
@@ -18,9 +19,11 @@
 
 #include "Common/CommonTypes.h"
 #include "Common/Event.h"
+#include "Common/Flag.h"
 #include "Common/SPSCQueue.h"
 #include "Common/TraversalClient.h"
 #include "Core/NetPlayProto.h"
+#include "Core/NetPlayRollback.h"
 #include "Core/SyncIdentifier.h"
 #include "InputCommon/GCPadStatus.h"
 
@@ -146,6 +149,9 @@ public:
 
   u64 GetInitialRTCValue() const;
 
+  // Only available while a game is running in the rollback network mode.
+  std::optional<RollbackSession::Stats> GetRollbackStats();
+
   void OnTraversalStateChanged() override;
   void OnConnectReady(ENetAddress addr) override;
   void OnConnectFailed(Common::TraversalConnectFailedReason reason) override;
@@ -206,6 +212,11 @@ protected:
 
   std::chrono::time_point<std::chrono::steady_clock> m_buffer_under_target_last;
 
+  // Whether the emulation speed is unlimited to catch up with the other players, and the speed to
+  // go back to afterwards.
+  bool m_fast_forward = false;
+  float m_speed_before_fast_forward = 1.0f;
+
   NetPlayUI* m_dialog = nullptr;
 
   ENetHost* m_client = nullptr;
@@ -256,8 +267,17 @@ private:
   void SyncSaveDataResponse(bool success);
   void SyncCodeResponse(bool success);
 
+  GCPadStatus GetLocalPadStatus(int local_pad) const;
   bool PollLocalPad(int local_pad, sf::Packet& packet);
   void SendPadHostPoll(PadIndex pad_num);
+  void SetFastForward(bool fast_forward);
+
+  bool GetRollbackNetPads(int pad_nb, bool batching, GCPadStatus* pad_status);
+  void ReceiveRollbackInputs();
+  void StartRollbackThread();
+  void StopRollbackThread();
+  void RollbackThreadFunc();
+  void UpdateRollbackState();
 
   bool AddLocalWiimoteToBuffer(int local_wiimote, const WiimoteEmu::SerializedWiimoteState& state,
                                sf::Packet& packet);
@@ -347,6 +367,14 @@ private:
   u64 m_initial_rtc = 0;
   u32 m_timebase_frame = 0;
 
+  // Rollback network mode. The session is only accessed from the CPU thread (except for its
+  // stats); the thread asks the CPU thread to take and restore snapshots at a safe point.
+  // StartGame replaces the session while holding m_crit.game.
+  std::unique_ptr<RollbackSession> m_rollback;
+  std::thread m_rollback_thread;
+  Common::Event m_rollback_event;
+  Common::Flag m_rollback_thread_running;
+
   std::unique_ptr<IOS::HLE::FS::FileSystem> m_wii_sync_fs;
   std::vector<u64> m_wii_sync_titles;
   std::string m_wii_sync_redirect_folder;
@@ -103,6 +103,8 @@ struct NetSettings
   bool sync_codes = false;
   std::string save_data_region;
   bool golf_mode = false;
+  // Maximum number of frames to roll back by in the rollback network mode, 0 if it isn't used.
+  u32 rollback_frames = 0;
   bool use_fma = false;
   bool hide_remote_gbas = false;
 
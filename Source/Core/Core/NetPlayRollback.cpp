@@ -0,0 +1,236 @@
+// Copyright 2024 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "Core/NetPlayRollback.h"
+
+#include <algorithm>
+#include <limits>
+#include <utility>
+
+#include "Common/Assert.h"
+#include "Common/Logging/Log.h"
+
+namespace NetPlay
+{
+// The buffers of dropped snapshots are kept around, up to this number, to avoid allocating the
+// memory for a whole emulated state every frame.
+static constexpr size_t MAX_FREE_SNAPSHOT_BUFFERS = 2;
+
+static bool IsSameInput(const GCPadStatus& a, const GCPadStatus& b)
+{
+  return a.button == b.button && a.stickX == b.stickX && a.stickY == b.stickY &&
+         a.substickX == b.substickX && a.substickY == b.substickY &&
+         a.triggerLeft == b.triggerLeft && a.triggerRight == b.triggerRight &&
+         a.analogA == b.analogA && a.analogB == b.analogB && a.isConnected == b.isConnected;
+}
+
+RollbackSession::RollbackSession(u32 max_frames, const std::array<bool, 4>& remote_pads)
+    : m_max_frames(std::max<u32>(max_frames, 1)), m_remote_pads(remote_pads)
+{
+  // Until the first input of a player is received, predict that nothing is pressed.
+  GCPadStatus neutral;
+  neutral.stickX = GCPadStatus::MAIN_STICK_CENTER_X;
+  neutral.stickY = GCPadStatus::MAIN_STICK_CENTER_Y;
+  neutral.substickX = GCPadStatus::C_STICK_CENTER_X;
+  neutral.substickY = GCPadStatus::C_STICK_CENTER_Y;
+  m_last_confirmed_inputs.fill(neutral);
+
+  m_stats.rollback_frames_histogram.resize(m_max_frames + 2);
+}
+
+bool RollbackSession::MustWaitForInput() const
+{
+  const Frame next_frame = m_current_frame + 1;
+  for (size_t pad = 0; pad < m_remote_pads.size(); ++pad)
+  {
+    if (!m_remote_pads[pad])
+      continue;
+
+    // The inputs of a remote player can be ahead of the local frames.
+    if (m_snapshots.empty() ? m_confirmed_frames[pad] < next_frame :
+                              m_confirmed_frames[pad] < next_frame &&
+                                  next_frame - m_confirmed_frames[pad] > m_max_frames)
+    {
+      return true;
+    }
+  }
+  return false;
+}
+
+void RollbackSession::BeginFrame()
+{
+  ++m_current_frame;
+
+  std::lock_guard lk(m_stats_lock);
+  if (m_current_frame <= m_newest_frame)
+  {
+    ++m_stats.resimulated_frames;
+    return;
+  }
+
+  m_newest_frame = m_current_frame;
+  if (m_resimulating)
+  {
+    m_resimulating = false;
+    const auto time = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - m_resimulation_start);
+    m_stats.last_resimulation_time = time;
+    m_stats.total_resimulation_time += time;
+  }
+
+  ++m_stats.frames;
+  m_stats.rollbacks_last_frame = m_rollbacks_this_frame;
+  m_rollbacks_this_frame = 0;
+}
+
+RollbackSession::FrameInput& RollbackSession::GetFrameInput(int pad, Frame frame)
+{
+  ASSERT(frame >= m_first_input_frame);
+  auto& inputs = m_inputs[pad];
+  const size_t index = static_cast<size_t>(frame - m_first_input_frame);
+  if (index >= inputs.size())
+    inputs.resize(index + 1);
+  return inputs[index];
+}
+
+void RollbackSession::AddInput(int pad, const GCPadStatus& status)
+{
+  const Frame frame = ++m_confirmed_frames[pad];
+  m_last_confirmed_inputs[pad] = status;
+  if (frame < m_first_input_frame)
+    return;
+
+  // Frames after the current one were either never simulated, or will be simulated again anyway
+  // because of an earlier rollback.
+  FrameInput& input = GetFrameInput(pad, frame);
+  if (input.used && frame <= m_current_frame && !IsSameInput(input.status, status))
+    m_misprediction = std::min(m_misprediction.value_or(frame), frame);
+
+  input.status = status;
+  input.confirmed = true;
+}
+
+GCPadStatus RollbackSession::GetInput(int pad)
+{
+  if (m_current_frame < m_first_input_frame)
+    return m_last_confirmed_inputs[pad];
+
+  FrameInput& input = GetFrameInput(pad, m_current_frame);
+  if (!input.confirmed)
+    input.status = m_last_confirmed_inputs[pad];
+  input.used = true;
+  return input.status;
+}
+
+bool RollbackSession::ShouldTakeSnapshot() const
+{
+  return m_current_frame > 0 && (m_snapshots.empty() || m_snapshots.back().frame < m_current_frame);
+}
+
+RollbackSession::SavedState RollbackSession::TakeSnapshotBuffer()
+{
+  if (m_free_buffers.empty())
+    return {};
+
+  SavedState buffer = std::move(m_free_buffers.back());
+  m_free_buffers.pop_back();
+  return buffer;
+}
+
+void RollbackSession::AddSnapshot(SavedState state)
+{
+  m_snapshots.push_back({m_current_frame, std::move(state)});
+  DropOldSnapshots();
+}
+
+RollbackSession::Frame RollbackSession::GetOldestConfirmedFrame() const
+{
+  Frame oldest = std::numeric_limits<Frame>::max();
+  for (size_t pad = 0; pad < m_remote_pads.size(); ++pad)
+  {
+    if (m_remote_pads[pad])
+      oldest = std::min(oldest, m_confirmed_frames[pad]);
+  }
+  return std::min(oldest, m_current_frame);
+}
+
+void RollbackSession::DropOldSnapshots()
+{
+  // Mispredictions can only happen after the oldest confirmed frame, so only the newest snapshot
+  // taken up to that frame and the ones after it can still be needed.
+  const Frame oldest_confirmed_frame = GetOldestConfirmedFrame();
+  while (m_snapshots.size() > 1 && (m_snapshots[1].frame <= oldest_confirmed_frame ||
+                                    m_snapshots.size() > m_max_frames + 2))
+  {
+    if (m_free_buffers.size() < MAX_FREE_SNAPSHOT_BUFFERS)
+      m_free_buffers.push_back(std::move(m_snapshots.front().state));
+    m_snapshots.pop_front();
+  }
+
+  // The frame of the oldest snapshot still has to be replayed after restoring it.
+  const Frame first_needed_frame = std::max<Frame>(m_snapshots.front().frame, 1);
+  for (; m_first_input_frame < first_needed_frame; ++m_first_input_frame)
+  {
+    for (auto& inputs : m_inputs)
+    {
+      if (!inputs.empty())
+        inputs.pop_front();
+    }
+  }
+}
+
+RollbackSession::SavedState* RollbackSession::BeginRollback()
+{
+  if (!m_misprediction)
+    return nullptr;
+
+  const Frame mispredicted_frame = *m_misprediction;
+  m_misprediction.reset();
+
+  const auto snapshot =
+      std::find_if(m_snapshots.rbegin(), m_snapshots.rend(),
+                   [mispredicted_frame](const Snapshot& s) { return s.frame < mispredicted_frame; });
+  if (snapshot == m_snapshots.rend())
+  {
+    ERROR_LOG_FMT(NETPLAY, "Rollback: no snapshot before mispredicted frame {}",
+                  mispredicted_frame);
+    return nullptr;
+  }
+
+  // The snapshots taken after the restored one were simulated with the wrong inputs.
+  const auto restored = snapshot.base() - 1;
+  for (auto it = restored + 1; it != m_snapshots.end(); ++it)
+  {
+    if (m_free_buffers.size() < MAX_FREE_SNAPSHOT_BUFFERS)
+      m_free_buffers.push_back(std::move(it->state));
+  }
+  m_snapshots.erase(restored + 1, m_snapshots.end());
+
+  const Frame rollback_frames = m_current_frame - restored->frame;
+  DEBUG_LOG_FMT(NETPLAY, "Rollback: frame {} mispredicted, rolling back {} frames to frame {}",
+                mispredicted_frame, rollback_frames, restored->frame);
+
+  m_current_frame = restored->frame;
+  if (!m_resimulating)
+  {
+    m_resimulating = true;
+    m_resimulation_start = std::chrono::steady_clock::now();
+  }
+  ++m_rollbacks_this_frame;
+
+  std::lock_guard lk(m_stats_lock);
+  ++m_stats.rollbacks;
+  m_stats.max_rollback_frames = std::max(m_stats.max_rollback_frames, rollback_frames);
+  if (rollback_frames >= m_stats.rollback_frames_histogram.size())
+    m_stats.rollback_frames_histogram.resize(rollback_frames + 1);
+  ++m_stats.rollback_frames_histogram[rollback_frames];
+
+  return &restored->state;
+}
+
+RollbackSession::Stats RollbackSession::GetStats() const
+{
+  std::lock_guard lk(m_stats_lock);
+  return m_stats;
+}
+}  // namespace NetPlay
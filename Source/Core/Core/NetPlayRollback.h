@@ -0,0 +1,137 @@
+// Copyright 2024 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <deque>
+#include <mutex>
+#include <optional>
+#include <vector>
+
+#include "Common/CommonTypes.h"
+#include "Core/HW/Memmap.h"
+#include "InputCommon/GCPadStatus.h"
+
+namespace NetPlay
+{
+// Input and snapshot bookkeeping for the rollback network mode.
+//
+// Instead of waiting for the inputs of remote players, the emulation runs ahead with predicted
+// inputs (the last input received from each player). When the real input for a frame arrives and
+// it doesn't match the prediction, the emulated state is restored from the newest snapshot taken
+// before that frame, and the following frames are simulated again with the corrected inputs, as
+// fast as possible.
+//
+// A frame is one batched poll of the GameCube controllers. Frame 0 is the time before the first
+// poll. Snapshots are taken and restored by the owner; they can be taken at any point of a frame,
+// since everything that happens after them only depends on the inputs of the following frames.
+//
+// All methods must be called from the CPU thread, except GetStats.
+class RollbackSession final
+{
+public:
+  using Frame = u64;
+
+  struct Stats
+  {
+    // Frames simulated for the first time.
+    u64 frames = 0;
+    u64 rollbacks = 0;
+    u64 resimulated_frames = 0;
+    u64 max_rollback_frames = 0;
+    // Number of rollbacks by how many frames they went back.
+    std::vector<u64> rollback_frames_histogram;
+    // Number of rollbacks during the last frame that was simulated for the first time.
+    u32 rollbacks_last_frame = 0;
+    std::chrono::microseconds last_resimulation_time{};
+    std::chrono::microseconds total_resimulation_time{};
+  };
+
+  // A snapshot as saved by State::SaveToBufferForNetPlayRollback.
+  struct SavedState
+  {
+    std::vector<u8> state;
+    Memory::StateMemoryBuffer memory;
+  };
+
+  // remote_pads are the in-game pads controlled by other players, whose inputs are predicted. The
+  // inputs of local pads must be added for every new frame, before they are read.
+  RollbackSession(u32 max_frames, const std::array<bool, 4>& remote_pads);
+
+  u32 GetMaxFrames() const { return m_max_frames; }
+  Frame GetCurrentFrame() const { return m_current_frame; }
+  // Whether the current frame is simulated for the first time, as opposed to simulated again after
+  // a rollback. Local inputs must only be polled and sent for new frames.
+  bool IsNewFrame() const { return !m_resimulating; }
+  bool IsResimulating() const { return m_resimulating; }
+
+  // Whether the next frame can't start yet, because it would be too far ahead of the inputs
+  // received from some player to be able to roll back to it. Before the first snapshot was taken,
+  // this keeps the session in lockstep.
+  bool MustWaitForInput() const;
+  void BeginFrame();
+
+  // Records the real input of a pad for the first frame it hasn't been received for yet.
+  void AddInput(int pad, const GCPadStatus& status);
+  // Returns the input of a pad for the current frame, predicting it if it wasn't received yet.
+  GCPadStatus GetInput(int pad);
+
+  bool ShouldTakeSnapshot() const;
+  // Returns the buffers to save the next snapshot to, reusing those of an old snapshot.
+  SavedState TakeSnapshotBuffer();
+  // The snapshot must have been taken during the current frame.
+  void AddSnapshot(SavedState state);
+
+  bool HasMisprediction() const { return m_misprediction.has_value(); }
+  // If an input was mispredicted, rewinds the session to the newest snapshot taken before it and
+  // returns that snapshot, which must be loaded right away. Returns nullptr otherwise.
+  SavedState* BeginRollback();
+
+  Stats GetStats() const;
+
+private:
+  struct FrameInput
+  {
+    GCPadStatus status;
+    bool confirmed = false;
+    // Whether the emulated game read this input, as opposed to it only being received.
+    bool used = false;
+  };
+
+  struct Snapshot
+  {
+    Frame frame;
+    SavedState state;
+  };
+
+  FrameInput& GetFrameInput(int pad, Frame frame);
+  Frame GetOldestConfirmedFrame() const;
+  void DropOldSnapshots();
+
+  const u32 m_max_frames;
+  const std::array<bool, 4> m_remote_pads;
+
+  Frame m_current_frame = 0;
+  Frame m_newest_frame = 0;
+  bool m_resimulating = false;
+  std::chrono::steady_clock::time_point m_resimulation_start;
+  u32 m_rollbacks_this_frame = 0;
+
+  // Inputs of the frames starting at m_first_input_frame.
+  std::array<std::deque<FrameInput>, 4> m_inputs;
+  Frame m_first_input_frame = 1;
+  std::array<Frame, 4> m_confirmed_frames{};
+  std::array<GCPadStatus, 4> m_last_confirmed_inputs;
+
+  std::optional<Frame> m_misprediction;
+
+  std::deque<Snapshot> m_snapshots;
+  std::vector<SavedState> m_free_buffers;
+
+  mutable std::mutex m_stats_lock;
+  Stats m_stats;
+};
+}  // namespace NetPlay
@@ -1450,6 +1450,9 @@ bool NetPlayServer::SetupNetSettings()
   settings.strict_settings_sync = Config::Get(Config::NETPLAY_STRICT_SETTINGS_SYNC);
   settings.sync_codes = Config::Get(Config::NETPLAY_SYNC_CODES);
   settings.golf_mode = Config::Get(Config::NETPLAY_NETWORK_MODE) == "golf";
+  settings.rollback_frames = Config::Get(Config::NETPLAY_NETWORK_MODE) == "rollback" ?
+                                 Config::Get(Config::NETPLAY_ROLLBACK_FRAMES) :
+                                 0;
   settings.use_fma = DoAllPlayersHaveHardwareFMA();
   settings.hide_remote_gbas = Config::Get(Config::NETPLAY_HIDE_REMOTE_GBAS);
 
@@ -1657,6 +1660,7 @@ bool NetPlayServer::StartGame()
   spac << m_settings.sync_codes;
 
   spac << m_settings.golf_mode;
+  spac << m_settings.rollback_frames;
   spac << m_settings.use_fma;
   spac << m_settings.hide_remote_gbas;
 
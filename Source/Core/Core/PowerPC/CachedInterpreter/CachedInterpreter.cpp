@@ -288,6 +288,8 @@ bool CachedInterpreter::HandleFunctionHooking(u32 address)
 
 void CachedInterpreter::Jit(u32 address)
 {
+  ScopedCompileTimer timer(m_compile_stats);
+
   if (m_code.size() >= CODE_SIZE / sizeof(Instruction) - 0x1000 ||
       SConfig::GetInstance().bJITNoBlockCache)
   {
@@ -59,6 +59,16 @@ using namespace PowerPC;
 // * Does not recompile all instructions - sometimes falls back to inserting a CALL to the
 // corresponding Interpreter function.
 
+// Superblocks
+//
+// With superblocks enabled, blocks whose branch following was cut short by the follow threshold
+// count their entries. Once a block has been entered SUPERBLOCK_PROMOTION_THRESHOLD times, it is
+// recompiled with a much higher follow threshold, so that the whole hot path (typically a loop body
+// including its calls to small leaf functions) becomes a single block. The register caches are then
+// kept across what used to be the exits of the separate, linked blocks, instead of flushing and
+// reloading every guest register at each of them.
+constexpr u32 SUPERBLOCK_PROMOTION_THRESHOLD = 1000;
+
 // Open questions
 // * Should there be any statically allocated registers? r3, r4, r5, r8, r0 come to mind.. maybe sp
 // * Does it make sense to finish off the remaining non-jitted instructions? Seems we are hitting
@@ -741,6 +751,7 @@ void Jit64::Trace()
 
 void Jit64::Jit(u32 em_address)
 {
+  ScopedCompileTimer timer(m_compile_stats);
   Jit(em_address, true);
 }
 
@@ -786,11 +797,21 @@ void Jit64::Jit(u32 em_address, bool clear_cache_and_retry_on_failure)
         analyzer.ClearOption(PPCAnalyst::PPCAnalyzer::OPTION_CROR_MERGE);
         analyzer.ClearOption(PPCAnalyst::PPCAnalyzer::OPTION_CARRY_MERGE);
         analyzer.ClearOption(PPCAnalyst::PPCAnalyzer::OPTION_BRANCH_FOLLOW);
+        analyzer.ClearOption(PPCAnalyst::PPCAnalyzer::OPTION_DATAFLOW);
       }
       Trace();
     }
   }
 
+  js.compilingQuickTier = ShouldCompileQuickTier(em_address);
+  analyzer.SetQuickAnalysisEnabled(js.compilingQuickTier);
+
+  const bool superblock = m_enable_superblocks && js.superblockAddresses.find(em_address) !=
+                                                     js.superblockAddresses.end();
+  analyzer.SetBranchFollowingThreshold(superblock ?
+                                           PPCAnalyst::SUPERBLOCK_BRANCH_FOLLOWING_THRESHOLD :
+                                           PPCAnalyst::BRANCH_FOLLOWING_THRESHOLD);
+
   // Analyze the block, collect all instructions it is made of (including inlining,
   // if that is enabled), reorder instructions for optimal performance, and join joinable
   // instructions.
@@ -913,6 +934,19 @@ bool Jit64::DoJit(u32 em_address, JitBlock* b, u32 nextPC)
   MOV(32, PPCSTATE(pc), Imm32(js.blockStart));
 #endif
 
+  if (js.compilingQuickTier)
+  {
+    WriteHotnessCountdown(b, TIER_UP_THRESHOLD, JitInterface::ExceptionType::TierUp);
+  }
+  else if (m_enable_superblocks && code_block.m_branch_following_truncated &&
+           js.superblockAddresses.find(js.blockStart) == js.superblockAddresses.end())
+  {
+    // Count down towards promoting this block to a superblock, as doing so would make a
+    // difference. See the comment at the top of this file.
+    WriteHotnessCountdown(b, SUPERBLOCK_PROMOTION_THRESHOLD,
+                          JitInterface::ExceptionType::Superblock);
+  }
+
   // Start up the register allocators
   // They use the information in gpa/fpa to preload commonly used registers.
   gpr.Start();
@@ -955,8 +989,8 @@ bool Jit64::DoJit(u32 em_address, JitBlock* b, u32 nextPC)
     }
   }
 
-  if (js.noSpeculativeConstantsAddresses.find(js.blockStart) ==
-      js.noSpeculativeConstantsAddresses.end())
+  if (!js.compilingQuickTier && js.noSpeculativeConstantsAddresses.find(js.blockStart) ==
+                                     js.noSpeculativeConstantsAddresses.end())
   {
     IntializeSpeculativeConstants();
   }
@@ -1043,11 +1077,10 @@ bool Jit64::DoJit(u32 em_address, JitBlock* b, u32 nextPC)
 
     if (op.skip)
     {
-      if (IsDebuggingEnabled())
+      // Besides the BLR following optimization, op.skip is set by the dataflow optimizations for
+      // instructions that don't change anything. Only the former needs to be seen by branch watch.
+      if (IsDebuggingEnabled() && op.opinfo->type == OpType::Branch)
       {
-        // The only thing that currently sets op.skip is the BLR following optimization.
-        // If any non-branch instruction starts setting that too, this will need to be changed.
-        ASSERT(op.inst.hex == 0x4e800020);
         WriteBranchWatch<true>(op.address, op.branchTo, op.inst, RSCRATCH, RSCRATCH2,
                                CallerSavedRegistersInUse());
       }
@@ -1246,6 +1279,25 @@ void Jit64::EnableOptimization()
   analyzer.SetOption(PPCAnalyst::PPCAnalyzer::OPTION_CROR_MERGE);
   analyzer.SetOption(PPCAnalyst::PPCAnalyzer::OPTION_CARRY_MERGE);
   analyzer.SetOption(PPCAnalyst::PPCAnalyzer::OPTION_BRANCH_FOLLOW);
+  analyzer.SetOption(PPCAnalyst::PPCAnalyzer::OPTION_DATAFLOW);
+}
+
+void Jit64::WriteHotnessCountdown(JitBlock* b, u32 count, JitInterface::ExceptionType type)
+{
+  b->hotness_countdown = count;
+  MOV(64, R(RSCRATCH), ImmPtr(&b->hotness_countdown));
+  SUB(32, MatR(RSCRATCH), Imm8(1));
+  FixupBranch hot = J_CC(CC_Z, Jump::Near);
+
+  SwitchToFarCode();
+  SetJumpTarget(hot);
+  MOV(32, PPCSTATE(pc), Imm32(js.blockStart));
+  ABI_PushRegistersAndAdjustStack({}, 0);
+  ABI_CallFunctionPC(JitInterface::CompileExceptionCheckFromJIT, &m_system.GetJitInterface(),
+                     static_cast<u32>(type));
+  ABI_PopRegistersAndAdjustStack({}, 0);
+  JMP(asm_routines.dispatcher_no_check, Jump::Near);
+  SwitchToNearCode();
 }
 
 void Jit64::IntializeSpeculativeConstants()
@@ -33,6 +33,7 @@
 #include "Core/PowerPC/Jit64Common/TrampolineCache.h"
 #include "Core/PowerPC/JitCommon/JitBase.h"
 #include "Core/PowerPC/JitCommon/JitCache.h"
+#include "Core/PowerPC/JitInterface.h"
 
 namespace PPCAnalyst
 {
@@ -73,6 +74,9 @@ public:
   BitSet8 ComputeStaticGQRs(const PPCAnalyst::CodeBlock&) const;
 
   void IntializeSpeculativeConstants();
+  // Counts down on every entry into the block, and raises the given compile exception for the
+  // block once the count reaches zero.
+  void WriteHotnessCountdown(JitBlock* b, u32 count, JitInterface::ExceptionType type);
 
   JitBlockCache* GetBlockCache() override { return &blocks; }
   void Trace();
@@ -3,8 +3,10 @@
 
 #include "Core/PowerPC/Jit64Common/EmuCodeBlock.h"
 
+#include <array>
 #include <functional>
 #include <limits>
+#include <optional>
 
 #include "Common/Assert.h"
 #include "Common/CPUDetect.h"
@@ -131,6 +133,98 @@ FixupBranch EmuCodeBlock::CheckIfSafeAddress(const OpArg& reg_value, X64Reg reg_
   return J_CC(CC_Z, m_far_code.Enabled() ? Jump::Near : Jump::Short);
 }
 
+FixupBranch EmuCodeBlock::SoftwareTLBAccess(bool write, const OpArg& reg_value, X64Reg reg_addr,
+                                            int accessSize, BitSet32 registers_in_use,
+                                            bool signExtend, bool swap)
+{
+  const X64Reg value = reg_value.IsSimpleReg() ? reg_value.GetSimpleReg() : INVALID_REG;
+
+  // Get ourselves two temporaries, preferring ones we don't have to save. A load can use its
+  // destination, since it's overwritten anyway.
+  std::array<X64Reg, 2> tmp{INVALID_REG, INVALID_REG};
+  size_t num_tmp = 0;
+  for (bool in_use : {false, true})
+  {
+    for (X64Reg reg : {write ? INVALID_REG : value, RSCRATCH, RSCRATCH2, RSCRATCH_EXTRA})
+    {
+      if (num_tmp == tmp.size() || reg == INVALID_REG || reg == reg_addr || (write && reg == value) ||
+          registers_in_use[reg] != in_use || reg == tmp[0])
+      {
+        continue;
+      }
+      tmp[num_tmp++] = reg;
+    }
+  }
+  ASSERT(num_tmp == tmp.size());
+
+  const auto push = [&] {
+    for (X64Reg reg : tmp)
+    {
+      if (registers_in_use[reg])
+        PUSH(reg);
+    }
+  };
+  const auto pop = [&] {
+    for (auto it = tmp.rbegin(); it != tmp.rend(); ++it)
+    {
+      if (registers_in_use[*it])
+        POP(*it);
+    }
+  };
+
+  const X64Reg page = tmp[0];
+  const X64Reg index = tmp[1];
+  const int page_off =
+      write ? PPCSTATE_OFF(software_tlb_write.page) : PPCSTATE_OFF(software_tlb_read.page);
+  const int sr_off =
+      write ? PPCSTATE_OFF(software_tlb_write.sr) : PPCSTATE_OFF(software_tlb_read.sr);
+  const int host_page_off = write ? PPCSTATE_OFF(software_tlb_write.host_page) :
+                                    PPCSTATE_OFF(software_tlb_read.host_page);
+
+  push();
+  MOV(32, R(page), R(reg_addr));
+  SHR(32, R(page), Imm8(PowerPC::HW_PAGE_INDEX_SHIFT));
+  MOV(32, R(index), R(page));
+  AND(32, R(index), Imm32(PowerPC::SOFTWARE_TLB_SIZE - 1));
+  CMP(32, R(page), MComplex(RPPCSTATE, index, SCALE_4, page_off));
+  FixupBranch page_miss = J_CC(CC_NE);
+
+  // Entries are tagged with the segment register they were translated with.
+  SHR(32, R(page), Imm8(28 - PowerPC::HW_PAGE_INDEX_SHIFT));
+  MOV(32, R(page), MComplex(RPPCSTATE, page, SCALE_4, PPCSTATE_OFF(sr)));
+  CMP(32, R(page), MComplex(RPPCSTATE, index, SCALE_4, sr_off));
+  FixupBranch sr_miss = J_CC(CC_NE);
+
+  // Accesses which cross into the next page have to be translated separately.
+  const X64Reg host_page = index;
+  const X64Reg offset = page;
+  MOV(64, R(host_page), MComplex(RPPCSTATE, index, SCALE_8, host_page_off));
+  MOV(32, R(offset), R(reg_addr));
+  AND(32, R(offset), Imm32(PowerPC::HW_PAGE_MASK));
+  CMP(32, R(offset), Imm32(PowerPC::HW_PAGE_SIZE - accessSize / 8));
+  FixupBranch offset_miss = J_CC(CC_A);
+
+  const OpArg host_address = MRegSum(host_page, offset);
+  if (!write)
+    LoadAndSwap(accessSize, value, host_address, signExtend);
+  else if (reg_value.IsImm())
+    MOV(accessSize, host_address, swap ? SwapImmediate(accessSize, reg_value) : reg_value);
+  else if (swap)
+    SwapAndStore(accessSize, host_address, value);
+  else
+    MOV(accessSize, host_address, reg_value);
+  pop();
+  ADD(64, PPCSTATE(software_tlb_hits), Imm8(1));
+  FixupBranch hit = J(Jump::Near);
+
+  SetJumpTarget(page_miss);
+  SetJumpTarget(sr_miss);
+  SetJumpTarget(offset_miss);
+  pop();
+
+  return hit;
+}
+
 void EmuCodeBlock::UnsafeWriteRegToReg(OpArg reg_value, X64Reg reg_addr, int accessSize, s32 offset,
                                        bool swap, MovInfo* info)
 {
@@ -225,6 +319,19 @@ public:
   {
     CallLambda(8 * sizeof(T), lambda);
   }
+  void VisitDirectWithFallback(const T* const* addr_ptr, u32 mask,
+                               const std::function<T(Core::System&, u32)>* fallback) override
+  {
+    m_code->MOV(64, R(RSCRATCH), ImmPtr(addr_ptr));
+    m_code->MOV(64, R(RSCRATCH), MatR(RSCRATCH));
+    m_code->TEST(64, R(RSCRATCH), R(RSCRATCH));
+    FixupBranch slow = m_code->J_CC(CC_Z, Gen::XEmitter::Jump::Near);
+    LoadScratchMaskToReg(8 * sizeof(T), mask);
+    FixupBranch done = m_code->J(Gen::XEmitter::Jump::Near);
+    m_code->SetJumpTarget(slow);
+    CallLambda(8 * sizeof(T), fallback);
+    m_code->SetJumpTarget(done);
+  }
 
 private:
   // Generates code to load a constant to the destination register. In
@@ -253,6 +360,12 @@ private:
   void LoadAddrMaskToReg(int sbits, const void* ptr, u32 mask)
   {
     m_code->MOV(64, R(RSCRATCH), ImmPtr(ptr));
+    LoadScratchMaskToReg(sbits, mask);
+  }
+
+  // Loads the value RSCRATCH points to into the destination register.
+  void LoadScratchMaskToReg(int sbits, u32 mask)
+  {
     // If we do not need to mask, we can do the sign extend while loading
     // from memory. If masking is required, we have to first zero extend,
     // then mask, then sign extend if needed (1 instr vs. 2/3).
@@ -386,6 +499,14 @@ void EmuCodeBlock::SafeLoadToReg(X64Reg reg_value, const Gen::OpArg& opAddress,
     SetJumpTarget(slow);
   }
 
+  // Page table translations which lead to RAM can still avoid the call into the MMU.
+  std::optional<FixupBranch> software_tlb_hit;
+  if (dr_set && !m_jit.m_ppc_state.m_enable_dcache && m_jit.m_system.IsMMUMode())
+  {
+    software_tlb_hit = SoftwareTLBAccess(false, R(reg_value), reg_addr, accessSize, registersInUse,
+                                         signExtend, true);
+  }
+
   // PC is used by memory watchpoints (if enabled), profiling where to insert gather pipe
   // interrupt checks, and printing accurate PC locations in debug logs.
   //
@@ -435,6 +556,9 @@ void EmuCodeBlock::SafeLoadToReg(X64Reg reg_value, const Gen::OpArg& opAddress,
     }
     SetJumpTarget(exit);
   }
+
+  if (software_tlb_hit)
+    SetJumpTarget(*software_tlb_hit);
 }
 
 void EmuCodeBlock::SafeLoadToRegImmediate(X64Reg reg_value, u32 address, int accessSize,
@@ -560,6 +684,14 @@ void EmuCodeBlock::SafeWriteRegToReg(OpArg reg_value, X64Reg reg_addr, int acces
     SetJumpTarget(slow);
   }
 
+  // Page table translations which lead to RAM can still avoid the call into the MMU.
+  std::optional<FixupBranch> software_tlb_hit;
+  if (dr_set && !m_jit.m_ppc_state.m_enable_dcache && m_jit.m_system.IsMMUMode())
+  {
+    software_tlb_hit =
+        SoftwareTLBAccess(true, reg_value, reg_addr, accessSize, registersInUse, false, swap);
+  }
+
   // PC is used by memory watchpoints (if enabled), profiling where to insert gather pipe
   // interrupt checks, and printing accurate PC locations in debug logs.
   //
@@ -616,6 +748,9 @@ void EmuCodeBlock::SafeWriteRegToReg(OpArg reg_value, X64Reg reg_addr, int acces
     }
     SetJumpTarget(exit);
   }
+
+  if (software_tlb_hit)
+    SetJumpTarget(*software_tlb_hit);
 }
 
 void EmuCodeBlock::SafeWriteRegToReg(Gen::X64Reg reg_value, Gen::X64Reg reg_addr, int accessSize,
@@ -55,6 +55,12 @@ public:
 
   Gen::FixupBranch CheckIfSafeAddress(const Gen::OpArg& reg_value, Gen::X64Reg reg_addr,
                                       BitSet32 registers_in_use);
+  // Looks reg_addr up in the software TLB (see PowerPC::SoftwareTLB) and, on a hit, performs the
+  // access directly. The returned branch is taken on a hit and should skip the slow path.
+  // For loads, reg_value must be a simple register.
+  Gen::FixupBranch SoftwareTLBAccess(bool write, const Gen::OpArg& reg_value, Gen::X64Reg reg_addr,
+                                     int accessSize, BitSet32 registers_in_use, bool signExtend,
+                                     bool swap);
   // these return the address of the MOV, for backpatching
   void UnsafeWriteRegToReg(Gen::OpArg reg_value, Gen::X64Reg reg_addr, int accessSize,
                            s32 offset = 0, bool swap = true, Gen::MovInfo* info = nullptr);
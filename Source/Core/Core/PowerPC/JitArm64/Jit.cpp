@@ -85,12 +85,14 @@ void JitArm64::SetOptimizationEnabled(bool enabled)
     analyzer.SetOption(PPCAnalyst::PPCAnalyzer::OPTION_CONDITIONAL_CONTINUE);
     analyzer.SetOption(PPCAnalyst::PPCAnalyzer::OPTION_CARRY_MERGE);
     analyzer.SetOption(PPCAnalyst::PPCAnalyzer::OPTION_BRANCH_FOLLOW);
+    analyzer.SetOption(PPCAnalyst::PPCAnalyzer::OPTION_DATAFLOW);
   }
   else
   {
     analyzer.ClearOption(PPCAnalyst::PPCAnalyzer::OPTION_CONDITIONAL_CONTINUE);
     analyzer.ClearOption(PPCAnalyst::PPCAnalyzer::OPTION_CARRY_MERGE);
     analyzer.ClearOption(PPCAnalyst::PPCAnalyzer::OPTION_BRANCH_FOLLOW);
+    analyzer.ClearOption(PPCAnalyst::PPCAnalyzer::OPTION_DATAFLOW);
   }
 }
 
@@ -299,6 +301,29 @@ void JitArm64::ResetStack()
   ADD(ARM64Reg::SP, ARM64Reg::X0, 0);
 }
 
+void JitArm64::WriteHotnessCountdown(JitBlock* b, u32 count, JitInterface::ExceptionType type)
+{
+  b->hotness_countdown = count;
+
+  MOVP2R(ARM64Reg::X0, &b->hotness_countdown);
+  LDR(IndexType::Unsigned, ARM64Reg::W1, ARM64Reg::X0, 0);
+  SUBS(ARM64Reg::W1, ARM64Reg::W1, 1);
+  STR(IndexType::Unsigned, ARM64Reg::W1, ARM64Reg::X0, 0);
+  FixupBranch not_hot = B(CCFlags::CC_NEQ);
+  FixupBranch hot = B();
+
+  SwitchToFarCode();
+  SetJumpTarget(hot);
+  MOVI2R(DISPATCHER_PC, js.blockStart);
+  STR(IndexType::Unsigned, DISPATCHER_PC, PPC_REG, PPCSTATE_OFF(pc));
+  ABI_CallFunction(&JitInterface::CompileExceptionCheckFromJIT, &m_system.GetJitInterface(),
+                   static_cast<u32>(type));
+  B(dispatcher_no_check);
+  SwitchToNearCode();
+
+  SetJumpTarget(not_hot);
+}
+
 void JitArm64::IntializeSpeculativeConstants()
 {
   // If the block depends on an input register which looks like a gather pipe or MMIO related
@@ -892,6 +917,7 @@ void JitArm64::Trace()
 
 void JitArm64::Jit(u32 em_address)
 {
+  ScopedCompileTimer timer(m_compile_stats);
   Jit(em_address, true);
 }
 
@@ -947,6 +973,9 @@ void JitArm64::Jit(u32 em_address, bool clear_cache_and_retry_on_failure)
     }
   }
 
+  js.compilingQuickTier = ShouldCompileQuickTier(em_address);
+  analyzer.SetQuickAnalysisEnabled(js.compilingQuickTier);
+
   // Analyze the block, collect all instructions it is made of (including inlining,
   // if that is enabled), reorder instructions for optimal performance, and join joinable
   // instructions.
@@ -1058,6 +1087,9 @@ bool JitArm64::DoJit(u32 em_address, JitBlock* b, u32 nextPC)
     BeginTimeProfile(b);
   }
 
+  if (js.compilingQuickTier)
+    WriteHotnessCountdown(b, TIER_UP_THRESHOLD, JitInterface::ExceptionType::TierUp);
+
   if (code_block.m_gqr_used.Count() == 1 &&
       js.pairedQuantizeAddresses.find(js.blockStart) == js.pairedQuantizeAddresses.end())
   {
@@ -1083,8 +1115,8 @@ bool JitArm64::DoJit(u32 em_address, JitBlock* b, u32 nextPC)
   gpr.Start(js.gpa);
   fpr.Start(js.fpa);
 
-  if (js.noSpeculativeConstantsAddresses.find(js.blockStart) ==
-      js.noSpeculativeConstantsAddresses.end())
+  if (!js.compilingQuickTier && js.noSpeculativeConstantsAddresses.find(js.blockStart) ==
+                                     js.noSpeculativeConstantsAddresses.end())
   {
     IntializeSpeculativeConstants();
   }
@@ -1183,11 +1215,10 @@ bool JitArm64::DoJit(u32 em_address, JitBlock* b, u32 nextPC)
 
     if (op.skip)
     {
-      if (IsDebuggingEnabled())
+      // Besides the BLR following optimization, op.skip is set by the dataflow optimizations for
+      // instructions that don't change anything. Only the former needs to be seen by branch watch.
+      if (IsDebuggingEnabled() && op.opinfo->type == OpType::Branch)
       {
-        // The only thing that currently sets op.skip is the BLR following optimization.
-        // If any non-branch instruction starts setting that too, this will need to be changed.
-        ASSERT(op.inst.hex == 0x4e800020);
         const ARM64Reg bw_reg_a = gpr.GetReg(), bw_reg_b = gpr.GetReg();
         const BitSet32 gpr_caller_save =
             gpr.GetCallerSavedUsed() & ~BitSet32{DecodeReg(bw_reg_a), DecodeReg(bw_reg_b)};
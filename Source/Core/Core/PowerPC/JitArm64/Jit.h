@@ -17,6 +17,7 @@
 #include "Core/PowerPC/JitArmCommon/BackPatch.h"
 #include "Core/PowerPC/JitCommon/JitAsmCommon.h"
 #include "Core/PowerPC/JitCommon/JitBase.h"
+#include "Core/PowerPC/JitInterface.h"
 #include "Core/PowerPC/PPCAnalyst.h"
 
 class JitArm64 : public JitBase, public Arm64Gen::ARM64CodeBlock, public CommonAsmRoutinesBase
@@ -295,6 +296,9 @@ protected:
   void ResetFreeMemoryRanges();
 
   void IntializeSpeculativeConstants();
+  // Counts down on every entry into the block, and raises the given compile exception for the
+  // block once the count reaches zero.
+  void WriteHotnessCountdown(JitBlock* b, u32 count, JitInterface::ExceptionType type);
 
   // AsmRoutines
   void GenerateAsm();
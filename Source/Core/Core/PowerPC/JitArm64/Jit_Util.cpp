@@ -56,7 +56,12 @@ private:
   void WriteRegToAddr(int sbits, const void* ptr, u32 mask)
   {
     const s32 offset = m_emit->MOVPage2R(ARM64Reg::X0, ptr);
+    LoadMaskToReg(sbits, mask, offset);
+  }
 
+  // Loads the value at X0 + offset into the destination register.
+  void LoadMaskToReg(int sbits, u32 mask, s32 offset)
+  {
     // If we do not need to mask, we can do the sign extend while loading
     // from memory. If masking is required, we have to first zero extend,
     // then mask, then sign extend if needed (1 instr vs. ~4).
@@ -113,6 +118,18 @@ public:
   {
     CallLambda(8 * sizeof(T), lambda);
   }
+  void VisitDirectWithFallback(const T* const* addr_ptr, u32 mask,
+                               const std::function<T(Core::System&, u32)>* fallback) override
+  {
+    const s32 offset = m_emit->MOVPage2R(ARM64Reg::X0, addr_ptr);
+    m_emit->LDR(IndexType::Unsigned, ARM64Reg::X0, ARM64Reg::X0, offset);
+    FixupBranch slow = m_emit->CBZ(ARM64Reg::X0);
+    LoadMaskToReg(8 * sizeof(T), mask, 0);
+    FixupBranch done = m_emit->B();
+    m_emit->SetJumpTarget(slow);
+    CallLambda(8 * sizeof(T), fallback);
+    m_emit->SetJumpTarget(done);
+  }
 
 private:
   void LoadConstantToReg(int sbits, u32 value)
@@ -150,7 +167,12 @@ private:
   void LoadAddrMaskToReg(int sbits, const void* ptr, u32 mask)
   {
     const s32 offset = m_emit->MOVPage2R(ARM64Reg::X0, ptr);
+    LoadMaskToReg(sbits, mask, offset);
+  }
 
+  // Loads the value at X0 + offset into the destination register.
+  void LoadMaskToReg(int sbits, u32 mask, s32 offset)
+  {
     // If we do not need to mask, we can do the sign extend while loading
     // from memory. If masking is required, we have to first zero extend,
     // then mask, then sign extend if needed (1 instr vs. ~4).
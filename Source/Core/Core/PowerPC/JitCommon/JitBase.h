@@ -4,6 +4,7 @@
 #pragma once
 
 #include <array>
+#include <chrono>
 #include <cstddef>
 #include <map>
 #include <unordered_set>
@@ -19,6 +20,7 @@
 #include "Core/PowerPC/CPUCoreBase.h"
 #include "Core/PowerPC/JitCommon/JitAsmCommon.h"
 #include "Core/PowerPC/JitCommon/JitCache.h"
+#include "Core/PowerPC/JitInterface.h"
 #include "Core/PowerPC/PPCAnalyst.h"
 
 namespace Core
@@ -111,6 +113,9 @@ protected:
     int skipInstructions;
     CarryFlag carryFlag;
 
+    // Whether the current block is compiled as the cheap first tier of tiered compilation.
+    bool compilingQuickTier;
+
     bool generatingTrampoline = false;
     u8* trampolineExceptionHandler;
 
@@ -128,6 +133,8 @@ protected:
     std::unordered_set<u32> fifoWriteAddresses;
     std::unordered_set<u32> pairedQuantizeAddresses;
     std::unordered_set<u32> noSpeculativeConstantsAddresses;
+    std::unordered_set<u32> superblockAddresses;
+    std::unordered_set<u32> tierUpAddresses;
   };
 
   PPCAnalyst::CodeBlock code_block;
@@ -150,6 +157,8 @@ protected:
   bool bJITRegisterCacheOff = false;
   bool m_enable_debugging = false;
   bool m_enable_branch_following = false;
+  bool m_enable_superblocks = false;
+  bool m_enable_tiered_compilation = false;
   bool m_enable_float_exceptions = false;
   bool m_enable_div_by_zero_exceptions = false;
   bool m_low_dcbz_hack = false;
@@ -162,7 +171,7 @@ protected:
   bool m_cleanup_after_stackfault = false;
   u8* m_stack_guard = nullptr;
 
-  static const std::array<std::pair<bool JitBase::*, const Config::Info<bool>*>, 22> JIT_SETTINGS;
+  static const std::array<std::pair<bool JitBase::*, const Config::Info<bool>*>, 24> JIT_SETTINGS;
 
   bool DoesConfigNeedRefresh();
   void RefreshConfig();
@@ -176,8 +185,38 @@ protected:
 
   bool CanMergeNextInstructions(int count) const;
 
+  // With tiered compilation, blocks are first compiled with a quick analysis (see
+  // PPCAnalyzer::SetQuickAnalysisEnabled) and without speculative constants, which cuts down on
+  // compile stutter. Blocks that get executed TIER_UP_THRESHOLD times are recompiled with the full
+  // analysis, which replaces the first tier in the block cache's entry points.
+  static constexpr u32 TIER_UP_THRESHOLD = 100;
+  bool ShouldCompileQuickTier(u32 em_address) const;
+
   bool ShouldHandleFPExceptionForInstruction(const PPCAnalyst::CodeOp* op);
 
+  // Counts a block compilation, and adds the time until the end of the scope to the compile stats.
+  class ScopedCompileTimer
+  {
+  public:
+    explicit ScopedCompileTimer(JitInterface::CompileStats& stats)
+        : m_stats(stats), m_start(std::chrono::steady_clock::now())
+    {
+    }
+    ~ScopedCompileTimer()
+    {
+      ++m_stats.blocks_compiled;
+      m_stats.compile_time += std::chrono::steady_clock::now() - m_start;
+    }
+    ScopedCompileTimer(const ScopedCompileTimer&) = delete;
+    ScopedCompileTimer& operator=(const ScopedCompileTimer&) = delete;
+
+  private:
+    JitInterface::CompileStats& m_stats;
+    std::chrono::steady_clock::time_point m_start;
+  };
+
+  JitInterface::CompileStats m_compile_stats;
+
 public:
   explicit JitBase(Core::System& system);
   JitBase(const JitBase&) = delete;
@@ -192,6 +231,7 @@ public:
   virtual JitBaseBlockCache* GetBlockCache() = 0;
 
   virtual void Jit(u32 em_address) = 0;
+  const JitInterface::CompileStats& GetCompileStats() const { return m_compile_stats; }
 
   virtual const CommonAsmRoutinesBase* GetAsmRoutines() = 0;
 
@@ -68,6 +68,8 @@ void JitBaseBlockCache::Clear()
   m_jit.js.fifoWriteAddresses.clear();
   m_jit.js.pairedQuantizeAddresses.clear();
   m_jit.js.noSpeculativeConstantsAddresses.clear();
+  m_jit.js.superblockAddresses.clear();
+  m_jit.js.tierUpAddresses.clear();
   for (auto& e : block_map)
   {
     DestroyBlock(e.second);
@@ -303,6 +305,8 @@ void JitBaseBlockCache::InvalidateICacheInternal(u32 physical_address, u32 addre
         m_jit.js.fifoWriteAddresses.erase(i);
         m_jit.js.pairedQuantizeAddresses.erase(i);
         m_jit.js.noSpeculativeConstantsAddresses.erase(i);
+        m_jit.js.superblockAddresses.erase(i);
+        m_jit.js.tierUpAddresses.erase(i);
       }
     }
   }
@@ -92,6 +92,10 @@ struct JitBlock : public JitBlockData
     u64 ticStart;
     u64 ticStop;
   } profile_data = {};
+
+  // Counts down on every entry into the block. Used by JITs that recompile blocks once they have
+  // proven to be hot.
+  u32 hotness_countdown = 0;
 };
 
 typedef void (*CompiledCode)();
@@ -23,6 +23,7 @@
 #include "Common/MsgHandler.h"
 
 #include "Core/Core.h"
+#include "Core/MemTools.h"
 #include "Core/PowerPC/CPUCoreBase.h"
 #include "Core/PowerPC/CachedInterpreter/CachedInterpreter.h"
 #include "Core/PowerPC/JitCommon/JitBase.h"
@@ -53,7 +54,7 @@ void JitInterface::SetJit(std::unique_ptr<JitBase> jit)
 
 void JitInterface::DoState(PointerWrap& p)
 {
-  if (m_jit && p.IsReadMode())
+  if (m_jit && p.IsReadMode() && !m_keep_cache_on_state_load)
     m_jit->ClearCache();
 }
 
@@ -100,17 +101,25 @@ void JitInterface::SetProfilingState(ProfilingState state)
 
 void JitInterface::UpdateMembase()
 {
+  auto& memory = m_system.GetMemory();
   if (!m_jit)
+  {
+    memory.SetGPUResidencySupported(false);
     return;
+  }
 
   auto& ppc_state = m_system.GetPPCState();
-  auto& memory = m_system.GetMemory();
 #ifdef _M_ARM_64
   // JitArm64 is currently using the no fastmem arena code path even when only fastmem is off.
   const bool fastmem_arena = m_jit->jo.fastmem;
 #else
   const bool fastmem_arena = m_jit->jo.fastmem_arena;
 #endif
+  // Accesses through the page mappings don't fault on GPU resident memory. The memory manager
+  // also only sees the faults if the exception handler isn't limited to the JIT's own, and in
+  // single core mode writing memory back would mean rendering inside the fault handler.
+  memory.SetGPUResidencySupported(fastmem_arena && m_system.IsDualCoreMode() &&
+                                  EMM::IsExceptionHandlerProcessWide());
   if (ppc_state.msr.DR)
   {
     ppc_state.mem_ptr =
@@ -150,6 +159,16 @@ void JitInterface::WriteProfileResults(const std::string& filename) const
   }
 }
 
+std::optional<JitInterface::CompileStats> JitInterface::GetCompileStats() const
+{
+  if (!m_jit)
+    return std::nullopt;
+
+  CompileStats stats;
+  Core::RunAsCPUThread([this, &stats] { stats = m_jit->GetCompileStats(); });
+  return stats;
+}
+
 void JitInterface::GetProfileResults(Profiler::ProfileStats* prof_stats) const
 {
   // Can't really do this with no m_jit core available
@@ -281,6 +300,12 @@ void JitInterface::InvalidateICacheLines(u32 address, u32 count)
     InvalidateICache(address & ~0x1f, 32 * count, false);
 }
 
+void JitInterface::ErasePhysicalRange(u32 address, u32 size)
+{
+  if (m_jit)
+    m_jit->GetBlockCache()->ErasePhysicalRange(address, size);
+}
+
 void JitInterface::InvalidateICacheLineFromJIT(JitInterface& jit_interface, u32 address)
 {
   jit_interface.InvalidateICacheLine(address);
@@ -309,6 +334,12 @@ void JitInterface::CompileExceptionCheck(ExceptionType type)
   case ExceptionType::SpeculativeConstants:
     exception_addresses = &m_jit->js.noSpeculativeConstantsAddresses;
     break;
+  case ExceptionType::Superblock:
+    exception_addresses = &m_jit->js.superblockAddresses;
+    break;
+  case ExceptionType::TierUp:
+    exception_addresses = &m_jit->js.tierUpAddresses;
+    break;
   }
 
   auto& ppc_state = m_system.GetPPCState();
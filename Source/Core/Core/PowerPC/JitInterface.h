@@ -3,7 +3,9 @@
 
 #pragma once
 
+#include <chrono>
 #include <memory>
+#include <optional>
 #include <string>
 #include <variant>
 
@@ -39,6 +41,11 @@ public:
   ~JitInterface();
 
   void DoState(PointerWrap& p);
+  // Loading a state clears the code cache, unless it's kept for the rollback network mode. Guest
+  // code can only have changed in the guest memory the state restored, which the caller erases
+  // the blocks of with ErasePhysicalRange.
+  void SetKeepCacheOnStateLoad(bool keep) { m_keep_cache_on_state_load = keep; }
+  bool IsKeepingCacheOnStateLoad() const { return m_keep_cache_on_state_load; }
 
   CPUCoreBase* InitJitCore(PowerPC::CPUCore core);
   CPUCoreBase* GetCore() const;
@@ -65,6 +72,14 @@ public:
   void SetProfilingState(ProfilingState state);
   void WriteProfileResults(const std::string& filename) const;
   void GetProfileResults(Profiler::ProfileStats* prof_stats) const;
+
+  struct CompileStats
+  {
+    u64 blocks_compiled = 0;
+    std::chrono::nanoseconds compile_time{};
+  };
+  // Returns nullopt if no JIT is active.
+  std::optional<CompileStats> GetCompileStats() const;
   std::variant<GetHostCodeError, GetHostCodeResult> GetHostCode(u32 address) const;
 
   // Memory Utilities
@@ -83,6 +98,7 @@ public:
   void InvalidateICache(u32 address, u32 size, bool forced);
   void InvalidateICacheLine(u32 address);
   void InvalidateICacheLines(u32 address, u32 count);
+  void ErasePhysicalRange(u32 address, u32 size);
   static void InvalidateICacheLineFromJIT(JitInterface& jit_interface, u32 address);
   static void InvalidateICacheLinesFromJIT(JitInterface& jit_interface, u32 address, u32 count);
 
@@ -90,7 +106,9 @@ public:
   {
     FIFOWrite,
     PairedQuantize,
-    SpeculativeConstants
+    SpeculativeConstants,
+    Superblock,
+    TierUp
   };
   void CompileExceptionCheck(ExceptionType type);
   static void CompileExceptionCheckFromJIT(JitInterface& jit_interface, ExceptionType type);
@@ -102,5 +120,6 @@ public:
 
 private:
   std::unique_ptr<JitBase> m_jit;
+  bool m_keep_cache_on_state_load = false;
   Core::System& m_system;
 };
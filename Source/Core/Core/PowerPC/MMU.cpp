@@ -213,6 +213,8 @@ T MMU::ReadFromHardware(u32 em_address)
     // mirrors of memory).
     T value;
     em_address &= m_memory.GetRamMask();
+    // The page might still have to be written by the GPU.
+    m_memory.PrepareHostAccess(em_address, sizeof(T));
 
     if (!m_ppc_state.m_enable_dcache || wi)
     {
@@ -231,6 +233,7 @@ T MMU::ReadFromHardware(u32 em_address)
       (em_address & 0x0FFFFFFF) < m_memory.GetExRamSizeReal())
   {
     T value;
+    m_memory.PrepareHostAccess(em_address, sizeof(T));
     em_address &= 0x0FFFFFFF;
 
     if (!m_ppc_state.m_enable_dcache || wi)
@@ -410,6 +413,7 @@ void MMU::WriteToHardware(u32 em_address, const u32 data, const u32 size)
     // Handle RAM; the masking intentionally discards bits (essentially creating
     // mirrors of memory).
     em_address &= m_memory.GetRamMask();
+    m_memory.PrepareHostAccess(em_address, size);
 
     if (m_ppc_state.m_enable_dcache && !wi)
       m_ppc_state.dCache.Write(em_address, &swapped_data, size, HID0(m_ppc_state).DLOCK);
@@ -423,6 +427,7 @@ void MMU::WriteToHardware(u32 em_address, const u32 data, const u32 size)
   if (m_memory.GetEXRAM() && (em_address >> 28) == 0x1 &&
       (em_address & 0x0FFFFFFF) < m_memory.GetExRamSizeReal())
   {
+    m_memory.PrepareHostAccess(em_address, size);
     em_address &= 0x0FFFFFFF;
 
     if (m_ppc_state.m_enable_dcache && !wi)
@@ -1334,6 +1339,9 @@ void MMU::SDRUpdated()
 
   m_ppc_state.pagetable_base = htaborg << 16;
   m_ppc_state.pagetable_hashmask = ((htabmask << 10) | 0x3ff);
+
+  InvalidatePageWalkCache();
+  InvalidateSoftwareTLB();
 }
 
 enum class TLBLookupResult
@@ -1423,6 +1431,103 @@ void MMU::InvalidateTLBEntry(u32 address)
 
   m_ppc_state.tlb[PowerPC::DATA_TLB_INDEX][entry_index].Invalidate();
   m_ppc_state.tlb[PowerPC::INST_TLB_INDEX][entry_index].Invalidate();
+
+  InvalidatePageWalkCache();
+
+  // tlbie invalidates a whole congruence class, which in the software TLB is every entry whose
+  // index shares its low bits with the page.
+  for (size_t i = entry_index; i < SOFTWARE_TLB_SIZE; i += TLB_SIZE / TLB_WAYS)
+  {
+    m_ppc_state.software_tlb_read.page[i] = SoftwareTLB::INVALID_PAGE;
+    m_ppc_state.software_tlb_write.page[i] = SoftwareTLB::INVALID_PAGE;
+  }
+}
+
+void MMU::InvalidatePageWalkCache()
+{
+  if (++m_page_walk_cache_generation == 0)
+  {
+    m_page_walk_cache = {};
+    m_page_walk_cache_generation = 1;
+  }
+}
+
+void MMU::InvalidateSoftwareTLB()
+{
+  m_ppc_state.software_tlb_read.Invalidate();
+  m_ppc_state.software_tlb_write.Invalidate();
+}
+
+void MMU::ClearPageTableCaches()
+{
+  InvalidatePageWalkCache();
+  InvalidateSoftwareTLB();
+}
+
+void MMU::UpdateSoftwareTLB(u32 address, u32 sr, u32 physical_address, bool writable)
+{
+  const u32 page_address = address & ~HW_PAGE_MASK;
+  if (m_power_pc.GetMemChecks().OverlapsMemcheck(page_address, HW_PAGE_SIZE))
+    return;
+
+  u8* host_page;
+  physical_address &= ~HW_PAGE_MASK;
+  if (m_memory.GetRAM() && (physical_address & 0xF8000000) == 0x00000000)
+  {
+    physical_address &= m_memory.GetRamMask();
+  }
+  else if (m_memory.GetEXRAM() && (physical_address >> 28) == 0x1 &&
+           (physical_address & 0x0FFFFFFF) < m_memory.GetExRamSizeReal())
+  {
+    physical_address &= 0x1FFFFFFF;
+  }
+  else
+  {
+    return;
+  }
+
+  // Accesses through the physical fastmem view fault on GPU resident memory, unlike those through
+  // the views GetPointer returns.
+  if (m_memory.GetPhysicalBase())
+    host_page = m_memory.GetPhysicalBase() + physical_address;
+  else
+    host_page = m_memory.GetPointer(physical_address);
+
+  const u32 page = address >> HW_PAGE_INDEX_SHIFT;
+  const size_t index = page & (SOFTWARE_TLB_SIZE - 1);
+  const auto update = [&](SoftwareTLB& tlb) {
+    tlb.page[index] = page;
+    tlb.sr[index] = sr;
+    tlb.host_page[index] = host_page;
+  };
+
+  update(m_ppc_state.software_tlb_read);
+  if (writable)
+    update(m_ppc_state.software_tlb_write);
+}
+
+MMU::TLBStats MMU::GetTLBStats() const
+{
+  return TLBStats{
+      .software_tlb_hits = m_ppc_state.software_tlb_hits,
+      .tlb_hits = m_tlb_hits.load(std::memory_order_relaxed),
+      .page_walk_cache_hits = m_page_walk_cache_hits.load(std::memory_order_relaxed),
+      .page_walks = m_page_walks.load(std::memory_order_relaxed),
+  };
+}
+
+void MMU::ResetTLBStats()
+{
+  m_ppc_state.software_tlb_hits = 0;
+  m_tlb_hits.store(0, std::memory_order_relaxed);
+  m_page_walk_cache_hits.store(0, std::memory_order_relaxed);
+  m_page_walks.store(0, std::memory_order_relaxed);
+}
+
+// Only the CPU thread writes the counters, so a plain load and store is enough.
+static void IncrementTLBStat(std::atomic<u64>& counter)
+{
+  counter.store(counter.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
 }
 
 // Page Address Translation
@@ -1440,6 +1545,13 @@ MMU::TranslateAddressResult MMU::TranslatePageAddress(const EffectiveAddress add
       LookupTLBPageAddress(m_ppc_state, flag, address.Hex, VSID, &translated_address, wi);
   if (res == TLBLookupResult::Found)
   {
+    if constexpr (!IsNoExceptionFlag(flag))
+      IncrementTLBStat(m_tlb_hits);
+    if constexpr (flag == XCheckTLBFlag::Read || flag == XCheckTLBFlag::Write)
+    {
+      if (!*wi)
+        UpdateSoftwareTLB(address.Hex, sr.Hex, translated_address, flag == XCheckTLBFlag::Write);
+    }
     return TranslateAddressResult{TranslateAddressResultEnum::PAGE_TABLE_TRANSLATED,
                                   translated_address};
   }
@@ -1459,6 +1571,37 @@ MMU::TranslateAddressResult MMU::TranslatePageAddress(const EffectiveAddress add
   const u32 page_index = address.page_index;  // 16 bit
   const u32 api = address.API;                //  6 bit (part of page_index)
 
+  // Page walk cache. Entries only come from walks which already set the R bit in the page table,
+  // but a write to a page whose C bit isn't set yet still has to go through the page table.
+  const u32 tag = address.Hex >> HW_PAGE_INDEX_SHIFT;
+  PageWalkCacheEntry& cache_entry = m_page_walk_cache[(tag ^ VSID) & (PAGE_WALK_CACHE_SIZE - 1)];
+  if (res == TLBLookupResult::NotFound && cache_entry.generation == m_page_walk_cache_generation &&
+      cache_entry.tag == tag && cache_entry.vsid == VSID)
+  {
+    const UPTE_Hi pte2(cache_entry.pte);
+    if (flag != XCheckTLBFlag::Write || pte2.C != 0)
+    {
+      UpdateTLBEntry(m_ppc_state, flag, pte2, address.Hex, VSID);
+
+      *wi = (pte2.WIMG & 0b1100) != 0;
+      const u32 physical_address = (pte2.RPN << 12) | offset;
+
+      if constexpr (!IsNoExceptionFlag(flag))
+        IncrementTLBStat(m_page_walk_cache_hits);
+      if constexpr (flag == XCheckTLBFlag::Read || flag == XCheckTLBFlag::Write)
+      {
+        if (!*wi)
+          UpdateSoftwareTLB(address.Hex, sr.Hex, physical_address, pte2.C != 0);
+      }
+
+      return TranslateAddressResult{TranslateAddressResultEnum::PAGE_TABLE_TRANSLATED,
+                                    physical_address};
+    }
+  }
+
+  if constexpr (!IsNoExceptionFlag(flag))
+    IncrementTLBStat(m_page_walks);
+
   // hash function no 1 "xor" .360
   u32 hash = (VSID ^ page_index);
 
@@ -1516,9 +1659,23 @@ MMU::TranslateAddressResult MMU::TranslatePageAddress(const EffectiveAddress add
           UpdateTLBEntry(m_ppc_state, flag, pte2, address.Hex, VSID);
 
         *wi = (pte2.WIMG & 0b1100) != 0;
+        const u32 physical_address = (pte2.RPN << 12) | offset;
+
+        if constexpr (!IsNoExceptionFlag(flag))
+        {
+          cache_entry = PageWalkCacheEntry{.tag = tag,
+                                           .vsid = VSID,
+                                           .pte = pte2.Hex,
+                                           .generation = m_page_walk_cache_generation};
+        }
+        if constexpr (flag == XCheckTLBFlag::Read || flag == XCheckTLBFlag::Write)
+        {
+          if (!*wi)
+            UpdateSoftwareTLB(address.Hex, sr.Hex, physical_address, pte2.C != 0);
+        }
 
         return TranslateAddressResult{TranslateAddressResultEnum::PAGE_TABLE_TRANSLATED,
-                                      (pte2.RPN << 12) | offset};
+                                      physical_address};
       }
     }
   }
@@ -1654,6 +1811,9 @@ void MMU::DBATUpdated()
   m_memory.UpdateLogicalMemory(m_dbat_table);
 #endif
 
+  // Memchecks and BATs take priority over whatever the software TLB has cached.
+  InvalidateSoftwareTLB();
+
   // IsOptimizable*Address and dcbz depends on the BAT mapping, so we need a flush here.
   m_system.GetJitInterface().ClearSafe();
 }
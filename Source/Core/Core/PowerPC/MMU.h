@@ -4,6 +4,7 @@
 #pragma once
 
 #include <array>
+#include <atomic>
 #include <cstddef>
 #include <optional>
 #include <string>
@@ -241,6 +242,21 @@ public:
   void InvalidateTLBEntry(u32 address);
   void DBATUpdated();
   void IBATUpdated();
+  // Drops the page walk cache and the software TLB. Neither is part of savestates.
+  void ClearPageTableCaches();
+
+  struct TLBStats
+  {
+    // Lookups by JIT code which were resolved inline. Misses fall back to the other levels.
+    u64 software_tlb_hits = 0;
+    u64 tlb_hits = 0;
+    u64 page_walk_cache_hits = 0;
+    u64 page_walks = 0;
+  };
+  // The counters are only written by the CPU thread, so they're updated without a locked
+  // read-modify-write, and readers on other threads get an approximate value.
+  TLBStats GetTLBStats() const;
+  void ResetTLBStats();
 
   // Result changes based on the BAT registers and MSR.DR.  Returns whether
   // it's safe to optimize a read or write to this address to an unguarded
@@ -297,6 +313,22 @@ private:
   template <const XCheckTLBFlag flag>
   TranslateAddressResult TranslatePageAddress(const EffectiveAddress address, bool* wi);
 
+  // Second level of the TLB: a larger direct-mapped cache of page table entries which sits between
+  // the small TLB in PowerPCState and the hashed page table walk. Rather than being cleared, it is
+  // invalidated by bumping the generation, which makes tlbie and SDR1 writes cheap.
+  struct PageWalkCacheEntry
+  {
+    u32 tag = 0;
+    u32 vsid = 0;
+    u32 pte = 0;
+    u32 generation = 0;
+  };
+  static constexpr size_t PAGE_WALK_CACHE_SIZE = 4096;
+
+  void InvalidatePageWalkCache();
+  void InvalidateSoftwareTLB();
+  void UpdateSoftwareTLB(u32 address, u32 sr, u32 physical_address, bool writable);
+
   void GenerateDSIException(u32 effective_address, bool write);
   void GenerateISIException(u32 effective_address);
 
@@ -326,6 +358,13 @@ private:
 
   BatTable m_ibat_table;
   BatTable m_dbat_table;
+
+  std::array<PageWalkCacheEntry, PAGE_WALK_CACHE_SIZE> m_page_walk_cache{};
+  u32 m_page_walk_cache_generation = 1;
+
+  std::atomic<u64> m_tlb_hits = 0;
+  std::atomic<u64> m_page_walk_cache_hits = 0;
+  std::atomic<u64> m_page_walks = 0;
 };
 
 void ClearDCacheLineFromJit(MMU& mmu, u32 address);
@@ -4,7 +4,9 @@
 #include "Core/PowerPC/PPCAnalyst.h"
 
 #include <algorithm>
+#include <array>
 #include <map>
+#include <optional>
 #include <queue>
 #include <string>
 #include <vector>
@@ -41,9 +43,6 @@
 
 namespace PPCAnalyst
 {
-// 0 does not perform block merging
-constexpr u32 BRANCH_FOLLOWING_THRESHOLD = 2;
-
 constexpr u32 INVALID_BRANCH_TARGET = 0xFFFFFFFF;
 
 static u32 EvaluateBranchTarget(UGeckoInstruction instr, u32 pc)
@@ -590,7 +589,7 @@ void PPCAnalyzer::SetInstructionStats(CodeBlock* block, CodeOp* code,
   }
   else if (opinfo->flags & FL_READ_CR_BI)
   {
-    code->crIn[code->inst.BI] = true;
+    code->crIn[code->inst.BI >> 2] = true;
   }
   else if (opinfo->type == OpType::CR)
   {
@@ -731,6 +730,43 @@ void PPCAnalyzer::SetInstructionStats(CodeBlock* block, CodeOp* code,
   }
 }
 
+namespace
+{
+// Tracks the registers used by the straight-line part of a busy wait loop. Every iteration of the
+// loop computes the same values as long as it only reads registers it wrote to earlier in the
+// loop, or does not write to these registers.
+class BusyWaitRegisterTracker
+{
+public:
+  bool Add(const CodeOp& op)
+  {
+    for (int reg : op.regsIn)
+    {
+      if (!m_written_regs[reg])
+        m_write_disallowed_regs[reg] = true;
+    }
+    for (int reg : op.regsOut)
+    {
+      if (m_write_disallowed_regs[reg])
+        return false;
+      m_written_regs[reg] = true;
+    }
+    return true;
+  }
+
+private:
+  BitSet32 m_write_disallowed_regs;
+  BitSet32 m_written_regs;
+};
+
+// In the future, some subsets of other instruction types might get supported. Right now, only
+// try loops that have this very restricted instruction set.
+bool IsBusyWaitInstruction(const CodeOp& op)
+{
+  return op.opinfo->type == OpType::Integer || op.opinfo->type == OpType::Load;
+}
+}  // namespace
+
 bool PPCAnalyzer::IsBusyWaitLoop(CodeBlock* block, CodeOp* code, size_t instructions) const
 {
   // Very basic algorithm to detect busy wait loops:
@@ -739,12 +775,8 @@ bool PPCAnalyzer::IsBusyWaitLoop(CodeBlock* block, CodeOp* code, size_t instruct
   //   * It only reads from registers it wrote to earlier in the loop, or it
   //     does not write to these registers.
   //
-  // Would benefit a lot from basic inlining support - a lot of the most
-  // used busy loops are DSP register interactions, which are bl/cmp/bne
-  // (with the bl target a pure function that follows the above rules). We
-  // don't detect these at the moment.
-  std::bitset<32> write_disallowed_regs;
-  std::bitset<32> written_regs;
+  // Loops polling a register through a call are handled by IsPollingCallLoop.
+  BusyWaitRegisterTracker tracker;
   for (size_t i = 0; i <= instructions; ++i)
   {
     if (code[i].opinfo->type == OpType::Branch)
@@ -754,36 +786,90 @@ bool PPCAnalyzer::IsBusyWaitLoop(CodeBlock* block, CodeOp* code, size_t instruct
       if (code[i].branchTo == block->m_address && i == instructions)
         return true;
     }
-    else if (code[i].opinfo->type != OpType::Integer && code[i].opinfo->type != OpType::Load)
+    else if (!IsBusyWaitInstruction(code[i]) || !tracker.Add(code[i]))
     {
-      // In the future, some subsets of other instruction types might get
-      // supported. Right now, only try loops that have this very
-      // restricted instruction set.
       return false;
     }
-    else
-    {
-      for (int reg : code[i].regsIn)
-      {
-        if (reg == -1)
-          continue;
-        if (written_regs[reg])
-          continue;
-        write_disallowed_regs[reg] = true;
-      }
-      for (int reg : code[i].regsOut)
-      {
-        if (reg == -1)
-          continue;
-        if (write_disallowed_regs[reg])
-          return false;
-        written_regs[reg] = true;
-      }
-    }
   }
   return false;
 }
 
+bool PPCAnalyzer::IsPollingCallLoop(CodeBlock* block, CodeOp* code, size_t instructions) const
+{
+  // Most of the busy wait loops that remain are hardware register (e.g. DSP mailbox) polls
+  // through a small accessor function:
+  //
+  //   loop: bl poll      <- last instruction of the previous block
+  //         cmpwi r3, 0  <- this block
+  //         bne loop
+  //
+  // The loop body is the callee followed by this block, and it has to follow the same rules as
+  // IsBusyWaitLoop. The callee must be a leaf function that ends with its first blr.
+  //
+  // The call and the callee are outside of the block, so if the loop is detected, their addresses
+  // are added to the block's physical addresses to have the block invalidated when they change.
+  static constexpr size_t MAX_CALLEE_INSTRUCTIONS = 16;
+
+  if (code[instructions].branchUsesCtr)
+    return false;
+
+  auto& mmu = Core::System::GetInstance().GetMMU();
+  const u32 call_address = block->m_address - 4;
+  const auto call = mmu.TryReadInstruction(call_address);
+  if (!call.valid)
+    return false;
+
+  const UGeckoInstruction call_inst = call.hex;
+  if (call_inst.OPCD != 18 || !call_inst.LK)
+    return false;
+
+  std::array<u32, MAX_CALLEE_INSTRUCTIONS + 1> physical_addresses;
+  size_t physical_address_count = 0;
+  physical_addresses[physical_address_count++] = call.physical_address;
+
+  u32 address = SignExt26(call_inst.LI << 2);
+  if (!call_inst.AA)
+    address += call_address;
+
+  BusyWaitRegisterTracker tracker;
+  for (size_t i = 0;; ++i, address += 4)
+  {
+    if (i == MAX_CALLEE_INSTRUCTIONS)
+      return false;
+
+    const auto result = mmu.TryReadInstruction(address);
+    if (!result.valid)
+      return false;
+
+    physical_addresses[physical_address_count++] = result.physical_address;
+
+    const UGeckoInstruction inst = result.hex;
+    if (inst.hex == 0x4E800020)  // blr
+      break;
+
+    CodeOp op{};
+    op.opinfo = PPCTables::GetOpInfo(inst, address);
+    op.address = address;
+    op.inst = inst;
+    if (!IsBusyWaitInstruction(op))
+      return false;
+
+    SetInstructionStats(block, &op, op.opinfo);
+    if (!tracker.Add(op))
+      return false;
+  }
+
+  for (size_t i = 0; i < instructions; ++i)
+  {
+    if (!IsBusyWaitInstruction(code[i]) || !tracker.Add(code[i]))
+      return false;
+  }
+
+  for (size_t i = 0; i < physical_address_count; ++i)
+    block->m_physical_addresses.insert(physical_addresses[i]);
+  return true;
+}
+
 static bool CanCauseGatherPipeInterruptCheck(const CodeOp& op)
 {
   // eieio
@@ -794,6 +880,262 @@ static bool CanCauseGatherPipeInterruptCheck(const CodeOp& op)
          op.opinfo->type == OpType::StorePS;
 }
 
+namespace
+{
+// The value of a word in the stack frame, which is still held in a GPR.
+struct StackSlot
+{
+  s32 offset;
+  u32 reg;
+};
+
+constexpr std::size_t MAX_STACK_SLOTS = 16;
+
+// The GPR written by a simple integer instruction, and its value if all inputs are known.
+struct ConstantResult
+{
+  u32 reg;
+  u32 value;
+};
+}  // namespace
+
+static std::optional<ConstantResult> EvaluateConstant(UGeckoInstruction inst, BitSet32 known,
+                                                      const std::array<u32, 32>& values)
+{
+  switch (inst.OPCD)
+  {
+  case 14:  // addi
+  case 15:  // addis
+  {
+    const u32 imm = inst.OPCD == 14 ? static_cast<u32>(inst.SIMM_16) :
+                                      static_cast<u32>(inst.SIMM_16) << 16;
+    if (inst.RA == 0)
+      return ConstantResult{inst.RD, imm};
+    if (!known[inst.RA])
+      return std::nullopt;
+    return ConstantResult{inst.RD, values[inst.RA] + imm};
+  }
+  case 24:  // ori
+  case 25:  // oris
+  {
+    const u32 imm = inst.OPCD == 24 ? inst.UIMM : inst.UIMM << 16;
+    if (!known[inst.RS])
+      return std::nullopt;
+    return ConstantResult{inst.RA, values[inst.RS] | imm};
+  }
+  case 31:
+    // mr
+    if (inst.SUBOP10 == 444 && inst.RS == inst.RB && !inst.Rc && known[inst.RS])
+      return ConstantResult{inst.RA, values[inst.RS]};
+    return std::nullopt;
+  default:
+    return std::nullopt;
+  }
+}
+
+// Whether the instruction leaves its destination register unchanged, e.g. nop or mr r3, r3.
+static bool IsRegisterNop(UGeckoInstruction inst)
+{
+  switch (inst.OPCD)
+  {
+  case 14:  // addi
+  case 15:  // addis
+    return inst.RA != 0 && inst.RD == inst.RA && inst.SIMM_16 == 0;
+  case 24:  // ori
+  case 25:  // oris
+    return inst.RA == inst.RS && inst.UIMM == 0;
+  case 31:
+    return inst.SUBOP10 == 444 && inst.RS == inst.RB && inst.RA == inst.RS && !inst.Rc;
+  default:
+    return false;
+  }
+}
+
+// The size of the stack memory written by a D-form store relative to r1, if it is one.
+static std::optional<s32> GetStackStoreSize(UGeckoInstruction inst)
+{
+  if (inst.RA != 1)
+    return std::nullopt;
+
+  switch (inst.OPCD)
+  {
+  case 38:  // stb
+  case 39:  // stbu
+    return 1;
+  case 44:  // sth
+  case 45:  // sthu
+    return 2;
+  case 36:  // stw
+  case 37:  // stwu
+  case 52:  // stfs
+  case 53:  // stfsu
+    return 4;
+  case 54:  // stfd
+  case 55:  // stfdu
+    return 8;
+  default:
+    return std::nullopt;
+  }
+}
+
+static bool CanWriteMemory(const CodeOp& op)
+{
+  if (!(op.opinfo->flags & FL_LOADSTORE))
+    return false;
+
+  return op.opinfo->type != OpType::Load && op.opinfo->type != OpType::LoadFP &&
+         op.opinfo->type != OpType::LoadPS;
+}
+
+void PPCAnalyzer::PropagateValues(CodeBlock* block, CodeOp* code) const
+{
+  BitSet32 known;
+  std::array<u32, 32> values{};
+
+  // r1 is the stack pointer per the EABI, so stores relative to it are assumed to only alias other
+  // accesses relative to it, and never MMIO. Stores relative to any other register may alias
+  // anything.
+  std::array<StackSlot, MAX_STACK_SLOTS> slots;
+  std::size_t num_slots = 0;
+  const auto find_slot = [&](s32 offset) {
+    return std::find_if(slots.begin(), slots.begin() + num_slots,
+                        [offset](const StackSlot& slot) { return slot.offset == offset; });
+  };
+  const auto erase_slots_if = [&](auto predicate) {
+    num_slots = std::remove_if(slots.begin(), slots.begin() + num_slots, predicate) - slots.begin();
+  };
+  const auto add_slot = [&](s32 offset, u32 reg) {
+    if (num_slots == slots.size())
+    {
+      // Forget the oldest slot.
+      std::move(slots.begin() + 1, slots.end(), slots.begin());
+      num_slots--;
+    }
+    slots[num_slots++] = {offset, reg};
+  };
+
+  const auto ppc_mode = Core::System::GetInstance().GetPowerPC().GetMode();
+  for (u32 i = 0; i < block->m_num_instructions; i++)
+  {
+    CodeOp& op = code[i];
+
+    // HLE hooks run before the instruction at their address, and can change any register or memory.
+    if (HLE::TryReplaceFunction(op.address, ppc_mode))
+    {
+      known = BitSet32{};
+      num_slots = 0;
+    }
+
+    if (op.skip)
+      continue;
+
+    // lwz rD, d(r1)
+    if (op.inst.OPCD == 32 && op.inst.RA == 1)
+    {
+      const auto slot = find_slot(op.inst.SIMM_16);
+      if (slot != slots.begin() + num_slots)
+      {
+        if (slot->reg == op.inst.RD)
+        {
+          op.skip = true;
+          continue;
+        }
+
+        // mr rD, rS
+        op.inst = (31 << 26) | (slot->reg << 21) | (op.inst.RD << 16) | (slot->reg << 11) |
+                  (444 << 1);
+        op.opinfo = PPCTables::GetOpInfo(op.inst, op.address);
+        SetInstructionStats(block, &op, op.opinfo);
+      }
+    }
+
+    const std::optional<ConstantResult> result = EvaluateConstant(op.inst, known, values);
+    if (IsRegisterNop(op.inst) ||
+        (result && known[result->reg] && values[result->reg] == result->value))
+    {
+      op.skip = true;
+      continue;
+    }
+
+    if (CanWriteMemory(op))
+    {
+      const std::optional<s32> size = GetStackStoreSize(op.inst);
+      if (size)
+      {
+        const s32 offset = op.inst.SIMM_16;
+        erase_slots_if([&](const StackSlot& slot) {
+          return slot.offset < offset + *size && offset < slot.offset + 4;
+        });
+      }
+      else
+      {
+        num_slots = 0;
+      }
+    }
+
+    // lswi and lswx write a run of registers starting at rD, but only rD is in regsOut, as the
+    // length of the run isn't known for lswx.
+    if (op.inst.OPCD == 31 && (op.inst.SUBOP10 == 533 || op.inst.SUBOP10 == 597))
+    {
+      known = BitSet32{};
+      num_slots = 0;
+    }
+
+    known &= ~op.regsOut;
+    if (result)
+    {
+      known[result->reg] = true;
+      values[result->reg] = result->value;
+    }
+
+    if (op.regsOut[1])
+      num_slots = 0;
+    else
+      erase_slots_if([&](const StackSlot& slot) { return op.regsOut[slot.reg]; });
+
+    if (op.inst.OPCD == 36 && op.inst.RA == 1)  // stw rS, d(r1)
+      add_slot(op.inst.SIMM_16, op.inst.RS);
+    else if (op.inst.OPCD == 32 && op.inst.RA == 1 && op.inst.RD != 1)  // lwz rD, d(r1)
+      add_slot(op.inst.SIMM_16, op.inst.RD);
+  }
+}
+
+void PPCAnalyzer::EliminateDeadCR0Updates(CodeBlock* block, CodeOp* code) const
+{
+  // Assume the next block (or any branch that can leave the block) wants CR0, to be safe.
+  bool cr0_live = true;
+  const auto ppc_mode = Core::System::GetInstance().GetPowerPC().GetMode();
+  for (int i = block->m_num_instructions - 1; i >= 0; i--)
+  {
+    CodeOp& op = code[i];
+    if (op.skip)
+      continue;
+
+    const bool may_exit_block = !!HLE::TryReplaceFunction(op.address, ppc_mode) ||
+                                op.canEndBlock || op.canCauseException ||
+                                CanCauseGatherPipeInterruptCheck(op);
+    if (may_exit_block)
+      cr0_live = true;
+
+    if (!cr0_live && op.inst.Rc && (op.opinfo->flags & FL_RC_BIT))
+    {
+      op.inst.Rc = 0;
+      op.crOut[0] = false;
+    }
+
+    if (op.crOut[0])
+      cr0_live = false;
+    if (op.crIn[0] || may_exit_block)
+      cr0_live = true;
+  }
+}
+
+void PPCAnalyzer::OptimizeBlock(CodeBlock* block, CodeOp* code) const
+{
+  PropagateValues(block, code);
+  EliminateDeadCR0Updates(block, code);
+}
+
 u32 PPCAnalyzer::Analyze(u32 address, CodeBlock* block, CodeBuffer* buffer,
                          std::size_t block_size) const
 {
@@ -810,6 +1152,7 @@ u32 PPCAnalyzer::Analyze(u32 address, CodeBlock* block, CodeBuffer* buffer,
   // Reset our block state
   block->m_broken = false;
   block->m_memory_exception = false;
+  block->m_branch_following_truncated = false;
   block->m_num_instructions = 0;
   block->m_gqr_used = BitSet8(0);
   block->m_physical_addresses.clear();
@@ -822,7 +1165,7 @@ u32 PPCAnalyzer::Analyze(u32 address, CodeBlock* block, CodeBuffer* buffer,
   u32 numFollows = 0;
   u32 num_inst = 0;
 
-  const bool enable_follow = m_enable_branch_following;
+  const bool enable_follow = m_enable_branch_following && !m_enable_quick_analysis;
 
   auto& mmu = Core::System::GetInstance().GetMMU();
   for (std::size_t i = 0; i < block_size; ++i)
@@ -884,7 +1227,11 @@ u32 PPCAnalyzer::Analyze(u32 address, CodeBlock* block, CodeBuffer* buffer,
       {
         code[i].branchTo = code[caller].address + 4;
         if ((inst.BO & BO_DONT_DECREMENT_FLAG) && (inst.BO & BO_DONT_CHECK_CONDITION) &&
-            numFollows < BRANCH_FOLLOWING_THRESHOLD)
+            numFollows >= m_branch_following_threshold)
+        {
+          block->m_branch_following_truncated = true;
+        }
+        else if ((inst.BO & BO_DONT_DECREMENT_FLAG) && (inst.BO & BO_DONT_CHECK_CONDITION))
         {
           // bclrx with unconditional branch = return
           // Follow it if we can propagate the LR value of the last CALL instruction.
@@ -942,9 +1289,10 @@ u32 PPCAnalyzer::Analyze(u32 address, CodeBlock* block, CodeBuffer* buffer,
     }
 
     code[i].branchIsIdleLoop =
-        code[i].branchTo == block->m_address && IsBusyWaitLoop(block, code, i);
+        (code[i].branchTo == block->m_address && IsBusyWaitLoop(block, code, i)) ||
+        (code[i].branchTo == block->m_address - 4 && IsPollingCallLoop(block, code, i));
 
-    if (follow && numFollows < BRANCH_FOLLOWING_THRESHOLD)
+    if (follow && numFollows < m_branch_following_threshold)
     {
       // Follow the unconditional branch.
       numFollows++;
@@ -952,6 +1300,9 @@ u32 PPCAnalyzer::Analyze(u32 address, CodeBlock* block, CodeBuffer* buffer,
     }
     else
     {
+      if (follow)
+        block->m_branch_following_truncated = true;
+
       // Just pick the next instruction
       address += 4;
       if (!conditional_continue && InstructionCanEndBlock(code[i]))  // right now we stop early
@@ -970,7 +1321,12 @@ u32 PPCAnalyzer::Analyze(u32 address, CodeBlock* block, CodeBuffer* buffer,
 
   block->m_num_instructions = num_inst;
 
-  if (block->m_num_instructions > 1)
+  // These optimizations are invisible to the guest, but not to someone stepping through the
+  // block in the debugger.
+  if (HasOption(OPTION_DATAFLOW) && !m_is_debugging_enabled && !m_enable_quick_analysis)
+    OptimizeBlock(block, code);
+
+  if (block->m_num_instructions > 1 && !m_enable_quick_analysis)
     ReorderInstructions(block->m_num_instructions, code);
 
   if ((!found_exit && num_inst > 0) || block_size == 1)
@@ -979,6 +1335,12 @@ u32 PPCAnalyzer::Analyze(u32 address, CodeBlock* block, CodeBuffer* buffer,
     block->m_broken = true;
   }
 
+  AnalyzeRegisterUsage(block, code);
+  return address;
+}
+
+void PPCAnalyzer::AnalyzeRegisterUsage(CodeBlock* block, CodeOp* code) const
+{
   // Scan for flag dependencies; assume the next block (or any branch that can leave the block)
   // wants flags, to be safe.
   bool wantsFPRF = true;
@@ -1017,14 +1379,21 @@ u32 PPCAnalyzer::Analyze(u32 address, CodeBlock* block, CodeBuffer* buffer,
     op.fprDiscardable = fprDiscardable;
     op.crDiscardable = crDiscardable;
     op.fprInXmm = fprInXmm;
-    gprBlockInputs &= ~op.regsOut;
-    gprBlockInputs |= op.regsIn;
-    gprInUse |= op.regsIn | op.regsOut;
-    fprInUse |= op.fregsIn | op.GetFregsOut();
-    crInUse |= op.crIn | op.crOut;
 
-    if (strncmp(op.opinfo->opname, "stfd", 4))
-      fprInXmm |= op.fregsIn;
+    // Skipped instructions don't get any code emitted, so they neither read nor write registers.
+    // In particular, a register written by a skipped instruction still holds the value it had
+    // before, so it must not become discardable.
+    if (!op.skip)
+    {
+      gprBlockInputs &= ~op.regsOut;
+      gprBlockInputs |= op.regsIn;
+      gprInUse |= op.regsIn | op.regsOut;
+      fprInUse |= op.fregsIn | op.GetFregsOut();
+      crInUse |= op.crIn | op.crOut;
+
+      if (strncmp(op.opinfo->opname, "stfd", 4))
+        fprInXmm |= op.fregsIn;
+    }
 
     if (hle)
     {
@@ -1042,7 +1411,7 @@ u32 PPCAnalyzer::Analyze(u32 address, CodeBlock* block, CodeBuffer* buffer,
       fprDiscardable = BitSet32{};
       crDiscardable = BitSet8{};
     }
-    else
+    else if (!op.skip)
     {
       gprDiscardable |= op.regsOut;
       gprDiscardable &= ~op.regsIn;
@@ -1148,7 +1517,6 @@ u32 PPCAnalyzer::Analyze(u32 address, CodeBlock* block, CodeBuffer* buffer,
   block->m_gqr_used = gqrUsed;
   block->m_gqr_modified = gqrModified;
   block->m_gpr_inputs = gprBlockInputs;
-  return address;
 }
 
 }  // namespace PPCAnalyst
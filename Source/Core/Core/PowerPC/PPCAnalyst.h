@@ -26,6 +26,13 @@ class CPUThreadGuard;
 
 namespace PPCAnalyst
 {
+// 0 does not perform block merging
+constexpr u32 BRANCH_FOLLOWING_THRESHOLD = 2;
+
+// Used for superblocks, which are only formed for blocks that have proven to be hot, so the cost
+// of the larger code size is paid off by keeping registers cached across the followed branches.
+constexpr u32 SUPERBLOCK_BRANCH_FOLLOWING_THRESHOLD = 8;
+
 struct CodeOp  // 16B
 {
   UGeckoInstruction inst;
@@ -120,6 +127,9 @@ struct CodeBlock
   // Did we have a memory_exception?
   bool m_memory_exception = false;
 
+  // Did branch following stop because the branch following threshold was reached?
+  bool m_branch_following_truncated = false;
+
   // Which GQRs this block uses, if any.
   BitSet8 m_gqr_used;
 
@@ -172,6 +182,10 @@ public:
 
     // Reorder cror instructions next to their associated fcmp.
     OPTION_CROR_MERGE = (1 << 6),
+
+    // Propagate constants and stack values through the block, and drop instructions and CR0
+    // updates whose results are never observed. See OptimizeBlock.
+    OPTION_DATAFLOW = (1 << 7),
   };
 
   // Option setting/getting
@@ -180,10 +194,27 @@ public:
   bool HasOption(AnalystOption option) const { return !!(m_options & option); }
   void SetDebuggingEnabled(bool enabled) { m_is_debugging_enabled = enabled; }
   void SetBranchFollowingEnabled(bool enabled) { m_enable_branch_following = enabled; }
+  void SetBranchFollowingThreshold(u32 threshold) { m_branch_following_threshold = threshold; }
+  // Skip branch following and instruction reordering, trading code quality for analysis speed.
+  void SetQuickAnalysisEnabled(bool enabled) { m_enable_quick_analysis = enabled; }
   void SetFloatExceptionsEnabled(bool enabled) { m_enable_float_exceptions = enabled; }
   void SetDivByZeroExceptionsEnabled(bool enabled) { m_enable_div_by_zero_exceptions = enabled; }
   u32 Analyze(u32 address, CodeBlock* block, CodeBuffer* buffer, std::size_t block_size) const;
 
+  void SetInstructionStats(CodeBlock* block, CodeOp* code, const GekkoOPInfo* opinfo) const;
+
+  // Optimizations over the straight-line code of an analyzed block, shared by all JITs:
+  // - Instructions which write a constant that the destination register is already known to hold
+  //   (or which don't change their destination at all) are marked as skipped.
+  // - Word loads from the stack frame that is still held in a GPR, because of an earlier load or
+  //   store of the same slot, are turned into register moves.
+  // - The Rc bit is cleared from instructions whose CR0 result is overwritten before being read.
+  void OptimizeBlock(CodeBlock* block, CodeOp* code) const;
+
+  // Computes which registers and flags each instruction of an analyzed block needs, and which of
+  // them are overwritten before being read again.
+  void AnalyzeRegisterUsage(CodeBlock* block, CodeOp* code) const;
+
 private:
   enum class ReorderType
   {
@@ -196,14 +227,18 @@ private:
   void ReorderInstructionsCore(u32 instructions, CodeOp* code, bool reverse,
                                ReorderType type) const;
   void ReorderInstructions(u32 instructions, CodeOp* code) const;
-  void SetInstructionStats(CodeBlock* block, CodeOp* code, const GekkoOPInfo* opinfo) const;
+  void PropagateValues(CodeBlock* block, CodeOp* code) const;
+  void EliminateDeadCR0Updates(CodeBlock* block, CodeOp* code) const;
   bool IsBusyWaitLoop(CodeBlock* block, CodeOp* code, size_t instructions) const;
+  bool IsPollingCallLoop(CodeBlock* block, CodeOp* code, size_t instructions) const;
 
   // Options
   u32 m_options = 0;
 
   bool m_is_debugging_enabled = false;
   bool m_enable_branch_following = false;
+  u32 m_branch_following_threshold = BRANCH_FOLLOWING_THRESHOLD;
+  bool m_enable_quick_analysis = false;
   bool m_enable_float_exceptions = false;
   bool m_enable_div_by_zero_exceptions = false;
 };
@@ -4,6 +4,7 @@
 #include "Core/PowerPC/PowerPC.h"
 
 #include <algorithm>
+#include <array>
 #include <cstring>
 #include <istream>
 #include <ostream>
@@ -85,12 +86,23 @@ std::ostream& operator<<(std::ostream& os, CPUCore core)
 }
 
 PowerPCManager::PowerPCManager(Core::System& system)
-    : m_breakpoints(system), m_memchecks(system), m_debug_interface(system), m_system(system)
+    : m_breakpoints(system), m_memchecks(system), m_debug_interface(system),
+      m_sampling_profiler(system), m_system(system)
 {
 }
 
 PowerPCManager::~PowerPCManager() = default;
 
+// Whether the registers the BAT tables are built from are the same.
+static bool AreBATRegistersEqual(const std::array<u32, 1024>& a, const u32 (&b)[1024])
+{
+  const auto equal = [&](u32 first, u32 last) {
+    return std::equal(a.begin() + first, a.begin() + last + 1, b + first);
+  };
+  return equal(SPR_IBAT0U, SPR_DBAT3L) && equal(SPR_IBAT4U, SPR_DBAT7L) &&
+         a[SPR_HID4] == b[SPR_HID4];
+}
+
 void PowerPCManager::DoState(PointerWrap& p)
 {
   // some of this code has been disabled, because
@@ -116,6 +128,7 @@ void PowerPCManager::DoState(PointerWrap& p)
   p.Do(m_ppc_state.xer_stringctrl);
   p.DoArray(m_ppc_state.ps);
   p.DoArray(m_ppc_state.sr);
+  const auto old_spr = std::to_array(m_ppc_state.spr);
   p.DoArray(m_ppc_state.spr);
   p.DoArray(m_ppc_state.tlb);
   p.Do(m_ppc_state.pagetable_base);
@@ -138,9 +151,15 @@ void PowerPCManager::DoState(PointerWrap& p)
     RoundingModeUpdated(m_ppc_state);
     RecalculateAllFeatureFlags(m_ppc_state);
 
+    // Updating the BATs clears the JIT's block cache, which rollback loads keep.
     auto& mmu = m_system.GetMMU();
-    mmu.IBATUpdated();
-    mmu.DBATUpdated();
+    if (!m_system.GetJitInterface().IsKeepingCacheOnStateLoad() ||
+        !AreBATRegistersEqual(old_spr, m_ppc_state.spr))
+    {
+      mmu.IBATUpdated();
+      mmu.DBATUpdated();
+    }
+    mmu.ClearPageTableCaches();
   }
 
   // SystemTimers::DecrementerSet();
@@ -237,6 +256,7 @@ void PowerPCManager::InitializeCPUCore(CPUCore cpu_core)
   }
 
   m_mode = m_cpu_core_base == &interpreter ? CoreMode::Interpreter : CoreMode::JIT;
+  m_system.GetJitInterface().UpdateMembase();
 }
 
 std::span<const CPUCore> AvailableCPUCores()
@@ -303,6 +323,10 @@ void PowerPCManager::Reset()
   m_ppc_state.pagetable_hashmask = 0;
   m_ppc_state.tlb = {};
 
+  auto& mmu = m_system.GetMMU();
+  mmu.ClearPageTableCaches();
+  mmu.ResetTLBStats();
+
   ResetRegisters();
   m_ppc_state.iCache.Reset();
   m_ppc_state.dCache.Reset();
@@ -326,6 +350,7 @@ void PowerPCManager::ScheduleInvalidateCacheThreadSafe(u32 address)
 void PowerPCManager::Shutdown()
 {
   CPUThreadConfigCallback::RemoveConfigChangedCallback(m_registered_config_callback_id);
+  m_sampling_profiler.Stop();
   InjectExternalCPUCore(nullptr);
   m_system.GetJitInterface().Shutdown();
   m_system.GetInterpreter().Shutdown();
@@ -16,6 +16,7 @@
 #include "Core/CPUThreadConfigCallback.h"
 #include "Core/Debugger/BranchWatch.h"
 #include "Core/Debugger/PPCDebugInterface.h"
+#include "Core/Debugger/SamplingProfiler.h"
 #include "Core/PowerPC/BreakPoints.h"
 #include "Core/PowerPC/ConditionRegister.h"
 #include "Core/PowerPC/Gekko.h"
@@ -72,6 +73,29 @@ struct TLBEntry
   void Invalidate() { tag.fill(INVALID_TAG); }
 };
 
+// Software TLB, a direct-mapped cache of page table translations which lead straight to host RAM.
+// It isn't part of the emulated hardware: the JIT looks guest addresses up in it inline before
+// falling back to MMU::TranslateAddress. Entries are tagged with the raw segment register value, so
+// segment register writes don't need to invalidate anything.
+constexpr size_t SOFTWARE_TLB_SIZE = 256;
+
+struct SoftwareTLB
+{
+  static constexpr u32 INVALID_PAGE = 0xffffffff;
+
+  std::array<u32, SOFTWARE_TLB_SIZE> page;
+  std::array<u32, SOFTWARE_TLB_SIZE> sr;
+  std::array<u8*, SOFTWARE_TLB_SIZE> host_page;
+
+  SoftwareTLB() { Invalidate(); }
+  void Invalidate()
+  {
+    page.fill(INVALID_PAGE);
+    sr.fill(0);
+    host_page.fill(nullptr);
+  }
+};
+
 struct PairedSingle
 {
   u64 PS0AsU64() const { return ps0; }
@@ -181,6 +205,12 @@ struct PowerPCState
 
   std::array<std::array<TLBEntry, TLB_SIZE / TLB_WAYS>, NUM_TLBS> tlb;
 
+  // Not saved in savestates, since it's rebuilt on demand from the page table.
+  SoftwareTLB software_tlb_read;
+  SoftwareTLB software_tlb_write;
+  // Counted by the JIT code itself, since hits never reach the MMU.
+  u64 software_tlb_hits = 0;
+
   u32 pagetable_base = 0;
   u32 pagetable_hashmask = 0;
 
@@ -301,6 +331,8 @@ public:
   const PPCDebugInterface& GetDebugInterface() const { return m_debug_interface; }
   Core::BranchWatch& GetBranchWatch() { return m_branch_watch; }
   const Core::BranchWatch& GetBranchWatch() const { return m_branch_watch; }
+  Core::SamplingProfiler& GetSamplingProfiler() { return m_sampling_profiler; }
+  const Core::SamplingProfiler& GetSamplingProfiler() const { return m_sampling_profiler; }
 
 private:
   void InitializeCPUCore(CPUCore cpu_core);
@@ -318,6 +350,7 @@ private:
   MemChecks m_memchecks;
   PPCDebugInterface m_debug_interface;
   Core::BranchWatch m_branch_watch;
+  Core::SamplingProfiler m_sampling_profiler;
 
   CPUThreadConfigCallback::ConfigChangedCallbackID m_registered_config_callback_id;
 
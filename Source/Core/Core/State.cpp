@@ -6,6 +6,7 @@
 #include <algorithm>
 #include <atomic>
 #include <condition_variable>
+#include <cstring>
 #include <filesystem>
 #include <locale>
 #include <map>
@@ -46,6 +47,7 @@
 #include "Core/Host.h"
 #include "Core/Movie.h"
 #include "Core/NetPlayClient.h"
+#include "Core/PowerPC/JitInterface.h"
 #include "Core/PowerPC/PowerPC.h"
 #include "Core/System.h"
 
@@ -78,6 +80,8 @@ static std::mutex s_load_or_save_in_progress_mutex;
 struct CompressAndDumpState_args
 {
   std::vector<u8> buffer_vector;
+  // Guest memory left out of buffer_vector, see Memory::MemoryManager::RequestSnapshot.
+  std::vector<Memory::SnapshotHole> memory_snapshot_holes;
   std::string filename;
   std::shared_ptr<Common::Event> state_write_done_event;
 };
@@ -227,6 +231,51 @@ void LoadFromBuffer(std::vector<u8>& buffer)
       true);
 }
 
+void SaveToBufferForNetPlayRollback(std::vector<u8>& buffer, Memory::StateMemoryBuffer& memory)
+{
+  Core::RunOnCPUThread(
+      [&] {
+        auto& system_memory = Core::System::GetInstance().GetMemory();
+        system_memory.SetStateMemoryBuffer(&memory);
+
+        u8* ptr = nullptr;
+        PointerWrap p_measure(&ptr, 0, PointerWrap::Mode::Measure);
+        DoState(p_measure);
+        const size_t buffer_size = reinterpret_cast<size_t>(ptr);
+        buffer.resize(buffer_size);
+
+        ptr = buffer.data();
+        PointerWrap p(&ptr, buffer_size, PointerWrap::Mode::Write);
+        DoState(p);
+
+        system_memory.SetStateMemoryBuffer(nullptr);
+      },
+      true);
+}
+
+void LoadFromBufferForNetPlayRollback(std::vector<u8>& buffer, Memory::StateMemoryBuffer& memory)
+{
+  Core::RunOnCPUThread(
+      [&] {
+        auto& system = Core::System::GetInstance();
+        auto& jit_interface = system.GetJitInterface();
+        system.GetMemory().SetStateMemoryBuffer(&memory);
+        jit_interface.SetKeepCacheOnStateLoad(true);
+
+        u8* ptr = buffer.data();
+        PointerWrap p(&ptr, buffer.size(), PointerWrap::Mode::Read);
+        DoState(p);
+
+        jit_interface.SetKeepCacheOnStateLoad(false);
+        system.GetMemory().SetStateMemoryBuffer(nullptr);
+
+        // Guest code doesn't change, except for whatever the state just restored.
+        for (const Memory::WrittenRange& range : memory.restored_ranges)
+          jit_interface.ErasePhysicalRange(range.physical_address, range.size);
+      },
+      true);
+}
+
 void SaveToBuffer(std::vector<u8>& buffer)
 {
   Core::RunOnCPUThread(
@@ -382,8 +431,42 @@ static void WriteHeadersToFile(size_t uncompressed_size, File::IOFile& f)
   // If StateExtendedHeader is amended to include more than the base, add WriteBytes() calls here.
 }
 
+static void FillMemorySnapshotHoles(CompressAndDumpState_args& save_args)
+{
+  if (save_args.memory_snapshot_holes.empty())
+    return;
+
+  auto& memory = Core::System::GetInstance().GetMemory();
+  const std::vector<u8>& partial = save_args.buffer_vector;
+
+  size_t full_size = partial.size();
+  for (const Memory::SnapshotHole& hole : save_args.memory_snapshot_holes)
+    full_size += hole.size;
+
+  std::vector<u8> full(full_size);
+  size_t partial_offset = 0;
+  u8* dest = full.data();
+  for (const Memory::SnapshotHole& hole : save_args.memory_snapshot_holes)
+  {
+    const size_t copy_size = hole.offset - partial_offset;
+    std::memcpy(dest, partial.data() + partial_offset, copy_size);
+    dest += copy_size;
+    partial_offset = hole.offset;
+
+    memory.ReadSnapshot(dest, hole.shm_position, hole.size);
+    dest += hole.size;
+  }
+  std::memcpy(dest, partial.data() + partial_offset, partial.size() - partial_offset);
+  memory.EndSnapshot();
+
+  save_args.buffer_vector = std::move(full);
+  save_args.memory_snapshot_holes.clear();
+}
+
 static void CompressAndDumpState(CompressAndDumpState_args& save_args)
 {
+  FillMemorySnapshotHoles(save_args);
+
   const u8* const buffer_data = save_args.buffer_vector.data();
   const size_t buffer_size = save_args.buffer_vector.size();
   const std::string& filename = save_args.filename;
@@ -470,11 +553,18 @@ void SaveAs(const std::string& filename, bool wait)
           ++s_state_writes_in_queue;
         }
 
+        // Guest memory is copied by the worker thread when possible, so emulation can resume
+        // without waiting for it.
+        auto& memory = Core::System::GetInstance().GetMemory();
+        const bool snapshot = memory.RequestSnapshot();
+
         // Measure the size of the buffer.
         u8* ptr = nullptr;
         PointerWrap p_measure(&ptr, 0, PointerWrap::Mode::Measure);
         DoState(p_measure);
-        const size_t buffer_size = reinterpret_cast<size_t>(ptr);
+        size_t buffer_size = reinterpret_cast<size_t>(ptr);
+        if (snapshot)
+          buffer_size -= memory.GetSnapshotSize();
 
         // Then actually do the write.
         std::vector<u8> current_buffer;
@@ -482,6 +572,8 @@ void SaveAs(const std::string& filename, bool wait)
         ptr = current_buffer.data();
         PointerWrap p(&ptr, buffer_size, PointerWrap::Mode::Write);
         DoState(p);
+        std::vector<Memory::SnapshotHole> snapshot_holes =
+            memory.TakeSnapshotHoles(current_buffer.data());
 
         if (p.IsWriteMode())
         {
@@ -491,6 +583,7 @@ void SaveAs(const std::string& filename, bool wait)
 
           CompressAndDumpState_args save_args;
           save_args.buffer_vector = std::move(current_buffer);
+          save_args.memory_snapshot_holes = std::move(snapshot_holes);
           save_args.filename = filename;
           if (wait)
           {
@@ -506,6 +599,7 @@ void SaveAs(const std::string& filename, bool wait)
         else
         {
           // someone aborted the save by changing the mode?
+          memory.EndSnapshot();
           {
             // Note: The worker thread takes care of this in the other branch.
             std::lock_guard lk_(s_state_writes_in_queue_mutex);
@@ -13,6 +13,11 @@
 
 #include "Common/CommonTypes.h"
 
+namespace Memory
+{
+struct StateMemoryBuffer;
+}
+
 namespace State
 {
 // number of states
@@ -103,6 +108,12 @@ void LoadAs(const std::string& filename);
 
 void SaveToBuffer(std::vector<u8>& buffer);
 void LoadFromBuffer(std::vector<u8>& buffer);
+// Unlike LoadFromBuffer, this is allowed during netplay. Only meant for the rollback network mode,
+// where each client saves and restores its own snapshots to correct mispredicted inputs. Guest
+// memory is kept apart, so that reusing the buffers of old snapshots only copies the pages written
+// since, and loading keeps the JIT's code cache.
+void SaveToBufferForNetPlayRollback(std::vector<u8>& buffer, Memory::StateMemoryBuffer& memory);
+void LoadFromBufferForNetPlayRollback(std::vector<u8>& buffer, Memory::StateMemoryBuffer& memory);
 
 void LoadLastSaved(int i = 1);
 void SaveFirstSaved();
@@ -0,0 +1,192 @@
+// Copyright 2024 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "DolphinNoGUI/Benchmark.h"
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+#include <picojson.h>
+
+#include "Common/Thread.h"
+#include "Core/Config/GraphicsSettings.h"
+#include "Core/Config/MainSettings.h"
+#include "Core/System.h"
+#include "VideoCommon/Statistics.h"
+#include "VideoCommon/VideoEvents.h"
+
+static double ToMilliseconds(std::chrono::nanoseconds duration)
+{
+  return std::chrono::duration<double, std::milli>(duration).count();
+}
+
+Benchmark::Benchmark(u32 warmup_frames, u32 frames, std::function<void()> on_finished)
+    : m_warmup_frames(warmup_frames), m_frames(std::max<u32>(frames, 1)),
+      m_on_finished(std::move(on_finished))
+{
+}
+
+Benchmark::~Benchmark() = default;
+
+void Benchmark::Start()
+{
+  // Only for this session, so that the user's settings aren't overwritten.
+  Config::SetCurrent(Config::MAIN_EMULATION_SPEED, 0.0f);
+  Config::SetCurrent(Config::GFX_VSYNC, false);
+
+  m_frame_times.reserve(m_frames);
+  m_frame_end_hook = VIEndFieldEvent::Register([this] { OnFrameEnd(); }, "Benchmark");
+  m_present_hook = AfterPresentEvent::Register([this](PresentInfo&) { OnPresent(); }, "Benchmark");
+}
+
+void Benchmark::OnFrameEnd()
+{
+  if (m_finished.IsSet())
+    return;
+
+  const Clock::time_point now = Clock::now();
+  if (m_frame_count == m_warmup_frames)
+  {
+    auto& system = Core::System::GetInstance();
+    m_dual_core = system.IsDualCoreMode();
+    m_jit_start_stats = system.GetJitInterface().GetCompileStats();
+    m_cpu_thread_start_time = Common::GetCurrentThreadCPUTime();
+    m_start_time = now;
+    m_measuring.Set();
+  }
+  else if (m_frame_count > m_warmup_frames)
+  {
+    m_frame_times.push_back(now - m_last_frame_time);
+  }
+
+  m_last_frame_time = now;
+  ++m_frame_count;
+
+  if (m_frame_count <= m_warmup_frames + m_frames)
+    return;
+
+  m_cpu_thread_time = Common::GetCurrentThreadCPUTime() - m_cpu_thread_start_time;
+  m_jit_end_stats = Core::System::GetInstance().GetJitInterface().GetCompileStats();
+  m_measuring.Clear();
+  m_finished.Set();
+
+  if (m_on_finished)
+    m_on_finished();
+}
+
+void Benchmark::OnPresent()
+{
+  if (!m_measuring.IsSet())
+    return;
+
+  GPUSample sample;
+  sample.time = Clock::now();
+  sample.thread_time = Common::GetCurrentThreadCPUTime();
+  sample.pixel_shaders_created = g_stats.num_pixel_shaders_created;
+  sample.vertex_shaders_created = g_stats.num_vertex_shaders_created;
+  sample.textures_created = g_stats.num_textures_created;
+  sample.textures_uploaded = g_stats.num_textures_uploaded;
+  sample.textures_alive = g_stats.num_textures_alive;
+
+  std::lock_guard lk(m_gpu_lock);
+  if (!m_gpu_first_sample)
+    m_gpu_first_sample = sample;
+  m_gpu_last_sample = sample;
+  ++m_presents;
+}
+
+std::string Benchmark::GetReport() const
+{
+  picojson::object report;
+  report["completed"] = picojson::value(m_finished.IsSet());
+  report["warmup_frames"] = picojson::value(static_cast<double>(m_warmup_frames));
+  report["frames"] = picojson::value(static_cast<double>(m_frame_times.size()));
+  report["dual_core"] = picojson::value(m_dual_core);
+
+  const std::chrono::nanoseconds duration = m_last_frame_time - m_start_time;
+  report["duration_ms"] = picojson::value(ToMilliseconds(duration));
+  if (duration.count() > 0)
+  {
+    report["fps"] = picojson::value(static_cast<double>(m_frame_times.size()) /
+                                    std::chrono::duration<double>(duration).count());
+  }
+
+  if (!m_frame_times.empty())
+  {
+    std::vector<Clock::duration> sorted = m_frame_times;
+    std::sort(sorted.begin(), sorted.end());
+
+    // Nearest-rank percentiles.
+    const auto percentile = [&sorted](double p) {
+      const size_t rank = static_cast<size_t>(std::ceil(p / 100.0 * sorted.size()));
+      const size_t index = std::clamp<size_t>(rank, 1, sorted.size()) - 1;
+      return picojson::value(ToMilliseconds(sorted[index]));
+    };
+
+    picojson::object frame_time;
+    frame_time["mean"] = picojson::value(ToMilliseconds(duration) / sorted.size());
+    frame_time["min"] = picojson::value(ToMilliseconds(sorted.front()));
+    frame_time["p50"] = percentile(50);
+    frame_time["p90"] = percentile(90);
+    frame_time["p95"] = percentile(95);
+    frame_time["p99"] = percentile(99);
+    frame_time["max"] = picojson::value(ToMilliseconds(sorted.back()));
+    report["frame_time_ms"] = picojson::value(std::move(frame_time));
+  }
+
+  const auto thread_report = [](std::chrono::nanoseconds busy, std::chrono::nanoseconds wall) {
+    picojson::object thread;
+    thread["busy_ms"] = picojson::value(ToMilliseconds(busy));
+    if (wall.count() > 0)
+    {
+      thread["busy_fraction"] =
+          picojson::value(static_cast<double>(busy.count()) / static_cast<double>(wall.count()));
+    }
+    return picojson::value(std::move(thread));
+  };
+  if (m_finished.IsSet())
+    report["cpu_thread"] = thread_report(m_cpu_thread_time, duration);
+
+  if (m_jit_start_stats && m_jit_end_stats)
+  {
+    picojson::object jit;
+    jit["blocks_compiled"] = picojson::value(
+        static_cast<double>(m_jit_end_stats->blocks_compiled - m_jit_start_stats->blocks_compiled));
+    jit["compile_time_ms"] = picojson::value(
+        ToMilliseconds(m_jit_end_stats->compile_time - m_jit_start_stats->compile_time));
+    report["jit"] = picojson::value(std::move(jit));
+  }
+
+  std::lock_guard lk(m_gpu_lock);
+  report["presents"] = picojson::value(static_cast<double>(m_presents));
+  if (m_gpu_first_sample && m_gpu_last_sample)
+  {
+    const GPUSample& first = *m_gpu_first_sample;
+    const GPUSample& last = *m_gpu_last_sample;
+
+    // In single core mode, the GPU thread is the CPU thread.
+    if (m_dual_core)
+    {
+      report["gpu_thread"] =
+          thread_report(last.thread_time - first.thread_time, last.time - first.time);
+    }
+
+    picojson::object shaders;
+    shaders["pixel_shaders_compiled"] = picojson::value(
+        static_cast<double>(last.pixel_shaders_created - first.pixel_shaders_created));
+    shaders["vertex_shaders_compiled"] = picojson::value(
+        static_cast<double>(last.vertex_shaders_created - first.vertex_shaders_created));
+    report["shaders"] = picojson::value(std::move(shaders));
+
+    picojson::object textures;
+    textures["created"] =
+        picojson::value(static_cast<double>(last.textures_created - first.textures_created));
+    textures["uploaded"] =
+        picojson::value(static_cast<double>(last.textures_uploaded - first.textures_uploaded));
+    textures["alive"] = picojson::value(static_cast<double>(last.textures_alive));
+    report["texture_cache"] = picojson::value(std::move(textures));
+  }
+
+  return picojson::value(std::move(report)).serialize(true);
+}
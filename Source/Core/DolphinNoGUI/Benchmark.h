@@ -0,0 +1,81 @@
+// Copyright 2024 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <chrono>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "Common/CommonTypes.h"
+#include "Common/Flag.h"
+#include "Common/HookableEvent.h"
+#include "Core/PowerPC/JitInterface.h"
+
+// Runs the emulation unthrottled for a fixed number of frames, and reports performance statistics
+// as JSON. Frames are counted in VI fields, so the workload only depends on the booted game and the
+// movie being played back (if any), not on how fast the host is.
+class Benchmark final
+{
+public:
+  Benchmark(u32 warmup_frames, u32 frames, std::function<void()> on_finished);
+  ~Benchmark();
+
+  Benchmark(const Benchmark&) = delete;
+  Benchmark& operator=(const Benchmark&) = delete;
+
+  // Must be called before booting.
+  void Start();
+  bool IsFinished() const { return m_finished.IsSet(); }
+
+  // Must be called after emulation has stopped.
+  std::string GetReport() const;
+
+private:
+  using Clock = std::chrono::steady_clock;
+
+  struct GPUSample
+  {
+    Clock::time_point time;
+    std::chrono::nanoseconds thread_time{};
+    int pixel_shaders_created = 0;
+    int vertex_shaders_created = 0;
+    int textures_created = 0;
+    int textures_uploaded = 0;
+    int textures_alive = 0;
+  };
+
+  // Called from the CPU thread.
+  void OnFrameEnd();
+  // Called from the GPU thread.
+  void OnPresent();
+
+  const u32 m_warmup_frames;
+  const u32 m_frames;
+  std::function<void()> m_on_finished;
+
+  Common::EventHook m_frame_end_hook;
+  Common::EventHook m_present_hook;
+
+  Common::Flag m_measuring;
+  Common::Flag m_finished;
+
+  // Only accessed from the CPU thread while emulation is running.
+  u32 m_frame_count = 0;
+  bool m_dual_core = false;
+  Clock::time_point m_start_time;
+  Clock::time_point m_last_frame_time;
+  std::vector<Clock::duration> m_frame_times;
+  std::chrono::nanoseconds m_cpu_thread_start_time{};
+  std::chrono::nanoseconds m_cpu_thread_time{};
+  std::optional<JitInterface::CompileStats> m_jit_start_stats;
+  std::optional<JitInterface::CompileStats> m_jit_end_stats;
+
+  mutable std::mutex m_gpu_lock;
+  std::optional<GPUSample> m_gpu_first_sample;
+  std::optional<GPUSample> m_gpu_last_sample;
+  u64 m_presents = 0;
+};
@@ -7,6 +7,8 @@
 #include <cstddef>
 #include <cstdio>
 #include <cstring>
+#include <memory>
+#include <optional>
 #include <signal.h>
 #include <string>
 #include <vector>
@@ -17,6 +19,7 @@
 #include <Windows.h>
 #endif
 
+#include "Common/FileUtil.h"
 #include "Common/ScopeGuard.h"
 #include "Common/StringUtil.h"
 #include "Core/Boot/Boot.h"
@@ -24,6 +27,9 @@
 #include "Core/Core.h"
 #include "Core/DolphinAnalytics.h"
 #include "Core/Host.h"
+#include "Core/Movie.h"
+#include "Core/System.h"
+#include "DolphinNoGUI/Benchmark.h"
 
 #include "UICommon/CommandLineParse.h"
 #ifdef USE_DISCORD_PRESENCE
@@ -179,6 +185,24 @@ static std::unique_ptr<Platform> GetPlatform(const optparse::Values& options)
   return nullptr;
 }
 
+static bool WriteBenchmarkReport(const Benchmark& benchmark, const optparse::Values& options)
+{
+  const std::string report = benchmark.GetReport() + '\n';
+  if (!options.is_set("benchmark_output"))
+  {
+    std::fputs(report.c_str(), stdout);
+    return true;
+  }
+
+  const std::string path = static_cast<const char*>(options.get("benchmark_output"));
+  if (!File::WriteStringToFile(path, report))
+  {
+    fprintf(stderr, "Failed to write the benchmark report to %s\n", path.c_str());
+    return false;
+  }
+  return true;
+}
+
 #ifdef _WIN32
 #define main app_main
 #endif
@@ -210,6 +234,21 @@ int main(int argc, char* argv[])
             "macos"
 #endif
       });
+  parser->add_option("--benchmark")
+      .action("store")
+      .type("int")
+      .metavar("<frames>")
+      .help("Run the given number of frames as fast as possible, then exit and print a "
+            "performance report in JSON");
+  parser->add_option("--benchmark_warmup")
+      .action("store")
+      .type("int")
+      .metavar("<frames>")
+      .help("Number of frames to run before the benchmark starts measuring");
+  parser->add_option("--benchmark_output")
+      .action("store")
+      .metavar("<file>")
+      .help("Write the benchmark report to a file instead of stdout");
 
   optparse::Values& options = CommandLineParse::ParseArguments(parser.get(), argc, argv);
   std::vector<std::string> args = parser->args();
@@ -304,6 +343,33 @@ int main(int argc, char* argv[])
 
   DolphinAnalytics::Instance().ReportDolphinStart("nogui");
 
+  if (options.is_set("movie"))
+  {
+    std::optional<std::string> savestate_path;
+    if (Core::System::GetInstance().GetMovie().PlayInput(
+            static_cast<const char*>(options.get("movie")), &savestate_path))
+    {
+      boot->boot_session_data.SetSavestateData(std::move(savestate_path),
+                                               DeleteSavestateAfterBoot::No);
+    }
+  }
+
+  std::unique_ptr<Benchmark> benchmark;
+  if (options.is_set("benchmark"))
+  {
+    const int frames = static_cast<int>(options.get("benchmark"));
+    const int warmup_frames =
+        options.is_set("benchmark_warmup") ? static_cast<int>(options.get("benchmark_warmup")) : 0;
+    if (frames <= 0 || warmup_frames < 0)
+    {
+      fprintf(stderr, "Invalid number of benchmark frames\n");
+      return 1;
+    }
+
+    benchmark = std::make_unique<Benchmark>(warmup_frames, frames, [] { s_platform->Stop(); });
+    benchmark->Start();
+  }
+
   if (!BootManager::BootCore(std::move(boot), wsi))
   {
     fprintf(stderr, "Could not boot the specified file\n");
@@ -318,9 +384,13 @@ int main(int argc, char* argv[])
   Core::Stop();
 
   Core::Shutdown();
+
+  if (benchmark && !WriteBenchmarkReport(*benchmark, options))
+    return 1;
+
   s_platform.reset();
 
-  return 0;
+  return benchmark && !benchmark->IsFinished() ? 1 : 0;
 }
 
 #ifdef _WIN32
@@ -164,12 +164,22 @@ void AdvancedWidget::CreateWidgets()
       // i18n: VS is short for vertex shaders.
       tr("Prefer VS for Point/Line Expansion"), Config::GFX_PREFER_VS_FOR_LINE_POINT_EXPANSION);
   m_cpu_cull = new ConfigBool(tr("Cull Vertices on the CPU"), Config::GFX_CPU_CULL);
+  m_display_list_cache =
+      new ConfigBool(tr("Cache Display Lists"), Config::GFX_DISPLAY_LIST_CACHE);
+  m_texture_deduplication =
+      new ConfigBool(tr("Deduplicate Textures"), Config::GFX_TEXTURE_DEDUPLICATION);
+  m_parallel_texture_decoding =
+      new ConfigBool(tr("Decode Textures on Multiple Threads"),
+                     Config::GFX_PARALLEL_TEXTURE_DECODING);
 
   misc_layout->addWidget(m_enable_cropping, 0, 0);
   misc_layout->addWidget(m_enable_prog_scan, 0, 1);
   misc_layout->addWidget(m_backend_multithreading, 1, 0);
   misc_layout->addWidget(m_prefer_vs_for_point_line_expansion, 1, 1);
   misc_layout->addWidget(m_cpu_cull, 2, 0);
+  misc_layout->addWidget(m_display_list_cache, 3, 0);
+  misc_layout->addWidget(m_texture_deduplication, 3, 1);
+  misc_layout->addWidget(m_parallel_texture_decoding, 4, 0);
 #ifdef _WIN32
   m_borderless_fullscreen =
       new ConfigBool(tr("Borderless Fullscreen"), Config::GFX_BORDERLESS_FULLSCREEN);
@@ -380,6 +390,26 @@ void AdvancedWidget::AddDescriptions()
       QT_TR_NOOP("Cull vertices on the CPU to reduce the number of draw calls required.  "
                  "May affect performance and draw statistics.<br><br>"
                  "<dolphin_emphasis>If unsure, leave this unchecked.</dolphin_emphasis>");
+  static const char TR_DISPLAY_LIST_CACHE_DESCRIPTION[] =
+      QT_TR_NOOP("Remembers the primitives and decoded vertices of display lists that are called "
+                 "repeatedly, so that they don't need to be parsed and loaded again. Display "
+                 "lists are checked for changes on every call.<br><br>May improve performance "
+                 "in games that reuse display lists, at the cost of some memory.<br><br>"
+                 "<dolphin_emphasis>If unsure, leave this unchecked.</dolphin_emphasis>");
+  static const char TR_TEXTURE_DEDUPLICATION_DESCRIPTION[] =
+      QT_TR_NOOP("Lets textures with identical contents at different addresses share a single "
+                 "decoded texture, even when the texture cache accuracy only samples textures "
+                 "for hashing. Their whole contents are hashed to confirm that they match.<br><br>"
+                 "May reduce stuttering and VRAM usage in games that load the same textures to "
+                 "several addresses.<br><br>"
+                 "<dolphin_emphasis>If unsure, leave this unchecked.</dolphin_emphasis>");
+  static const char TR_PARALLEL_TEXTURE_DECODING_DESCRIPTION[] =
+      QT_TR_NOOP("Splits the decoding of large textures and their mipmaps across several CPU "
+                 "threads. Textures are still fully decoded before they are used, so this does "
+                 "not affect what is rendered.<br><br>Has no effect on textures which are decoded "
+                 "on the GPU.<br><br>May reduce stuttering when games load large textures on "
+                 "CPUs with many cores.<br><br>"
+                 "<dolphin_emphasis>If unsure, leave this unchecked.</dolphin_emphasis>");
   static const char TR_DEFER_EFB_ACCESS_INVALIDATION_DESCRIPTION[] = QT_TR_NOOP(
       "Defers invalidation of the EFB access cache until a GPU synchronization command "
       "is executed. If disabled, the cache will be invalidated with every draw call. "
@@ -453,6 +483,9 @@ void AdvancedWidget::AddDescriptions()
   m_prefer_vs_for_point_line_expansion->SetDescription(
       tr(TR_PREFER_VS_FOR_POINT_LINE_EXPANSION_DESCRIPTION).arg(vsexpand_extra));
   m_cpu_cull->SetDescription(tr(TR_CPU_CULL_DESCRIPTION));
+  m_display_list_cache->SetDescription(tr(TR_DISPLAY_LIST_CACHE_DESCRIPTION));
+  m_texture_deduplication->SetDescription(tr(TR_TEXTURE_DEDUPLICATION_DESCRIPTION));
+  m_parallel_texture_decoding->SetDescription(tr(TR_PARALLEL_TEXTURE_DECODING_DESCRIPTION));
 #ifdef _WIN32
   m_borderless_fullscreen->SetDescription(tr(TR_BORDERLESS_FULLSCREEN_DESCRIPTION));
 #endif
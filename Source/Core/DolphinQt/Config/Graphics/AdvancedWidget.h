@@ -70,6 +70,9 @@ private:
   ConfigBool* m_backend_multithreading;
   ConfigBool* m_prefer_vs_for_point_line_expansion;
   ConfigBool* m_cpu_cull;
+  ConfigBool* m_display_list_cache;
+  ConfigBool* m_texture_deduplication;
+  ConfigBool* m_parallel_texture_decoding;
   ConfigBool* m_borderless_fullscreen;
 
   // Experimental
@@ -53,11 +53,14 @@ void HacksWidget::CreateWidgets()
       new ConfigBool(tr("Store EFB Copies to Texture Only"), Config::GFX_HACK_SKIP_EFB_COPY_TO_RAM);
   m_defer_efb_copies =
       new ConfigBool(tr("Defer EFB Copies to RAM"), Config::GFX_HACK_DEFER_EFB_COPIES);
+  m_lazy_efb_copies =
+      new ConfigBool(tr("Write EFB Copies on CPU Access"), Config::GFX_HACK_LAZY_EFB_COPIES);
 
   efb_layout->addWidget(m_skip_efb_cpu, 0, 0);
   efb_layout->addWidget(m_ignore_format_changes, 0, 1);
   efb_layout->addWidget(m_store_efb_copies, 1, 0);
   efb_layout->addWidget(m_defer_efb_copies, 1, 1);
+  efb_layout->addWidget(m_lazy_efb_copies, 2, 0);
 
   // Texture Cache
   auto* texture_cache_box = new QGroupBox(tr("Texture Cache"));
@@ -152,6 +155,8 @@ void HacksWidget::ConnectWidgets()
           [this](int) { UpdateDeferEFBCopiesEnabled(); });
   connect(m_store_xfb_copies, &QCheckBox::stateChanged,
           [this](int) { UpdateDeferEFBCopiesEnabled(); });
+  connect(m_defer_efb_copies, &QCheckBox::stateChanged,
+          [this](int) { UpdateDeferEFBCopiesEnabled(); });
   connect(m_immediate_xfb, &QCheckBox::stateChanged,
           [this](int) { UpdateSkipPresentingDuplicateFramesEnabled(); });
   connect(m_vi_skip, &QCheckBox::stateChanged,
@@ -242,6 +247,13 @@ void HacksWidget::AddDescriptions()
       "many games, at the risk of breaking those which do not safely synchronize with the "
       "emulated GPU.<br><br><dolphin_emphasis>If unsure, leave this "
       "checked.</dolphin_emphasis>");
+  static const char TR_LAZY_EFB_COPIES_DESCRIPTION[] = QT_TR_NOOP(
+      "Leaves deferred EFB copies on the GPU even after the game synchronizes with the emulated "
+      "GPU, and only writes them to RAM once the emulated CPU accesses their memory.<br><br>"
+      "Avoids waiting for EFB copies which are never read by the CPU, but is only effective "
+      "with the fastmem JIT, and games which read EFB copies through DMA may show outdated "
+      "contents.<br><br><dolphin_emphasis>If unsure, leave this "
+      "unchecked.</dolphin_emphasis>");
   static const char TR_ACCUARCY_DESCRIPTION[] = QT_TR_NOOP(
       "Adjusts the accuracy at which the GPU receives texture updates from RAM.<br><br>"
       "The \"Safe\" setting eliminates the likelihood of the GPU missing texture updates "
@@ -299,6 +311,7 @@ void HacksWidget::AddDescriptions()
   m_ignore_format_changes->SetDescription(tr(TR_IGNORE_FORMAT_CHANGE_DESCRIPTION));
   m_store_efb_copies->SetDescription(tr(TR_STORE_EFB_TO_TEXTURE_DESCRIPTION));
   m_defer_efb_copies->SetDescription(tr(TR_DEFER_EFB_COPIES_DESCRIPTION));
+  m_lazy_efb_copies->SetDescription(tr(TR_LAZY_EFB_COPIES_DESCRIPTION));
   m_accuracy->SetTitle(tr("Texture Cache Accuracy"));
   m_accuracy->SetDescription(tr(TR_ACCUARCY_DESCRIPTION));
   m_store_xfb_copies->SetDescription(tr(TR_STORE_XFB_TO_TEXTURE_DESCRIPTION));
@@ -318,6 +331,7 @@ void HacksWidget::UpdateDeferEFBCopiesEnabled()
   // enabled.
   const bool can_defer = m_store_efb_copies->isChecked() && m_store_xfb_copies->isChecked();
   m_defer_efb_copies->setEnabled(!can_defer);
+  m_lazy_efb_copies->setEnabled(!can_defer && m_defer_efb_copies->isChecked());
 }
 
 void HacksWidget::UpdateSkipPresentingDuplicateFramesEnabled()
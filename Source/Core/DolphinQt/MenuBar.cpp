@@ -15,6 +15,8 @@
 #include <QMap>
 #include <QUrl>
 
+#include <fmt/format.h>
+
 #include "Common/Align.h"
 #include "Common/CommonPaths.h"
 #include "Common/FileUtil.h"
@@ -158,6 +160,9 @@ void MenuBar::OnEmulationStateChanged(Core::State state)
   m_jit_clear_cache->setEnabled(running);
   m_jit_log_coverage->setEnabled(!running);
   m_jit_search_instruction->setEnabled(running);
+  if (!running && m_jit_sampling_profiler->isChecked())
+    m_jit_sampling_profiler->setChecked(false);
+  m_jit_sampling_profiler->setEnabled(running);
 
   // Symbols
   m_symbols->setEnabled(running);
@@ -881,6 +886,19 @@ void MenuBar::AddJITMenu()
     Config::SetBaseOrCurrent(Config::MAIN_LARGE_ENTRY_POINTS_MAP, !enabled);
   });
 
+  m_jit_superblocks = m_jit->addAction(tr("Enable Superblocks"));
+  m_jit_superblocks->setCheckable(true);
+  m_jit_superblocks->setChecked(Config::Get(Config::MAIN_JIT_SUPERBLOCKS));
+  connect(m_jit_superblocks, &QAction::toggled,
+          [](bool enabled) { Config::SetBaseOrCurrent(Config::MAIN_JIT_SUPERBLOCKS, enabled); });
+
+  m_jit_tiered_compilation = m_jit->addAction(tr("Enable Tiered Compilation"));
+  m_jit_tiered_compilation->setCheckable(true);
+  m_jit_tiered_compilation->setChecked(Config::Get(Config::MAIN_JIT_TIERED_COMPILATION));
+  connect(m_jit_tiered_compilation, &QAction::toggled, [](bool enabled) {
+    Config::SetBaseOrCurrent(Config::MAIN_JIT_TIERED_COMPILATION, enabled);
+  });
+
   m_jit_clear_cache = m_jit->addAction(tr("Clear Cache"), this, &MenuBar::ClearCache);
 
   m_jit->addSeparator();
@@ -889,6 +907,9 @@ void MenuBar::AddJITMenu()
       m_jit->addAction(tr("Log JIT Instruction Coverage"), this, &MenuBar::LogInstructions);
   m_jit_search_instruction =
       m_jit->addAction(tr("Search for an Instruction"), this, &MenuBar::SearchInstruction);
+  m_jit_sampling_profiler = m_jit->addAction(tr("Sampling Profiler"));
+  m_jit_sampling_profiler->setCheckable(true);
+  connect(m_jit_sampling_profiler, &QAction::toggled, this, &MenuBar::ToggleSamplingProfiler);
 
   m_jit->addSeparator();
 
@@ -1791,3 +1812,28 @@ void MenuBar::SearchInstruction()
   if (!found)
     NOTICE_LOG_FMT(POWERPC, "Opcode {} not found", op.toStdString());
 }
+
+void MenuBar::ToggleSamplingProfiler(bool enabled)
+{
+  auto& profiler = Core::System::GetInstance().GetPowerPC().GetSamplingProfiler();
+  if (enabled)
+  {
+    profiler.Clear();
+    profiler.Start();
+    return;
+  }
+
+  profiler.Stop();
+  if (profiler.GetSampleCount() == 0)
+    return;
+
+  const std::string path = fmt::format("{}SamplingProfile_{}", File::GetUserPath(D_DUMPDEBUG_IDX),
+                                       SConfig::GetInstance().GetGameID());
+  File::CreateFullPath(path);
+  if (profiler.WriteFoldedStacks(path + ".folded", g_symbolDB) &&
+      profiler.WritePprof(path + ".pb", g_symbolDB))
+  {
+    NOTICE_LOG_FMT(POWERPC, "Wrote {} samples to {}.folded and {}.pb", profiler.GetSampleCount(),
+                   path, path);
+  }
+}
@@ -0,0 +1,309 @@
+// Copyright 2024 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "DolphinTool/BenchmarkCommand.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <variant>
+#include <vector>
+
+#include <OptionParser.h>
+#include <fmt/format.h>
+#include <fmt/ostream.h>
+#include <picojson.h>
+
+#include "Common/CommonTypes.h"
+#include "Common/FileUtil.h"
+#include "Common/Flag.h"
+#include "Common/ScopeGuard.h"
+#include "Common/Thread.h"
+#include "Common/WindowSystemInfo.h"
+#include "Core/Boot/Boot.h"
+#include "Core/BootManager.h"
+#include "Core/Config/GraphicsSettings.h"
+#include "Core/Config/MainSettings.h"
+#include "Core/Core.h"
+#include "Core/FifoPlayer/FifoPlayer.h"
+#include "Core/System.h"
+#include "UICommon/UICommon.h"
+#include "VideoBackends/Null/VideoBackend.h"
+#include "VideoBackends/Software/VideoBackend.h"
+#include "VideoCommon/StageTimings.h"
+
+namespace DolphinTool
+{
+namespace
+{
+using Clock = std::chrono::steady_clock;
+
+// Only accessed from the CPU thread until finished is set.
+struct BenchmarkState
+{
+  u32 frames_per_loop = 0;
+  u32 warmup_loops = 0;
+  u32 loops = 0;
+  int cpu = -1;
+
+  u64 frame_count = 0;
+  Clock::time_point loop_start;
+  std::vector<Clock::duration> loop_times;
+  StageTimings::Timings timings{};
+  Common::Flag finished;
+};
+
+double ToMilliseconds(std::chrono::nanoseconds duration)
+{
+  return std::chrono::duration<double, std::milli>(duration).count();
+}
+
+// Called by the FIFO player on the CPU thread, right before each frame is written. In single core
+// mode, the previous frame has been fully processed by the video frontend at that point.
+void OnFrameWritten(BenchmarkState& state)
+{
+  if (state.finished.IsSet())
+    return;
+
+  if (state.frame_count == 0 && state.cpu >= 0)
+    Common::SetCurrentThreadAffinity(1u << state.cpu);
+
+  const u64 frame = state.frame_count++;
+  if (frame % state.frames_per_loop != 0)
+    return;
+
+  const u64 loop = frame / state.frames_per_loop;
+  const Clock::time_point now = Clock::now();
+  if (loop > state.warmup_loops)
+    state.loop_times.push_back(now - state.loop_start);
+  state.loop_start = now;
+
+  if (loop == state.warmup_loops)
+  {
+    StageTimings::Reset();
+    StageTimings::SetEnabled(true);
+  }
+  else if (loop == state.warmup_loops + state.loops)
+  {
+    StageTimings::SetEnabled(false);
+    state.timings = StageTimings::Get();
+    state.finished.Set();
+  }
+}
+
+std::string GetReport(const BenchmarkState& state, const std::string& backend)
+{
+  picojson::object report;
+  report["backend"] = picojson::value(backend);
+  report["frames_per_loop"] = picojson::value(static_cast<double>(state.frames_per_loop));
+  report["warmup_loops"] = picojson::value(static_cast<double>(state.warmup_loops));
+  report["loops"] = picojson::value(static_cast<double>(state.loop_times.size()));
+  if (state.cpu >= 0)
+    report["pinned_cpu"] = picojson::value(static_cast<double>(state.cpu));
+
+  std::chrono::nanoseconds total{};
+  picojson::array loop_times;
+  for (const Clock::duration& time : state.loop_times)
+  {
+    total += time;
+    loop_times.emplace_back(ToMilliseconds(time));
+  }
+  report["loop_times_ms"] = picojson::value(std::move(loop_times));
+  report["total_ms"] = picojson::value(ToMilliseconds(total));
+
+  if (!state.loop_times.empty())
+  {
+    std::vector<Clock::duration> sorted = state.loop_times;
+    std::sort(sorted.begin(), sorted.end());
+    report["loop_time_min_ms"] = picojson::value(ToMilliseconds(sorted.front()));
+    report["loop_time_median_ms"] = picojson::value(ToMilliseconds(sorted[sorted.size() / 2]));
+  }
+
+  picojson::object stages;
+  for (size_t i = 0; i < StageTimings::NUM_STAGES; ++i)
+  {
+    const StageTimings::StageTiming& timing = state.timings[i];
+    picojson::object stage;
+    stage["calls"] = picojson::value(static_cast<double>(timing.calls));
+    stage["total_ms"] = picojson::value(ToMilliseconds(timing.time));
+    if (timing.calls != 0)
+    {
+      stage["mean_us"] = picojson::value(
+          std::chrono::duration<double, std::micro>(timing.time).count() / timing.calls);
+    }
+    if (total.count() > 0)
+    {
+      stage["fraction"] = picojson::value(static_cast<double>(timing.time.count()) /
+                                          static_cast<double>(total.count()));
+    }
+    stages[StageTimings::GetStageName(static_cast<StageTimings::Stage>(i))] =
+        picojson::value(std::move(stage));
+  }
+  report["stages"] = picojson::value(std::move(stages));
+
+  return picojson::value(std::move(report)).serialize(true);
+}
+}  // namespace
+
+int BenchmarkCommand(const std::vector<std::string>& args)
+{
+  optparse::OptionParser parser;
+
+  parser.usage("usage: benchmark [options]...");
+  parser.description("Replays a FIFO log as fast as possible and reports the time spent in the "
+                     "main stages of the video frontend, as JSON.");
+
+  parser.add_option("-u", "--user")
+      .type("string")
+      .action("store")
+      .help("User folder path. Will be automatically created if this option is not set.")
+      .set_default("");
+
+  parser.add_option("-i", "--input")
+      .type("string")
+      .action("store")
+      .help("Path to the FIFO log FILE (.dff).")
+      .metavar("FILE");
+
+  parser.add_option("-o", "--output")
+      .type("string")
+      .action("store")
+      .help("Optional. Write the report to FILE instead of stdout.")
+      .metavar("FILE");
+
+  parser.add_option("-b", "--backend")
+      .type("string")
+      .action("store")
+      .help("Video backend to replay the FIFO log with. Default is null. [%choices]")
+      .choices({"null", "software"})
+      .set_default("null");
+
+  parser.add_option("-l", "--loops")
+      .type("int")
+      .action("store")
+      .help("Number of times to replay the FIFO log while measuring. Default is 10.")
+      .set_default(10);
+
+  parser.add_option("-w", "--warmup_loops")
+      .type("int")
+      .action("store")
+      .help("Number of times to replay the FIFO log before measuring, to fill the caches. "
+            "Default is 1.")
+      .set_default(1);
+
+  parser.add_option("-c", "--cpu")
+      .type("int")
+      .action("store")
+      .help("CPU to pin the emulation thread to, or -1 to not pin it. Default is 0.")
+      .set_default(0);
+
+  const optparse::Values& options = parser.parse_args(args);
+
+  UICommon::SetUserDirectory(options["user"]);
+  UICommon::Init();
+  Common::ScopeGuard ui_common_guard([] { UICommon::Shutdown(); });
+
+  // Validate options
+  if (!options.is_set("input"))
+  {
+    fmt::print(std::cerr, "Error: No input set\n");
+    return EXIT_FAILURE;
+  }
+  const std::string& input_file_path = options["input"];
+
+  const int loops = static_cast<int>(options.get("loops"));
+  const int warmup_loops = static_cast<int>(options.get("warmup_loops"));
+  if (loops <= 0 || warmup_loops < 0)
+  {
+    fmt::print(std::cerr, "Error: Invalid number of loops\n");
+    return EXIT_FAILURE;
+  }
+
+  const int cpu = static_cast<int>(options.get("cpu"));
+  if (cpu < -1 || cpu >= 32)
+  {
+    fmt::print(std::cerr, "Error: Invalid CPU {}\n", cpu);
+    return EXIT_FAILURE;
+  }
+
+  const std::string backend =
+      options["backend"] == "software" ? SW::VideoSoftware::NAME : Null::VideoBackend::NAME;
+
+  std::unique_ptr<BootParameters> boot = BootParameters::GenerateFromFile(input_file_path);
+  if (!boot || !std::holds_alternative<BootParameters::DFF>(boot->parameters))
+  {
+    fmt::print(std::cerr, "Error: {} is not a FIFO log\n", input_file_path);
+    return EXIT_FAILURE;
+  }
+
+  // Only for this session, so that the user's settings aren't overwritten. Single core mode keeps
+  // the whole frontend on the pinned thread, which makes the timings more stable.
+  Config::SetCurrent(Config::MAIN_GFX_BACKEND, backend);
+  Config::SetCurrent(Config::MAIN_CPU_THREAD, false);
+  Config::SetCurrent(Config::MAIN_EMULATION_SPEED, 0.0f);
+  Config::SetCurrent(Config::MAIN_FIFOPLAYER_LOOP_REPLAY, true);
+  Config::SetCurrent(Config::GFX_VSYNC, false);
+
+  WindowSystemInfo wsi;
+  wsi.type = WindowSystemType::Headless;
+  UICommon::InitControllers(wsi);
+  Common::ScopeGuard controllers_guard([] { UICommon::ShutdownControllers(); });
+
+  BenchmarkState state;
+  state.warmup_loops = static_cast<u32>(warmup_loops);
+  state.loops = static_cast<u32>(loops);
+  state.cpu = cpu;
+
+  FifoPlayer& fifo_player = Core::System::GetInstance().GetFifoPlayer();
+  fifo_player.SetFrameWrittenCallback([&state, &fifo_player] {
+    if (state.frames_per_loop == 0)
+    {
+      state.frames_per_loop =
+          fifo_player.GetFrameRangeEnd() - fifo_player.GetFrameRangeStart() + 1;
+    }
+    OnFrameWritten(state);
+  });
+  Common::ScopeGuard callback_guard([&fifo_player] { fifo_player.SetFrameWrittenCallback({}); });
+
+  if (!BootManager::BootCore(std::move(boot), wsi))
+  {
+    fmt::print(std::cerr, "Error: Could not replay {}\n", input_file_path);
+    return EXIT_FAILURE;
+  }
+
+  while (!state.finished.IsSet() && Core::IsRunning())
+  {
+    Core::HostDispatchJobs();
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+
+  Core::Stop();
+  Core::Shutdown();
+  StageTimings::SetEnabled(false);
+
+  if (!state.finished.IsSet())
+  {
+    fmt::print(std::cerr, "Error: The replay stopped before the benchmark finished\n");
+    return EXIT_FAILURE;
+  }
+
+  const std::string report = GetReport(state, backend) + '\n';
+  if (!options.is_set("output"))
+  {
+    fmt::print(std::cout, "{}", report);
+    return EXIT_SUCCESS;
+  }
+
+  const std::string& output_file_path = options["output"];
+  if (!File::WriteStringToFile(output_file_path, report))
+  {
+    fmt::print(std::cerr, "Error: Unable to write the report to {}\n", output_file_path);
+    return EXIT_FAILURE;
+  }
+  return EXIT_SUCCESS;
+}
+}  // namespace DolphinTool
@@ -0,0 +1,79 @@
+// Copyright 2024 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "DolphinTool/PackCommand.h"
+
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include <OptionParser.h>
+#include <fmt/format.h>
+#include <fmt/ostream.h>
+
+#include "Common/FileSearch.h"
+#include "Common/FileUtil.h"
+#include "VideoCommon/Assets/TexturePack.h"
+
+namespace DolphinTool
+{
+int PackCommand(const std::vector<std::string>& args)
+{
+  optparse::OptionParser parser;
+
+  parser.usage("usage: pack [options]...");
+
+  parser.add_option("-i", "--input")
+      .type("string")
+      .action("store")
+      .help("Path to a directory of custom textures, which is searched recursively.")
+      .metavar("DIRECTORY");
+
+  parser.add_option("-o", "--output")
+      .type("string")
+      .action("store")
+      .help("Path to the texture pack FILE to create. Texture packs use the .dtp extension.")
+      .metavar("FILE");
+
+  const optparse::Values& options = parser.parse_args(args);
+
+  // Validate options
+  const std::string& input_path = options["input"];
+  if (input_path.empty())
+  {
+    fmt::print(std::cerr, "Error: No input set\n");
+    return EXIT_FAILURE;
+  }
+  if (!File::IsDirectory(input_path))
+  {
+    fmt::print(std::cerr, "Error: Input is not a directory\n");
+    return EXIT_FAILURE;
+  }
+
+  const std::string& output_path = options["output"];
+  if (output_path.empty())
+  {
+    fmt::print(std::cerr, "Error: No output set\n");
+    return EXIT_FAILURE;
+  }
+
+  const std::vector<std::string> files =
+      Common::DoFileSearch({input_path}, {".dds", ".png"}, /*recursive*/ true);
+  if (files.empty())
+  {
+    fmt::print(std::cerr, "Error: No .dds or .png files found in the input\n");
+    return EXIT_FAILURE;
+  }
+
+  if (!VideoCommon::TexturePack::Write(output_path, files))
+  {
+    fmt::print(std::cerr, "Error: Failed to write the texture pack. Every texture must be "
+                          "readable, and texture file names must be unique, even across "
+                          "subdirectories.\n");
+    return EXIT_FAILURE;
+  }
+
+  fmt::print(std::cout, "Packed {} textures into '{}'\n", files.size(), output_path);
+  return EXIT_SUCCESS;
+}
+}  // namespace DolphinTool
@@ -16,15 +16,17 @@
 #include "Common/Version.h"
 #include "Core/Core.h"
 
+#include "DolphinTool/BenchmarkCommand.h"
 #include "DolphinTool/ConvertCommand.h"
 #include "DolphinTool/HeaderCommand.h"
+#include "DolphinTool/PackCommand.h"
 #include "DolphinTool/VerifyCommand.h"
 
 static void PrintUsage()
 {
   fmt::print(std::cerr, "usage: dolphin-tool COMMAND -h\n"
                         "\n"
-                        "commands supported: [convert, verify, header]\n");
+                        "commands supported: [convert, verify, header, benchmark, pack]\n");
 }
 
 #ifdef _WIN32
@@ -51,6 +53,10 @@ int main(int argc, char* argv[])
     return DolphinTool::VerifyCommand(args);
   else if (command_str == "header")
     return DolphinTool::HeaderCommand(args);
+  else if (command_str == "benchmark")
+    return DolphinTool::BenchmarkCommand(args);
+  else if (command_str == "pack")
+    return DolphinTool::PackCommand(args);
   PrintUsage();
   return EXIT_FAILURE;
 }
@@ -75,6 +75,7 @@ bool VertexManager::Initialize()
 {
   if (!VertexManagerBase::Initialize())
     return false;
+  m_can_reuse_committed_buffers = true;
 
   CD3D11_BUFFER_DESC bufdesc((VERTEX_STREAM_BUFFER_SIZE + INDEX_STREAM_BUFFER_SIZE) / BUFFER_COUNT,
                              D3D11_BIND_INDEX_BUFFER | D3D11_BIND_VERTEX_BUFFER,
@@ -260,6 +261,15 @@ void VertexManager::CommitBuffer(u32 num_vertices, u32 vertex_stride, u32 num_in
   D3D::stateman->SetIndexBuffer(m_buffers[m_current_buffer].Get());
 }
 
+bool VertexManager::ReuseCommittedBuffer(u32 vertex_stride)
+{
+  // Only CommitBuffer() writes to the buffers, and the driver keeps the contents of a buffer that
+  // is mapped without discarding, so the last commit is always intact.
+  D3D::stateman->SetVertexBuffer(m_buffers[m_current_buffer].Get(), vertex_stride, 0);
+  D3D::stateman->SetIndexBuffer(m_buffers[m_current_buffer].Get());
+  return true;
+}
+
 void VertexManager::UploadUniforms()
 {
   auto& system = Core::System::GetInstance();
@@ -51,6 +51,7 @@ protected:
   void ResetBuffer(u32 vertex_stride) override;
   void CommitBuffer(u32 num_vertices, u32 vertex_stride, u32 num_indices, u32* out_base_vertex,
                     u32* out_base_index) override;
+  bool ReuseCommittedBuffer(u32 vertex_stride) override;
   void UploadUniforms() override;
 
 private:
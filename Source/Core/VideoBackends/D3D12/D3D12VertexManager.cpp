@@ -32,6 +32,7 @@ bool VertexManager::Initialize()
 {
   if (!VertexManagerBase::Initialize())
     return false;
+  m_can_reuse_committed_buffers = true;
 
   if (!m_vertex_stream_buffer.AllocateBuffer(VERTEX_STREAM_BUFFER_SIZE) ||
       !m_index_stream_buffer.AllocateBuffer(INDEX_STREAM_BUFFER_SIZE) ||
@@ -125,6 +126,9 @@ void VertexManager::CommitBuffer(u32 num_vertices, u32 vertex_stride, u32 num_in
 
   m_vertex_stream_buffer.CommitMemory(vertex_data_size);
   m_index_stream_buffer.CommitMemory(index_data_size);
+  m_last_commit_fence_value = g_dx_context->GetCurrentFenceValue();
+  m_last_commit_vertex_end = m_vertex_stream_buffer.GetCurrentOffset();
+  m_last_commit_index_end = m_index_stream_buffer.GetCurrentOffset();
 
   ADDSTAT(g_stats.this_frame.bytes_vertex_streamed, static_cast<int>(vertex_data_size));
   ADDSTAT(g_stats.this_frame.bytes_index_streamed, static_cast<int>(index_data_size));
@@ -136,6 +140,26 @@ void VertexManager::CommitBuffer(u32 num_vertices, u32 vertex_stride, u32 num_in
                                      m_index_stream_buffer.GetSize(), DXGI_FORMAT_R16_UINT);
 }
 
+bool VertexManager::ReuseCommittedBuffer(u32 vertex_stride)
+{
+  // The stream buffers only know about the command list the data was committed in, so the draw
+  // must be recorded to the same one. If either buffer has wrapped around since, the data may
+  // have been overwritten.
+  if (g_dx_context->GetCurrentFenceValue() != m_last_commit_fence_value ||
+      m_vertex_stream_buffer.GetCurrentOffset() < m_last_commit_vertex_end ||
+      m_index_stream_buffer.GetCurrentOffset() < m_last_commit_index_end)
+  {
+    return false;
+  }
+
+  Gfx::GetInstance()->SetVertexBuffer(m_vertex_stream_buffer.GetGPUPointer(),
+                                      m_vertex_srv.cpu_handle, vertex_stride,
+                                      m_vertex_stream_buffer.GetSize());
+  Gfx::GetInstance()->SetIndexBuffer(m_index_stream_buffer.GetGPUPointer(),
+                                     m_index_stream_buffer.GetSize(), DXGI_FORMAT_R16_UINT);
+  return true;
+}
+
 void VertexManager::UploadUniforms()
 {
   UpdateVertexShaderConstants();
@@ -29,6 +29,7 @@ protected:
   void ResetBuffer(u32 vertex_stride) override;
   void CommitBuffer(u32 num_vertices, u32 vertex_stride, u32 num_indices, u32* out_base_vertex,
                     u32* out_base_index) override;
+  bool ReuseCommittedBuffer(u32 vertex_stride) override;
   void UploadUniforms() override;
 
   void UpdateVertexShaderConstants();
@@ -47,6 +48,11 @@ protected:
   StreamBuffer m_texel_stream_buffer;
   std::array<DescriptorHandle, NUM_TEXEL_BUFFER_FORMATS> m_texel_buffer_views = {};
   DescriptorHandle m_vertex_srv = {};
+
+  // Where the last committed batch ended, and the command list it was committed in.
+  u64 m_last_commit_fence_value = 0;
+  u32 m_last_commit_vertex_end = 0;
+  u32 m_last_commit_index_end = 0;
 };
 
 }  // namespace DX12
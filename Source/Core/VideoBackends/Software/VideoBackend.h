@@ -10,6 +10,7 @@ namespace SW
 {
 class VideoSoftware : public VideoBackendBase
 {
+public:
   bool Initialize(const WindowSystemInfo& wsi) override;
   void Shutdown() override;
 
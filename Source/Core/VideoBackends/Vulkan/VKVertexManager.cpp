@@ -64,6 +64,7 @@ bool VertexManager::Initialize()
 {
   if (!VertexManagerBase::Initialize())
     return false;
+  m_can_reuse_committed_buffers = true;
 
   m_vertex_stream_buffer =
       StreamBuffer::Create(VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
@@ -185,6 +186,9 @@ void VertexManager::CommitBuffer(u32 num_vertices, u32 vertex_stride, u32 num_in
 
   m_vertex_stream_buffer->CommitMemory(vertex_data_size);
   m_index_stream_buffer->CommitMemory(index_data_size);
+  m_last_commit_fence_counter = g_command_buffer_mgr->GetCurrentFenceCounter();
+  m_last_commit_vertex_end = m_vertex_stream_buffer->GetCurrentOffset();
+  m_last_commit_index_end = m_index_stream_buffer->GetCurrentOffset();
 
   ADDSTAT(g_stats.this_frame.bytes_vertex_streamed, static_cast<int>(vertex_data_size));
   ADDSTAT(g_stats.this_frame.bytes_index_streamed, static_cast<int>(index_data_size));
@@ -195,6 +199,25 @@ void VertexManager::CommitBuffer(u32 num_vertices, u32 vertex_stride, u32 num_in
                                               VK_INDEX_TYPE_UINT16);
 }
 
+bool VertexManager::ReuseCommittedBuffer(u32 vertex_stride)
+{
+  // The stream buffers only know about the command buffer the data was committed in, so the draw
+  // must be recorded to the same one. If either buffer has wrapped around since, the data may
+  // have been overwritten.
+  if (g_command_buffer_mgr->GetCurrentFenceCounter() != m_last_commit_fence_counter ||
+      m_vertex_stream_buffer->GetCurrentOffset() < m_last_commit_vertex_end ||
+      m_index_stream_buffer->GetCurrentOffset() < m_last_commit_index_end)
+  {
+    return false;
+  }
+
+  StateTracker::GetInstance()->SetVertexBuffer(m_vertex_stream_buffer->GetBuffer(), 0,
+                                               VERTEX_STREAM_BUFFER_SIZE);
+  StateTracker::GetInstance()->SetIndexBuffer(m_index_stream_buffer->GetBuffer(), 0,
+                                              VK_INDEX_TYPE_UINT16);
+  return true;
+}
+
 void VertexManager::UploadUniforms()
 {
   UpdateVertexShaderConstants();
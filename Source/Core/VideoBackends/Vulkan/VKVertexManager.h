@@ -33,6 +33,7 @@ protected:
   void ResetBuffer(u32 vertex_stride) override;
   void CommitBuffer(u32 num_vertices, u32 vertex_stride, u32 num_indices, u32* out_base_vertex,
                     u32* out_base_index) override;
+  bool ReuseCommittedBuffer(u32 vertex_stride) override;
   void UploadUniforms() override;
 
   void DestroyTexelBufferViews();
@@ -53,5 +54,10 @@ protected:
   std::unique_ptr<StreamBuffer> m_texel_stream_buffer;
   std::array<VkBufferView, NUM_TEXEL_BUFFER_FORMATS> m_texel_buffer_views = {};
   u32 m_uniform_buffer_reserve_size = 0;
+
+  // Where the last committed batch ended, and the command buffer it was committed in.
+  u64 m_last_commit_fence_counter = 0;
+  u32 m_last_commit_vertex_end = 0;
+  u32 m_last_commit_index_end = 0;
 };
 }  // namespace Vulkan
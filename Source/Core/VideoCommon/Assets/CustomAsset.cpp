@@ -28,6 +28,11 @@ CustomAssetLibrary::TimeType CustomAsset::GetLastWriteTime() const
   return m_owning_library->GetLastAssetWriteTime(m_asset_id);
 }
 
+std::optional<std::vector<std::filesystem::path>> CustomAsset::GetFilePaths() const
+{
+  return m_owning_library->GetAssetFilePaths(m_asset_id);
+}
+
 const CustomAssetLibrary::TimeType& CustomAsset::GetLastLoadedTime() const
 {
   std::lock_guard lk(m_info_lock);
@@ -6,9 +6,11 @@
 #include "Common/CommonTypes.h"
 #include "VideoCommon/Assets/CustomAssetLibrary.h"
 
+#include <filesystem>
 #include <memory>
 #include <mutex>
 #include <optional>
+#include <vector>
 
 namespace VideoCommon
 {
@@ -33,6 +35,9 @@ public:
   // Note: not thread safe, expected to be called by the loader
   CustomAssetLibrary::TimeType GetLastWriteTime() const;
 
+  // Queries the files the asset is loaded from, if the library knows them
+  std::optional<std::vector<std::filesystem::path>> GetFilePaths() const;
+
   // Returns the time that the data was last loaded
   const CustomAssetLibrary::TimeType& GetLastLoadedTime() const;
 
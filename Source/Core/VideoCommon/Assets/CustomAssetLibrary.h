@@ -6,7 +6,9 @@
 #include <chrono>
 #include <filesystem>
 #include <map>
+#include <optional>
 #include <string>
+#include <vector>
 
 namespace VideoCommon
 {
@@ -40,6 +42,14 @@ public:
   // Gets the last write time for a given asset id
   virtual TimeType GetLastAssetWriteTime(const AssetID& asset_id) const = 0;
 
+  // Gets the files the asset is loaded from, so they can be watched for changes instead of
+  // polling the write time.  Returns nothing if there are no files known to the library
+  virtual std::optional<std::vector<std::filesystem::path>>
+  GetAssetFilePaths(const AssetID& asset_id) const
+  {
+    return std::nullopt;
+  }
+
   // Loads a texture as a game texture, providing additional checks like confirming
   // each mip level size is correct and that the format is consistent across the data
   LoadInfo LoadGameTexture(const AssetID& asset_id, TextureData* data);
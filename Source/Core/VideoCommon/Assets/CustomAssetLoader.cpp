@@ -3,7 +3,18 @@
 
 #include "VideoCommon/Assets/CustomAssetLoader.h"
 
+#include <algorithm>
+#include <set>
+
+#ifdef __linux__
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
 #include "Common/MemoryUtil.h"
+#include "Common/StringUtil.h"
+#include "Common/Thread.h"
 #include "VideoCommon/Assets/CustomAssetLibrary.h"
 
 namespace VideoCommon
@@ -18,72 +29,273 @@ void CustomAssetLoader::Init()
   m_max_memory_available =
       (sys_mem / 2 < recommended_min_mem) ? (sys_mem / 2) : (sys_mem - recommended_min_mem);
 
+#ifdef __linux__
+  m_inotify_fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+  if (m_inotify_fd < 0)
+    WARN_LOG_FMT(VIDEO, "Failed to initialize inotify, asset changes will be polled for");
+#endif
+
   m_asset_monitor_thread = std::thread([this]() {
     Common::SetCurrentThreadName("Asset monitor");
-    while (true)
+    MonitorThread();
+  });
+
+  m_loader_threads_shutdown = false;
+  const std::size_t thread_count =
+      std::clamp<std::size_t>(std::thread::hardware_concurrency() / 2, 1, MAX_LOADER_THREADS);
+  for (std::size_t i = 0; i < thread_count; i++)
+  {
+    m_loader_threads.emplace_back([this]() {
+      Common::SetCurrentThreadName("Custom Asset Loader");
+      LoaderThread();
+    });
+  }
+}
+
+void CustomAssetLoader ::Shutdown()
+{
+  {
+    std::lock_guard lk(m_queue_lock);
+    m_loader_threads_shutdown = true;
+    for (auto& queue : m_load_queues)
+      queue.clear();
+    m_pending_loads.clear();
+  }
+  m_queue_cond_var.notify_all();
+  for (std::thread& thread : m_loader_threads)
+    thread.join();
+  m_loader_threads.clear();
+
+  m_asset_monitor_thread_shutdown.Set();
+  m_asset_monitor_thread.join();
+  m_assets_to_monitor.clear();
+  m_total_bytes_loaded = 0;
+
+#ifdef __linux__
+  if (m_inotify_fd >= 0)
+  {
+    close(m_inotify_fd);
+    m_inotify_fd = -1;
+  }
+#endif
+
+  std::lock_guard lk(m_latency_lock);
+  m_load_latencies.clear();
+  m_next_latency_sample = 0;
+}
+
+void CustomAssetLoader::QueueLoad(const std::shared_ptr<CustomAsset>& asset,
+                                  LoadPriority priority, bool only_if_pending)
+{
+  {
+    std::lock_guard lk(m_queue_lock);
+    if (m_loader_threads_shutdown)
+      return;
+
+    const auto iter = m_pending_loads.find(asset.get());
+    if (iter == m_pending_loads.end())
+    {
+      if (only_if_pending)
+        return;
+      m_pending_loads.emplace(asset.get(), priority);
+    }
+    else
+    {
+      if (iter->second <= priority)
+        return;
+      // The entry in the lower priority queue is skipped once it is reached
+      iter->second = priority;
+    }
+
+    m_load_queues[static_cast<std::size_t>(priority)].push_back({asset, Clock::now()});
+  }
+  m_queue_cond_var.notify_one();
+}
+
+void CustomAssetLoader::LoaderThread()
+{
+  while (true)
+  {
+    QueuedLoad load;
+    LoadPriority priority;
+    std::shared_ptr<CustomAsset> ptr;
+    {
+      std::unique_lock lk(m_queue_lock);
+      m_queue_cond_var.wait(lk, [this] {
+        return m_loader_threads_shutdown ||
+               std::any_of(m_load_queues.begin(), m_load_queues.end(),
+                           [](const auto& queue) { return !queue.empty(); });
+      });
+      if (m_loader_threads_shutdown)
+        return;
+
+      const auto queue = std::find_if(m_load_queues.begin(), m_load_queues.end(),
+                                      [](const auto& q) { return !q.empty(); });
+      priority = static_cast<LoadPriority>(queue - m_load_queues.begin());
+      load = std::move(queue->front());
+      queue->pop_front();
+
+      ptr = load.asset.lock();
+      if (!ptr)
+        continue;
+
+      const auto pending = m_pending_loads.find(ptr.get());
+      if (pending == m_pending_loads.end() || pending->second != priority)
+        continue;
+      m_pending_loads.erase(pending);
+    }
+
+    if (priority == LoadPriority::Reload)
+    {
+      (void)ptr->Load();
+      continue;
+    }
+
+    if (m_memory_exceeded)
+      continue;
+
+    if (ptr->Load())
     {
-      if (m_asset_monitor_thread_shutdown.IsSet())
+      if (priority == LoadPriority::Visible)
+        RecordLoadLatency(Clock::now() - load.queue_time);
+
+      const bool watched = WatchAssetFiles(*ptr);
+
+      std::lock_guard lk(m_asset_load_lock);
+      const std::size_t asset_memory_size = ptr->GetByteSizeInMemory();
+      m_total_bytes_loaded += asset_memory_size;
+      m_assets_to_monitor.try_emplace(ptr->GetAssetId(), MonitoredAsset{ptr, watched});
+      if (m_total_bytes_loaded > m_max_memory_available)
       {
-        break;
+        ERROR_LOG_FMT(VIDEO,
+                      "Asset memory exceeded with asset '{}', future assets won't load until "
+                      "memory is available.",
+                      ptr->GetAssetId());
+        m_memory_exceeded = true;
       }
+    }
+  }
+}
 
-      std::this_thread::sleep_for(TIME_BETWEEN_ASSET_MONITOR_CHECKS);
+void CustomAssetLoader::MonitorThread()
+{
+  while (!m_asset_monitor_thread_shutdown.IsSet())
+  {
+    const bool files_changed = WaitForFileChanges();
 
+    // Watched assets only need to be checked when the OS reported a change, which avoids querying
+    // the write time of every loaded file twice a second
+    std::vector<std::shared_ptr<CustomAsset>> changed_assets;
+    {
       std::lock_guard lk(m_asset_load_lock);
       for (auto& [asset_id, asset_to_monitor] : m_assets_to_monitor)
       {
-        if (auto ptr = asset_to_monitor.lock())
+        if (asset_to_monitor.watched && !files_changed)
+          continue;
+
+        if (auto ptr = asset_to_monitor.asset.lock())
         {
           const auto write_time = ptr->GetLastWriteTime();
           if (write_time > ptr->GetLastLoadedTime())
-          {
-            (void)ptr->Load();
-          }
+            changed_assets.push_back(std::move(ptr));
         }
       }
     }
-  });
 
-  m_asset_load_thread.Reset("Custom Asset Loader", [this](std::weak_ptr<CustomAsset> asset) {
-    if (auto ptr = asset.lock())
-    {
-      if (m_memory_exceeded)
-        return;
+    // Queued outside of the lock, as dropping the last reference to an asset takes it again
+    for (const auto& asset : changed_assets)
+      QueueLoad(asset, LoadPriority::Reload, /*only_if_pending*/ false);
+  }
+}
 
-      if (ptr->Load())
-      {
-        std::lock_guard lk(m_asset_load_lock);
-        const std::size_t asset_memory_size = ptr->GetByteSizeInMemory();
-        m_total_bytes_loaded += asset_memory_size;
-        m_assets_to_monitor.try_emplace(ptr->GetAssetId(), ptr);
-        if (m_total_bytes_loaded > m_max_memory_available)
-        {
-          ERROR_LOG_FMT(VIDEO,
-                        "Asset memory exceeded with asset '{}', future assets won't load until "
-                        "memory is available.",
-                        ptr->GetAssetId());
-          m_memory_exceeded = true;
-        }
-      }
+bool CustomAssetLoader::WatchAssetFiles(const CustomAsset& asset)
+{
+#ifdef __linux__
+  if (m_inotify_fd < 0)
+    return false;
+
+  // Without any files to watch, changes can only be noticed by polling
+  const auto paths = asset.GetFilePaths();
+  if (!paths || paths->empty())
+    return false;
+
+  // Directories are watched rather than the files, as editors often save by replacing the file
+  std::set<std::string> directories;
+  for (const auto& path : *paths)
+    directories.insert(PathToString(path.parent_path()));
+  for (const std::string& directory : directories)
+  {
+    // Watching a directory twice just returns the existing watch
+    if (inotify_add_watch(m_inotify_fd, directory.c_str(),
+                          IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE | IN_ATTRIB) < 0)
+    {
+      return false;
     }
-  });
+  }
+  return true;
+#else
+  return false;
+#endif
 }
 
-void CustomAssetLoader ::Shutdown()
+bool CustomAssetLoader::WaitForFileChanges()
 {
-  m_asset_load_thread.Shutdown(true);
+#ifdef __linux__
+  if (m_inotify_fd >= 0)
+  {
+    // The timeout is only needed for assets that can't be watched and to notice shutdowns
+    pollfd fd{m_inotify_fd, POLLIN, 0};
+    if (poll(&fd, 1, static_cast<int>(TIME_BETWEEN_ASSET_MONITOR_CHECKS.count())) <= 0)
+      return false;
 
-  m_asset_monitor_thread_shutdown.Set();
-  m_asset_monitor_thread.join();
-  m_assets_to_monitor.clear();
-  m_total_bytes_loaded = 0;
+    // The events themselves aren't needed, every watched asset is checked
+    alignas(inotify_event) char buffer[4096];
+    bool files_changed = false;
+    while (read(m_inotify_fd, buffer, sizeof(buffer)) > 0)
+      files_changed = true;
+    return files_changed;
+  }
+#endif
+
+  std::this_thread::sleep_for(TIME_BETWEEN_ASSET_MONITOR_CHECKS);
+  return false;
+}
+
+void CustomAssetLoader::RecordLoadLatency(Clock::duration latency)
+{
+  std::lock_guard lk(m_latency_lock);
+  if (m_load_latencies.size() < NUM_LATENCY_SAMPLES)
+    m_load_latencies.push_back(latency);
+  else
+    m_load_latencies[m_next_latency_sample] = latency;
+  m_next_latency_sample = (m_next_latency_sample + 1) % NUM_LATENCY_SAMPLES;
+}
+
+CustomAssetLoader::LoadLatencies CustomAssetLoader::GetLoadLatencies() const
+{
+  std::vector<Clock::duration> latencies;
+  {
+    std::lock_guard lk(m_latency_lock);
+    latencies = m_load_latencies;
+  }
+  if (latencies.empty())
+    return {};
+
+  std::sort(latencies.begin(), latencies.end());
+  const auto percentile = [&latencies](std::size_t percent) {
+    const std::size_t index = (latencies.size() - 1) * percent / 100;
+    return std::chrono::duration<double, std::milli>(latencies[index]).count();
+  };
+  return {latencies.size(), percentile(50), percentile(90), percentile(99)};
 }
 
 std::shared_ptr<GameTextureAsset>
 CustomAssetLoader::LoadGameTexture(const CustomAssetLibrary::AssetID& asset_id,
-                                   std::shared_ptr<CustomAssetLibrary> library)
+                                   std::shared_ptr<CustomAssetLibrary> library,
+                                   LoadPriority priority)
 {
-  return LoadOrCreateAsset<GameTextureAsset>(asset_id, m_game_textures, std::move(library));
+  return LoadOrCreateAsset<GameTextureAsset>(asset_id, m_game_textures, std::move(library),
+                                             priority);
 }
 
 std::shared_ptr<PixelShaderAsset>
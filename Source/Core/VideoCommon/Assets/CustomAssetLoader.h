@@ -3,15 +3,18 @@
 
 #pragma once
 
+#include <array>
 #include <chrono>
+#include <condition_variable>
+#include <deque>
 #include <map>
 #include <memory>
 #include <mutex>
 #include <thread>
+#include <vector>
 
 #include "Common/Flag.h"
 #include "Common/Logging/Log.h"
-#include "Common/WorkQueueThread.h"
 #include "VideoCommon/Assets/CustomAsset.h"
 #include "VideoCommon/Assets/MaterialAsset.h"
 #include "VideoCommon/Assets/MeshAsset.h"
@@ -25,6 +28,27 @@ namespace VideoCommon
 class CustomAssetLoader
 {
 public:
+  // Loads are handed to the loader threads in this order
+  enum class LoadPriority
+  {
+    // Needed by what is being drawn right now
+    Visible,
+    // Likely to be needed soon, such as when preloading
+    Prefetch,
+    // Changed on the disk since it was last loaded
+    Reload,
+  };
+  static constexpr std::size_t NUM_LOAD_PRIORITIES = 3;
+
+  // How long it took to load the assets that were needed right away, in milliseconds
+  struct LoadLatencies
+  {
+    std::size_t count = 0;
+    double p50 = 0;
+    double p90 = 0;
+    double p99 = 0;
+  };
+
   CustomAssetLoader() = default;
   ~CustomAssetLoader() = default;
   CustomAssetLoader(const CustomAssetLoader&) = delete;
@@ -40,8 +64,11 @@ public:
   // Loads happen asynchronously where the data will be set now or in the future
   // Callees are expected to query the underlying data with 'GetData()'
   // from the 'CustomLoadableAsset' class to determine if the data is ready for use
-  std::shared_ptr<GameTextureAsset> LoadGameTexture(const CustomAssetLibrary::AssetID& asset_id,
-                                                    std::shared_ptr<CustomAssetLibrary> library);
+  // If the asset is still waiting to be loaded, it is moved up to the given priority
+  std::shared_ptr<GameTextureAsset>
+  LoadGameTexture(const CustomAssetLibrary::AssetID& asset_id,
+                  std::shared_ptr<CustomAssetLibrary> library,
+                  LoadPriority priority = LoadPriority::Visible);
 
   std::shared_ptr<PixelShaderAsset> LoadPixelShader(const CustomAssetLibrary::AssetID& asset_id,
                                                     std::shared_ptr<CustomAssetLibrary> library);
@@ -52,20 +79,42 @@ public:
   std::shared_ptr<MeshAsset> LoadMesh(const CustomAssetLibrary::AssetID& asset_id,
                                       std::shared_ptr<CustomAssetLibrary> library);
 
+  // Percentiles over the most recent visible loads
+  LoadLatencies GetLoadLatencies() const;
+
 private:
+  using Clock = std::chrono::steady_clock;
+
+  struct QueuedLoad
+  {
+    std::weak_ptr<CustomAsset> asset;
+    Clock::time_point queue_time;
+  };
+
+  struct MonitoredAsset
+  {
+    std::weak_ptr<CustomAsset> asset;
+    // Whether changes to the asset's files are reported by the OS, rather than having to be polled
+    bool watched = false;
+  };
+
   // TODO C++20: use a 'derived_from' concept against 'CustomAsset' when available
   template <typename AssetType>
   std::shared_ptr<AssetType>
   LoadOrCreateAsset(const CustomAssetLibrary::AssetID& asset_id,
                     std::map<CustomAssetLibrary::AssetID, std::weak_ptr<AssetType>>& asset_map,
-                    std::shared_ptr<CustomAssetLibrary> library)
+                    std::shared_ptr<CustomAssetLibrary> library,
+                    LoadPriority priority = LoadPriority::Visible)
   {
     auto [it, inserted] = asset_map.try_emplace(asset_id);
     if (!inserted)
     {
       auto shared = it->second.lock();
       if (shared)
+      {
+        QueueLoad(shared, priority, /*only_if_pending*/ true);
         return shared;
+      }
     }
     std::shared_ptr<AssetType> ptr(new AssetType(std::move(library), asset_id), [&](AssetType* a) {
       {
@@ -78,14 +127,35 @@ private:
           m_memory_exceeded = false;
         }
       }
+      {
+        std::lock_guard lk(m_queue_lock);
+        m_pending_loads.erase(a);
+      }
       delete a;
     });
     it->second = ptr;
-    m_asset_load_thread.Push(it->second);
+    QueueLoad(ptr, priority, /*only_if_pending*/ false);
     return ptr;
   }
 
+  // Queues the asset unless it is already queued with the same or a higher priority.  With
+  // only_if_pending, assets which aren't queued at all are left alone
+  void QueueLoad(const std::shared_ptr<CustomAsset>& asset, LoadPriority priority,
+                 bool only_if_pending);
+
+  void LoaderThread();
+  void MonitorThread();
+
+  // Starts watching the files of a loaded asset, returning whether the OS reports changes to them
+  bool WatchAssetFiles(const CustomAsset& asset);
+  // Sleeps until the next check, returning whether any watched file changed in the meantime
+  bool WaitForFileChanges();
+
+  void RecordLoadLatency(Clock::duration latency);
+
   static constexpr auto TIME_BETWEEN_ASSET_MONITOR_CHECKS = std::chrono::milliseconds{500};
+  static constexpr std::size_t MAX_LOADER_THREADS = 4;
+  static constexpr std::size_t NUM_LATENCY_SAMPLES = 256;
 
   std::map<CustomAssetLibrary::AssetID, std::weak_ptr<GameTextureAsset>> m_game_textures;
   std::map<CustomAssetLibrary::AssetID, std::weak_ptr<PixelShaderAsset>> m_pixel_shaders;
@@ -98,11 +168,27 @@ private:
   std::size_t m_max_memory_available = 0;
   std::atomic_bool m_memory_exceeded = false;
 
-  std::map<CustomAssetLibrary::AssetID, std::weak_ptr<CustomAsset>> m_assets_to_monitor;
+  std::map<CustomAssetLibrary::AssetID, MonitoredAsset> m_assets_to_monitor;
 
   // Use a recursive mutex to handle the scenario where an asset goes out of scope while
   // iterating over the assets to monitor which calls the lock above in 'LoadOrCreateAsset'
   std::recursive_mutex m_asset_load_lock;
-  Common::WorkQueueThread<std::weak_ptr<CustomAsset>> m_asset_load_thread;
+
+  // One queue per priority.  An asset may be in several queues after its priority was raised,
+  // m_pending_loads tells which of the entries is current
+  std::mutex m_queue_lock;
+  std::condition_variable m_queue_cond_var;
+  std::array<std::deque<QueuedLoad>, NUM_LOAD_PRIORITIES> m_load_queues;
+  std::map<const CustomAsset*, LoadPriority> m_pending_loads;
+  bool m_loader_threads_shutdown = false;
+  std::vector<std::thread> m_loader_threads;
+
+  mutable std::mutex m_latency_lock;
+  std::vector<Clock::duration> m_load_latencies;
+  std::size_t m_next_latency_sample = 0;
+
+#ifdef __linux__
+  int m_inotify_fd = -1;
+#endif
 };
 }  // namespace VideoCommon
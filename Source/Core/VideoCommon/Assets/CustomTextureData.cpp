@@ -8,6 +8,7 @@
 #include <cstdint>
 #include <cstring>
 #include <functional>
+#include <span>
 
 #include "Common/Align.h"
 #include "Common/IOFile.h"
@@ -257,7 +258,39 @@ static void ConvertTexture_R8G8B8(VideoCommon::CustomTextureData::ArraySlice::Le
   level->data = std::move(new_data);
 }
 
-static bool ParseDDSHeader(File::IOFile& file, DDSLoadInfo* info)
+// Reads a file which is already in memory, such as one in a texture pack, like File::IOFile reads
+// one from the disk.
+class MemoryReader
+{
+public:
+  explicit MemoryReader(std::span<const u8> data) : m_data(data) {}
+
+  bool ReadBytes(void* data, size_t length)
+  {
+    if (length > m_data.size() - m_position)
+      return false;
+    std::memcpy(data, m_data.data() + m_position, length);
+    m_position += length;
+    return true;
+  }
+
+  bool Seek(s64 offset, File::SeekOrigin origin)
+  {
+    if (origin != File::SeekOrigin::Begin || offset < 0 || static_cast<u64>(offset) > GetSize())
+      return false;
+    m_position = static_cast<size_t>(offset);
+    return true;
+  }
+
+  u64 GetSize() const { return m_data.size(); }
+
+private:
+  std::span<const u8> m_data;
+  size_t m_position = 0;
+};
+
+template <typename Reader>
+static bool ParseDDSHeader(Reader& file, DDSLoadInfo* info)
 {
   // Exit as early as possible for non-DDS textures, since all extensions are currently
   // passed through this function.
@@ -457,10 +490,10 @@ static bool ParseDDSHeader(File::IOFile& file, DDSLoadInfo* info)
   return true;
 }
 
-static bool ReadMipLevel(VideoCommon::CustomTextureData::ArraySlice::Level* level,
-                         File::IOFile& file, const std::string& filename, u32 mip_level,
-                         const DDSLoadInfo& info, u32 width, u32 height, u32 row_length,
-                         size_t size)
+template <typename Reader>
+static bool ReadMipLevel(VideoCommon::CustomTextureData::ArraySlice::Level* level, Reader& file,
+                         const std::string& filename, u32 mip_level, const DDSLoadInfo& info,
+                         u32 width, u32 height, u32 row_length, size_t size)
 {
   // D3D11 cannot handle block compressed textures where the first mip level is
   // not a multiple of the block size.
@@ -490,16 +523,11 @@ static bool ReadMipLevel(VideoCommon::CustomTextureData::ArraySlice::Level* leve
   return true;
 }
 
-}  // namespace
-
-namespace VideoCommon
+template <typename Reader>
+static bool LoadDDSTextureFromReader(VideoCommon::CustomTextureData* texture, Reader& file,
+                                     const std::string& filename)
 {
-bool LoadDDSTexture(CustomTextureData* texture, const std::string& filename)
-{
-  File::IOFile file;
-  file.Open(filename, "rb");
-  if (!file.IsOpen())
-    return false;
+  using VideoCommon::CustomTextureData;
 
   DDSLoadInfo info;
   if (!ParseDDSHeader(file, &info))
@@ -547,21 +575,55 @@ bool LoadDDSTexture(CustomTextureData* texture, const std::string& filename)
   return true;
 }
 
-bool LoadDDSTexture(CustomTextureData::ArraySlice::Level* level, const std::string& filename,
-                    u32 mip_level)
+template <typename Reader>
+static bool LoadDDSMipLevelFromReader(VideoCommon::CustomTextureData::ArraySlice::Level* level,
+                                      Reader& file, const std::string& filename, u32 mip_level)
 {
   // Only loading a single mip level.
+  DDSLoadInfo info;
+  if (!ParseDDSHeader(file, &info))
+    return false;
+
+  return ReadMipLevel(level, file, filename, mip_level, info, info.width, info.height,
+                      info.first_mip_row_length, info.first_mip_size);
+}
+}  // namespace
+
+namespace VideoCommon
+{
+bool LoadDDSTexture(CustomTextureData* texture, const std::string& filename)
+{
   File::IOFile file;
   file.Open(filename, "rb");
   if (!file.IsOpen())
     return false;
 
-  DDSLoadInfo info;
-  if (!ParseDDSHeader(file, &info))
+  return LoadDDSTextureFromReader(texture, file, filename);
+}
+
+bool LoadDDSTexture(CustomTextureData* texture, std::span<const u8> data,
+                    const std::string& name)
+{
+  MemoryReader reader(data);
+  return LoadDDSTextureFromReader(texture, reader, name);
+}
+
+bool LoadDDSTexture(CustomTextureData::ArraySlice::Level* level, const std::string& filename,
+                    u32 mip_level)
+{
+  File::IOFile file;
+  file.Open(filename, "rb");
+  if (!file.IsOpen())
     return false;
 
-  return ReadMipLevel(level, file, filename, mip_level, info, info.width, info.height,
-                      info.first_mip_row_length, info.first_mip_size);
+  return LoadDDSMipLevelFromReader(level, file, filename, mip_level);
+}
+
+bool LoadDDSTexture(CustomTextureData::ArraySlice::Level* level, std::span<const u8> data,
+                    const std::string& name, u32 mip_level)
+{
+  MemoryReader reader(data);
+  return LoadDDSMipLevelFromReader(level, reader, name, mip_level);
 }
 
 bool LoadPNGTexture(CustomTextureData::ArraySlice::Level* level, const std::string& filename)
@@ -574,6 +636,15 @@ bool LoadPNGTexture(CustomTextureData::ArraySlice::Level* level, const std::stri
   std::vector<u8> buffer(file.GetSize());
   file.ReadBytes(buffer.data(), file.GetSize());
 
+  return LoadPNGTexture(level, buffer);
+}
+
+bool LoadPNGTexture(CustomTextureData::ArraySlice::Level* level, std::span<const u8> data)
+{
+  if (!level) [[unlikely]]
+    return false;
+
+  const std::vector<u8> buffer(data.begin(), data.end());
   if (!Common::LoadPNG(buffer, &level->data, &level->width, &level->height))
     return false;
 
@@ -3,6 +3,7 @@
 
 #pragma once
 
+#include <span>
 #include <string>
 #include <vector>
 
@@ -30,7 +31,11 @@ public:
 };
 
 bool LoadDDSTexture(CustomTextureData* texture, const std::string& filename);
+bool LoadDDSTexture(CustomTextureData* texture, std::span<const u8> data, const std::string& name);
 bool LoadDDSTexture(CustomTextureData::ArraySlice::Level* level, const std::string& filename,
                     u32 mip_level);
+bool LoadDDSTexture(CustomTextureData::ArraySlice::Level* level, std::span<const u8> data,
+                    const std::string& name, u32 mip_level);
 bool LoadPNGTexture(CustomTextureData::ArraySlice::Level* level, const std::string& filename);
+bool LoadPNGTexture(CustomTextureData::ArraySlice::Level* level, std::span<const u8> data);
 }  // namespace VideoCommon
@@ -74,6 +74,19 @@ DirectFilesystemAssetLibrary::GetLastAssetWriteTime(const AssetID& asset_id) con
   return {};
 }
 
+std::optional<std::vector<std::filesystem::path>>
+DirectFilesystemAssetLibrary::GetAssetFilePaths(const AssetID& asset_id) const
+{
+  std::vector<std::filesystem::path> paths;
+  for (auto& [key, value] : GetAssetMapForID(asset_id))
+    paths.push_back(std::move(value));
+
+  // The asset might be mapped later, which can only be noticed by polling
+  if (paths.empty())
+    return std::nullopt;
+  return paths;
+}
+
 CustomAssetLibrary::LoadInfo DirectFilesystemAssetLibrary::LoadPixelShader(const AssetID& asset_id,
                                                                            PixelShaderData* data)
 {
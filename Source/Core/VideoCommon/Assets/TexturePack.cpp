@@ -0,0 +1,255 @@
+// Copyright 2024 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "VideoCommon/Assets/TexturePack.h"
+
+#include <algorithm>
+#include <cstring>
+#include <utility>
+
+#ifdef _WIN32
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "Common/Align.h"
+#include "Common/FileUtil.h"
+#include "Common/IOFile.h"
+#include "Common/Logging/Log.h"
+#include "Common/StringUtil.h"
+
+namespace VideoCommon
+{
+std::unique_ptr<TexturePack> TexturePack::Open(const std::string& path)
+{
+  std::unique_ptr<TexturePack> pack(new TexturePack());
+  pack->m_path = path;
+
+#ifdef _WIN32
+  const HANDLE file = CreateFileW(UTF8ToWString(path).c_str(), GENERIC_READ, FILE_SHARE_READ,
+                                  nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+  if (file == INVALID_HANDLE_VALUE)
+    return nullptr;
+  pack->m_file_handle = file;
+
+  LARGE_INTEGER size;
+  if (!GetFileSizeEx(file, &size) || size.QuadPart == 0)
+    return nullptr;
+
+  const HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+  if (!mapping)
+    return nullptr;
+  pack->m_mapping_handle = mapping;
+
+  pack->m_data = static_cast<const u8*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+  if (!pack->m_data)
+    return nullptr;
+  pack->m_size = static_cast<size_t>(size.QuadPart);
+#else
+  const int fd = open(path.c_str(), O_RDONLY);
+  if (fd < 0)
+    return nullptr;
+
+  struct stat st;
+  if (fstat(fd, &st) != 0 || st.st_size == 0)
+  {
+    close(fd);
+    return nullptr;
+  }
+
+  void* data = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_SHARED, fd, 0);
+  close(fd);
+  if (data == MAP_FAILED)
+    return nullptr;
+  pack->m_data = static_cast<const u8*>(data);
+  pack->m_size = static_cast<size_t>(st.st_size);
+#endif
+
+  Header header;
+  if (pack->m_size < sizeof(header))
+    return nullptr;
+  std::memcpy(&header, pack->m_data, sizeof(header));
+  if (header.magic != MAGIC || header.version != VERSION)
+  {
+    ERROR_LOG_FMT(VIDEO, "'{}' is not a supported texture pack", path);
+    return nullptr;
+  }
+
+  const u64 index_size = u64{header.file_count} * sizeof(IndexEntry);
+  if (header.index_offset % alignof(IndexEntry) != 0 || header.index_offset > pack->m_size ||
+      index_size + header.names_size > pack->m_size - header.index_offset)
+  {
+    ERROR_LOG_FMT(VIDEO, "Texture pack '{}' is truncated", path);
+    return nullptr;
+  }
+
+  pack->m_index = {reinterpret_cast<const IndexEntry*>(pack->m_data + header.index_offset),
+                   header.file_count};
+  pack->m_names = reinterpret_cast<const char*>(pack->m_data + header.index_offset + index_size);
+  for (size_t i = 0; i < pack->m_index.size(); ++i)
+  {
+    const IndexEntry& entry = pack->m_index[i];
+    if (entry.data_offset > pack->m_size || entry.data_size > pack->m_size - entry.data_offset ||
+        entry.name_offset > header.names_size ||
+        entry.name_size > header.names_size - entry.name_offset)
+    {
+      ERROR_LOG_FMT(VIDEO, "Texture pack '{}' has an invalid index", path);
+      return nullptr;
+    }
+
+    // GetFile does a binary search, so the names must be sorted and unique.
+    if (i != 0 && pack->GetName(pack->m_index[i - 1]) >= pack->GetName(entry))
+    {
+      ERROR_LOG_FMT(VIDEO, "Texture pack '{}' has an unsorted index", path);
+      return nullptr;
+    }
+  }
+
+  return pack;
+}
+
+bool TexturePack::Write(const std::string& path, const std::vector<std::string>& files)
+{
+  std::vector<std::pair<std::string, const std::string*>> names;
+  names.reserve(files.size());
+  for (const std::string& file : files)
+  {
+    std::string name, extension;
+    SplitPath(file, nullptr, &name, &extension);
+    names.emplace_back(name + extension, &file);
+  }
+  std::sort(names.begin(), names.end());
+
+  const auto duplicate = std::adjacent_find(
+      names.begin(), names.end(), [](const auto& a, const auto& b) { return a.first == b.first; });
+  if (duplicate != names.end())
+  {
+    ERROR_LOG_FMT(VIDEO, "'{}' and '{}' have the same name", *duplicate->second,
+                  *std::next(duplicate)->second);
+    return false;
+  }
+
+  File::IOFile output(path, "wb");
+  if (!output)
+  {
+    ERROR_LOG_FMT(VIDEO, "Failed to create '{}'", path);
+    return false;
+  }
+
+  // Don't leave a partial pack behind, since it would still be loaded as a valid pack if only some
+  // of the textures couldn't be read.
+  const auto fail = [&output, &path] {
+    output.Close();
+    File::Delete(path);
+    return false;
+  };
+
+  Header header{MAGIC, VERSION, static_cast<u32>(names.size()), 0, 0};
+  if (!output.WriteArray(&header, 1))
+    return fail();
+
+  std::vector<IndexEntry> index;
+  index.reserve(names.size());
+  std::string name_data;
+  std::vector<u8> data;
+  for (const auto& [name, file_path] : names)
+  {
+    File::IOFile input(*file_path, "rb");
+    if (!input)
+    {
+      ERROR_LOG_FMT(VIDEO, "Failed to open '{}'", *file_path);
+      return fail();
+    }
+
+    data.resize(input.GetSize());
+    if (!input.ReadBytes(data.data(), data.size()))
+    {
+      ERROR_LOG_FMT(VIDEO, "Failed to read '{}'", *file_path);
+      return fail();
+    }
+
+    const u64 offset = Common::AlignUp(output.Tell(), DATA_ALIGNMENT);
+    if (!output.Seek(static_cast<s64>(offset), File::SeekOrigin::Begin) ||
+        !output.WriteBytes(data.data(), data.size()))
+    {
+      return fail();
+    }
+
+    index.push_back({offset, data.size(), static_cast<u32>(name_data.size()),
+                     static_cast<u32>(name.size())});
+    name_data += name;
+  }
+
+  header.names_size = static_cast<u32>(name_data.size());
+  header.index_offset = Common::AlignUp(output.Tell(), alignof(IndexEntry));
+  if (!output.Seek(static_cast<s64>(header.index_offset), File::SeekOrigin::Begin) ||
+      !output.WriteArray(index.data(), index.size()) ||
+      !output.WriteBytes(name_data.data(), name_data.size()) ||
+      !output.Seek(0, File::SeekOrigin::Begin) || !output.WriteArray(&header, 1) || !output.Close())
+  {
+    return fail();
+  }
+
+  return true;
+}
+
+TexturePack::~TexturePack()
+{
+#ifdef _WIN32
+  if (m_data)
+    UnmapViewOfFile(m_data);
+  if (m_mapping_handle)
+    CloseHandle(m_mapping_handle);
+  if (m_file_handle)
+    CloseHandle(m_file_handle);
+#else
+  if (m_data)
+    munmap(const_cast<u8*>(m_data), m_size);
+#endif
+}
+
+std::vector<std::string_view> TexturePack::GetFileNames() const
+{
+  std::vector<std::string_view> names;
+  names.reserve(m_index.size());
+  for (const IndexEntry& entry : m_index)
+    names.push_back(GetName(entry));
+  return names;
+}
+
+std::optional<std::span<const u8>> TexturePack::GetFile(std::string_view name) const
+{
+  const auto iter = std::lower_bound(
+      m_index.begin(), m_index.end(), name,
+      [this](const IndexEntry& entry, std::string_view n) { return GetName(entry) < n; });
+  if (iter == m_index.end() || GetName(*iter) != name)
+    return std::nullopt;
+
+  return std::span<const u8>(m_data + iter->data_offset, iter->data_size);
+}
+
+void TexturePack::Prefetch(std::span<const u8> file) const
+{
+  if (file.empty())
+    return;
+
+#ifdef _WIN32
+  WIN32_MEMORY_RANGE_ENTRY range{const_cast<u8*>(file.data()), file.size()};
+  PrefetchVirtualMemory(GetCurrentProcess(), 1, &range, 0);
+#else
+  const uintptr_t page_size = static_cast<uintptr_t>(sysconf(_SC_PAGESIZE));
+  const uintptr_t start = Common::AlignDown(reinterpret_cast<uintptr_t>(file.data()), page_size);
+  const uintptr_t end = reinterpret_cast<uintptr_t>(file.data() + file.size());
+  madvise(reinterpret_cast<void*>(start), end - start, MADV_WILLNEED);
+#endif
+}
+
+std::string_view TexturePack::GetName(const IndexEntry& entry) const
+{
+  return {m_names + entry.name_offset, entry.name_size};
+}
+}  // namespace VideoCommon
@@ -0,0 +1,84 @@
+// Copyright 2024 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "Common/CommonTypes.h"
+
+namespace VideoCommon
+{
+// A single file which contains the files of a custom texture pack, so that large packs don't
+// have to be read through the filesystem one file at a time. The textures are stored as they are,
+// which means that DDS textures keep their block compressed mip chains.
+//
+// The file starts with a header, followed by the file data, each of which is aligned to
+// DATA_ALIGNMENT, followed by the index, which is sorted by name, followed by the names.
+class TexturePack
+{
+public:
+  static constexpr u32 MAGIC = 0x50544C44;  // "DLTP"
+  static constexpr u32 VERSION = 1;
+  static constexpr u64 DATA_ALIGNMENT = 0x1000;
+
+  struct Header
+  {
+    u32 magic;
+    u32 version;
+    u32 file_count;
+    u32 names_size;
+    u64 index_offset;
+  };
+  static_assert(sizeof(Header) == 24);
+
+  struct IndexEntry
+  {
+    u64 data_offset;
+    u64 data_size;
+    u32 name_offset;
+    u32 name_size;
+  };
+  static_assert(sizeof(IndexEntry) == 24);
+
+  // Maps the pack into memory. Returns nullptr if the file is not a valid texture pack.
+  static std::unique_ptr<TexturePack> Open(const std::string& path);
+
+  // Writes the given files to a new pack, naming them by their file names without the directory.
+  // Fails without leaving a pack behind if any of the files can't be read.
+  static bool Write(const std::string& path, const std::vector<std::string>& files);
+
+  ~TexturePack();
+  TexturePack(const TexturePack&) = delete;
+  TexturePack& operator=(const TexturePack&) = delete;
+
+  const std::string& GetPath() const { return m_path; }
+  std::vector<std::string_view> GetFileNames() const;
+  std::optional<std::span<const u8>> GetFile(std::string_view name) const;
+
+  // Asks the OS to start reading the file in the background. Pages which haven't been used for a
+  // while are evicted by the OS again, so a pack doesn't have to fit in memory.
+  void Prefetch(std::span<const u8> file) const;
+
+private:
+  TexturePack() = default;
+
+  std::string_view GetName(const IndexEntry& entry) const;
+
+  std::string m_path;
+  const u8* m_data = nullptr;
+  size_t m_size = 0;
+#ifdef _WIN32
+  void* m_file_handle = nullptr;
+  void* m_mapping_handle = nullptr;
+#endif
+  std::span<const IndexEntry> m_index;
+  const char* m_names = nullptr;
+};
+}  // namespace VideoCommon
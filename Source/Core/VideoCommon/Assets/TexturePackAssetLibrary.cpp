@@ -0,0 +1,191 @@
+// Copyright 2024 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "VideoCommon/Assets/TexturePackAssetLibrary.h"
+
+#include <utility>
+
+#include <fmt/format.h>
+
+#include "Common/Logging/Log.h"
+#include "Common/StringUtil.h"
+#include "VideoCommon/Assets/TextureAsset.h"
+#include "VideoCommon/RenderState.h"
+
+namespace VideoCommon
+{
+namespace
+{
+std::size_t GetAssetSize(const CustomTextureData& data)
+{
+  std::size_t total = 0;
+  for (const auto& slice : data.m_slices)
+  {
+    for (const auto& level : slice.m_levels)
+    {
+      total += level.data.size();
+    }
+  }
+  return total;
+}
+
+std::string GetLowerExtension(const std::string& file_name)
+{
+  std::string extension;
+  SplitPath(file_name, nullptr, nullptr, &extension);
+  Common::ToLower(&extension);
+  return extension;
+}
+}  // namespace
+
+CustomAssetLibrary::LoadInfo TexturePackAssetLibrary::LoadTexture(const AssetID& asset_id,
+                                                                  TextureData* data)
+{
+  const auto file = GetFileForID(asset_id);
+  if (!file)
+  {
+    ERROR_LOG_FMT(VIDEO, "Asset '{}' error - not found in any texture pack!", asset_id);
+    return {};
+  }
+
+  const auto file_data = file->pack->GetFile(file->name);
+  if (!file_data)
+  {
+    ERROR_LOG_FMT(VIDEO, "Asset '{}' error - '{}' is missing from texture pack '{}'!", asset_id,
+                  file->name, file->pack->GetPath());
+    return {};
+  }
+
+  data->m_sampler = RenderState::GetLinearSamplerState();
+  data->m_type = TextureData::Type::Type_Texture2D;
+
+  const std::string ext = GetLowerExtension(file->name);
+  if (ext == ".dds")
+  {
+    if (!LoadDDSTexture(&data->m_texture, *file_data, file->name))
+    {
+      ERROR_LOG_FMT(VIDEO, "Asset '{}' error - could not load dds texture!", asset_id);
+      return {};
+    }
+
+    if (data->m_texture.m_slices.empty()) [[unlikely]]
+      data->m_texture.m_slices.push_back({});
+  }
+  else if (ext == ".png")
+  {
+    data->m_texture.m_slices.resize(1);
+    auto& slice = data->m_texture.m_slices[0];
+    slice.m_levels.resize(1);
+
+    if (!LoadPNGTexture(&slice.m_levels[0], *file_data))
+    {
+      ERROR_LOG_FMT(VIDEO, "Asset '{}' error - could not load png texture!", asset_id);
+      return {};
+    }
+  }
+  else
+  {
+    ERROR_LOG_FMT(VIDEO, "Asset '{}' error - extension '{}' unknown!", asset_id, ext);
+    return {};
+  }
+
+  if (!LoadMips(*file, &data->m_texture.m_slices[0]))
+    return {};
+
+  return LoadInfo{GetAssetSize(data->m_texture), file->assign_time};
+}
+
+CustomAssetLibrary::LoadInfo TexturePackAssetLibrary::LoadPixelShader(const AssetID& asset_id,
+                                                                      PixelShaderData*)
+{
+  ERROR_LOG_FMT(VIDEO, "Asset '{}' error - texture packs only contain textures!", asset_id);
+  return {};
+}
+
+CustomAssetLibrary::LoadInfo TexturePackAssetLibrary::LoadMaterial(const AssetID& asset_id,
+                                                                   MaterialData*)
+{
+  ERROR_LOG_FMT(VIDEO, "Asset '{}' error - texture packs only contain textures!", asset_id);
+  return {};
+}
+
+CustomAssetLibrary::LoadInfo TexturePackAssetLibrary::LoadMesh(const AssetID& asset_id, MeshData*)
+{
+  ERROR_LOG_FMT(VIDEO, "Asset '{}' error - texture packs only contain textures!", asset_id);
+  return {};
+}
+
+CustomAssetLibrary::TimeType
+TexturePackAssetLibrary::GetLastAssetWriteTime(const AssetID& asset_id) const
+{
+  const auto file = GetFileForID(asset_id);
+  return file ? file->assign_time : TimeType{};
+}
+
+const TexturePack* TexturePackAssetLibrary::AddPack(std::unique_ptr<TexturePack> pack)
+{
+  std::lock_guard lk(m_lock);
+  return m_packs.emplace_back(std::move(pack)).get();
+}
+
+void TexturePackAssetLibrary::SetAssetIDFile(const AssetID& asset_id, const TexturePack* pack,
+                                             std::string file_name)
+{
+  std::lock_guard lk(m_lock);
+  m_assetid_to_file[asset_id] =
+      PackFile{pack, std::move(file_name), std::chrono::system_clock::now()};
+}
+
+void TexturePackAssetLibrary::Prefetch(const AssetID& asset_id) const
+{
+  const auto file = GetFileForID(asset_id);
+  if (!file)
+    return;
+
+  if (const auto file_data = file->pack->GetFile(file->name))
+    file->pack->Prefetch(*file_data);
+}
+
+bool TexturePackAssetLibrary::LoadMips(const PackFile& file, CustomTextureData::ArraySlice* data)
+{
+  if (!data) [[unlikely]]
+    return false;
+
+  std::string filename;
+  std::string extension;
+  SplitPath(file.name, nullptr, &filename, &extension);
+  const std::string extension_lower = GetLowerExtension(file.name);
+
+  // Load additional mip levels
+  for (u32 mip_level = static_cast<u32>(data->m_levels.size());; mip_level++)
+  {
+    const auto mip_level_filename = filename + fmt::format("_mip{}", mip_level) + extension;
+    const auto mip_data = file.pack->GetFile(mip_level_filename);
+    if (!mip_data)
+      return true;
+
+    VideoCommon::CustomTextureData::ArraySlice::Level level;
+    const bool loaded = extension_lower == ".dds" ?
+                            LoadDDSTexture(&level, *mip_data, mip_level_filename, mip_level) :
+                            LoadPNGTexture(&level, *mip_data);
+    if (!loaded)
+    {
+      ERROR_LOG_FMT(VIDEO, "Custom mipmap '{}' failed to load", mip_level_filename);
+      return false;
+    }
+
+    data->m_levels.push_back(std::move(level));
+  }
+
+  return true;
+}
+
+std::optional<TexturePackAssetLibrary::PackFile>
+TexturePackAssetLibrary::GetFileForID(const AssetID& asset_id) const
+{
+  std::lock_guard lk(m_lock);
+  if (auto iter = m_assetid_to_file.find(asset_id); iter != m_assetid_to_file.end())
+    return iter->second;
+  return std::nullopt;
+}
+}  // namespace VideoCommon
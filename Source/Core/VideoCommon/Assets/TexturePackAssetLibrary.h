@@ -0,0 +1,60 @@
+// Copyright 2024 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "VideoCommon/Assets/CustomAssetLibrary.h"
+#include "VideoCommon/Assets/CustomTextureData.h"
+#include "VideoCommon/Assets/TexturePack.h"
+
+namespace VideoCommon
+{
+// This class implements 'CustomAssetLibrary' and loads textures from texture packs, which are
+// mapped into memory, so only the textures that are used are ever read from the disk
+class TexturePackAssetLibrary final : public CustomAssetLibrary
+{
+public:
+  LoadInfo LoadTexture(const AssetID& asset_id, TextureData* data) override;
+  LoadInfo LoadPixelShader(const AssetID& asset_id, PixelShaderData* data) override;
+  LoadInfo LoadMaterial(const AssetID& asset_id, MaterialData* data) override;
+  LoadInfo LoadMesh(const AssetID& asset_id, MeshData* data) override;
+
+  // Packs can't change while they are mapped, so this is the time the asset id was assigned.
+  // There are no files to watch, so a reassigned asset id is noticed by polling this
+  TimeType GetLastAssetWriteTime(const AssetID& asset_id) const override;
+
+  // Takes ownership of the pack, which has to outlive any asset id assigned to one of its files
+  const TexturePack* AddPack(std::unique_ptr<TexturePack> pack);
+
+  // Assigns the asset id to a texture file in a pack that was added
+  void SetAssetIDFile(const AssetID& asset_id, const TexturePack* pack, std::string file_name);
+
+  // Starts reading the texture from the disk in the background, before it is loaded
+  void Prefetch(const AssetID& asset_id) const;
+
+private:
+  struct PackFile
+  {
+    const TexturePack* pack;
+    std::string name;
+    TimeType assign_time;
+  };
+
+  // Loads additional mip levels into the texture structure until _mip<N> texture is not found
+  bool LoadMips(const PackFile& file, CustomTextureData::ArraySlice* data);
+
+  // Gets the pack file given an asset id
+  std::optional<PackFile> GetFileForID(const AssetID& asset_id) const;
+
+  mutable std::mutex m_lock;
+  std::vector<std::unique_ptr<TexturePack>> m_packs;
+  std::map<AssetID, PackFile> m_assetid_to_file;
+};
+}  // namespace VideoCommon
@@ -12,6 +12,7 @@
 #include "VideoCommon/Present.h"
 #include "VideoCommon/RenderBase.h"
 #include "VideoCommon/Statistics.h"
+#include "VideoCommon/TextureCacheBase.h"
 #include "VideoCommon/VertexManagerBase.h"
 #include "VideoCommon/VideoBackendBase.h"
 #include "VideoCommon/VideoCommon.h"
@@ -175,6 +176,11 @@ void AsyncRequests::HandleEvent(const AsyncRequests::Event& e)
   case Event::DO_SAVE_STATE:
     VideoCommon_DoState(*e.do_save_state.p);
     break;
+
+  case Event::WRITE_BACK_EFB_COPIES:
+    g_texture_cache->WriteBackEFBCopies(e.write_back_efb_copies.address,
+                                        e.write_back_efb_copies.size);
+    break;
   }
 }
 
@@ -30,6 +30,7 @@ public:
       FIFO_RESET,
       PERF_QUERY,
       DO_SAVE_STATE,
+      WRITE_BACK_EFB_COPIES,
     } type;
     u64 time;
 
@@ -75,6 +76,12 @@ public:
       {
         PointerWrap* p;
       } do_save_state;
+
+      struct
+      {
+        u32 address;
+        u32 size;
+      } write_back_efb_copies;
     };
   };
 
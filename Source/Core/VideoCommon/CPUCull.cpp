@@ -3,6 +3,8 @@
 
 #include "VideoCommon/CPUCull.h"
 
+#include <array>
+
 #include "Common/Assert.h"
 #include "Common/CPUDetect.h"
 #include "Common/MathUtil.h"
@@ -10,6 +12,7 @@
 #include "Core/System.h"
 
 #include "VideoCommon/CPMemory.h"
+#include "VideoCommon/Statistics.h"
 #include "VideoCommon/VertexManagerBase.h"
 #include "VideoCommon/VertexShaderManager.h"
 #include "VideoCommon/VideoConfig.h"
@@ -54,10 +57,18 @@
 #include "VideoCommon/CPUCullImpl.h"
 #define USE_FMA
 #include "VideoCommon/CPUCullImpl.h"
+#define USE_AVX2
+#include "VideoCommon/CPUCullImpl.h"
+#define USE_AVX512
+#include "VideoCommon/CPUCullImpl.h"
 #endif
 
 #if defined(USE_SSE)
-#if defined(__AVX__) && defined(__FMA__)
+#if defined(__AVX512F__)
+static constexpr int MIN_SSE = 60;
+#elif defined(__AVX2__) && defined(__FMA__)
+static constexpr int MIN_SSE = 52;
+#elif defined(__AVX__) && defined(__FMA__)
 static constexpr int MIN_SSE = 51;
 #elif defined(__AVX__)
 static constexpr int MIN_SSE = 50;
@@ -74,7 +85,11 @@ template <bool PositionHas3Elems, bool PerVertexPosMtx>
 static CPUCull::TransformFunction GetTransformFunction()
 {
 #if defined(USE_SSE)
-  if (MIN_SSE >= 51 || (cpu_info.bAVX && cpu_info.bFMA))
+  if (MIN_SSE >= 60 || (cpu_info.bAVX512F && cpu_info.bAVX2 && cpu_info.bFMA))
+    return CPUCull_AVX512::TransformVertices<PositionHas3Elems, PerVertexPosMtx>;
+  else if (MIN_SSE >= 52 || (cpu_info.bAVX2 && cpu_info.bFMA))
+    return CPUCull_AVX2::TransformVertices<PositionHas3Elems, PerVertexPosMtx>;
+  else if (MIN_SSE >= 51 || (cpu_info.bAVX && cpu_info.bFMA))
     return CPUCull_FMA::TransformVertices<PositionHas3Elems, PerVertexPosMtx>;
   else if (MIN_SSE >= 50 || cpu_info.bAVX)
     return CPUCull_AVX::TransformVertices<PositionHas3Elems, PerVertexPosMtx>;
@@ -91,6 +106,38 @@ static CPUCull::TransformFunction GetTransformFunction()
 #endif
 }
 
+template <bool PositionHas3Elems, bool PerVertexPosMtx>
+static CPUCull::TransformFunction
+GetTransformKernel([[maybe_unused]] CPUCull::TransformKernel kernel)
+{
+#if defined(USE_SSE)
+  switch (kernel)
+  {
+  case CPUCull::TransformKernel::SSE:
+    return CPUCull_SSE::TransformVertices<PositionHas3Elems, PerVertexPosMtx>;
+  case CPUCull::TransformKernel::FMA:
+    return CPUCull_FMA::TransformVertices<PositionHas3Elems, PerVertexPosMtx>;
+  case CPUCull::TransformKernel::AVX2:
+    return CPUCull_AVX2::TransformVertices<PositionHas3Elems, PerVertexPosMtx>;
+  case CPUCull::TransformKernel::AVX512:
+    return CPUCull_AVX512::TransformVertices<PositionHas3Elems, PerVertexPosMtx>;
+  }
+#endif
+  return nullptr;
+}
+
+template <bool PositionHas3Elems>
+static CPUCull::BoundsFunction GetBoundsFunction()
+{
+#if defined(USE_SSE)
+  return CPUCull_SSE::ComputeBounds<PositionHas3Elems>;
+#elif defined(USE_NEON)
+  return CPUCull_NEON::ComputeBounds<PositionHas3Elems>;
+#else
+  return CPUCull_Scalar::ComputeBounds<PositionHas3Elems>;
+#endif
+}
+
 template <OpcodeDecoder::Primitive Primitive, CullMode Mode>
 static CPUCull::CullFunction GetCullFunction0()
 {
@@ -121,6 +168,67 @@ static Common::EnumMap<CPUCull::CullFunction, CullMode::All> GetCullFunction1()
   };
 }
 
+enum class BoundsTestResult
+{
+  Outside,
+  Inside,
+  Intersecting,
+};
+
+// Draws with fewer vertices are cheaper to transform than to bound
+static constexpr u32 MIN_BOUNDS_TEST_VERTICES = 32;
+
+// Checking the first primitives before transforming the rest allows accepting draws early, since
+// a draw with visible primitives usually has some near its start. This is a multiple of the
+// vertices per triangle and per quad, so that only whole primitives are checked.
+static constexpr u32 PARTIAL_TRANSFORM_VERTICES = 96;
+
+// Positions are transformed by an affine function, so if all corners of a draw's bounding box are
+// outside of the same side of the frustum, then so are all of its vertices.
+static BoundsTestResult TestBounds(const CPUCull::BoundingBox& bounds,
+                                   const VertexShaderManager& vsmanager)
+{
+  const u32 idx = g_main_cp_state.matrix_index_a.PosNormalMtxIdx & 0x3f;
+  const float* posmtx = &xfmem.posMatrices[idx * 4];
+  const auto& projection = vsmanager.constants.projection;
+
+  // One bit for each of the sides of the frustum that all corners are outside of
+  u32 outside = 0xf;
+  bool inside = true;
+  for (u32 corner = 0; corner < 8; corner++)
+  {
+    const float x = (corner & 1) ? bounds.max.x : bounds.min.x;
+    const float y = (corner & 2) ? bounds.max.y : bounds.min.y;
+    const float z = (corner & 4) ? bounds.max.z : bounds.min.z;
+
+    std::array<float, 4> view;
+    for (u32 i = 0; i < 3; i++)
+    {
+      const float* row = &posmtx[i * 4];
+      view[i] = row[0] * x + row[1] * y + row[2] * z + row[3];
+    }
+    view[3] = 1.0f;
+
+    std::array<float, 4> clip;
+    for (u32 i = 0; i < 4; i++)
+    {
+      clip[i] = projection[i][0] * view[0] + projection[i][1] * view[1] +
+                projection[i][2] * view[2] + projection[i][3] * view[3];
+    }
+
+    const u32 corner_outside = u32(clip[0] < -clip[3]) | u32(clip[1] < -clip[3]) << 1 |
+                               u32(clip[0] > clip[3]) << 2 | u32(clip[1] > clip[3]) << 3;
+    outside &= corner_outside;
+    inside &= corner_outside == 0 && clip[3] > 0.0f;
+  }
+
+  if (outside != 0)
+    return BoundsTestResult::Outside;
+  if (inside)
+    return BoundsTestResult::Inside;
+  return BoundsTestResult::Intersecting;
+}
+
 CPUCull::~CPUCull() = default;
 
 void CPUCull::Init()
@@ -129,6 +237,8 @@ void CPUCull::Init()
   m_transform_table[false][true] = GetTransformFunction<false, true>();
   m_transform_table[true][false] = GetTransformFunction<true, false>();
   m_transform_table[true][true] = GetTransformFunction<true, true>();
+  m_bounds_table[false] = GetBoundsFunction<false>();
+  m_bounds_table[true] = GetBoundsFunction<true>();
   using Prim = OpcodeDecoder::Primitive;
   m_cull_table[Prim::GX_DRAW_QUADS] = GetCullFunction1<Prim::GX_DRAW_QUADS>();
   m_cull_table[Prim::GX_DRAW_QUADS_2] = GetCullFunction1<Prim::GX_DRAW_QUADS>();
@@ -137,6 +247,19 @@ void CPUCull::Init()
   m_cull_table[Prim::GX_DRAW_TRIANGLE_FAN] = GetCullFunction1<Prim::GX_DRAW_TRIANGLE_FAN>();
 }
 
+CPUCull::TransformFunction CPUCull::GetTransformKernel(TransformKernel kernel,
+                                                       bool position_has_3_elems,
+                                                       bool per_vertex_pos_mtx)
+{
+  if (position_has_3_elems)
+  {
+    return per_vertex_pos_mtx ? ::GetTransformKernel<true, true>(kernel) :
+                                ::GetTransformKernel<true, false>(kernel);
+  }
+  return per_vertex_pos_mtx ? ::GetTransformKernel<false, true>(kernel) :
+                              ::GetTransformKernel<false, false>(kernel);
+}
+
 bool CPUCull::AreAllVerticesCulled(VertexLoaderBase* loader, OpcodeDecoder::Primitive primitive,
                                    const u8* src, u32 count)
 {
@@ -163,10 +286,53 @@ bool CPUCull::AreAllVerticesCulled(VertexLoaderBase* loader, OpcodeDecoder::Prim
   CullMode cullmode = bpmem.genMode.cullmode;
   if (xfmem.viewport.ht > 0)  // See videosoftware Clipper.cpp:IsBackface
     cullmode = cullmode_invert[cullmode];
+
+  INCSTAT(g_stats.this_frame.num_cpu_cull_draws);
+
+  // Without a per-vertex matrix index, every vertex is transformed by the same matrix.
+  if (!perVertexPosMtx && count >= MIN_BOUNDS_TEST_VERTICES)
+  {
+    BoundingBox bounds;
+    m_bounds_table[posHas3Elems](&bounds, src, stride, count);
+    switch (TestBounds(bounds, system.GetVertexShaderManager()))
+    {
+    case BoundsTestResult::Outside:
+      INCSTAT(g_stats.this_frame.num_cpu_cull_bounds_early_outs);
+      INCSTAT(g_stats.this_frame.num_cpu_culled_draws);
+      ADDSTAT(g_stats.this_frame.num_cpu_culled_vertices, count);
+      return true;
+    case BoundsTestResult::Inside:
+      // Only degenerate primitives could be culled, and drawing those is harmless
+      if (cullmode == CullMode::None)
+      {
+        INCSTAT(g_stats.this_frame.num_cpu_cull_bounds_early_outs);
+        return false;
+      }
+      break;
+    case BoundsTestResult::Intersecting:
+      break;
+    }
+  }
+
   const TransformFunction transform = m_transform_table[posHas3Elems][perVertexPosMtx];
-  transform(m_transform_buffer.get(), src, stride, count);
   const CullFunction cull = m_cull_table[primitive][cullmode];
-  return cull(m_transform_buffer.get(), count);
+  TransformedVertex* transformed = m_transform_buffer.get();
+  u32 num_transformed = 0;
+  if (count >= PARTIAL_TRANSFORM_VERTICES * 2)
+  {
+    transform(transformed, src, stride, PARTIAL_TRANSFORM_VERTICES);
+    if (!cull(transformed, PARTIAL_TRANSFORM_VERTICES))
+      return false;
+    num_transformed = PARTIAL_TRANSFORM_VERTICES;
+  }
+  transform(transformed + num_transformed, src + num_transformed * stride, stride,
+            count - num_transformed);
+  if (!cull(transformed, count))
+    return false;
+
+  INCSTAT(g_stats.this_frame.num_cpu_culled_draws);
+  ADDSTAT(g_stats.this_frame.num_cpu_culled_vertices, count);
+  return true;
 }
 
 template <typename T>
@@ -20,8 +20,28 @@ public:
     float x, y, z, w;
   };
 
+  // Object space bounds of the positions of a draw. Only x, y and z are meaningful.
+  struct BoundingBox
+  {
+    TransformedVertex min, max;
+  };
+
   using TransformFunction = void (*)(void*, const void*, u32, int);
   using CullFunction = bool (*)(const CPUCull::TransformedVertex*, int);
+  using BoundsFunction = void (*)(BoundingBox*, const void*, u32, int);
+
+  // A specific x86 transform kernel, regardless of whether the host supports it. The kernels are
+  // interchangeable, which lets them be compared against each other. Returns nullptr if the kernel
+  // isn't built for this architecture.
+  enum class TransformKernel
+  {
+    SSE,
+    FMA,
+    AVX2,
+    AVX512,
+  };
+  static TransformFunction GetTransformKernel(TransformKernel kernel, bool position_has_3_elems,
+                                              bool per_vertex_pos_mtx);
 
 private:
   template <typename T>
@@ -32,6 +52,7 @@ private:
   std::unique_ptr<TransformedVertex[], BufferDeleter<TransformedVertex>> m_transform_buffer{};
   u32 m_transform_buffer_size = 0;
   std::array<std::array<TransformFunction, 2>, 2> m_transform_table{};
+  std::array<BoundsFunction, 2> m_bounds_table{};
   Common::EnumMap<Common::EnumMap<CullFunction, CullMode::All>,
                   OpcodeDecoder::Primitive::GX_DRAW_TRIANGLE_FAN>
       m_cull_table{};
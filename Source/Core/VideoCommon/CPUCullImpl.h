@@ -1,7 +1,11 @@
 // Copyright 2022 Dolphin Emulator Project
 // SPDX-License-Identifier: GPL-2.0-or-later
 
-#if defined(USE_FMA)
+#if defined(USE_AVX512)
+#define VECTOR_NAMESPACE CPUCull_AVX512
+#elif defined(USE_AVX2)
+#define VECTOR_NAMESPACE CPUCull_AVX2
+#elif defined(USE_FMA)
 #define VECTOR_NAMESPACE CPUCull_FMA
 #elif defined(USE_AVX)
 #define VECTOR_NAMESPACE CPUCull_AVX
@@ -19,7 +23,11 @@
 #error This file is meant to be used by CPUCull.cpp only!
 #endif
 
-#if defined(__GNUC__) && defined(USE_FMA) && !(defined(__AVX__) && defined(__FMA__))
+#if defined(__GNUC__) && defined(USE_AVX512) && !defined(__AVX512F__)
+#define ATTR_TARGET __attribute__((target("avx512f,avx2,fma")))
+#elif defined(__GNUC__) && defined(USE_AVX2) && !(defined(__AVX2__) && defined(__FMA__))
+#define ATTR_TARGET __attribute__((target("avx2,fma")))
+#elif defined(__GNUC__) && defined(USE_FMA) && !(defined(__AVX__) && defined(__FMA__))
 #define ATTR_TARGET __attribute__((target("avx,fma")))
 #elif defined(__GNUC__) && defined(USE_AVX) && !defined(__AVX__)
 #define ATTR_TARGET __attribute__((target("avx")))
@@ -505,6 +513,242 @@ LoadTransformVertex(const u8* data, Vector pos0, Vector pos1, Vector pos2, Vecto
   return vertex;
 }
 
+template <bool PositionHas3Elems>
+ATTR_TARGET DOLPHIN_FORCE_INLINE static Vector LoadPosition(const u8* data)
+{
+  const float* fdata = reinterpret_cast<const float*>(data);
+#if defined(USE_SSE)
+  if constexpr (PositionHas3Elems)
+    return _mm_loadu_ps(fdata);
+  else
+    return _mm_loadl_pi(_mm_setzero_ps(), reinterpret_cast<const __m64*>(fdata));
+#elif defined(USE_NEON)
+  if constexpr (PositionHas3Elems)
+    return vld1q_f32(fdata);
+  else
+    return vcombine_f32(vld1_f32(fdata), vdup_n_f32(0.0f));
+#else
+  Vector vertex;
+  vertex.x = fdata[0];
+  vertex.y = fdata[1];
+  vertex.z = PositionHas3Elems ? fdata[2] : 0.0f;
+  vertex.w = 1.0f;
+  return vertex;
+#endif
+}
+
+#ifdef USE_AVX2
+// The wide kernels work on one component of WIDE_VERTICES vertices per register. Groups of four
+// vertices are loaded into the 128-bit lanes and transposed within them, so lane i of a register
+// holds vertex i.
+#ifdef USE_AVX512
+typedef __m512 WideVector;
+typedef __m512i WideIndices;
+constexpr int WIDE_VERTICES = 16;
+
+ATTR_TARGET DOLPHIN_FORCE_INLINE static WideVector WideSet(float value)
+{
+  return _mm512_set1_ps(value);
+}
+ATTR_TARGET DOLPHIN_FORCE_INLINE static WideVector WideAdd(WideVector a, WideVector b)
+{
+  return _mm512_add_ps(a, b);
+}
+ATTR_TARGET DOLPHIN_FORCE_INLINE static WideVector WideMul(WideVector a, WideVector b)
+{
+  return _mm512_mul_ps(a, b);
+}
+ATTR_TARGET DOLPHIN_FORCE_INLINE static WideVector WideFMA(WideVector a, WideVector b,
+                                                           WideVector c)
+{
+  return _mm512_fmadd_ps(a, b, c);
+}
+ATTR_TARGET DOLPHIN_FORCE_INLINE static WideIndices WideVertexOffsets(u32 stride)
+{
+  return _mm512_mullo_epi32(_mm512_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7,  //
+                                              8, 9, 10, 11, 12, 13, 14, 15),
+                            _mm512_set1_epi32(stride));
+}
+ATTR_TARGET DOLPHIN_FORCE_INLINE static WideIndices WideLoadMatrixIndices(const u8* vertices,
+                                                                          WideIndices offsets)
+{
+  const __m512i data = _mm512_i32gather_epi32(offsets, vertices, 1);
+  return _mm512_slli_epi32(_mm512_and_si512(data, _mm512_set1_epi32(0x3f)), 2);
+}
+ATTR_TARGET DOLPHIN_FORCE_INLINE static WideVector WideGather(const float* base,
+                                                              WideIndices indices)
+{
+  return _mm512_i32gather_ps(indices, base, sizeof(float));
+}
+ATTR_TARGET DOLPHIN_FORCE_INLINE static void WideTranspose(WideVector& o0, WideVector& o1,
+                                                           WideVector& o2, WideVector& o3)
+{
+  __m512d tmp0 = _mm512_castps_pd(_mm512_unpacklo_ps(o0, o1));
+  __m512d tmp1 = _mm512_castps_pd(_mm512_unpacklo_ps(o2, o3));
+  __m512d tmp2 = _mm512_castps_pd(_mm512_unpackhi_ps(o0, o1));
+  __m512d tmp3 = _mm512_castps_pd(_mm512_unpackhi_ps(o2, o3));
+  o0 = _mm512_castpd_ps(_mm512_unpacklo_pd(tmp0, tmp1));
+  o1 = _mm512_castpd_ps(_mm512_unpackhi_pd(tmp0, tmp1));
+  o2 = _mm512_castpd_ps(_mm512_unpacklo_pd(tmp2, tmp3));
+  o3 = _mm512_castpd_ps(_mm512_unpackhi_pd(tmp2, tmp3));
+}
+template <bool PositionHas3Elems>
+ATTR_TARGET DOLPHIN_FORCE_INLINE static WideVector WideLoad(const u8* data, u32 stride, int i)
+{
+  __m512 output = _mm512_castps128_ps512(LoadPosition<PositionHas3Elems>(data + stride * i));
+  output = _mm512_insertf32x4(output, LoadPosition<PositionHas3Elems>(data + stride * (i + 4)), 1);
+  output = _mm512_insertf32x4(output, LoadPosition<PositionHas3Elems>(data + stride * (i + 8)), 2);
+  output = _mm512_insertf32x4(output, LoadPosition<PositionHas3Elems>(data + stride * (i + 12)), 3);
+  return output;
+}
+ATTR_TARGET DOLPHIN_FORCE_INLINE static void WideStore(Vector* output, WideVector v, int i)
+{
+  output[i] = _mm512_castps512_ps128(v);
+  output[i + 4] = _mm512_extractf32x4_ps(v, 1);
+  output[i + 8] = _mm512_extractf32x4_ps(v, 2);
+  output[i + 12] = _mm512_extractf32x4_ps(v, 3);
+}
+#else
+typedef __m256 WideVector;
+typedef __m256i WideIndices;
+constexpr int WIDE_VERTICES = 8;
+
+ATTR_TARGET DOLPHIN_FORCE_INLINE static WideVector WideSet(float value)
+{
+  return _mm256_set1_ps(value);
+}
+ATTR_TARGET DOLPHIN_FORCE_INLINE static WideVector WideAdd(WideVector a, WideVector b)
+{
+  return _mm256_add_ps(a, b);
+}
+ATTR_TARGET DOLPHIN_FORCE_INLINE static WideVector WideMul(WideVector a, WideVector b)
+{
+  return _mm256_mul_ps(a, b);
+}
+ATTR_TARGET DOLPHIN_FORCE_INLINE static WideVector WideFMA(WideVector a, WideVector b,
+                                                           WideVector c)
+{
+  return _mm256_fmadd_ps(a, b, c);
+}
+ATTR_TARGET DOLPHIN_FORCE_INLINE static WideIndices WideVertexOffsets(u32 stride)
+{
+  return _mm256_mullo_epi32(_mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7), _mm256_set1_epi32(stride));
+}
+ATTR_TARGET DOLPHIN_FORCE_INLINE static WideIndices WideLoadMatrixIndices(const u8* vertices,
+                                                                          WideIndices offsets)
+{
+  const __m256i data =
+      _mm256_i32gather_epi32(reinterpret_cast<const int*>(vertices), offsets, 1);
+  return _mm256_slli_epi32(_mm256_and_si256(data, _mm256_set1_epi32(0x3f)), 2);
+}
+ATTR_TARGET DOLPHIN_FORCE_INLINE static WideVector WideGather(const float* base,
+                                                              WideIndices indices)
+{
+  return _mm256_i32gather_ps(base, indices, sizeof(float));
+}
+ATTR_TARGET DOLPHIN_FORCE_INLINE static void WideTranspose(WideVector& o0, WideVector& o1,
+                                                           WideVector& o2, WideVector& o3)
+{
+  TransposeYMM(o0, o1, o2, o3);
+}
+template <bool PositionHas3Elems>
+ATTR_TARGET DOLPHIN_FORCE_INLINE static WideVector WideLoad(const u8* data, u32 stride, int i)
+{
+  const __m128 low = LoadPosition<PositionHas3Elems>(data + stride * i);
+  const __m128 high = LoadPosition<PositionHas3Elems>(data + stride * (i + 4));
+  return _mm256_insertf128_ps(_mm256_castps128_ps256(low), high, 1);
+}
+ATTR_TARGET DOLPHIN_FORCE_INLINE static void WideStore(Vector* output, WideVector v, int i)
+{
+  output[i] = _mm256_castps256_ps128(v);
+  output[i + 4] = _mm256_extractf128_ps(v, 1);
+}
+#endif
+
+// Same operations in the same order as TransformVertexYMM, so that the results are identical.
+template <bool PositionHas3Elems>
+ATTR_TARGET DOLPHIN_FORCE_INLINE static WideVector
+TransformPositionWide(WideVector x, WideVector y, WideVector z, const float* row)
+{
+  WideVector output = WideFMA(x, WideSet(row[0]), WideSet(row[3]));
+  output = WideFMA(y, WideSet(row[1]), output);
+  if constexpr (PositionHas3Elems)
+    output = WideFMA(z, WideSet(row[2]), output);
+  return output;
+}
+
+// Same operations in the same order as TransformVertexNoTransposeYMM.
+ATTR_TARGET DOLPHIN_FORCE_INLINE static WideVector
+TransformPositionWide(WideVector x, WideVector y, WideVector z, const float* row,
+                      WideIndices matrix_indices)
+{
+  const WideVector m0 = WideGather(row + 0, matrix_indices);
+  const WideVector m1 = WideGather(row + 1, matrix_indices);
+  const WideVector m2 = WideGather(row + 2, matrix_indices);
+  const WideVector m3 = WideGather(row + 3, matrix_indices);
+  return WideAdd(WideAdd(WideMul(x, m0), WideMul(y, m1)), WideAdd(WideMul(z, m2), m3));
+}
+
+// Same operations in the same order as ApplyMatrixYMM, with w = 1.
+ATTR_TARGET DOLPHIN_FORCE_INLINE static WideVector
+ApplyProjectionWide(WideVector x, WideVector y, WideVector z, const float* row)
+{
+  WideVector output = WideMul(x, WideSet(row[0]));
+  output = WideFMA(y, WideSet(row[1]), output);
+  output = WideFMA(z, WideSet(row[2]), output);
+  return WideAdd(output, WideSet(row[3]));
+}
+
+// Returns the number of vertices that were transformed, which is a multiple of WIDE_VERTICES.
+template <bool PositionHas3Elems, bool PerVertexPosMtx>
+ATTR_TARGET static int TransformVerticesWide(Vector* output, const u8* vertices, u32 stride,
+                                             int count, const float* projection,
+                                             const float* posmtx)
+{
+  const int wide_count = count - count % WIDE_VERTICES;
+  const WideIndices offsets = WideVertexOffsets(stride);
+  for (int i = 0; i < wide_count; i += WIDE_VERTICES)
+  {
+    // Vertex data layout always starts with posmtx data if available, then position data
+    const u8* position = vertices + (PerVertexPosMtx ? sizeof(u32) : 0);
+    WideVector x = WideLoad<PositionHas3Elems>(position, stride, 0);
+    WideVector y = WideLoad<PositionHas3Elems>(position, stride, 1);
+    WideVector z = WideLoad<PositionHas3Elems>(position, stride, 2);
+    WideVector w = WideLoad<PositionHas3Elems>(position, stride, 3);
+    WideTranspose(x, y, z, w);
+
+    WideVector view_x, view_y, view_z;
+    if constexpr (PerVertexPosMtx)
+    {
+      const WideIndices matrix_indices = WideLoadMatrixIndices(vertices, offsets);
+      view_x = TransformPositionWide(x, y, z, &xfmem.posMatrices[0], matrix_indices);
+      view_y = TransformPositionWide(x, y, z, &xfmem.posMatrices[4], matrix_indices);
+      view_z = TransformPositionWide(x, y, z, &xfmem.posMatrices[8], matrix_indices);
+    }
+    else
+    {
+      view_x = TransformPositionWide<PositionHas3Elems>(x, y, z, posmtx + 0);
+      view_y = TransformPositionWide<PositionHas3Elems>(x, y, z, posmtx + 4);
+      view_z = TransformPositionWide<PositionHas3Elems>(x, y, z, posmtx + 8);
+    }
+
+    x = ApplyProjectionWide(view_x, view_y, view_z, projection + 0);
+    y = ApplyProjectionWide(view_x, view_y, view_z, projection + 4);
+    z = ApplyProjectionWide(view_x, view_y, view_z, projection + 8);
+    w = ApplyProjectionWide(view_x, view_y, view_z, projection + 12);
+    WideTranspose(x, y, z, w);
+    WideStore(output, x, 0);
+    WideStore(output, y, 1);
+    WideStore(output, z, 2);
+    WideStore(output, w, 3);
+
+    vertices += stride * WIDE_VERTICES;
+    output += WIDE_VERTICES;
+  }
+  return wide_count;
+}
+#endif
+
 template <bool PositionHas3Elems, bool PerVertexPosMtx>
 ATTR_TARGET static void TransformVertices(void* output, const void* vertices, u32 stride, int count)
 {
@@ -512,6 +756,15 @@ ATTR_TARGET static void TransformVertices(void* output, const void* vertices, u3
   const u8* cvertices = static_cast<const u8*>(vertices);
   Vector* voutput = static_cast<Vector*>(output);
   u32 idx = g_main_cp_state.matrix_index_a.PosNormalMtxIdx & 0x3f;
+#ifdef USE_AVX2
+  const int wide_count = TransformVerticesWide<PositionHas3Elems, PerVertexPosMtx>(
+      voutput, cvertices, stride, count,
+      reinterpret_cast<const float*>(vsmanager.constants.projection.data()),
+      &xfmem.posMatrices[idx * 4]);
+  cvertices += stride * wide_count;
+  voutput += wide_count;
+  count -= wide_count;
+#endif
 #ifdef USE_AVX
   __m256 proj0, proj1, proj2, proj3;
   __m256 pos0, pos1, pos2, pos3;
@@ -551,6 +804,41 @@ ATTR_TARGET static void TransformVertices(void* output, const void* vertices, u3
 #endif
 }
 
+template <bool PositionHas3Elems>
+ATTR_TARGET static void ComputeBounds(CPUCull::BoundingBox* bounds, const void* vertices,
+                                      u32 stride, int count)
+{
+  const u8* cvertices = static_cast<const u8*>(vertices);
+  Vector vmin = LoadPosition<PositionHas3Elems>(cvertices);
+  Vector vmax = vmin;
+  for (int i = 1; i < count; i++)
+  {
+    cvertices += stride;
+    const Vector vertex = LoadPosition<PositionHas3Elems>(cvertices);
+    // NaNs have to end up in the bounds, so that they can't be used to reject a draw.
+#if defined(USE_SSE)
+    // minps and maxps return the second operand if either one is NaN
+    const Vector nan = _mm_cmpunord_ps(vertex, vertex);
+    vmin = _mm_or_ps(_mm_min_ps(vertex, vmin), nan);
+    vmax = _mm_or_ps(_mm_max_ps(vertex, vmax), nan);
+#elif defined(USE_NEON)
+    vmin = vminq_f32(vmin, vertex);
+    vmax = vmaxq_f32(vmax, vertex);
+#else
+    const auto min = [](float a, float b) { return (b < a || b != b) ? b : a; };
+    const auto max = [](float a, float b) { return (b > a || b != b) ? b : a; };
+    vmin.x = min(vmin.x, vertex.x);
+    vmin.y = min(vmin.y, vertex.y);
+    vmin.z = min(vmin.z, vertex.z);
+    vmax.x = max(vmax.x, vertex.x);
+    vmax.y = max(vmax.y, vertex.y);
+    vmax.z = max(vmax.z, vertex.z);
+#endif
+  }
+  reinterpret_cast<Vector&>(bounds->min) = vmin;
+  reinterpret_cast<Vector&>(bounds->max) = vmax;
+}
+
 template <CullMode Mode>
 ATTR_TARGET DOLPHIN_FORCE_INLINE static bool CullTriangle(const CPUCull::TransformedVertex& a,
                                                           const CPUCull::TransformedVertex& b,
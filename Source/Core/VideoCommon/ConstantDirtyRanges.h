@@ -0,0 +1,81 @@
+// Copyright 2024 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstring>
+#include <memory>
+#include <utility>
+
+#include "Common/CommonTypes.h"
+
+// Tracks which 16 byte registers of a constant buffer were written since it was last uploaded.
+// Games frequently write the values that are already there, e.g. by loading the same matrix
+// before every draw, so Resolve() compares the written registers with the uploaded contents, and
+// only the registers that actually changed require another upload.
+template <typename T>
+class ConstantDirtyRanges
+{
+public:
+  static constexpr u32 REGISTER_SIZE = 16;
+  static constexpr u32 NUM_REGISTERS = sizeof(T) / REGISTER_SIZE;
+  static_assert(sizeof(T) % REGISTER_SIZE == 0, "Constant buffers must consist of registers");
+
+  // Marks the registers containing [field, field + size) of constants as written.
+  void Mark(const T& constants, const void* field, size_t size)
+  {
+    const size_t offset =
+        static_cast<const u8*>(field) - reinterpret_cast<const u8*>(std::addressof(constants));
+    const size_t first = offset / REGISTER_SIZE;
+    const size_t last = (offset + size - 1) / REGISTER_SIZE;
+    for (size_t i = first; i <= last; ++i)
+      m_written[i / 64] |= u64{1} << (i % 64);
+  }
+
+  bool HasWrites() const
+  {
+    for (const u64 word : m_written)
+    {
+      if (word != 0)
+        return true;
+    }
+    return false;
+  }
+
+  // Takes over the written registers that differ from the uploaded contents, and returns how many
+  // bytes changed. If nothing changed, the constant buffer doesn't need to be uploaded again.
+  u32 Resolve(const T& constants)
+  {
+    const u8* current = reinterpret_cast<const u8*>(std::addressof(constants));
+    u32 changed = 0;
+    for (size_t word = 0; word < m_written.size(); ++word)
+    {
+      u64 bits = std::exchange(m_written[word], 0);
+      while (bits != 0)
+      {
+        const size_t offset = (word * 64 + std::countr_zero(bits)) * REGISTER_SIZE;
+        bits &= bits - 1;
+        if (std::memcmp(&m_uploaded[offset], current + offset, REGISTER_SIZE) != 0)
+        {
+          std::memcpy(&m_uploaded[offset], current + offset, REGISTER_SIZE);
+          changed += REGISTER_SIZE;
+        }
+      }
+    }
+    return changed;
+  }
+
+  // Takes over the whole buffer, for when it is uploaded regardless of what was written.
+  void Reset(const T& constants)
+  {
+    m_written.fill(0);
+    std::memcpy(m_uploaded.data(), std::addressof(constants), sizeof(T));
+  }
+
+private:
+  std::array<u64, (NUM_REGISTERS + 63) / 64> m_written{};
+  alignas(16) std::array<u8, sizeof(T)> m_uploaded{};
+};
@@ -0,0 +1,111 @@
+// Copyright 2024 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "VideoCommon/DisplayListCache.h"
+
+#include <xxhash.h>
+
+#include "Common/Logging/Log.h"
+#include "Core/HW/Memmap.h"
+#include "Core/System.h"
+
+std::unique_ptr<DisplayListCache> g_display_list_cache;
+
+DisplayListCache::Entry& DisplayListCache::GetEntry(u32 address, u32 size, const u8* data,
+                                                    bool data_is_guest_memory)
+{
+  const auto [iter, inserted] = m_entries.try_emplace(GetKey(address, size));
+  Entry& entry = iter->second;
+  auto& memory = Core::System::GetInstance().GetMemory();
+  if (!data_is_guest_memory)
+    entry.write_generation.reset();
+  const bool was_watched = entry.write_generation.has_value();
+  if (was_watched)
+  {
+    if (memory.IsUnwrittenSince(address, size, *entry.write_generation))
+      return entry;
+    entry.write_generation.reset();
+  }
+
+  // Writes have to be watched for before hashing, so that none are missed in between.
+  std::optional<u64> write_generation;
+  if (data_is_guest_memory && !was_watched && entry.state == Entry::State::Recorded &&
+      entry.watch_writes)
+  {
+    write_generation = memory.WatchForWrites(address, size);
+  }
+
+  const u64 hash = XXH64(data, size, 0);
+  if (inserted || entry.hash != hash)
+  {
+    Invalidate(entry);
+    entry.state = Entry::State::New;
+    entry.hash = hash;
+  }
+  else if (was_watched)
+  {
+    entry.watch_writes = false;
+  }
+  else
+  {
+    entry.write_generation = write_generation;
+  }
+  return entry;
+}
+
+void DisplayListCache::FinishRecording(Entry& entry)
+{
+  entry.state = Entry::State::Recorded;
+  entry.decoded_size = 0;
+  for (const Primitive& primitive : entry.primitives)
+  {
+    if (primitive.decoded)
+      entry.decoded_size += primitive.decoded->data.size();
+  }
+  m_decoded_size += entry.decoded_size;
+
+  if (m_decoded_size > MAX_DECODED_SIZE)
+  {
+    // Replaying is only possible for entries that are still around, so the caller's entry must
+    // stay valid. Clearing everything else is enough to make room.
+    INFO_LOG_FMT(VIDEO, "Display list cache is full ({} bytes), clearing", m_decoded_size);
+    std::erase_if(m_entries, [&entry](const auto& pair) { return &pair.second != &entry; });
+    m_decoded_size = entry.decoded_size;
+  }
+}
+
+void DisplayListCache::Invalidate(Entry& entry)
+{
+  m_decoded_size -= entry.decoded_size;
+  entry.state = Entry::State::Seen;
+  entry.write_generation.reset();
+  entry.parsed_size = 0;
+  entry.primitives.clear();
+  entry.decoded_size = 0;
+}
+
+void DisplayListCache::Clear()
+{
+  m_entries.clear();
+  m_decoded_size = 0;
+}
+
+void DisplayListCache::Primitive::SetFormat(const TVtxDesc& desc, const VAT& attr)
+{
+  // BitField unions can't be copy assigned.
+  vtx_desc.low.Hex = desc.low.Hex;
+  vtx_desc.high.Hex = desc.high.Hex;
+  vtx_attr.g0.Hex = attr.g0.Hex;
+  vtx_attr.g1.Hex = attr.g1.Hex;
+  vtx_attr.g2.Hex = attr.g2.Hex;
+}
+
+bool DisplayListCache::IsSameFormat(const Primitive& primitive, const TVtxDesc& vtx_desc,
+                                    const VAT& vtx_attr)
+{
+  return primitive.vtx_desc.low.Hex == vtx_desc.low.Hex &&
+         primitive.vtx_desc.high.Hex == vtx_desc.high.Hex &&
+         primitive.vtx_attr.g0.Hex == vtx_attr.g0.Hex &&
+         primitive.vtx_attr.g1.Hex == vtx_attr.g1.Hex &&
+         primitive.vtx_attr.g2.Hex == vtx_attr.g2.Hex;
+}
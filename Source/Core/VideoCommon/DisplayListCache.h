@@ -0,0 +1,96 @@
+// Copyright 2024 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <memory>
+#include <optional>
+#include <unordered_map>
+#include <vector>
+
+#include "Common/CommonTypes.h"
+#include "VideoCommon/CPMemory.h"
+#include "VideoCommon/OpcodeDecoding.h"
+#include "VideoCommon/VertexLoaderManager.h"
+
+// Remembers where the primitives of a display list are, and what their vertices decode to, so
+// that a display list that is called again doesn't need to be parsed and vertex loaded again.
+// Entries are validated with a hash of the display list's contents. If the display list is read
+// straight from guest memory, recorded entries are watched for writes where guest memory supports
+// it, and only hashed again once written to. The vertex
+// format of every primitive is checked when it is replayed, as it decides how the rest of the
+// display list is parsed. All other commands are executed again from the display list itself.
+class DisplayListCache
+{
+public:
+  struct Primitive
+  {
+    // Offset of the vertex data in the display list, which follows a 3 byte command.
+    u32 offset = 0;
+    OpcodeDecoder::Primitive primitive{};
+    u8 vat = 0;
+    u16 num_vertices = 0;
+    u32 vertex_size = 0;
+    TVtxDesc vtx_desc;
+    VAT vtx_attr;
+
+    // Not set if the vertices are read from vertex arrays, which can change between calls.
+    std::optional<VertexLoaderManager::DecodedVertices> decoded;
+
+    u32 GetEnd() const { return offset + num_vertices * vertex_size; }
+    void SetFormat(const TVtxDesc& desc, const VAT& attr);
+  };
+
+  struct Entry
+  {
+    // Entries are only recorded on the second call with the same contents, as many display lists
+    // are built every frame and only called once.
+    enum class State
+    {
+      New,
+      Seen,
+      Recorded,
+    };
+
+    State state = State::New;
+    u64 hash = 0;
+    // Set while the display list is watched for writes, and its hash is known to be up to date.
+    std::optional<u64> write_generation;
+    // Cleared once the pages were written without the display list changing, as they then hold
+    // other data which is written to, and watching them would cost a fault on every call.
+    bool watch_writes = true;
+    // How much of the display list was parsed, as an incomplete command at the end is ignored.
+    u32 parsed_size = 0;
+    std::vector<Primitive> primitives;
+    size_t decoded_size = 0;
+  };
+
+  // Above this, the cache is cleared.
+  static constexpr size_t MAX_DECODED_SIZE = 64 * 1024 * 1024;
+
+  // Returns the entry of a display list, resetting it to New if its contents changed. Writes can
+  // only be watched for if data points to guest memory, and not to a copy of it like the one the
+  // deterministic GPU thread reads from, which was taken before any recent writes.
+  Entry& GetEntry(u32 address, u32 size, const u8* data, bool data_is_guest_memory);
+
+  // Marks an entry as recorded after its primitives were added.
+  void FinishRecording(Entry& entry);
+  // Makes an entry be recorded again on its next call, e.g. if the vertex format changed.
+  void Invalidate(Entry& entry);
+
+  void Clear();
+  bool IsEmpty() const { return m_entries.empty(); }
+  size_t GetDecodedSize() const { return m_decoded_size; }
+
+  // Whether vertex formats are the same, and a primitive is therefore the same size.
+  static bool IsSameFormat(const Primitive& primitive, const TVtxDesc& vtx_desc,
+                           const VAT& vtx_attr);
+
+private:
+  static u64 GetKey(u32 address, u32 size) { return (static_cast<u64>(address) << 32) | size; }
+
+  std::unordered_map<u64, Entry> m_entries;
+  size_t m_decoded_size = 0;
+};
+
+extern std::unique_ptr<DisplayListCache> g_display_list_cache;
@@ -0,0 +1,57 @@
+// Copyright 2024 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "VideoCommon/DrawBufferReuse.h"
+
+#include <xxhash.h>
+
+void DrawBufferReuse::BeginBatch()
+{
+  m_batch_hash = 0;
+}
+
+void DrawBufferReuse::AddVertices(std::span<const u8> state, std::span<const u8> source)
+{
+  if (!m_batch_hash)
+    return;
+
+  const u64 state_hash = XXH64(state.data(), state.size(), *m_batch_hash);
+  m_batch_hash = XXH64(source.data(), source.size(), state_hash);
+}
+
+void DrawBufferReuse::AddUnknownVertices()
+{
+  m_batch_hash.reset();
+}
+
+const DrawBufferReuse::CommittedBatch*
+DrawBufferReuse::FindReusableBatch(u32 num_vertices, u32 vertex_stride, u32 num_indices) const
+{
+  if (!m_batch_hash || !m_last_committed_batch || m_last_committed_batch->hash != *m_batch_hash ||
+      m_last_committed_batch->num_vertices != num_vertices ||
+      m_last_committed_batch->vertex_stride != vertex_stride ||
+      m_last_committed_batch->num_indices != num_indices)
+  {
+    return nullptr;
+  }
+  return &*m_last_committed_batch;
+}
+
+void DrawBufferReuse::SetCommitted(u32 num_vertices, u32 vertex_stride, u32 num_indices,
+                                   u32 base_vertex, u32 base_index)
+{
+  if (!m_batch_hash)
+  {
+    m_last_committed_batch.reset();
+    return;
+  }
+
+  m_last_committed_batch =
+      CommittedBatch{num_vertices, vertex_stride, num_indices, base_vertex, base_index,
+                     *m_batch_hash};
+}
+
+void DrawBufferReuse::Invalidate()
+{
+  m_last_committed_batch.reset();
+}
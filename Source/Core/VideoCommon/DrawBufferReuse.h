@@ -0,0 +1,48 @@
+// Copyright 2024 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <optional>
+#include <span>
+
+#include "Common/CommonTypes.h"
+
+// Recognizes a GX batch which is the same as the last committed one, so that its buffers can be
+// drawn from again instead of the data being streamed a second time. The decoded vertices are in
+// write-combined memory on most backends, which is slow to read back, so batches are identified by
+// what their vertices were decoded from instead, as it's added to the batch.
+class DrawBufferReuse
+{
+public:
+  struct CommittedBatch
+  {
+    u32 num_vertices = 0;
+    u32 vertex_stride = 0;
+    u32 num_indices = 0;
+    u32 base_vertex = 0;
+    u32 base_index = 0;
+    u64 hash = 0;
+  };
+
+  // Starts identifying a new batch.
+  void BeginBatch();
+  // Adds vertices which only depend on the given state and source data, e.g. the vertex format
+  // and the vertices in the FIFO, to the current batch.
+  void AddVertices(std::span<const u8> state, std::span<const u8> source);
+  // Adds vertices which can't be identified, e.g. because they read from vertex arrays, which makes
+  // the batch unique.
+  void AddUnknownVertices();
+
+  // Returns the last committed batch if it's the same as the current one.
+  const CommittedBatch* FindReusableBatch(u32 num_vertices, u32 vertex_stride,
+                                          u32 num_indices) const;
+  void SetCommitted(u32 num_vertices, u32 vertex_stride, u32 num_indices, u32 base_vertex,
+                    u32 base_index);
+  // Forgets the last committed batch, e.g. because something else was drawn from the buffers.
+  void Invalidate();
+
+private:
+  std::optional<u64> m_batch_hash;
+  std::optional<CommittedBatch> m_last_committed_batch;
+};
@@ -3,6 +3,7 @@
 
 #include "VideoCommon/FramebufferManager.h"
 
+#include <chrono>
 #include <fmt/format.h>
 #include <memory>
 
@@ -22,6 +23,7 @@
 #include "VideoCommon/FramebufferShaderGen.h"
 #include "VideoCommon/PixelShaderManager.h"
 #include "VideoCommon/Present.h"
+#include "VideoCommon/Statistics.h"
 #include "VideoCommon/VertexManagerBase.h"
 #include "VideoCommon/VideoCommon.h"
 #include "VideoCommon/VideoConfig.h"
@@ -478,17 +480,7 @@ u32 FramebufferManager::PeekEFBColor(u32 x, u32 y)
   if (g_ActiveConfig.backend_info.bUsesLowerLeftOrigin)
     y = EFB_HEIGHT - 1 - y;
 
-  u32 tile_index;
-  if (!IsEFBCacheTilePresent(false, x, y, &tile_index))
-    PopulateEFBCache(false, tile_index);
-
-  m_efb_color_cache.tiles[tile_index].frame_access_mask |= 1;
-
-  if (m_efb_color_cache.needs_flush)
-  {
-    m_efb_color_cache.readback_texture->Flush();
-    m_efb_color_cache.needs_flush = false;
-  }
+  PrepareEFBCacheForPeek(false, x, y);
 
   u32 value;
   m_efb_color_cache.readback_texture->ReadTexel(x, y, &value);
@@ -501,17 +493,7 @@ float FramebufferManager::PeekEFBDepth(u32 x, u32 y)
   if (g_ActiveConfig.backend_info.bUsesLowerLeftOrigin)
     y = EFB_HEIGHT - 1 - y;
 
-  u32 tile_index;
-  if (!IsEFBCacheTilePresent(true, x, y, &tile_index))
-    PopulateEFBCache(true, tile_index);
-
-  m_efb_depth_cache.tiles[tile_index].frame_access_mask |= 1;
-
-  if (m_efb_depth_cache.needs_flush)
-  {
-    m_efb_depth_cache.readback_texture->Flush();
-    m_efb_depth_cache.needs_flush = false;
-  }
+  PrepareEFBCacheForPeek(true, x, y);
 
   float value;
   m_efb_depth_cache.readback_texture->ReadTexel(x, y, &value);
@@ -538,20 +520,8 @@ void FramebufferManager::RefreshPeekCache()
     return;
   }
 
-  bool flush_command_buffer = false;
-  for (u32 i = 0; i < m_efb_color_cache.tiles.size(); i++)
-  {
-    if (m_efb_color_cache.tiles[i].frame_access_mask != 0 && !m_efb_color_cache.tiles[i].present)
-    {
-      PopulateEFBCache(false, i, true);
-      flush_command_buffer = true;
-    }
-    if (m_efb_depth_cache.tiles[i].frame_access_mask != 0 && !m_efb_depth_cache.tiles[i].present)
-    {
-      PopulateEFBCache(true, i, true);
-      flush_command_buffer = true;
-    }
-  }
+  bool flush_command_buffer = PopulateRecentlyPeekedTiles(false);
+  flush_command_buffer |= PopulateRecentlyPeekedTiles(true);
 
   m_efb_depth_cache.needs_refresh = false;
   m_efb_color_cache.needs_refresh = false;
@@ -562,6 +532,59 @@ void FramebufferManager::RefreshPeekCache()
   }
 }
 
+bool FramebufferManager::PopulateRecentlyPeekedTiles(bool depth)
+{
+  EFBCacheData& data = depth ? m_efb_depth_cache : m_efb_color_cache;
+  bool populated = false;
+  for (u32 i = 0; i < data.tiles.size(); i++)
+  {
+    if (data.tiles[i].frame_access_mask != 0 && !data.tiles[i].present)
+    {
+      PopulateEFBCache(depth, i, true);
+      populated = true;
+    }
+  }
+  return populated;
+}
+
+void FramebufferManager::PrepareEFBCacheForPeek(bool depth, u32 x, u32 y)
+{
+  EFBCacheData& data = depth ? m_efb_depth_cache : m_efb_color_cache;
+  u32 tile_index;
+  const bool present = IsEFBCacheTilePresent(depth, x, y, &tile_index);
+  data.tiles[tile_index].frame_access_mask |= 1;
+
+  if (present)
+  {
+    INCSTAT(g_stats.this_frame.num_efb_peek_cache_hits);
+    if (!data.needs_flush)
+      return;
+  }
+  else
+  {
+    INCSTAT(g_stats.this_frame.num_efb_peek_cache_misses);
+  }
+
+  const auto stall_start = std::chrono::steady_clock::now();
+  if (!present)
+  {
+    // With deferred invalidation, read back every tile that was peeked in the last few frames
+    // along with this one, so that games which peek scattered pixels only wait for the GPU once
+    // rather than once per tile. Otherwise every draw invalidates the cache, and a game which
+    // alternates between drawing and peeking would read back all of those tiles on every peek.
+    if (g_ActiveConfig.bEFBAccessDeferInvalidation)
+      PopulateRecentlyPeekedTiles(depth);
+    else
+      PopulateEFBCache(depth, tile_index);
+  }
+  data.readback_texture->Flush();
+  data.needs_flush = false;
+
+  const auto stall_time = std::chrono::duration_cast<std::chrono::microseconds>(
+      std::chrono::steady_clock::now() - stall_start);
+  ADDSTAT(g_stats.this_frame.efb_peek_stall_us, static_cast<int>(stall_time.count()));
+}
+
 void FramebufferManager::InvalidatePeekCache(bool forced)
 {
   if (forced || m_efb_color_cache.out_of_date)
@@ -182,6 +182,12 @@ protected:
   bool IsEFBCacheTilePresent(bool depth, u32 x, u32 y, u32* tile_index) const;
   MathUtil::Rectangle<int> GetEFBCacheTileRect(u32 tile_index) const;
   void PopulateEFBCache(bool depth, u32 tile_index, bool async = false);
+  // Asynchronously reads back the tiles which were peeked in recent frames but aren't present.
+  // Returns whether any readback was issued.
+  bool PopulateRecentlyPeekedTiles(bool depth);
+  // Makes the tile containing the pixel readable, waiting for the GPU if needed. On a miss, the
+  // recently peeked tiles are read back along with it if invalidation is deferred.
+  void PrepareEFBCacheForPeek(bool depth, u32 x, u32 y);
 
   void CreatePokeVertices(std::vector<EFBPokeVertex>* destination_list, u32 x, u32 y, float z,
                           u32 color);
@@ -27,28 +27,41 @@
 #include "VideoCommon/Assets/CustomAsset.h"
 #include "VideoCommon/Assets/CustomAssetLoader.h"
 #include "VideoCommon/Assets/DirectFilesystemAssetLibrary.h"
+#include "VideoCommon/Assets/TexturePack.h"
+#include "VideoCommon/Assets/TexturePackAssetLibrary.h"
 #include "VideoCommon/OnScreenDisplay.h"
 #include "VideoCommon/VideoConfig.h"
 
 constexpr std::string_view s_format_prefix{"tex1_"};
+constexpr std::string_view s_texture_pack_extension{".dtp"};
+
+namespace
+{
+struct HiresTextureFile
+{
+  bool has_arbitrary_mipmaps;
+  bool in_texture_pack;
+};
+}  // namespace
 
 static std::unordered_map<std::string, std::shared_ptr<HiresTexture>> s_hires_texture_cache;
-static std::unordered_map<std::string, bool> s_hires_texture_id_to_arbmipmap;
+static std::unordered_map<std::string, HiresTextureFile> s_hires_texture_id_to_file;
 
 static auto s_file_library = std::make_shared<VideoCommon::DirectFilesystemAssetLibrary>();
+static auto s_pack_library = std::make_shared<VideoCommon::TexturePackAssetLibrary>();
 
 namespace
 {
-std::pair<std::string, bool> GetNameArbPair(const TextureInfo& texture_info)
+std::pair<std::string, HiresTextureFile> GetNameFilePair(const TextureInfo& texture_info)
 {
-  if (s_hires_texture_id_to_arbmipmap.empty())
-    return {"", false};
+  if (s_hires_texture_id_to_file.empty())
+    return {"", {}};
 
   const auto texture_name_details = texture_info.CalculateTextureName();
   // look for an exact match first
   const std::string full_name = texture_name_details.GetFullName();
-  if (auto iter = s_hires_texture_id_to_arbmipmap.find(full_name);
-      iter != s_hires_texture_id_to_arbmipmap.end())
+  if (auto iter = s_hires_texture_id_to_file.find(full_name);
+      iter != s_hires_texture_id_to_file.end())
   {
     return {full_name, iter->second};
   }
@@ -57,8 +70,8 @@ std::pair<std::string, bool> GetNameArbPair(const TextureInfo& texture_info)
   const std::string texture_name_single_wildcard_tlut =
       fmt::format("{}_{}_$_{}", texture_name_details.base_name, texture_name_details.texture_name,
                   texture_name_details.format_name);
-  if (auto iter = s_hires_texture_id_to_arbmipmap.find(texture_name_single_wildcard_tlut);
-      iter != s_hires_texture_id_to_arbmipmap.end())
+  if (auto iter = s_hires_texture_id_to_file.find(texture_name_single_wildcard_tlut);
+      iter != s_hires_texture_id_to_file.end())
   {
     return {texture_name_single_wildcard_tlut, iter->second};
   }
@@ -67,13 +80,68 @@ std::pair<std::string, bool> GetNameArbPair(const TextureInfo& texture_info)
   const std::string texture_name_single_wildcard_tex =
       fmt::format("{}_${}_{}", texture_name_details.base_name, texture_name_details.tlut_name,
                   texture_name_details.format_name);
-  if (auto iter = s_hires_texture_id_to_arbmipmap.find(texture_name_single_wildcard_tex);
-      iter != s_hires_texture_id_to_arbmipmap.end())
+  if (auto iter = s_hires_texture_id_to_file.find(texture_name_single_wildcard_tex);
+      iter != s_hires_texture_id_to_file.end())
   {
     return {texture_name_single_wildcard_tex, iter->second};
   }
 
-  return {"", false};
+  return {"", {}};
+}
+
+std::shared_ptr<VideoCommon::CustomAssetLibrary> GetLibrary(const HiresTextureFile& file)
+{
+  if (file.in_texture_pack)
+    return s_pack_library;
+  return s_file_library;
+}
+
+// Removes the "_arb" marker from the name of a texture file, returning whether it was there.
+bool RemoveArbitraryMipmapMarker(std::string* filename)
+{
+  const size_t arb_index = filename->rfind("_arb");
+  if (arb_index == std::string::npos)
+    return false;
+  filename->erase(arb_index, 4);
+  return true;
+}
+
+// Registers the textures of every pack in the directory. Loose files take priority over packs, so
+// this is called after the loose files were registered. Pack textures aren't loaded ahead of
+// time even when custom textures are cached, but are streamed in as the game uses them, with
+// the OS evicting the pages of textures that haven't been used for a while.
+bool AddTexturePacks(const std::string& texture_directory)
+{
+  bool failed_insert = false;
+  const auto pack_paths = Common::DoFileSearch(
+      {texture_directory}, {std::string(s_texture_pack_extension)}, /*recursive*/ true);
+  for (const auto& pack_path : pack_paths)
+  {
+    auto pack = VideoCommon::TexturePack::Open(pack_path);
+    if (!pack)
+    {
+      ERROR_LOG_FMT(VIDEO, "Failed to open texture pack '{}'", pack_path);
+      continue;
+    }
+
+    const VideoCommon::TexturePack* added_pack = s_pack_library->AddPack(std::move(pack));
+    for (const std::string_view file_name : added_pack->GetFileNames())
+    {
+      std::string filename;
+      SplitPath(file_name, nullptr, &filename, nullptr);
+      if (!filename.starts_with(s_format_prefix))
+        continue;
+
+      const bool has_arbitrary_mipmaps = RemoveArbitraryMipmapMarker(&filename);
+      const auto [it, inserted] = s_hires_texture_id_to_file.try_emplace(
+          filename, HiresTextureFile{has_arbitrary_mipmaps, true});
+      if (!inserted)
+        failed_insert = true;
+      else
+        s_pack_library->SetAssetIDFile(filename, added_pack, std::string(file_name));
+    }
+  }
+  return failed_insert;
 }
 }  // namespace
 
@@ -115,13 +183,10 @@ void HiresTexture::Update()
 
       if (filename.substr(0, s_format_prefix.length()) == s_format_prefix)
       {
-        const size_t arb_index = filename.rfind("_arb");
-        const bool has_arbitrary_mipmaps = arb_index != std::string::npos;
-        if (has_arbitrary_mipmaps)
-          filename.erase(arb_index, 4);
+        const bool has_arbitrary_mipmaps = RemoveArbitraryMipmapMarker(&filename);
 
-        const auto [it, inserted] =
-            s_hires_texture_id_to_arbmipmap.try_emplace(filename, has_arbitrary_mipmaps);
+        const auto [it, inserted] = s_hires_texture_id_to_file.try_emplace(
+            filename, HiresTextureFile{has_arbitrary_mipmaps, false});
         if (!inserted)
         {
           failed_insert = true;
@@ -135,15 +200,20 @@ void HiresTexture::Update()
 
           if (g_ActiveConfig.bCacheHiresTextures)
           {
-            auto hires_texture = std::make_shared<HiresTexture>(
-                has_arbitrary_mipmaps,
-                system.GetCustomAssetLoader().LoadGameTexture(filename, s_file_library));
+            // Preloaded after the textures the game is drawing with
+            auto asset = system.GetCustomAssetLoader().LoadGameTexture(
+                filename, s_file_library, VideoCommon::CustomAssetLoader::LoadPriority::Prefetch);
+            auto hires_texture =
+                std::make_shared<HiresTexture>(has_arbitrary_mipmaps, std::move(asset));
             s_hires_texture_cache.try_emplace(filename, std::move(hires_texture));
           }
         }
       }
     }
 
+    if (AddTexturePacks(texture_directory))
+      failed_insert = true;
+
     if (failed_insert)
     {
       ERROR_LOG_FMT(VIDEO, "One or more textures at path '{}' were already inserted",
@@ -159,33 +229,44 @@ void HiresTexture::Update()
   else
   {
     OSD::AddMessage(
-        fmt::format("Found '{}' custom textures", s_hires_texture_id_to_arbmipmap.size()), 10000);
+        fmt::format("Found '{}' custom textures", s_hires_texture_id_to_file.size()), 10000);
   }
 }
 
 void HiresTexture::Clear()
 {
   s_hires_texture_cache.clear();
-  s_hires_texture_id_to_arbmipmap.clear();
+  s_hires_texture_id_to_file.clear();
   s_file_library = std::make_shared<VideoCommon::DirectFilesystemAssetLibrary>();
+  s_pack_library = std::make_shared<VideoCommon::TexturePackAssetLibrary>();
 }
 
 std::shared_ptr<HiresTexture> HiresTexture::Search(const TextureInfo& texture_info)
 {
-  const auto [base_filename, has_arb_mipmaps] = GetNameArbPair(texture_info);
+  const auto [base_filename, file] = GetNameFilePair(texture_info);
   if (base_filename == "")
     return nullptr;
 
   if (auto iter = s_hires_texture_cache.find(base_filename); iter != s_hires_texture_cache.end())
   {
+    // A preloaded texture which is still waiting to be loaded is needed now
+    if (!iter->second->GetAsset()->GetData())
+    {
+      auto& system = Core::System::GetInstance();
+      (void)system.GetCustomAssetLoader().LoadGameTexture(base_filename, GetLibrary(file));
+    }
     return iter->second;
   }
   else
   {
+    // Start reading a packed texture right away, instead of when the asset loader gets to it.
+    if (file.in_texture_pack)
+      s_pack_library->Prefetch(base_filename);
+
     auto& system = Core::System::GetInstance();
     auto hires_texture = std::make_shared<HiresTexture>(
-        has_arb_mipmaps,
-        system.GetCustomAssetLoader().LoadGameTexture(base_filename, s_file_library));
+        file.has_arbitrary_mipmaps,
+        system.GetCustomAssetLoader().LoadGameTexture(base_filename, GetLibrary(file)));
     if (g_ActiveConfig.bCacheHiresTextures)
     {
       s_hires_texture_cache.try_emplace(base_filename, hires_texture);
@@ -7,6 +7,12 @@
 #include <cstddef>
 #include <cstring>
 
+#if defined(_M_X86) || defined(_M_X86_64)
+#include <emmintrin.h>
+#elif defined(_M_ARM_64)
+#include <arm_neon.h>
+#endif
+
 #include "Common/CommonTypes.h"
 #include "Common/Logging/Log.h"
 #include "VideoCommon/OpcodeDecoding.h"
@@ -15,6 +21,90 @@
 namespace
 {
 constexpr u16 s_primitive_restart = UINT16_MAX;
+// Pattern entry for the first vertex of a fan, which stays the same for every triangle.
+constexpr u16 s_fan_center = UINT16_MAX - 1;
+
+// Writes |blocks| repetitions of a pattern of index offsets relative to |index|, advancing all
+// indices by |advance| after each repetition. Primitive restart and fan center entries don't
+// advance. This is where the bulk of the indices of long primitives is written; the regular
+// per-primitive code only handles the remainder.
+template <size_t N>
+u16* WritePattern(u16* index_ptr, const std::array<u16, N>& pattern, u32 index, u32 advance,
+                  u32 blocks)
+{
+  static_assert(N % 8 == 0, "Patterns must be a whole number of 128-bit vectors");
+  if (blocks == 0)
+    return index_ptr;
+
+  std::array<u16, N> first;
+  std::array<u16, N> step;
+  for (size_t i = 0; i < N; ++i)
+  {
+    if (pattern[i] == s_primitive_restart)
+    {
+      first[i] = s_primitive_restart;
+      step[i] = 0;
+    }
+    else if (pattern[i] == s_fan_center)
+    {
+      first[i] = static_cast<u16>(index);
+      step[i] = 0;
+    }
+    else
+    {
+      first[i] = static_cast<u16>(index + pattern[i]);
+      step[i] = static_cast<u16>(advance);
+    }
+  }
+
+  constexpr size_t num_vectors = N / 8;
+#if defined(_M_X86) || defined(_M_X86_64)
+  __m128i values[num_vectors];
+  __m128i steps[num_vectors];
+  for (size_t i = 0; i < num_vectors; ++i)
+  {
+    values[i] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&first[i * 8]));
+    steps[i] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&step[i * 8]));
+  }
+  for (u32 block = 0; block < blocks; ++block)
+  {
+    for (size_t i = 0; i < num_vectors; ++i)
+    {
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(index_ptr + i * 8), values[i]);
+      values[i] = _mm_add_epi16(values[i], steps[i]);
+    }
+    index_ptr += N;
+  }
+#elif defined(_M_ARM_64)
+  uint16x8_t values[num_vectors];
+  uint16x8_t steps[num_vectors];
+  for (size_t i = 0; i < num_vectors; ++i)
+  {
+    values[i] = vld1q_u16(&first[i * 8]);
+    steps[i] = vld1q_u16(&step[i * 8]);
+  }
+  for (u32 block = 0; block < blocks; ++block)
+  {
+    for (size_t i = 0; i < num_vectors; ++i)
+    {
+      vst1q_u16(index_ptr + i * 8, values[i]);
+      values[i] = vaddq_u16(values[i], steps[i]);
+    }
+    index_ptr += N;
+  }
+#else
+  for (u32 block = 0; block < blocks; ++block)
+  {
+    for (size_t i = 0; i < N; ++i)
+    {
+      index_ptr[i] = first[i];
+      first[i] += step[i];
+    }
+    index_ptr += N;
+  }
+#endif
+  return index_ptr;
+}
 
 template <bool pr>
 u16* WriteTriangle(u16* index_ptr, u32 index1, u32 index2, u32 index3)
@@ -30,7 +120,25 @@ u16* WriteTriangle(u16* index_ptr, u32 index1, u32 index2, u32 index3)
 template <bool pr>
 u16* AddList(u16* index_ptr, u32 num_verts, u32 index)
 {
-  for (u32 i = 2; i < num_verts; i += 3)
+  u32 i = 2;
+  if constexpr (pr)
+  {
+    constexpr std::array<u16, 8> pattern = {0, 1, 2, s_primitive_restart,
+                                            3, 4, 5, s_primitive_restart};
+    const u32 blocks = num_verts / 6;
+    index_ptr = WritePattern(index_ptr, pattern, index, 6, blocks);
+    i += blocks * 6;
+  }
+  else
+  {
+    constexpr std::array<u16, 24> pattern = {0,  1,  2,  3,  4,  5,  6,  7,  8,  9,  10, 11,
+                                             12, 13, 14, 15, 16, 17, 18, 19, 20, 21, 22, 23};
+    const u32 blocks = num_verts / 24;
+    index_ptr = WritePattern(index_ptr, pattern, index, 24, blocks);
+    i += blocks * 24;
+  }
+
+  for (; i < num_verts; i += 3)
   {
     index_ptr = WriteTriangle<pr>(index_ptr, index + i - 2, index + i - 1, index + i);
   }
@@ -42,7 +150,11 @@ u16* AddStrip(u16* index_ptr, u32 num_verts, u32 index)
 {
   if constexpr (pr)
   {
-    for (u32 i = 0; i < num_verts; ++i)
+    constexpr std::array<u16, 8> pattern = {0, 1, 2, 3, 4, 5, 6, 7};
+    const u32 blocks = num_verts / 8;
+    index_ptr = WritePattern(index_ptr, pattern, index, 8, blocks);
+
+    for (u32 i = blocks * 8; i < num_verts; ++i)
     {
       *index_ptr++ = index + i;
     }
@@ -50,8 +162,14 @@ u16* AddStrip(u16* index_ptr, u32 num_verts, u32 index)
   }
   else
   {
+    // Pairs of triangles, the second of which has its winding flipped.
+    constexpr std::array<u16, 24> pattern = {0, 1, 2, 1, 3, 2, 2, 3, 4, 3, 5, 4,
+                                             4, 5, 6, 5, 7, 6, 6, 7, 8, 7, 9, 8};
+    const u32 blocks = num_verts > 2 ? (num_verts - 2) / 8 : 0;
+    index_ptr = WritePattern(index_ptr, pattern, index, 8, blocks);
+
     bool wind = false;
-    for (u32 i = 2; i < num_verts; ++i)
+    for (u32 i = 2 + blocks * 8; i < num_verts; ++i)
     {
       index_ptr = WriteTriangle<pr>(index_ptr, index + i - 2, index + i - !wind, index + i - wind);
 
@@ -87,6 +205,15 @@ u16* AddFan(u16* index_ptr, u32 num_verts, u32 index)
 
   if constexpr (pr)
   {
+    constexpr std::array<u16, 24> pattern = {
+        1,  2,  s_fan_center, 3,  4,  s_primitive_restart,  //
+        4,  5,  s_fan_center, 6,  7,  s_primitive_restart,  //
+        7,  8,  s_fan_center, 9,  10, s_primitive_restart,  //
+        10, 11, s_fan_center, 12, 13, s_primitive_restart};
+    const u32 blocks = num_verts > 2 ? (num_verts - 2) / 12 : 0;
+    index_ptr = WritePattern(index_ptr, pattern, index, 12, blocks);
+    i += blocks * 12;
+
     for (; i + 3 <= num_verts; i += 3)
     {
       *index_ptr++ = index + i - 1;
@@ -107,6 +234,16 @@ u16* AddFan(u16* index_ptr, u32 num_verts, u32 index)
     }
   }
 
+  if constexpr (!pr)
+  {
+    constexpr std::array<u16, 24> pattern = {
+        s_fan_center, 1, 2, s_fan_center, 2, 3, s_fan_center, 3, 4, s_fan_center, 4, 5,
+        s_fan_center, 5, 6, s_fan_center, 6, 7, s_fan_center, 7, 8, s_fan_center, 8, 9};
+    const u32 blocks = num_verts > 2 ? (num_verts - 2) / 8 : 0;
+    index_ptr = WritePattern(index_ptr, pattern, index, 8, blocks);
+    i += blocks * 8;
+  }
+
   for (; i < num_verts; ++i)
   {
     index_ptr = WriteTriangle<pr>(index_ptr, index, index + i - 1, index + i);
@@ -135,6 +272,26 @@ template <bool pr>
 u16* AddQuads(u16* index_ptr, u32 num_verts, u32 index)
 {
   u32 i = 3;
+  if constexpr (pr)
+  {
+    constexpr std::array<u16, 40> pattern = {
+        1,  2,  0,  3,  s_primitive_restart, 5,  6,  4,  7,  s_primitive_restart,
+        9,  10, 8,  11, s_primitive_restart, 13, 14, 12, 15, s_primitive_restart,
+        17, 18, 16, 19, s_primitive_restart, 21, 22, 20, 23, s_primitive_restart,
+        25, 26, 24, 27, s_primitive_restart, 29, 30, 28, 31, s_primitive_restart};
+    const u32 blocks = num_verts / 32;
+    index_ptr = WritePattern(index_ptr, pattern, index, 32, blocks);
+    i += blocks * 32;
+  }
+  else
+  {
+    constexpr std::array<u16, 24> pattern = {0, 1, 2,  0, 2,  3,  4,  5,  6,  4,  6,  7,
+                                             8, 9, 10, 8, 10, 11, 12, 13, 14, 12, 14, 15};
+    const u32 blocks = num_verts / 16;
+    index_ptr = WritePattern(index_ptr, pattern, index, 16, blocks);
+    i += blocks * 16;
+  }
+
   for (; i < num_verts; i += 4)
   {
     if constexpr (pr)
@@ -170,7 +327,11 @@ u16* AddQuads_nonstandard(u16* index_ptr, u32 num_verts, u32 index)
 
 u16* AddLineList(u16* index_ptr, u32 num_verts, u32 index)
 {
-  for (u32 i = 1; i < num_verts; i += 2)
+  constexpr std::array<u16, 8> pattern = {0, 1, 2, 3, 4, 5, 6, 7};
+  const u32 blocks = num_verts / 8;
+  index_ptr = WritePattern(index_ptr, pattern, index, 8, blocks);
+
+  for (u32 i = 1 + blocks * 8; i < num_verts; i += 2)
   {
     *index_ptr++ = index + i - 1;
     *index_ptr++ = index + i;
@@ -182,7 +343,11 @@ u16* AddLineList(u16* index_ptr, u32 num_verts, u32 index)
 // so converting them to lists
 u16* AddLineStrip(u16* index_ptr, u32 num_verts, u32 index)
 {
-  for (u32 i = 1; i < num_verts; ++i)
+  constexpr std::array<u16, 8> pattern = {0, 1, 1, 2, 2, 3, 3, 4};
+  const u32 blocks = num_verts > 1 ? (num_verts - 1) / 4 : 0;
+  index_ptr = WritePattern(index_ptr, pattern, index, 4, blocks);
+
+  for (u32 i = 1 + blocks * 4; i < num_verts; ++i)
   {
     *index_ptr++ = index + i - 1;
     *index_ptr++ = index + i;
@@ -225,7 +390,11 @@ u16* AddLines_VSExpand(u16* index_ptr, u32 num_verts, u32 index)
 
 u16* AddPoints(u16* index_ptr, u32 num_verts, u32 index)
 {
-  for (u32 i = 0; i != num_verts; ++i)
+  constexpr std::array<u16, 8> pattern = {0, 1, 2, 3, 4, 5, 6, 7};
+  const u32 blocks = num_verts / 8;
+  index_ptr = WritePattern(index_ptr, pattern, index, 8, blocks);
+
+  for (u32 i = blocks * 8; i != num_verts; ++i)
   {
     *index_ptr++ = index + i;
   }
@@ -22,6 +22,7 @@ public:
 
   // returns numprimitives
   u32 GetNumVerts() const { return m_base_index; }
+  const u16* GetIndexData() const { return m_base_index_ptr; }
   u32 GetIndexLen() const { return static_cast<u32>(m_index_buffer_current - m_base_index_ptr); }
   u32 GetRemainingIndices(OpcodeDecoder::Primitive primitive) const;
 
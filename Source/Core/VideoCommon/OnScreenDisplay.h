@@ -16,6 +16,7 @@ enum class MessageType
 {
   NetPlayPing,
   NetPlayBuffer,
+  NetPlayRollback,
 
   // This entry must be kept last so that persistent typed messages are
   // displayed before other messages
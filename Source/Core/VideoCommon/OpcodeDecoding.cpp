@@ -14,6 +14,8 @@
 
 #include "VideoCommon/OpcodeDecoding.h"
 
+#include <optional>
+
 #include "Common/Assert.h"
 #include "Common/Logging/Log.h"
 #include "Core/FifoPlayer/FifoRecorder.h"
@@ -23,10 +25,13 @@
 #include "VideoCommon/CPMemory.h"
 #include "VideoCommon/CommandProcessor.h"
 #include "VideoCommon/DataReader.h"
+#include "VideoCommon/DisplayListCache.h"
 #include "VideoCommon/Fifo.h"
+#include "VideoCommon/StageTimings.h"
 #include "VideoCommon/Statistics.h"
 #include "VideoCommon/VertexLoaderBase.h"
 #include "VideoCommon/VertexLoaderManager.h"
+#include "VideoCommon/VideoConfig.h"
 #include "VideoCommon/XFMemory.h"
 #include "VideoCommon/XFStateManager.h"
 #include "VideoCommon/XFStructs.h"
@@ -130,10 +135,22 @@ public:
     // load vertices
     const u32 size = vertex_size * num_vertices;
 
-    const u32 bytes =
-        VertexLoaderManager::RunVertices<is_preprocess>(vat, primitive, num_vertices, vertex_data);
+    VertexLoaderManager::DecodedVertices* decoded = nullptr;
+    if constexpr (!is_preprocess)
+    {
+      if (m_recording)
+        decoded = RecordPrimitive(primitive, vat, vertex_size, num_vertices, vertex_data);
+    }
+
+    const u32 bytes = VertexLoaderManager::RunVertices<is_preprocess>(vat, primitive, num_vertices,
+                                                                      vertex_data, decoded);
 
     ASSERT(bytes == size);
+    if constexpr (!is_preprocess)
+    {
+      if (decoded && decoded->count == 0)
+        m_recording->primitives.back().decoded.reset();
+    }
 
     // 4 GPU ticks per vertex, 3 CPU ticks per GPU tick
     m_cycles += num_vertices * 4 * 3 + 6;
@@ -172,7 +189,8 @@ public:
         const u8* start_address;
 
         auto& fifo = system.GetFifo();
-        if (fifo.UseDeterministicGPUThread())
+        const bool deterministic_gpu_thread = fifo.UseDeterministicGPUThread();
+        if (deterministic_gpu_thread)
         {
           start_address = static_cast<u8*>(fifo.PopFifoAuxBuffer(size));
         }
@@ -188,7 +206,11 @@ public:
           // temporarily swap dl and non-dl (small "hack" for the stats)
           g_stats.SwapDL();
 
-          Run(start_address, size, *this);
+          // The FIFO recorder needs every command of the display list.
+          if (g_ActiveConfig.bDisplayListCache && !g_record_fifo_data)
+            RunCachedDisplayList(address, size, start_address, !deterministic_gpu_thread);
+          else
+            Run(start_address, size, *this);
           INCSTAT(g_stats.this_frame.num_dlists_called);
 
           // un-swap
@@ -255,6 +277,89 @@ public:
 
   u32 m_cycles = 0;
   bool m_in_display_list = false;
+
+private:
+  void RunCachedDisplayList(u32 address, u32 size, const u8* data, bool data_is_guest_memory)
+  {
+    DisplayListCache::Entry& entry =
+        g_display_list_cache->GetEntry(address, size, data, data_is_guest_memory);
+    switch (entry.state)
+    {
+    case DisplayListCache::Entry::State::New:
+      INCSTAT(g_stats.this_frame.num_dlist_cache_misses);
+      entry.state = DisplayListCache::Entry::State::Seen;
+      Run(data, size, *this);
+      break;
+
+    case DisplayListCache::Entry::State::Seen:
+      INCSTAT(g_stats.this_frame.num_dlist_cache_misses);
+      m_recording = &entry;
+      m_recording_start = data;
+      entry.parsed_size = Run(data, size, *this);
+      m_recording = nullptr;
+      g_display_list_cache->FinishRecording(entry);
+      break;
+
+    case DisplayListCache::Entry::State::Recorded:
+      INCSTAT(g_stats.this_frame.num_dlist_cache_hits);
+      ReplayDisplayList(entry, data, size);
+      break;
+    }
+  }
+
+  VertexLoaderManager::DecodedVertices* RecordPrimitive(OpcodeDecoder::Primitive primitive, u8 vat,
+                                                        u32 vertex_size, u16 num_vertices,
+                                                        const u8* vertex_data)
+  {
+    DisplayListCache::Primitive& recorded = m_recording->primitives.emplace_back();
+    recorded.offset = static_cast<u32>(vertex_data - m_recording_start);
+    recorded.primitive = primitive;
+    recorded.vat = vat;
+    recorded.num_vertices = num_vertices;
+    recorded.vertex_size = vertex_size;
+    recorded.SetFormat(g_main_cp_state.vtx_desc, g_main_cp_state.vtx_attr[vat]);
+    return &recorded.decoded.emplace();
+  }
+
+  void ReplayDisplayList(DisplayListCache::Entry& entry, const u8* data, u32 size)
+  {
+    u32 offset = 0;
+    for (const DisplayListCache::Primitive& primitive : entry.primitives)
+    {
+      // Everything up to the primitive command.
+      const u32 command_offset = primitive.offset - 3;
+      Run(data + offset, command_offset - offset, *this);
+
+      if (!DisplayListCache::IsSameFormat(primitive, g_main_cp_state.vtx_desc,
+                                          g_main_cp_state.vtx_attr[primitive.vat]))
+      {
+        // The primitive has a different size now, so the rest needs to be parsed again.
+        INCSTAT(g_stats.this_frame.num_dlist_cache_format_changes);
+        g_display_list_cache->Invalidate(entry);
+        Run(data + command_offset, size - command_offset, *this);
+        return;
+      }
+
+      if (primitive.decoded)
+      {
+        VertexLoaderManager::RunDecodedVertices(primitive.vat, primitive.primitive,
+                                                *primitive.decoded);
+        ADDSTAT(g_stats.this_frame.bytes_dlist_cache_saved,
+                primitive.num_vertices * primitive.vertex_size);
+      }
+      else
+      {
+        VertexLoaderManager::RunVertices(primitive.vat, primitive.primitive,
+                                         primitive.num_vertices, data + primitive.offset);
+      }
+      m_cycles += primitive.num_vertices * 4 * 3 + 6;
+      offset = primitive.GetEnd();
+    }
+    Run(data + offset, entry.parsed_size - offset, *this);
+  }
+
+  DisplayListCache::Entry* m_recording = nullptr;
+  const u8* m_recording_start = nullptr;
 };
 
 template <bool is_preprocess>
@@ -262,6 +367,9 @@ u8* RunFifo(DataReader src, u32* cycles)
 {
   using CallbackT = RunCallback<is_preprocess>;
   auto callback = CallbackT{};
+  std::optional<StageTimings::ScopedTimer> timer;
+  if constexpr (!is_preprocess)
+    timer.emplace(StageTimings::Stage::RunFifo);
   u32 size = Run(src.GetPointer(), static_cast<u32>(src.size()), callback);
 
   if (cycles != nullptr)
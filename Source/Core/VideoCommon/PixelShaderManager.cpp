@@ -120,7 +120,8 @@ void PixelShaderManager::SetConstants()
       constants.fogf[2] = 0;
       constants.fogf[3] = 1;
     }
-    dirty = true;
+    MarkDirty(constants.fogf);
+    MarkDirty(constants.fogrange);
 
     m_fog_range_adjusted_changed = false;
   }
@@ -129,7 +130,7 @@ void PixelShaderManager::SetConstants()
   {
     constants.zbias[1][0] = (s32)xfmem.viewport.farZ;
     constants.zbias[1][1] = (s32)xfmem.viewport.zRange;
-    dirty = true;
+    MarkDirty(constants.zbias[1]);
     m_viewport_changed = false;
   }
 
@@ -154,7 +155,7 @@ void PixelShaderManager::SetConstants()
             bpmem.tevindref.getTexCoord(stage) | bpmem.tevindref.getTexMap(stage) << 8 | 1 << 16;
     }
 
-    dirty = true;
+    MarkDirty(constants.pack1);
     m_indirect_dirty = false;
   }
 
@@ -179,7 +180,7 @@ void PixelShaderManager::SetTevColor(int index, int component, s32 value)
 {
   auto& c = constants.colors[index];
   c[component] = value;
-  dirty = true;
+  MarkDirty(c);
 
   PRIM_LOG("tev color{}: {} {} {} {}", index, c[0], c[1], c[2], c[3]);
 }
@@ -188,18 +189,22 @@ void PixelShaderManager::SetTevKonstColor(int index, int component, s32 value)
 {
   auto& c = constants.kcolors[index];
   c[component] = value;
-  dirty = true;
+  MarkDirty(c);
 
   // Konst for ubershaders. We build the whole array on cpu so the gpu can do a single indirect
   // access.
   if (component != 3)  // Alpha doesn't included in the .rgb konsts
+  {
     constants.konst[index + 12][component] = value;
+    MarkDirty(constants.konst[index + 12]);
+  }
 
   // .rrrr .gggg .bbbb .aaaa konsts
   constants.konst[index + 16 + component * 4][0] = value;
   constants.konst[index + 16 + component * 4][1] = value;
   constants.konst[index + 16 + component * 4][2] = value;
   constants.konst[index + 16 + component * 4][3] = value;
+  MarkDirty(constants.konst[index + 16 + component * 4]);
 
   PRIM_LOG("tev konst color{}: {} {} {} {}", index, c[0], c[1], c[2], c[3]);
 }
@@ -241,7 +246,7 @@ void PixelShaderManager::SetAlpha()
   constants.alpha[0] = bpmem.alpha_test.ref0;
   constants.alpha[1] = bpmem.alpha_test.ref1;
   constants.alpha[3] = static_cast<s32>(bpmem.dstalpha.alpha);
-  dirty = true;
+  MarkDirty(constants.alpha);
 }
 
 void PixelShaderManager::SetAlphaTestChanged()
@@ -287,7 +292,7 @@ void PixelShaderManager::SetSamplerState(int texmapid, u32 tm0, u32 tm1)
 void PixelShaderManager::SetZTextureBias()
 {
   constants.zbias[1][3] = bpmem.ztex1.bias;
-  dirty = true;
+  MarkDirty(constants.zbias[1]);
 }
 
 void PixelShaderManager::SetViewportChanged()
@@ -301,7 +306,7 @@ void PixelShaderManager::SetEfbScaleChanged(float scalex, float scaley)
 {
   constants.efbscale[0] = 1.0f / scalex;
   constants.efbscale[1] = 1.0f / scaley;
-  dirty = true;
+  MarkDirty(constants.efbscale);
 }
 
 void PixelShaderManager::SetZSlope(float dfdx, float dfdy, float f0)
@@ -309,7 +314,7 @@ void PixelShaderManager::SetZSlope(float dfdx, float dfdy, float f0)
   constants.zslope[0] = dfdx;
   constants.zslope[1] = dfdy;
   constants.zslope[2] = f0;
-  dirty = true;
+  MarkDirty(constants.zslope);
 }
 
 void PixelShaderManager::SetIndTexScaleChanged(bool high)
@@ -318,7 +323,7 @@ void PixelShaderManager::SetIndTexScaleChanged(bool high)
   constants.indtexscale[high][1] = bpmem.texscale[high].ts0;
   constants.indtexscale[high][2] = bpmem.texscale[high].ss1;
   constants.indtexscale[high][3] = bpmem.texscale[high].ts1;
-  dirty = true;
+  MarkDirty(constants.indtexscale[high]);
 }
 
 void PixelShaderManager::SetIndMatrixChanged(int matrixidx)
@@ -335,7 +340,7 @@ void PixelShaderManager::SetIndMatrixChanged(int matrixidx)
   constants.indtexmtx[2 * matrixidx + 1][1] = bpmem.indmtx[matrixidx].col1.md;
   constants.indtexmtx[2 * matrixidx + 1][2] = bpmem.indmtx[matrixidx].col2.mf;
   constants.indtexmtx[2 * matrixidx + 1][3] = 17 - scale;
-  dirty = true;
+  MarkDirty(&constants.indtexmtx[2 * matrixidx], 2 * sizeof(int4));
 
   PRIM_LOG("indmtx{}: scale={}, mat=({} {} {}; {} {} {})", matrixidx, scale,
            bpmem.indmtx[matrixidx].col0.ma, bpmem.indmtx[matrixidx].col1.mc,
@@ -369,13 +374,13 @@ void PixelShaderManager::SetZTextureTypeChanged()
     PanicAlertFmt("Invalid ztex format {}", bpmem.ztex2.type);
     break;
   }
-  dirty = true;
+  MarkDirty(constants.zbias[0]);
 }
 
 void PixelShaderManager::SetZTextureOpChanged()
 {
   constants.ztex_op = bpmem.ztex2.op;
-  dirty = true;
+  MarkDirty(constants.ztex_op);
 }
 
 void PixelShaderManager::SetTexCoordChanged(u8 texmapid)
@@ -383,7 +388,7 @@ void PixelShaderManager::SetTexCoordChanged(u8 texmapid)
   TCoordInfo& tc = bpmem.texcoords[texmapid];
   constants.texdims[texmapid][2] = tc.s.scale_minus_1 + 1;
   constants.texdims[texmapid][3] = tc.t.scale_minus_1 + 1;
-  dirty = true;
+  MarkDirty(constants.texdims[texmapid]);
 }
 
 void PixelShaderManager::SetFogColorChanged()
@@ -394,7 +399,7 @@ void PixelShaderManager::SetFogColorChanged()
   constants.fogcolor[0] = bpmem.fog.color.r;
   constants.fogcolor[1] = bpmem.fog.color.g;
   constants.fogcolor[2] = bpmem.fog.color.b;
-  dirty = true;
+  MarkDirty(constants.fogcolor);
 }
 
 void PixelShaderManager::SetFogParamChanged()
@@ -415,7 +420,9 @@ void PixelShaderManager::SetFogParamChanged()
     constants.fogi[3] = 1;
     constants.fogParam3 = 0;
   }
-  dirty = true;
+  MarkDirty(constants.fogf);
+  MarkDirty(constants.fogi);
+  MarkDirty(constants.fogParam3);
 }
 
 void PixelShaderManager::SetFogRangeAdjustChanged()
@@ -436,7 +443,7 @@ void PixelShaderManager::SetGenModeChanged()
 {
   constants.genmode = bpmem.genMode.hex;
   m_indirect_dirty = true;
-  dirty = true;
+  MarkDirty(constants.genmode);
 }
 
 void PixelShaderManager::SetZModeControl()
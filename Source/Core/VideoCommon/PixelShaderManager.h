@@ -6,6 +6,7 @@
 #include <span>
 
 #include "Common/CommonTypes.h"
+#include "VideoCommon/ConstantDirtyRanges.h"
 #include "VideoCommon/ConstantManager.h"
 
 class PointerWrap;
@@ -52,7 +53,17 @@ public:
   void SetBoundingBoxActive(bool active);
 
   PixelShaderConstants constants{};
+  // Forces the constants to be uploaded. Writes that may not change anything should be marked in
+  // dirty_ranges instead, VertexManagerBase sets this before drawing if they changed something.
   bool dirty = false;
+  ConstantDirtyRanges<PixelShaderConstants> dirty_ranges;
+
+  template <typename T>
+  void MarkDirty(const T& field)
+  {
+    dirty_ranges.Mark(constants, &field, sizeof(field));
+  }
+  void MarkDirty(const void* field, size_t size) { dirty_ranges.Mark(constants, field, size); }
 
   // Constants for custom shaders
   std::span<u8> custom_constants;
@@ -432,33 +432,37 @@ void ShaderCache::CompileMissingPipelines()
 
 std::unique_ptr<AbstractShader> ShaderCache::CompileVertexShader(const VertexShaderUid& uid) const
 {
-  const ShaderCode source_code =
-      GenerateVertexShaderCode(m_api_type, m_host_config, uid.GetUidData());
-  return g_gfx->CreateShaderFromSource(ShaderStage::Vertex, source_code.GetBuffer());
+  const auto source = m_vs_cache.source_cache.GetSource(m_host_config, uid, [&] {
+    return GenerateVertexShaderCode(m_api_type, m_host_config, uid.GetUidData());
+  });
+  return g_gfx->CreateShaderFromSource(ShaderStage::Vertex, *source);
 }
 
 std::unique_ptr<AbstractShader>
 ShaderCache::CompileVertexUberShader(const UberShader::VertexShaderUid& uid) const
 {
-  const ShaderCode source_code =
-      UberShader::GenVertexShader(m_api_type, m_host_config, uid.GetUidData());
-  return g_gfx->CreateShaderFromSource(ShaderStage::Vertex, source_code.GetBuffer(),
+  const auto source = m_uber_vs_cache.source_cache.GetSource(m_host_config, uid, [&] {
+    return UberShader::GenVertexShader(m_api_type, m_host_config, uid.GetUidData());
+  });
+  return g_gfx->CreateShaderFromSource(ShaderStage::Vertex, *source,
                                        fmt::to_string(*uid.GetUidData()));
 }
 
 std::unique_ptr<AbstractShader> ShaderCache::CompilePixelShader(const PixelShaderUid& uid) const
 {
-  const ShaderCode source_code =
-      GeneratePixelShaderCode(m_api_type, m_host_config, uid.GetUidData(), {});
-  return g_gfx->CreateShaderFromSource(ShaderStage::Pixel, source_code.GetBuffer());
+  const auto source = m_ps_cache.source_cache.GetSource(m_host_config, uid, [&] {
+    return GeneratePixelShaderCode(m_api_type, m_host_config, uid.GetUidData(), {});
+  });
+  return g_gfx->CreateShaderFromSource(ShaderStage::Pixel, *source);
 }
 
 std::unique_ptr<AbstractShader>
 ShaderCache::CompilePixelUberShader(const UberShader::PixelShaderUid& uid) const
 {
-  const ShaderCode source_code =
-      UberShader::GenPixelShader(m_api_type, m_host_config, uid.GetUidData(), {});
-  return g_gfx->CreateShaderFromSource(ShaderStage::Pixel, source_code.GetBuffer(),
+  const auto source = m_uber_ps_cache.source_cache.GetSource(m_host_config, uid, [&] {
+    return UberShader::GenPixelShader(m_api_type, m_host_config, uid.GetUidData(), {});
+  });
+  return g_gfx->CreateShaderFromSource(ShaderStage::Pixel, *source,
                                        fmt::to_string(*uid.GetUidData()));
 }
 
@@ -552,10 +556,11 @@ const AbstractShader* ShaderCache::InsertPixelUberShader(const UberShader::Pixel
 
 const AbstractShader* ShaderCache::CreateGeometryShader(const GeometryShaderUid& uid)
 {
-  const ShaderCode source_code =
-      GenerateGeometryShaderCode(m_api_type, m_host_config, uid.GetUidData());
+  const auto source = m_gs_cache.source_cache.GetSource(m_host_config, uid, [&] {
+    return GenerateGeometryShaderCode(m_api_type, m_host_config, uid.GetUidData());
+  });
   std::unique_ptr<AbstractShader> shader =
-      g_gfx->CreateShaderFromSource(ShaderStage::Geometry, source_code.GetBuffer(),
+      g_gfx->CreateShaderFromSource(ShaderStage::Geometry, *source,
                                     fmt::format("Geometry shader: {}", *uid.GetUidData()));
 
   auto& entry = m_gs_cache.shader_map[uid];
@@ -3,6 +3,9 @@
 
 #include "VideoCommon/ShaderGenCommon.h"
 
+#include <string>
+#include <utility>
+
 #include <fmt/format.h>
 
 #include "Common/Assert.h"
@@ -12,6 +15,23 @@
 #include "VideoCommon/VideoConfig.h"
 #include "VideoCommon/XFMemory.h"
 
+// Shaders are written in many small pieces, and uber shaders are several times larger than the
+// initial reservation. Rather than growing a new buffer by reallocating it for every shader, the
+// largest buffer of a finished shader is kept for the next one that is generated on the thread.
+static thread_local std::string s_spare_shader_buffer;
+
+ShaderCode::ShaderCode() : m_buffer(std::move(s_spare_shader_buffer))
+{
+  m_buffer.clear();
+  m_buffer.reserve(16384);
+}
+
+ShaderCode::~ShaderCode()
+{
+  if (m_buffer.capacity() > s_spare_shader_buffer.capacity())
+    s_spare_shader_buffer = std::move(m_buffer);
+}
+
 ShaderHostConfig ShaderHostConfig::GetCurrent()
 {
   ShaderHostConfig bits = {};
@@ -0,0 +1,70 @@
+// Copyright 2024 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <cstddef>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+
+#include "Common/CommonTypes.h"
+#include "VideoCommon/ShaderGenCommon.h"
+
+// Remembers the source code that was generated for shader UIDs. A shader is generated more than
+// once when a pipeline needs it while it is still queued for asynchronous compilation, and after
+// the host config is changed back to an earlier one, which recompiles every shader.
+// Accessed by the shader compiler threads.
+template <typename Uid>
+class ShaderSourceCache
+{
+public:
+  using Source = std::shared_ptr<const std::string>;
+
+  // Above this, the cache is cleared.
+  static constexpr size_t MAX_SIZE = 16 * 1024 * 1024;
+
+  // Returns the source of the UID for the host config, calling generate() if it isn't known.
+  template <typename GenerateFunction>
+  Source GetSource(const ShaderHostConfig& host_config, const Uid& uid, GenerateFunction generate)
+  {
+    const Key key{host_config.bits, uid};
+    {
+      std::lock_guard guard(m_mutex);
+      const auto iter = m_sources.find(key);
+      if (iter != m_sources.end())
+        return iter->second;
+    }
+
+    // Generated without holding the lock, as other threads may need to generate other shaders.
+    const ShaderCode code = generate();
+    Source source = std::make_shared<const std::string>(code.GetBuffer());
+
+    std::lock_guard guard(m_mutex);
+    if (m_size + source->size() > MAX_SIZE)
+    {
+      m_sources.clear();
+      m_size = 0;
+    }
+    const auto [iter, inserted] = m_sources.emplace(key, source);
+    if (inserted)
+      m_size += source->size();
+    return iter->second;
+  }
+
+  void Clear()
+  {
+    std::lock_guard guard(m_mutex);
+    m_sources.clear();
+    m_size = 0;
+  }
+
+private:
+  using Key = std::pair<u32, Uid>;
+
+  std::mutex m_mutex;
+  std::map<Key, Source> m_sources;
+  size_t m_size = 0;
+};
@@ -0,0 +1,68 @@
+// Copyright 2024 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "VideoCommon/StageTimings.h"
+
+namespace StageTimings
+{
+namespace
+{
+struct AtomicStageTiming
+{
+  std::atomic<u64> calls{0};
+  std::atomic<s64> time_ns{0};
+};
+
+std::array<AtomicStageTiming, NUM_STAGES> s_timings;
+}  // namespace
+
+std::atomic<bool> detail::s_enabled{false};
+
+const char* GetStageName(Stage stage)
+{
+  switch (stage)
+  {
+  case Stage::RunFifo:
+    return "run_fifo";
+  case Stage::VertexLoader:
+    return "vertex_loader";
+  case Stage::TextureCacheLoad:
+    return "texture_cache_load";
+  default:
+    return "unknown";
+  }
+}
+
+void SetEnabled(bool enabled)
+{
+  detail::s_enabled.store(enabled, std::memory_order_relaxed);
+}
+
+void Reset()
+{
+  for (AtomicStageTiming& timing : s_timings)
+  {
+    timing.calls.store(0, std::memory_order_relaxed);
+    timing.time_ns.store(0, std::memory_order_relaxed);
+  }
+}
+
+Timings Get()
+{
+  Timings timings;
+  for (size_t i = 0; i < NUM_STAGES; ++i)
+  {
+    timings[i].calls = s_timings[i].calls.load(std::memory_order_relaxed);
+    timings[i].time =
+        std::chrono::nanoseconds(s_timings[i].time_ns.load(std::memory_order_relaxed));
+  }
+  return timings;
+}
+
+void Add(Stage stage, std::chrono::nanoseconds time)
+{
+  AtomicStageTiming& timing = s_timings[static_cast<size_t>(stage)];
+  timing.calls.fetch_add(1, std::memory_order_relaxed);
+  timing.time_ns.fetch_add(time.count(), std::memory_order_relaxed);
+}
+}  // namespace StageTimings
@@ -0,0 +1,81 @@
+// Copyright 2024 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+
+#include "Common/CommonTypes.h"
+
+// Accumulated time spent in the main stages of the video frontend, for benchmarking it without
+// a GPU (see the benchmark command of DolphinTool). Collection is disabled by default, in which
+// case a timed scope only costs a relaxed atomic load.
+namespace StageTimings
+{
+enum class Stage
+{
+  // OpcodeDecoder::RunFifo, including everything it calls, such as the stages below.
+  RunFifo,
+  // The vertex loaders converting vertices to the native format.
+  VertexLoader,
+  // TextureCacheBase::Load, including the decoding and uploading of textures that weren't cached.
+  TextureCacheLoad,
+  Count,
+};
+
+constexpr size_t NUM_STAGES = static_cast<size_t>(Stage::Count);
+
+struct StageTiming
+{
+  u64 calls = 0;
+  std::chrono::nanoseconds time{};
+};
+
+using Timings = std::array<StageTiming, NUM_STAGES>;
+
+const char* GetStageName(Stage stage);
+
+namespace detail
+{
+extern std::atomic<bool> s_enabled;
+}
+
+void SetEnabled(bool enabled);
+inline bool IsEnabled()
+{
+  return detail::s_enabled.load(std::memory_order_relaxed);
+}
+void Reset();
+// Can be called from any thread.
+Timings Get();
+
+void Add(Stage stage, std::chrono::nanoseconds time);
+
+class ScopedTimer final
+{
+public:
+  explicit ScopedTimer(Stage stage) : m_stage(stage), m_enabled(IsEnabled())
+  {
+    if (m_enabled)
+      m_start = Clock::now();
+  }
+  ~ScopedTimer()
+  {
+    if (m_enabled)
+      Add(m_stage, Clock::now() - m_start);
+  }
+
+  ScopedTimer(const ScopedTimer&) = delete;
+  ScopedTimer& operator=(const ScopedTimer&) = delete;
+
+private:
+  using Clock = std::chrono::steady_clock;
+
+  const Stage m_stage;
+  const bool m_enabled;
+  Clock::time_point m_start;
+};
+}  // namespace StageTimings
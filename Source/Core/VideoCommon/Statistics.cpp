@@ -10,8 +10,10 @@
 
 #include "Core/DolphinAnalytics.h"
 #include "Core/HW/SystemTimers.h"
+#include "Core/PowerPC/MMU.h"
 #include "Core/System.h"
 
+#include "VideoCommon/Assets/CustomAssetLoader.h"
 #include "VideoCommon/BPFunctions.h"
 #include "VideoCommon/VideoCommon.h"
 #include "VideoCommon/VideoConfig.h"
@@ -90,14 +92,32 @@ void Statistics::Display() const
   draw_statistic("Textures created", "%d", num_textures_created);
   draw_statistic("Textures uploaded", "%d", num_textures_uploaded);
   draw_statistic("Textures alive", "%d", num_textures_alive);
+  draw_statistic("Textures shared", "%d (%i kB)", num_textures_shared,
+                 bytes_textures_shared / 1024);
   draw_statistic("pshaders created", "%d", num_pixel_shaders_created);
   draw_statistic("pshaders alive", "%d", num_pixel_shaders_alive);
   draw_statistic("vshaders created", "%d", num_vertex_shaders_created);
   draw_statistic("vshaders alive", "%d", num_vertex_shaders_alive);
   draw_statistic("shaders changes", "%d", this_frame.num_shader_changes);
   draw_statistic("dlists called", "%d", this_frame.num_dlists_called);
+  if (g_ActiveConfig.bDisplayListCache)
+  {
+    draw_statistic("dlist cache hits", "%d/%d", this_frame.num_dlist_cache_hits,
+                   this_frame.num_dlist_cache_hits + this_frame.num_dlist_cache_misses);
+    draw_statistic("dlist cache format changes", "%d",
+                   this_frame.num_dlist_cache_format_changes);
+    draw_statistic("dlist cache vertex data saved", "%i kB",
+                   this_frame.bytes_dlist_cache_saved / 1024);
+  }
   draw_statistic("Primitive joins", "%d", this_frame.num_primitive_joins);
   draw_statistic("Draw calls", "%d", this_frame.num_draw_calls);
+  if (g_ActiveConfig.bCPUCull)
+  {
+    draw_statistic("CPU culled draws", "%d/%d", this_frame.num_cpu_culled_draws,
+                   this_frame.num_cpu_cull_draws);
+    draw_statistic("CPU culled vertices", "%d", this_frame.num_cpu_culled_vertices);
+    draw_statistic("CPU cull bounds early-outs", "%d", this_frame.num_cpu_cull_bounds_early_outs);
+  }
   draw_statistic("Primitives", "%d", this_frame.num_prims);
   draw_statistic("Primitives (DL)", "%d", this_frame.num_dl_prims);
   draw_statistic("XF loads", "%d", this_frame.num_xf_loads);
@@ -106,15 +126,43 @@ void Statistics::Display() const
   draw_statistic("CP loads (DL)", "%d", this_frame.num_cp_loads_in_dl);
   draw_statistic("BP loads", "%d", this_frame.num_bp_loads);
   draw_statistic("BP loads (DL)", "%d", this_frame.num_bp_loads_in_dl);
+  draw_statistic("Reused draw buffers", "%d", this_frame.num_reused_draw_buffers);
   draw_statistic("Vertex streamed", "%i kB", this_frame.bytes_vertex_streamed / 1024);
   draw_statistic("Index streamed", "%i kB", this_frame.bytes_index_streamed / 1024);
   draw_statistic("Uniform streamed", "%i kB", this_frame.bytes_uniform_streamed / 1024);
+  draw_statistic("Uniform changed", "%i kB", this_frame.bytes_uniform_changed / 1024);
+  draw_statistic("Uniform uploads skipped", "%d", this_frame.num_uniform_uploads_skipped);
   draw_statistic("Vertex Loaders", "%d", num_vertex_loaders);
   draw_statistic("EFB peeks:", "%d", this_frame.num_efb_peeks);
   draw_statistic("EFB pokes:", "%d", this_frame.num_efb_pokes);
+  draw_statistic("EFB peek cache hits:", "%d/%d", this_frame.num_efb_peek_cache_hits,
+                 this_frame.num_efb_peek_cache_hits + this_frame.num_efb_peek_cache_misses);
+  draw_statistic("EFB peek stall:", "%.2f ms", this_frame.efb_peek_stall_us / 1000.0);
   draw_statistic("Draw dones:", "%d", this_frame.num_draw_done);
   draw_statistic("Tokens:", "%d/%d", this_frame.num_token, this_frame.num_token_int);
 
+  auto& system = Core::System::GetInstance();
+  if (system.IsMMUMode())
+  {
+    const auto tlb = system.GetMMU().GetTLBStats();
+    const u64 lookups =
+        tlb.software_tlb_hits + tlb.tlb_hits + tlb.page_walk_cache_hits + tlb.page_walks;
+    const auto percent = [lookups](u64 count) {
+      return lookups != 0 ? 100.0 * static_cast<double>(count) / lookups : 0.0;
+    };
+    draw_statistic("Software TLB hits:", "%.1f%%", percent(tlb.software_tlb_hits));
+    draw_statistic("TLB hits:", "%.1f%%", percent(tlb.tlb_hits));
+    draw_statistic("Page walk cache hits:", "%.1f%%", percent(tlb.page_walk_cache_hits));
+    draw_statistic("Page table walks:", "%llu", static_cast<unsigned long long>(tlb.page_walks));
+  }
+
+  const auto asset_latencies = system.GetCustomAssetLoader().GetLoadLatencies();
+  if (asset_latencies.count != 0)
+  {
+    draw_statistic("Asset load p50/p90/p99:", "%.1f/%.1f/%.1f ms", asset_latencies.p50,
+                   asset_latencies.p90, asset_latencies.p99);
+  }
+
   ImGui::Columns(1);
 
   ImGui::End();
@@ -18,6 +18,9 @@ struct Statistics
   int num_textures_created = 0;
   int num_textures_uploaded = 0;
   int num_textures_alive = 0;
+  // Texture lookups at other addresses which were given an existing texture with the same contents
+  int num_textures_shared = 0;
+  int bytes_textures_shared = 0;
 
   int num_vertex_loaders = 0;
 
@@ -52,11 +55,24 @@ struct Statistics
     int num_primitive_joins = 0;
     int num_draw_calls = 0;
 
+    int num_cpu_cull_draws = 0;
+    int num_cpu_culled_draws = 0;
+    int num_cpu_culled_vertices = 0;
+    int num_cpu_cull_bounds_early_outs = 0;
+
     int num_dlists_called = 0;
+    int num_dlist_cache_hits = 0;
+    int num_dlist_cache_misses = 0;
+    int num_dlist_cache_format_changes = 0;
+    int bytes_dlist_cache_saved = 0;
 
+    int num_reused_draw_buffers = 0;
     int bytes_vertex_streamed = 0;
     int bytes_index_streamed = 0;
     int bytes_uniform_streamed = 0;
+    // Uniform registers that were written and had a different value.
+    int bytes_uniform_changed = 0;
+    int num_uniform_uploads_skipped = 0;
 
     int num_triangles_clipped = 0;
     int num_triangles_in = 0;
@@ -71,6 +87,10 @@ struct Statistics
 
     int num_efb_peeks = 0;
     int num_efb_pokes = 0;
+    int num_efb_peek_cache_hits = 0;
+    int num_efb_peek_cache_misses = 0;
+    // Time spent waiting for EFB readbacks to complete when peeking.
+    int efb_peek_stall_us = 0;
 
     int num_draw_done = 0;
     int num_token = 0;
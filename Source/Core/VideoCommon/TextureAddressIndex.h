@@ -0,0 +1,99 @@
+// Copyright 2024 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <algorithm>
+#include <unordered_map>
+#include <vector>
+
+#include "Common/CommonTypes.h"
+
+// Finds the texture cache entries which may overlap a memory range. Every entry is added to the
+// bucket of each page its memory touches, along with its range. A query only has to look at the
+// buckets of the pages it touches, and can reject most entries in them without dereferencing
+// anything, instead of walking every texture that starts up to the maximum texture size before
+// the range.
+template <typename T>
+class TextureAddressIndex
+{
+public:
+  static constexpr u32 PAGE_SHIFT = 16;
+
+  void Add(u32 addr, u32 size, const T& value)
+  {
+    for (u32 page = FirstPage(addr); page <= LastPage(addr, size); ++page)
+      m_pages[page].push_back({addr, addr + size, value});
+  }
+
+  // The range must be the same one the value was added with.
+  void Remove(u32 addr, u32 size, const T& value)
+  {
+    for (u32 page = FirstPage(addr); page <= LastPage(addr, size); ++page)
+    {
+      const auto iter = m_pages.find(page);
+      if (iter == m_pages.end())
+        continue;
+
+      // Erased in place rather than swapped with the last element, to keep the insertion order.
+      std::vector<Item>& items = iter->second;
+      const auto item = std::find_if(items.begin(), items.end(),
+                                     [&value](const Item& i) { return i.value == value; });
+      if (item != items.end())
+        items.erase(item);
+      if (items.empty())
+        m_pages.erase(iter);
+    }
+  }
+
+  // Appends every value whose range touches [addr, addr + size], including those which end at addr
+  // or start at addr + size, to out. Each value is appended once, ordered by address, and values
+  // with the same address are in the order they were added.
+  void Find(u32 addr, u32 size, std::vector<T>* out) const
+  {
+    m_found.clear();
+    const u32 first_page = FirstPage(addr);
+    const u32 end = addr + size;
+    for (u32 page = first_page; page <= FirstPage(end); ++page)
+    {
+      const auto iter = m_pages.find(page);
+      if (iter == m_pages.end())
+        continue;
+
+      for (const Item& item : iter->second)
+      {
+        // Items spanning multiple pages are only reported from the first page of the query that
+        // they are in.
+        if (page != first_page && FirstPage(item.addr) != page)
+          continue;
+        if (item.addr <= end && item.end >= addr)
+          m_found.push_back(&item);
+      }
+    }
+
+    // Buckets are in insertion order. Sorting stably keeps it for items with the same address.
+    std::stable_sort(m_found.begin(), m_found.end(),
+                     [](const Item* a, const Item* b) { return a->addr < b->addr; });
+    for (const Item* item : m_found)
+      out->push_back(item->value);
+  }
+
+  void Clear() { m_pages.clear(); }
+
+  bool IsEmpty() const { return m_pages.empty(); }
+
+private:
+  struct Item
+  {
+    u32 addr;
+    u32 end;
+    T value;
+  };
+
+  static u32 FirstPage(u32 addr) { return addr >> PAGE_SHIFT; }
+  // Empty ranges are still added to the page of their address.
+  static u32 LastPage(u32 addr, u32 size) { return (addr + std::max(size, 1u) - 1) >> PAGE_SHIFT; }
+
+  std::unordered_map<u32, std::vector<Item>> m_pages;
+  mutable std::vector<const Item*> m_found;
+};
@@ -8,6 +8,7 @@
 #include <cstring>
 #include <memory>
 #include <string>
+#include <thread>
 #include <utility>
 #include <vector>
 #if defined(_M_X86_64)
@@ -28,6 +29,7 @@
 
 #include "Core/Config/GraphicsSettings.h"
 #include "Core/ConfigManager.h"
+#include "Core/Core.h"
 #include "Core/FifoPlayer/FifoPlayer.h"
 #include "Core/FifoPlayer/FifoRecorder.h"
 #include "Core/HW/Memmap.h"
@@ -37,6 +39,7 @@
 #include "VideoCommon/AbstractGfx.h"
 #include "VideoCommon/AbstractStagingTexture.h"
 #include "VideoCommon/Assets/CustomTextureData.h"
+#include "VideoCommon/AsyncRequests.h"
 #include "VideoCommon/BPMemory.h"
 #include "VideoCommon/FramebufferManager.h"
 #include "VideoCommon/GraphicsModSystem/Runtime/FBInfo.h"
@@ -47,6 +50,7 @@
 #include "VideoCommon/PixelShaderManager.h"
 #include "VideoCommon/Present.h"
 #include "VideoCommon/ShaderCache.h"
+#include "VideoCommon/StageTimings.h"
 #include "VideoCommon/Statistics.h"
 #include "VideoCommon/TMEM.h"
 #include "VideoCommon/TextureConversionShader.h"
@@ -64,6 +68,19 @@ static const int TEXTURE_POOL_KILL_THRESHOLD = 3;
 
 static int xfb_count = 0;
 
+static size_t GetTextureMemorySize(const TextureConfig& config)
+{
+  size_t size = 0;
+  for (u32 level = 0; level < config.levels; level++)
+  {
+    u32 rows = std::max(config.height >> level, 1u);
+    if (AbstractTexture::IsCompressedFormat(config.format))
+      rows = (rows + 3) / 4;
+    size += config.GetMipStride(level) * rows;
+  }
+  return size * config.layers;
+}
+
 std::unique_ptr<TextureCacheBase> g_texture_cache;
 
 TCacheEntry::TCacheEntry(std::unique_ptr<AbstractTexture> tex,
@@ -100,6 +117,9 @@ TextureCacheBase::TextureCacheBase()
   TexDecoder_SetTexFmtOverlayOptions(m_backup_config.texfmt_overlay,
                                      m_backup_config.texfmt_overlay_center);
 
+  if (m_backup_config.parallel_texture_decoding)
+    StartDecodeWorkers();
+
   HiresTexture::Init();
 
   TMEM::InvalidateAll();
@@ -107,10 +127,13 @@ TextureCacheBase::TextureCacheBase()
 
 void TextureCacheBase::Shutdown()
 {
-  // Clear pending EFB copies first, so we don't try to flush them.
+  // Clear pending EFB copies first, so we don't try to flush them. This includes the ones the CPU
+  // would have had them written back for.
+  Core::System::GetInstance().GetMemory().SetWriteBackFunction(nullptr);
   m_pending_efb_copies.clear();
 
   HiresTexture::Shutdown();
+  StopDecodeWorkers();
 
   // For correctness, we need to invalidate textures before the gpu context starts shutting down.
   Invalidate();
@@ -122,6 +145,26 @@ TextureCacheBase::~TextureCacheBase()
   m_temp = nullptr;
 }
 
+// Called by the memory manager before guest memory which lazy EFB copies haven't been written to
+// yet is accessed. On the CPU thread, this can run inside the fault handler, so it must not do
+// anything but wait for the GPU thread like an EFB access would. Lazy copies are only left in
+// memory in dual core mode, so the GPU thread only gets here through PrepareHostAccess.
+static void WriteBackLazyEFBCopies(u32 address, u32 size)
+{
+  if (Core::IsGPUThread())
+  {
+    g_texture_cache->WriteBackEFBCopies(address, size);
+    return;
+  }
+
+  AsyncRequests::Event e;
+  e.type = AsyncRequests::Event::WRITE_BACK_EFB_COPIES;
+  e.time = 0;
+  e.write_back_efb_copies.address = address;
+  e.write_back_efb_copies.size = size;
+  AsyncRequests::GetInstance()->PushEvent(e, true);
+}
+
 bool TextureCacheBase::Initialize()
 {
   if (!CreateUtilityTextures())
@@ -130,6 +173,7 @@ bool TextureCacheBase::Initialize()
     return false;
   }
 
+  Core::System::GetInstance().GetMemory().SetWriteBackFunction(WriteBackLazyEFBCopies);
   return true;
 }
 
@@ -142,6 +186,9 @@ void TextureCacheBase::Invalidate()
     bind.reset();
   m_textures_by_hash.clear();
   m_textures_by_address.clear();
+  m_textures_by_page.Clear();
+  m_shared_address_hashes.clear();
+  m_texture_data_hashes.clear();
 
   m_texture_pool.clear();
 }
@@ -172,6 +219,14 @@ void TextureCacheBase::OnConfigChanged(const VideoConfig& config)
     TexDecoder_SetTexFmtOverlayOptions(config.bTexFmtOverlayEnable, config.bTexFmtOverlayCenter);
   }
 
+  if (config.bParallelTextureDecoding != m_backup_config.parallel_texture_decoding)
+  {
+    if (config.bParallelTextureDecoding)
+      StartDecodeWorkers();
+    else
+      StopDecodeWorkers();
+  }
+
   SetBackupConfig(config);
 }
 
@@ -260,6 +315,7 @@ void TextureCacheBase::SetBackupConfig(const VideoConfig& config)
   m_backup_config.graphics_mods = config.bGraphicMods;
   m_backup_config.graphics_mod_change_count =
       config.graphics_mod_config ? config.graphics_mod_config->GetChangeCount() : 0;
+  m_backup_config.parallel_texture_decoding = config.bParallelTextureDecoding;
 }
 
 bool TextureCacheBase::DidLinkedAssetsChange(const TCacheEntry& entry)
@@ -349,7 +405,7 @@ RcTcacheEntry TextureCacheBase::ApplyPaletteToEntry(RcTcacheEntry& entry, const
     g_gfx->EndUtilityDrawing();
   }
 
-  m_textures_by_address.emplace(decoded_entry->addr, decoded_entry);
+  AddTexture(decoded_entry->addr, decoded_entry->size_in_bytes, decoded_entry);
 
   return decoded_entry;
 }
@@ -395,7 +451,7 @@ RcTcacheEntry TextureCacheBase::ReinterpretEntry(const RcTcacheEntry& existing_e
   g_gfx->EndUtilityDrawing();
   reinterpreted_entry->texture->FinishedRendering();
 
-  m_textures_by_address.emplace(reinterpreted_entry->addr, reinterpreted_entry);
+  AddTexture(reinterpreted_entry->addr, reinterpreted_entry->size_in_bytes, reinterpreted_entry);
 
   return reinterpreted_entry;
 }
@@ -749,7 +805,7 @@ void TextureCacheBase::DoLoadState(PointerWrap& p)
 
     auto& entry = GetEntry(id);
     if (entry)
-      m_textures_by_address.emplace(addr, entry);
+      AddTexture(addr, entry->size_in_bytes, entry);
   }
 
   // Fill in hash map.
@@ -850,10 +906,10 @@ RcTcacheEntry TextureCacheBase::DoPartialTextureUpdates(RcTcacheEntry& entry_to_
 
   u32 numBlocksX = (entry_to_update->native_width + block_width - 1) / block_width;
 
-  auto iter = FindOverlappingTextures(entry_to_update->addr, entry_to_update->size_in_bytes);
-  while (iter.first != iter.second)
+  for (const TexAddrCache::iterator iter :
+       FindOverlappingTextures(entry_to_update->addr, entry_to_update->size_in_bytes))
   {
-    auto& entry = iter.first->second;
+    auto& entry = iter->second;
     if (entry != entry_to_update && entry->IsCopy() &&
         entry->references.count(entry_to_update.get()) == 0 &&
         entry->OverlapsMemoryRange(entry_to_update->addr, entry_to_update->size_in_bytes) &&
@@ -866,7 +922,6 @@ RcTcacheEntry TextureCacheBase::DoPartialTextureUpdates(RcTcacheEntry& entry_to_
         {
           if (!CanReinterpretTextureOnGPU(entry_to_update->format.texfmt, entry->format.texfmt))
           {
-            ++iter.first;
             continue;
           }
 
@@ -889,7 +944,6 @@ RcTcacheEntry TextureCacheBase::DoPartialTextureUpdates(RcTcacheEntry& entry_to_
           }
           else
           {
-            ++iter.first;
             continue;
           }
         }
@@ -951,7 +1005,6 @@ RcTcacheEntry TextureCacheBase::DoPartialTextureUpdates(RcTcacheEntry& entry_to_
             static_cast<u32>(dst_x + copy_width) > entry_to_update->GetWidth() ||
             static_cast<u32>(dst_y + copy_height) > entry_to_update->GetHeight())
         {
-          ++iter.first;
           continue;
         }
 
@@ -977,7 +1030,7 @@ RcTcacheEntry TextureCacheBase::DoPartialTextureUpdates(RcTcacheEntry& entry_to_
         {
           // Remove the temporary converted texture, it won't be used anywhere else
           // TODO: It would be nice to convert and copy in one step, but this code path isn't common
-          iter.first = InvalidateTexture(iter.first);
+          InvalidateTexture(iter);
           continue;
         }
         else
@@ -991,11 +1044,10 @@ RcTcacheEntry TextureCacheBase::DoPartialTextureUpdates(RcTcacheEntry& entry_to_
       else
       {
         // If the hash does not match, this EFB copy will not be used for anything, so remove it
-        iter.first = InvalidateTexture(iter.first);
+        InvalidateTexture(iter);
         continue;
       }
     }
-    ++iter.first;
   }
 
   return entry_to_update;
@@ -1247,6 +1299,8 @@ private:
 
 TCacheEntry* TextureCacheBase::Load(const TextureInfo& texture_info)
 {
+  StageTimings::ScopedTimer timer(StageTimings::Stage::TextureCacheLoad);
+
   if (auto entry = LoadImpl(texture_info, false))
   {
     if (!DidLinkedAssetsChange(*entry))
@@ -1317,6 +1371,43 @@ TCacheEntry* TextureCacheBase::LoadImpl(const TextureInfo& texture_info, bool fo
   return entry.get();
 }
 
+u64 TextureCacheBase::GetTextureDataHash(const TextureInfo& texture_info, int sample_size)
+{
+  const u32 size = texture_info.GetTextureSize();
+  if (texture_info.IsFromTmem())
+    return Common::GetHash64(texture_info.GetData(), size, sample_size);
+
+  const u32 address = texture_info.GetRawAddress();
+  const auto [iter, inserted] = m_texture_data_hashes.try_emplace(address);
+  TextureDataHash& cached = iter->second;
+  const bool same_texture = !inserted && cached.size == size && cached.sample_size == sample_size;
+  const bool was_watched = same_texture && cached.write_generation.has_value();
+  auto& memory = Core::System::GetInstance().GetMemory();
+  if (was_watched && memory.IsUnwrittenSince(address, size, *cached.write_generation))
+    return cached.hash;
+
+  // Writes have to be watched for before hashing, so that none are missed in between.
+  std::optional<u64> write_generation;
+  if (same_texture && !was_watched && cached.watch_writes)
+    write_generation = memory.WatchForWrites(address, size);
+
+  const u64 hash = Common::GetHash64(texture_info.GetData(), size, sample_size);
+  if (!same_texture || cached.hash != hash)
+  {
+    cached = TextureDataHash{size, sample_size, hash};
+  }
+  else if (was_watched)
+  {
+    cached.write_generation.reset();
+    cached.watch_writes = false;
+  }
+  else
+  {
+    cached.write_generation = write_generation;
+  }
+  return hash;
+}
+
 RcTcacheEntry TextureCacheBase::GetTexture(const int textureCacheSafetyColorSampleSize,
                                            const TextureInfo& texture_info)
 {
@@ -1356,8 +1447,7 @@ RcTcacheEntry TextureCacheBase::GetTexture(const int textureCacheSafetyColorSamp
 
   // TODO: This doesn't hash GB tiles for preloaded RGBA8 textures (instead, it's hashing more data
   // from the low tmem bank than it should)
-  base_hash = Common::GetHash64(texture_info.GetData(), texture_info.GetTextureSize(),
-                                textureCacheSafetyColorSampleSize);
+  base_hash = GetTextureDataHash(texture_info, textureCacheSafetyColorSampleSize);
   u32 palette_size = 0;
   if (texture_info.GetPaletteSize())
   {
@@ -1542,9 +1632,36 @@ RcTcacheEntry TextureCacheBase::GetTexture(const int textureCacheSafetyColorSamp
   // textures cause unnecessary slowdowns
   // Example: Tales of Symphonia (GC) uses over 500 small textures in menus, but only around 70
   // different ones
-  if (textureCacheSafetyColorSampleSize == 0 ||
-      std::max(texture_info.GetTextureSize(), palette_size) <=
-          (u32)textureCacheSafetyColorSampleSize * 8)
+  // With texture deduplication, textures whose hash was only sampled are shared as well, once a
+  // hash of their whole contents confirmed that they are identical.
+  const bool fully_hashed = textureCacheSafetyColorSampleSize == 0 ||
+                            std::max(texture_info.GetTextureSize(), palette_size) <=
+                                (u32)textureCacheSafetyColorSampleSize * 8;
+  u64 content_hash = TEXHASH_INVALID;
+  if (fully_hashed)
+  {
+    content_hash = full_hash;
+  }
+  else if (g_ActiveConfig.bTextureDeduplication)
+  {
+    // A shared address is trusted as long as its sampled hash stays the same, like any address
+    // with an entry of its own.
+    const auto shared = m_shared_address_hashes.find(texture_info.GetRawAddress());
+    if (shared != m_shared_address_hashes.end() && shared->second.full_hash == full_hash &&
+        shared->second.format == full_format &&
+        shared->second.size == texture_info.GetTextureSize())
+    {
+      content_hash = shared->second.content_hash;
+    }
+    else
+    {
+      content_hash = Common::GetHash64(texture_info.GetData(), texture_info.GetTextureSize(), 0);
+      if (texture_info.GetPaletteSize())
+        content_hash ^= Common::GetHash64(texture_info.GetTlutAddress(), palette_size, 0);
+    }
+  }
+
+  if (content_hash != TEXHASH_INVALID)
   {
     auto hash_range = m_textures_by_hash.equal_range(full_hash);
     TexHashCache::iterator hash_iter = hash_range.first;
@@ -1554,12 +1671,24 @@ RcTcacheEntry TextureCacheBase::GetTexture(const int textureCacheSafetyColorSamp
       // All parameters, except the address, need to match here
       if (entry->format == full_format && entry->native_levels >= texture_info.GetLevelCount() &&
           entry->native_width == texture_info.GetRawWidth() &&
-          entry->native_height == texture_info.GetRawHeight())
+          entry->native_height == texture_info.GetRawHeight() &&
+          (fully_hashed || entry->content_hash == content_hash))
       {
         entry = DoPartialTextureUpdates(hash_iter->second, texture_info.GetTlutAddress(),
                                         texture_info.GetTlutFormat());
         if (entry)
         {
+          if (entry->addr != texture_info.GetRawAddress())
+          {
+            AddSharedAddress(entry.get(), texture_info.GetRawAddress());
+            if (!fully_hashed)
+            {
+              m_shared_address_hashes.insert_or_assign(
+                  texture_info.GetRawAddress(),
+                  SharedAddressHash{full_hash, full_format, texture_info.GetTextureSize(),
+                                    content_hash});
+            }
+          }
           entry->texture->FinishedRendering();
           return entry;
         }
@@ -1644,7 +1773,8 @@ RcTcacheEntry TextureCacheBase::GetTexture(const int textureCacheSafetyColorSamp
   }
 
   auto entry =
-      CreateTextureEntry(TextureCreationInfo{base_hash, full_hash, bytes_per_block, palette_size},
+      CreateTextureEntry(TextureCreationInfo{base_hash, full_hash, content_hash, bytes_per_block,
+                                             palette_size},
                          texture_info, textureCacheSafetyColorSampleSize,
                          std::move(data_for_assets), has_arbitrary_mipmaps, skip_texture_dump);
   entry->linked_game_texture_assets = std::move(cached_game_assets);
@@ -1727,6 +1857,7 @@ RcTcacheEntry TextureCacheBase::CreateTextureEntry(
     const bool decode_on_gpu =
         g_ActiveConfig.UseGPUTextureDecoding() &&
         !(texture_info.IsFromTmem() && texture_info.GetTextureFormat() == TextureFormat::RGBA8);
+    const bool decode_on_workers = ShouldDecodeOnWorkers(texture_info);
 
     ArbitraryMipmapDetector arbitrary_mip_detector;
 
@@ -1760,7 +1891,12 @@ RcTcacheEntry TextureCacheBase::CreateTextureEntry(
 
       CheckTempSize(total_texture_size);
       dst_buffer = m_temp;
-      if (!(texture_info.GetTextureFormat() == TextureFormat::RGBA8 && texture_info.IsFromTmem()))
+      if (decode_on_workers)
+      {
+        DecodeLevelsOnWorkers(texture_info, texLevels, dst_buffer);
+      }
+      else if (!(texture_info.GetTextureFormat() == TextureFormat::RGBA8 &&
+                 texture_info.IsFromTmem()))
       {
         TexDecoder_Decode(dst_buffer, texture_info.GetData(), expanded_width, expanded_height,
                           texture_info.GetTextureFormat(), texture_info.GetTlutAddress(),
@@ -1798,9 +1934,12 @@ RcTcacheEntry TextureCacheBase::CreateTextureEntry(
         // No need to call CheckTempSize here, as the whole buffer is preallocated at the beginning
         const u32 decoded_mip_size =
             mip_level->GetExpandedWidth() * sizeof(u32) * mip_level->GetExpandedHeight();
-        TexDecoder_Decode(dst_buffer, mip_level->GetData(), mip_level->GetExpandedWidth(),
-                          mip_level->GetExpandedHeight(), texture_info.GetTextureFormat(),
-                          texture_info.GetTlutAddress(), texture_info.GetTlutFormat());
+        if (!decode_on_workers)
+        {
+          TexDecoder_Decode(dst_buffer, mip_level->GetData(), mip_level->GetExpandedWidth(),
+                            mip_level->GetExpandedHeight(), texture_info.GetTextureFormat(),
+                            texture_info.GetTlutAddress(), texture_info.GetTlutFormat());
+        }
         entry->texture->Load(level, mip_level->GetRawWidth(), mip_level->GetRawHeight(),
                              mip_level->GetExpandedWidth(), dst_buffer, decoded_mip_size);
 
@@ -1832,12 +1971,12 @@ RcTcacheEntry TextureCacheBase::CreateTextureEntry(
     }
   }
 
-  const auto iter = m_textures_by_address.emplace(texture_info.GetRawAddress(), entry);
-  if (safety_color_sample_size == 0 ||
-      std::max(texture_info.GetTextureSize(), creation_info.palette_size) <=
-          (u32)safety_color_sample_size * 8)
+  const auto iter =
+      AddTexture(texture_info.GetRawAddress(), texture_info.GetTextureSize(), entry);
+  if (creation_info.content_hash != TEXHASH_INVALID)
   {
     entry->textures_by_hash_iter = m_textures_by_hash.emplace(creation_info.full_hash, entry);
+    entry->content_hash = creation_info.content_hash;
   }
 
   const TextureAndTLUTFormat full_format(texture_info.GetTextureFormat(),
@@ -1883,6 +2022,7 @@ RcTcacheEntry TextureCacheBase::GetXFBTexture(u32 address, u32 width, u32 height
     ERROR_LOG_FMT(VIDEO, "Trying to load XFB texture from invalid address {:#010x}", address);
     return {};
   }
+  memory.PrepareHostAccess(address, stride * height);
 
   // Do we currently have a mutable version of this XFB copy in VRAM?
   RcTcacheEntry entry = GetXFBFromCache(address, width, height, stride);
@@ -1931,7 +2071,7 @@ RcTcacheEntry TextureCacheBase::GetXFBTexture(u32 address, u32 width, u32 height
   entry->texture->FinishedRendering();
 
   // Insert into the texture cache so we can re-use it next frame, if needed.
-  m_textures_by_address.emplace(entry->addr, entry);
+  AddTexture(entry->addr, entry->size_in_bytes, entry);
   SETSTAT(g_stats.num_textures_alive, static_cast<int>(m_textures_by_address.size()));
   INCSTAT(g_stats.num_textures_uploaded);
 
@@ -2000,15 +2140,15 @@ void TextureCacheBase::StitchXFBCopy(RcTcacheEntry& stitched_entry)
   std::vector<TCacheEntry*> candidates;
   bool create_upscaled_copy = false;
 
-  auto iter = FindOverlappingTextures(stitched_entry->addr, stitched_entry->size_in_bytes);
-  while (iter.first != iter.second)
+  for (const TexAddrCache::iterator iter :
+       FindOverlappingTextures(stitched_entry->addr, stitched_entry->size_in_bytes))
   {
     // Currently, this checks the stride of the VRAM copy against the VI request. Therefore, for
     // interlaced modes, VRAM copies won't be considered candidates. This is okay for now, because
     // our force progressive hack means that an XFB copy should always have a matching stride. If
     // the hack is disabled, XFB2RAM should also be enabled. Should we wish to implement interlaced
     // stitching in the future, this would require a shader which grabs every second line.
-    auto& entry = iter.first->second;
+    auto& entry = iter->second;
     if (entry != stitched_entry && entry->IsCopy() &&
         entry->OverlapsMemoryRange(stitched_entry->addr, stitched_entry->size_in_bytes) &&
         entry->memory_stride == stitched_entry->memory_stride)
@@ -2024,11 +2164,9 @@ void TextureCacheBase::StitchXFBCopy(RcTcacheEntry& stitched_entry)
       else
       {
         // If the hash does not match, this EFB copy will not be used for anything, so remove it
-        iter.first = InvalidateTexture(iter.first);
-        continue;
+        InvalidateTexture(iter);
       }
     }
-    ++iter.first;
   }
 
   if (candidates.empty())
@@ -2305,6 +2443,9 @@ void TextureCacheBase::CopyRenderTargetToTexture(
   const u32 bytes_per_row = num_blocks_x * bytes_per_block;
   const u32 covered_range = num_blocks_y * dstStride;
 
+  if (copy_to_ram)
+    memory.PrepareHostWrite(dstAddr, covered_range);
+
   if (g_ActiveConfig.bGraphicMods)
   {
     FBInfo info;
@@ -2470,10 +2611,9 @@ void TextureCacheBase::CopyRenderTargetToTexture(
   // as our efb copy are marked to check them for partial texture updates.
   // TODO: The logic to detect overlapping strided efb copies is not 100% accurate.
   bool strided_efb_copy = dstStride != bytes_per_row;
-  auto iter = FindOverlappingTextures(dstAddr, covered_range);
-  while (iter.first != iter.second)
+  for (const TexAddrCache::iterator iter : FindOverlappingTextures(dstAddr, covered_range))
   {
-    RcTcacheEntry& overlapping_entry = iter.first->second;
+    RcTcacheEntry& overlapping_entry = iter->second;
 
     if (overlapping_entry->addr == dstAddr && overlapping_entry->is_xfb_copy)
     {
@@ -2495,7 +2635,7 @@ void TextureCacheBase::CopyRenderTargetToTexture(
       {
         // Pending EFB copies which are completely covered by this new copy can simply be tossed,
         // instead of having to flush them later on, since this copy will write over everything.
-        iter.first = InvalidateTexture(iter.first, true);
+        InvalidateTexture(iter, true);
         continue;
       }
 
@@ -2525,7 +2665,6 @@ void TextureCacheBase::CopyRenderTargetToTexture(
         overlapping_entry->textures_by_hash_iter = m_textures_by_hash.end();
       }
     }
-    ++iter.first;
   }
 
   if (OpcodeDecoder::g_record_fifo_data)
@@ -2546,7 +2685,8 @@ void TextureCacheBase::CopyRenderTargetToTexture(
   {
     const u64 hash = entry->CalculateHash();
     entry->SetHashes(hash, hash);
-    m_textures_by_address.emplace(dstAddr, std::move(entry));
+    const u32 size_in_bytes = entry->size_in_bytes;
+    AddTexture(dstAddr, size_in_bytes, std::move(entry));
   }
 }
 
@@ -2555,9 +2695,60 @@ void TextureCacheBase::FlushEFBCopies()
   if (m_pending_efb_copies.empty())
     return;
 
+  m_flushing_efb_copies = true;
   for (auto& entry : m_pending_efb_copies)
     FlushEFBCopy(entry.get());
   m_pending_efb_copies.clear();
+  m_flushing_efb_copies = false;
+}
+
+void TextureCacheBase::MakeEFBCopiesVisibleToCPU()
+{
+  if (!g_ActiveConfig.bLazyEFBCopies)
+  {
+    FlushEFBCopies();
+    return;
+  }
+
+  auto& memory = Core::System::GetInstance().GetMemory();
+  for (const RcTcacheEntry& entry : m_pending_efb_copies)
+  {
+    if (entry->pending_efb_copy_gpu_resident)
+      continue;
+
+    // The copies are written in order, so if one can't be left on the GPU, none of them can.
+    if (!memory.AddGPUResidentRange(entry->addr,
+                                    entry->memory_stride * entry->pending_efb_copy_height))
+    {
+      FlushEFBCopies();
+      return;
+    }
+    entry->pending_efb_copy_gpu_resident = true;
+  }
+}
+
+void TextureCacheBase::WriteBackEFBCopies(u32 address, u32 size)
+{
+  // Flushing writes to guest memory, which ends up here again.
+  if (m_flushing_efb_copies)
+    return;
+
+  const auto last = std::find_if(
+      m_pending_efb_copies.rbegin(), m_pending_efb_copies.rend(),
+      [address, size](const RcTcacheEntry& entry) {
+        const u32 covered_range = entry->memory_stride * entry->pending_efb_copy_height;
+        return entry->pending_efb_copy_gpu_resident && entry->addr < address + size &&
+               address < entry->addr + covered_range;
+      });
+  if (last == m_pending_efb_copies.rend())
+    return;
+
+  // Earlier copies may overlap the same memory, so they have to be written first.
+  m_flushing_efb_copies = true;
+  for (auto iter = m_pending_efb_copies.begin(); iter != last.base(); ++iter)
+    FlushEFBCopy(iter->get());
+  m_pending_efb_copies.erase(m_pending_efb_copies.begin(), last.base());
+  m_flushing_efb_copies = false;
 }
 
 void TextureCacheBase::FlushStaleBinds()
@@ -2583,8 +2774,15 @@ void TextureCacheBase::FlushEFBCopy(TCacheEntry* entry)
   auto& system = Core::System::GetInstance();
   auto& memory = system.GetMemory();
   u8* const dst = memory.GetPointer(entry->addr);
+  const u32 covered_range = entry->memory_stride * entry->pending_efb_copy_height;
+  memory.PrepareHostWrite(entry->addr, covered_range);
   WriteEFBCopyToRAM(dst, entry->pending_efb_copy_width, entry->pending_efb_copy_height,
                     entry->memory_stride, std::move(entry->pending_efb_copy));
+  if (entry->pending_efb_copy_gpu_resident)
+  {
+    memory.RemoveGPUResidentRange(entry->addr, covered_range);
+    entry->pending_efb_copy_gpu_resident = false;
+  }
 
   // If the EFB copy was invalidated (e.g. the bloom case mentioned in InvalidateTexture), we don't
   // need to do anything more. The entry will be automatically deleted by smart pointers
@@ -2600,9 +2798,7 @@ void TextureCacheBase::FlushEFBCopy(TCacheEntry* entry)
   // See the comment above regarding Rogue Squadron 2.
   if (entry->is_xfb_copy)
   {
-    const u32 covered_range = entry->pending_efb_copy_height * entry->memory_stride;
-    auto range = FindOverlappingTextures(entry->addr, covered_range);
-    for (auto iter = range.first; iter != range.second; ++iter)
+    for (const TexAddrCache::iterator iter : FindOverlappingTextures(entry->addr, covered_range))
     {
       auto& overlapping_entry = iter->second;
       if (overlapping_entry->may_have_overlapping_textures && overlapping_entry->is_xfb_copy &&
@@ -2772,21 +2968,24 @@ TextureCacheBase::TexAddrCache::iterator TextureCacheBase::GetTexCacheIter(TCach
   return m_textures_by_address.end();
 }
 
-std::pair<TextureCacheBase::TexAddrCache::iterator, TextureCacheBase::TexAddrCache::iterator>
-TextureCacheBase::FindOverlappingTextures(u32 addr, u32 size_in_bytes)
+TextureCacheBase::TexAddrCache::iterator
+TextureCacheBase::AddTexture(u32 addr, u32 size_in_bytes, RcTcacheEntry entry)
 {
-  // We index by the starting address only, so there is no way to query all textures
-  // which end after the given addr. But the GC textures have a limited size, so we
-  // look for all textures which have a start address bigger than addr minus the maximal
-  // texture size. But this yields false-positives which must be checked later on.
-
-  // 1024 x 1024 texel times 8 nibbles per texel
-  constexpr u32 max_texture_size = 1024 * 1024 * 4;
-  u32 lower_addr = addr > max_texture_size ? addr - max_texture_size : 0;
-  auto begin = m_textures_by_address.lower_bound(lower_addr);
-  auto end = m_textures_by_address.upper_bound(addr + size_in_bytes);
+  const auto iter = m_textures_by_address.emplace(addr, std::move(entry));
+  m_textures_by_page.Add(addr, size_in_bytes, iter);
+  return iter;
+}
 
-  return std::make_pair(begin, end);
+std::vector<TextureCacheBase::TexAddrCache::iterator>
+TextureCacheBase::FindOverlappingTextures(u32 addr, u32 size_in_bytes)
+{
+  // Indexing by the starting address only would require looking at every texture which starts
+  // up to the maximal texture size before addr. The page index only returns textures which
+  // actually touch the range. Erasing any of the returned textures doesn't invalidate the other
+  // iterators, so callers are free to invalidate textures while going through them.
+  std::vector<TexAddrCache::iterator> textures;
+  m_textures_by_page.Find(addr, size_in_bytes, &textures);
+  return textures;
 }
 
 TextureCacheBase::TexAddrCache::iterator
@@ -2796,6 +2995,7 @@ TextureCacheBase::InvalidateTexture(TexAddrCache::iterator iter, bool discard_pe
     return m_textures_by_address.end();
 
   RcTcacheEntry& entry = iter->second;
+  m_textures_by_page.Remove(iter->first, entry->size_in_bytes, iter);
 
   if (entry->textures_by_hash_iter != m_textures_by_hash.end())
   {
@@ -2812,7 +3012,8 @@ TextureCacheBase::InvalidateTexture(TexAddrCache::iterator iter, bool discard_pe
   // eventually flushed, they will overwrite each other, and the end result should be the same.
   if (entry->pending_efb_copy)
   {
-    if (discard_pending_efb_copy)
+    // The CPU may already have seen a copy which was left on the GPU, so it is still needed.
+    if (discard_pending_efb_copy && !entry->pending_efb_copy_gpu_resident)
     {
       // If the RAM copy is being completely overwritten by a new EFB copy, we can discard the
       // existing pending copy, and not bother waiting for it in the future. This happens in
@@ -2836,8 +3037,37 @@ TextureCacheBase::InvalidateTexture(TexAddrCache::iterator iter, bool discard_pe
   return m_textures_by_address.erase(iter);
 }
 
+void TextureCacheBase::AddSharedAddress(TCacheEntry* entry, u32 address)
+{
+  if (std::find(entry->shared_addresses.begin(), entry->shared_addresses.end(), address) !=
+      entry->shared_addresses.end())
+  {
+    return;
+  }
+
+  entry->shared_addresses.push_back(address);
+  m_num_shared_addresses++;
+  m_shared_texture_size += GetTextureMemorySize(entry->texture->GetConfig());
+  SETSTAT(g_stats.num_textures_shared, m_num_shared_addresses);
+  SETSTAT(g_stats.bytes_textures_shared, m_shared_texture_size);
+}
+
+void TextureCacheBase::RemoveSharedAddresses(TCacheEntry* entry)
+{
+  if (entry->shared_addresses.empty() || !entry->texture)
+    return;
+
+  m_num_shared_addresses -= static_cast<u32>(entry->shared_addresses.size());
+  m_shared_texture_size -=
+      entry->shared_addresses.size() * GetTextureMemorySize(entry->texture->GetConfig());
+  entry->shared_addresses.clear();
+  SETSTAT(g_stats.num_textures_shared, m_num_shared_addresses);
+  SETSTAT(g_stats.bytes_textures_shared, m_shared_texture_size);
+}
+
 void TextureCacheBase::ReleaseToPool(TCacheEntry* entry)
 {
+  RemoveSharedAddresses(entry);
   if (!entry->texture)
     return;
   auto config = entry->texture->GetConfig();
@@ -3091,6 +3321,118 @@ bool TextureCacheBase::DecodeTextureOnGPU(RcTcacheEntry& entry, u32 dst_level, c
   return true;
 }
 
+void TextureCacheBase::StartDecodeWorkers()
+{
+  // The GPU thread decodes a share of every texture as well, and the other half of the cores are
+  // left to the CPU thread and the shader compiler threads.
+  const u32 num_workers = std::clamp(std::thread::hardware_concurrency() / 2, 1u, 4u);
+  m_decode_workers.clear();
+  for (u32 i = 0; i < num_workers; i++)
+  {
+    m_decode_workers.push_back(std::make_unique<Common::WorkQueueThread<DecodeJob>>(
+        fmt::format("Texture Decoder {}", i), [](DecodeJob job) {
+          TexDecoder_Decode(job.dst, job.src, job.width, job.height, job.format, job.tlut,
+                            job.tlut_format);
+        }));
+  }
+}
+
+void TextureCacheBase::StopDecodeWorkers()
+{
+  m_decode_workers.clear();
+}
+
+bool TextureCacheBase::ShouldDecodeOnWorkers(const TextureInfo& texture_info) const
+{
+  // Below this, waking up the workers takes about as long as decoding the texture.
+  static constexpr u32 MIN_PIXELS = 128 * 128;
+
+  if (m_decode_workers.empty() ||
+      texture_info.GetExpandedWidth() * texture_info.GetExpandedHeight() < MIN_PIXELS)
+  {
+    return false;
+  }
+
+  // RGBA8 textures from TMEM are read from both banks, which DecodeJob doesn't support.
+  const TextureFormat format = texture_info.GetTextureFormat();
+  if (texture_info.IsFromTmem() && format == TextureFormat::RGBA8)
+    return false;
+
+  // Textures which can be decoded on the GPU are left to it.
+  return !g_ActiveConfig.UseGPUTextureDecoding() ||
+         !TextureConversionShaderTiled::GetDecodingShaderInfo(format);
+}
+
+void TextureCacheBase::DecodeLevelsOnWorkers(const TextureInfo& texture_info, u32 levels, u8* dst)
+{
+  const TextureFormat format = texture_info.GetTextureFormat();
+  const u32 block_height = texture_info.GetBlockHeight();
+  const u32 num_threads = static_cast<u32>(m_decode_workers.size()) + 1;
+
+  // Levels are split into bands of block rows, which are stored one after another in the source
+  // data, so that the base level is decoded by every thread. Bands are as large as the base
+  // level's share of each thread, which makes the smaller levels a single band. The format overlay
+  // is drawn relative to the decoded area, so with it, every level is decoded in one piece.
+  const u32 band_pixels =
+      texture_info.GetExpandedWidth() * texture_info.GetExpandedHeight() / num_threads;
+  const bool split_levels = !g_ActiveConfig.bTexFmtOverlayEnable;
+
+  m_decode_jobs.clear();
+  const auto add_level = [&](const u8* src, u32 width, u32 height) {
+    const u32 band_height =
+        split_levels ? std::max(Common::AlignUp(band_pixels / width, block_height), block_height) :
+                       height;
+    AddDecodeJobs(m_decode_jobs, dst, src, width, height, band_height, format,
+                  texture_info.GetTlutAddress(), texture_info.GetTlutFormat());
+    dst += width * height * sizeof(u32);
+  };
+
+  add_level(texture_info.GetData(), texture_info.GetExpandedWidth(),
+            texture_info.GetExpandedHeight());
+  for (u32 level = 1; level < levels; ++level)
+  {
+    const auto mip_level = texture_info.GetMipMapLevel(level - 1);
+    if (mip_level)
+    {
+      add_level(mip_level->GetData(), mip_level->GetExpandedWidth(),
+                mip_level->GetExpandedHeight());
+    }
+  }
+
+  // Every thread gets one band of the base level first, then the smaller levels are dealt out.
+  for (size_t i = 0; i < m_decode_jobs.size(); i++)
+  {
+    const size_t thread = i % num_threads;
+    if (thread < m_decode_workers.size())
+      m_decode_workers[thread]->Push(m_decode_jobs[i]);
+  }
+  for (size_t i = m_decode_workers.size(); i < m_decode_jobs.size(); i += num_threads)
+  {
+    const DecodeJob& job = m_decode_jobs[i];
+    TexDecoder_Decode(job.dst, job.src, job.width, job.height, job.format, job.tlut,
+                      job.tlut_format);
+  }
+  for (auto& worker : m_decode_workers)
+    worker->WaitForCompletion();
+}
+
+void TextureCacheBase::AddDecodeJobs(std::vector<DecodeJob>& jobs, u8* dst, const u8* src,
+                                     u32 width, u32 height, u32 band_height, TextureFormat format,
+                                     const u8* tlut, TLUTFormat tlut_format)
+{
+  // Bands are whole rows of blocks, which are stored one after another in the source data.
+  const u32 block_width = TexDecoder_GetBlockWidthInTexels(format);
+  const u32 block_height = TexDecoder_GetBlockHeightInTexels(format);
+  const u32 bytes_per_block =
+      (block_width * block_height * TexDecoder_GetTexelSizeInNibbles(format)) / 2;
+  for (u32 y = 0; y < height; y += band_height)
+  {
+    jobs.push_back({dst + y * width * sizeof(u32),
+                    src + (y / block_height) * (width / block_width) * bytes_per_block, width,
+                    std::min(band_height, height - y), format, tlut, tlut_format});
+  }
+}
+
 u32 TCacheEntry::BytesPerRow() const
 {
   // RGBA takes two cache lines per block; all others take one
@@ -3168,6 +3510,8 @@ u64 TCacheEntry::CalculateHash() const
   auto& system = Core::System::GetInstance();
   auto& memory = system.GetMemory();
   u8* ptr = memory.GetPointer(addr);
+  memory.PrepareHostAccess(addr, memory_stride == bytes_per_row ? size_in_bytes :
+                                                                  memory_stride * NumBlocksY());
   if (memory_stride == bytes_per_row)
   {
     return Common::GetHash64(ptr, size_in_bytes, hash_sample_size);
@@ -20,10 +20,12 @@
 #include "Common/CommonTypes.h"
 #include "Common/Flag.h"
 #include "Common/MathUtil.h"
+#include "Common/WorkQueueThread.h"
 
 #include "VideoCommon/AbstractTexture.h"
 #include "VideoCommon/Assets/CustomAsset.h"
 #include "VideoCommon/BPMemory.h"
+#include "VideoCommon/TextureAddressIndex.h"
 #include "VideoCommon/TextureConfig.h"
 #include "VideoCommon/TextureDecoder.h"
 #include "VideoCommon/TextureInfo.h"
@@ -124,6 +126,9 @@ struct TCacheEntry
   u32 size_in_bytes = 0;
   u64 base_hash = 0;
   u64 hash = 0;  // for paletted textures, hash = base_hash ^ palette_hash
+  // Hash of the whole texture and palette, if it was calculated. Equal to hash for textures which
+  // weren't only sampled for hashing.
+  u64 content_hash = 0;
   TextureAndTLUTFormat format;
   u32 memory_stride = 0;
   bool is_efb_copy = false;
@@ -163,9 +168,15 @@ struct TCacheEntry
   std::unique_ptr<AbstractStagingTexture> pending_efb_copy;
   u32 pending_efb_copy_width = 0;
   u32 pending_efb_copy_height = 0;
+  // Whether the memory of the pending EFB copy is only written once the CPU accesses it.
+  bool pending_efb_copy_gpu_resident = false;
 
   std::string texture_info_name = "";
 
+  // Other addresses whose textures had the same contents, and were given this entry instead of
+  // creating their own.
+  std::vector<u32> shared_addresses;
+
   std::vector<VideoCommon::CachedAsset<VideoCommon::GameTextureAsset>> linked_game_texture_assets;
   std::vector<VideoCommon::CachedAsset<VideoCommon::CustomAsset>> linked_asset_dependencies;
 
@@ -256,6 +267,9 @@ public:
   {
     u64 base_hash;
     u64 full_hash;
+    // Only set if the whole texture was hashed, in which case the entry is added to
+    // m_textures_by_hash.
+    u64 content_hash;
     u32 bytes_per_block;
     u32 palette_size;
   };
@@ -294,6 +308,14 @@ public:
   // Flushes all pending EFB copies to emulated RAM.
   void FlushEFBCopies();
 
+  // Called when the CPU may look at the pending EFB copies. With lazy EFB copies, they are left on
+  // the GPU until the CPU accesses their memory, otherwise they are flushed.
+  void MakeEFBCopiesVisibleToCPU();
+
+  // Flushes the pending EFB copies up to the last one which was made visible to the CPU and
+  // overlaps the given range of emulated RAM.
+  void WriteBackEFBCopies(u32 address, u32 size);
+
   // Flush any Bound textures that can't be reused
   void FlushStaleBinds();
 
@@ -307,6 +329,25 @@ public:
   static bool AllCopyFilterCoefsNeeded(const std::array<u32, 3>& coefficients);
   static bool CopyFilterCanOverflow(const std::array<u32, 3>& coefficients);
 
+  // Part of a texture level which is decoded on a worker thread.
+  struct DecodeJob
+  {
+    u8* dst;
+    const u8* src;
+    u32 width;
+    u32 height;
+    TextureFormat format;
+    const u8* tlut;
+    TLUTFormat tlut_format;
+  };
+
+  // Splits a level of the given expanded size into jobs for bands of band_height rows, which must
+  // be a multiple of the block height. The last band gets the rows that are left. Decoding every
+  // job gives the same result as decoding the level in one piece.
+  static void AddDecodeJobs(std::vector<DecodeJob>& jobs, u8* dst, const u8* src, u32 width,
+                            u32 height, u32 band_height, TextureFormat format, const u8* tlut,
+                            TLUTFormat tlut_format);
+
 protected:
   // Decodes the specified data to the GPU texture specified by entry.
   // Returns false if the configuration is not supported.
@@ -354,6 +395,8 @@ private:
 
   RcTcacheEntry GetXFBFromCache(u32 address, u32 width, u32 height, u32 stride);
 
+  u64 GetTextureDataHash(const TextureInfo& texture_info, int sample_size);
+
   RcTcacheEntry ApplyPaletteToEntry(RcTcacheEntry& entry, const u8* palette, TLUTFormat tlutfmt);
 
   RcTcacheEntry ReinterpretEntry(const RcTcacheEntry& existing_entry, TextureFormat new_format);
@@ -364,15 +407,31 @@ private:
 
   void CheckTempSize(size_t required_size);
 
+  void StartDecodeWorkers();
+  void StopDecodeWorkers();
+
+  // Whether the levels of the texture should be decoded with DecodeLevelsOnWorkers.
+  bool ShouldDecodeOnWorkers(const TextureInfo& texture_info) const;
+
+  // Decodes the base level and the mipmap levels below the given level count to dst, in the same
+  // layout as decoding them one after another. Returns once all of them have been decoded.
+  void DecodeLevelsOnWorkers(const TextureInfo& texture_info, u32 levels, u8* dst);
+
   RcTcacheEntry AllocateCacheEntry(const TextureConfig& config);
   std::optional<TexPoolEntry> AllocateTexture(const TextureConfig& config);
   TexPool::iterator FindMatchingTextureFromPool(const TextureConfig& config);
   TexAddrCache::iterator GetTexCacheIter(TCacheEntry* entry);
 
-  // Return all possible overlapping textures. As addr+size of the textures is not
-  // indexed, this may return false positives.
-  std::pair<TexAddrCache::iterator, TexAddrCache::iterator>
-  FindOverlappingTextures(u32 addr, u32 size_in_bytes);
+  // Records that a lookup at the address was given the entry of another address.
+  void AddSharedAddress(TCacheEntry* entry, u32 address);
+  void RemoveSharedAddresses(TCacheEntry* entry);
+
+  // Adds the texture to m_textures_by_address and m_textures_by_page.
+  TexAddrCache::iterator AddTexture(u32 addr, u32 size_in_bytes, RcTcacheEntry entry);
+
+  // Return all possible overlapping textures, ordered by address. This may return textures which
+  // end at addr or start at addr+size, so the callers still need to check for overlaps.
+  std::vector<TexAddrCache::iterator> FindOverlappingTextures(u32 addr, u32 size_in_bytes);
 
   // Removes and unlinks texture from texture cache and returns it to the pool
   TexAddrCache::iterator InvalidateTexture(TexAddrCache::iterator t_iter,
@@ -406,6 +465,9 @@ private:
   // but it's possible for invalidated TCache entries to live on elsewhere
   TexAddrCache m_textures_by_address;
 
+  // Indexes m_textures_by_address by the memory each texture covers, for overlap queries
+  TextureAddressIndex<TexAddrCache::iterator> m_textures_by_page;
+
   // m_textures_by_hash is an alternative view of the texture cache
   // All textures in here will also be in m_textures_by_address
   TexHashCache m_textures_by_hash;
@@ -417,6 +479,37 @@ private:
   TexPool m_texture_pool;
   u64 m_last_entry_id = 0;
 
+  // Across all entries, the number of shared addresses and the size of the textures they would
+  // have needed otherwise.
+  u32 m_num_shared_addresses = 0;
+  size_t m_shared_texture_size = 0;
+
+  // The full content hash last calculated for each shared address, along with the sampled hash and
+  // format it was calculated for. A shared address isn't in m_textures_by_address, so without this
+  // every lookup of it would hash the whole texture again.
+  struct SharedAddressHash
+  {
+    u64 full_hash;
+    TextureAndTLUTFormat format;
+    u32 size;
+    u64 content_hash;
+  };
+  std::unordered_map<u32, SharedAddressHash> m_shared_address_hashes;
+
+  // The hash of the texture data last read from each address in guest memory. Once it was the same
+  // twice, the data is watched for writes, and the hash is reused until the data is written to.
+  struct TextureDataHash
+  {
+    u32 size;
+    int sample_size;
+    u64 hash;
+    std::optional<u64> write_generation;
+    // Cleared once the pages were written without the data changing, as they then hold other data
+    // which is written to, and watching them would cost a fault on every write.
+    bool watch_writes = true;
+  };
+  std::unordered_map<u32, TextureDataHash> m_texture_data_hashes;
+
   // Backup configuration values
   struct BackupConfig
   {
@@ -433,9 +526,14 @@ private:
     bool arbitrary_mipmap_detection;
     bool graphics_mods;
     u32 graphics_mod_change_count;
+    bool parallel_texture_decoding;
   };
   BackupConfig m_backup_config = {};
 
+  // Threads which decode textures along with the GPU thread, if parallel decoding is enabled.
+  std::vector<std::unique_ptr<Common::WorkQueueThread<DecodeJob>>> m_decode_workers;
+  std::vector<DecodeJob> m_decode_jobs;
+
   // Encoding texture used for EFB copies to RAM.
   std::unique_ptr<AbstractTexture> m_efb_encoding_texture;
   std::unique_ptr<AbstractFramebuffer> m_efb_encoding_framebuffer;
@@ -450,6 +548,7 @@ private:
   // so that overlapping textures are written to guest RAM in the order they are issued.
   // It's valid for textures to live be in here after they've been invalidated
   std::vector<RcTcacheEntry> m_pending_efb_copies;
+  bool m_flushing_efb_copies = false;
 
   // Staging texture used for readbacks.
   // We store this in the class so that the same staging texture can be used for multiple
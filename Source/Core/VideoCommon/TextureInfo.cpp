@@ -47,8 +47,12 @@ TextureInfo TextureInfo::FromStage(u32 stage)
 
   auto& system = Core::System::GetInstance();
   auto& memory = system.GetMemory();
-  return TextureInfo(stage, memory.GetPointer(address), tlut_ptr, address, texture_format,
-                     tlut_format, width, height, false, nullptr, nullptr, mip_count);
+  TextureInfo texture_info(stage, memory.GetPointer(address), tlut_ptr, address, texture_format,
+                           tlut_format, width, height, false, nullptr, nullptr, mip_count);
+
+  // The texture may be a lazy EFB copy which hasn't been written to memory yet.
+  memory.PrepareHostAccess(address, texture_info.GetFullLevelSize());
+  return texture_info;
 }
 
 TextureInfo::TextureInfo(u32 stage, const u8* ptr, const u8* tlut_ptr, u32 address,
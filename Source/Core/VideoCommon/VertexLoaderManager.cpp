@@ -4,9 +4,12 @@
 #include "VideoCommon/VertexLoaderManager.h"
 
 #include <algorithm>
+#include <array>
+#include <cstring>
 #include <iterator>
 #include <memory>
 #include <mutex>
+#include <span>
 #include <string>
 #include <type_traits>
 #include <unordered_map>
@@ -27,6 +30,7 @@
 #include "VideoCommon/DataReader.h"
 #include "VideoCommon/IndexGenerator.h"
 #include "VideoCommon/NativeVertexFormat.h"
+#include "VideoCommon/StageTimings.h"
 #include "VideoCommon/Statistics.h"
 #include "VideoCommon/VertexLoaderBase.h"
 #include "VideoCommon/VertexManagerBase.h"
@@ -321,8 +325,123 @@ static void CheckCPConfiguration(int vtx_attr_group)
   }
 }
 
+static bool ReadsVertexArrays(const TVtxDesc& desc)
+{
+  if (IsIndexed(desc.low.Position) || IsIndexed(desc.low.Normal))
+    return true;
+  for (size_t i = 0; i < desc.low.Color.Size(); ++i)
+  {
+    if (IsIndexed(desc.low.Color[i]))
+      return true;
+  }
+  for (size_t i = 0; i < desc.high.TexCoord.Size(); ++i)
+  {
+    if (IsIndexed(desc.high.TexCoord[i]))
+      return true;
+  }
+  return false;
+}
+
+static void RestoreCaches(const TVtxDesc& desc, const VAT& vtx_attr,
+                          const DecodedVertices& decoded)
+{
+  // Only restore what the loader writes, as the rest is left over from earlier vertices.
+  if (desc.low.Position != VertexComponentFormat::NotPresent)
+    position_cache = decoded.position_cache;
+  if (desc.low.PosMatIdx)
+    position_matrix_index_cache = decoded.position_matrix_index_cache;
+  if (desc.low.Normal != VertexComponentFormat::NotPresent &&
+      vtx_attr.g0.NormalElements == NormalComponentCount::NTB)
+  {
+    tangent_cache = decoded.tangent_cache;
+    binormal_cache = decoded.binormal_cache;
+  }
+}
+
+// Adds vertices to the vertex manager. load writes the vertices to the given buffer, and returns
+// how many were written. source is what the vertices are decoded from, or empty if they also depend
+// on other data, and is used for recognizing batches which are drawn repeatedly.
+template <typename LoadFunction>
+static void AddVertices(VertexLoaderBase* loader, int vtx_attr_group,
+                        OpcodeDecoder::Primitive primitive, int count, bool decoded,
+                        std::span<const u8> source, LoadFunction load)
+{
+  if (g_needs_cp_xf_consistency_check) [[unlikely]]
+  {
+    CheckCPConfiguration(vtx_attr_group);
+    g_needs_cp_xf_consistency_check = false;
+  }
+
+  // If the native vertex format changed, force a flush.
+  if (loader->m_native_vertex_format != s_current_vtx_fmt ||
+      loader->m_native_components != g_current_components) [[unlikely]]
+  {
+    g_vertex_manager->Flush();
+
+    s_current_vtx_fmt = loader->m_native_vertex_format;
+    g_current_components = loader->m_native_components;
+    auto& system = Core::System::GetInstance();
+    auto& vertex_shader_manager = system.GetVertexShaderManager();
+    vertex_shader_manager.SetVertexFormat(loader->m_native_components,
+                                          loader->m_native_vertex_format->GetVertexDeclaration());
+  }
+
+  // CPUCull's performance increase comes from encoding fewer GPU commands, not sending less data
+  // Therefore it's only useful to check if culling could remove a flush
+  const bool can_cpu_cull = g_ActiveConfig.bCPUCull &&
+                            primitive < OpcodeDecoder::Primitive::GX_DRAW_LINES &&
+                            !g_vertex_manager->HasSendableVertices();
+
+  // if cull mode is CULL_ALL, tell VertexManager to skip triangles and quads.
+  // They still need to go through vertex loading, because we need to calculate a zfreeze
+  // reference slope.
+  const bool cullall = (bpmem.genMode.cullmode == CullMode::All &&
+                        primitive < OpcodeDecoder::Primitive::GX_DRAW_LINES);
+
+  const int stride = loader->m_native_vtx_decl.stride;
+  DataReader dst = g_vertex_manager->PrepareForAdditionalData(primitive, count, stride,
+                                                              cullall || can_cpu_cull);
+
+  {
+    StageTimings::ScopedTimer timer(StageTimings::Stage::VertexLoader);
+    count = load(dst.GetPointer());
+  }
+
+  if (can_cpu_cull && !cullall)
+  {
+    if (!g_vertex_manager->AreAllVerticesCulled(loader, primitive, dst.GetPointer(), count))
+    {
+      DataReader new_dst = g_vertex_manager->DisableCullAll(stride);
+      memmove(new_dst.GetPointer(), dst.GetPointer(), count * stride);
+    }
+  }
+
+  if (source.data())
+  {
+    // The indices only depend on the primitives added to the batch so far.
+    const TVtxDesc& desc = g_main_cp_state.vtx_desc;
+    const VAT& vat = g_main_cp_state.vtx_attr[vtx_attr_group];
+    const std::array<u32, 8> state = {desc.low.Hex, desc.high.Hex, vat.g0.Hex,
+                                      vat.g1.Hex,   vat.g2.Hex,    static_cast<u32>(primitive),
+                                      static_cast<u32>(count), decoded};
+    g_vertex_manager->IdentifyVertices(
+        std::span(reinterpret_cast<const u8*>(state.data()), sizeof(state)), source);
+  }
+  else
+  {
+    g_vertex_manager->IdentifyUnknownVertices();
+  }
+
+  g_vertex_manager->AddIndices(primitive, count);
+  g_vertex_manager->FlushData(count, loader->m_native_vtx_decl.stride);
+
+  ADDSTAT(g_stats.this_frame.num_prims, count);
+  INCSTAT(g_stats.this_frame.num_primitive_joins);
+}
+
 template <bool IsPreprocess>
-int RunVertices(int vtx_attr_group, OpcodeDecoder::Primitive primitive, int count, const u8* src)
+int RunVertices(int vtx_attr_group, OpcodeDecoder::Primitive primitive, int count, const u8* src,
+                DecodedVertices* decoded)
 {
   if (count == 0) [[unlikely]]
     return 0;
@@ -337,66 +456,47 @@ int RunVertices(int vtx_attr_group, OpcodeDecoder::Primitive primitive, int coun
     // Doing early return for the opposite case would be cleaner
     // but triggers a false unreachable code warning in MSVC debug builds.
 
-    if (g_needs_cp_xf_consistency_check) [[unlikely]]
-    {
-      CheckCPConfiguration(vtx_attr_group);
-      g_needs_cp_xf_consistency_check = false;
-    }
-
-    // If the native vertex format changed, force a flush.
-    if (loader->m_native_vertex_format != s_current_vtx_fmt ||
-        loader->m_native_components != g_current_components) [[unlikely]]
-    {
-      g_vertex_manager->Flush();
-
-      s_current_vtx_fmt = loader->m_native_vertex_format;
-      g_current_components = loader->m_native_components;
-      auto& system = Core::System::GetInstance();
-      auto& vertex_shader_manager = system.GetVertexShaderManager();
-      vertex_shader_manager.SetVertexFormat(loader->m_native_components,
-                                            loader->m_native_vertex_format->GetVertexDeclaration());
-    }
-
-    // CPUCull's performance increase comes from encoding fewer GPU commands, not sending less data
-    // Therefore it's only useful to check if culling could remove a flush
-    const bool can_cpu_cull = g_ActiveConfig.bCPUCull &&
-                              primitive < OpcodeDecoder::Primitive::GX_DRAW_LINES &&
-                              !g_vertex_manager->HasSendableVertices();
-
-    // if cull mode is CULL_ALL, tell VertexManager to skip triangles and quads.
-    // They still need to go through vertex loading, because we need to calculate a zfreeze
-    // reference slope.
-    const bool cullall = (bpmem.genMode.cullmode == CullMode::All &&
-                          primitive < OpcodeDecoder::Primitive::GX_DRAW_LINES);
-
-    const int stride = loader->m_native_vtx_decl.stride;
-    DataReader dst = g_vertex_manager->PrepareForAdditionalData(primitive, count, stride,
-                                                                cullall || can_cpu_cull);
-
-    count = loader->RunVertices(src, dst.GetPointer(), count);
-
-    if (can_cpu_cull && !cullall)
-    {
-      if (!g_vertex_manager->AreAllVerticesCulled(loader, primitive, dst.GetPointer(), count))
+    const bool reads_arrays = ReadsVertexArrays(g_main_cp_state.vtx_desc);
+    // Decoded vertices can only be reused if they don't read from vertex arrays in memory, and if
+    // they overwrite every entry of the zfreeze position cache.
+    const bool store_decoded = decoded && !reads_arrays && count >= 3;
+    const std::span<const u8> source =
+        reads_arrays ? std::span<const u8>() : std::span(src, static_cast<size_t>(size));
+    AddVertices(loader, vtx_attr_group, primitive, count, false, source, [&](u8* dst) {
+      const int loaded = loader->RunVertices(src, dst, count);
+      if (store_decoded)
       {
-        DataReader new_dst = g_vertex_manager->DisableCullAll(stride);
-        memmove(new_dst.GetPointer(), dst.GetPointer(), count * stride);
+        const u32 stride = loader->m_native_vtx_decl.stride;
+        decoded->count = loaded;
+        decoded->data.assign(dst, dst + loaded * stride);
+        decoded->position_cache = position_cache;
+        decoded->position_matrix_index_cache = position_matrix_index_cache;
+        decoded->tangent_cache = tangent_cache;
+        decoded->binormal_cache = binormal_cache;
       }
-    }
-
-    g_vertex_manager->AddIndices(primitive, count);
-    g_vertex_manager->FlushData(count, loader->m_native_vtx_decl.stride);
-
-    ADDSTAT(g_stats.this_frame.num_prims, count);
-    INCSTAT(g_stats.this_frame.num_primitive_joins);
+      return loaded;
+    });
   }
   return size;
 }
 
 template int RunVertices<false>(int vtx_attr_group, OpcodeDecoder::Primitive primitive, int count,
-                                const u8* src);
+                                const u8* src, DecodedVertices* decoded);
 template int RunVertices<true>(int vtx_attr_group, OpcodeDecoder::Primitive primitive, int count,
-                               const u8* src);
+                               const u8* src, DecodedVertices* decoded);
+
+void RunDecodedVertices(int vtx_attr_group, OpcodeDecoder::Primitive primitive,
+                        const DecodedVertices& decoded)
+{
+  VertexLoaderBase* loader = RefreshLoader(vtx_attr_group);
+  const auto load = [&](u8* dst) {
+    std::memcpy(dst, decoded.data.data(), decoded.data.size());
+    RestoreCaches(g_main_cp_state.vtx_desc, g_main_cp_state.vtx_attr[vtx_attr_group], decoded);
+    loader->m_numLoadedVertices += decoded.count;
+    return static_cast<int>(decoded.count);
+  };
+  AddVertices(loader, vtx_attr_group, primitive, decoded.count, true, decoded.data, load);
+}
 
 NativeVertexFormat* GetCurrentVertexFormat()
 {
@@ -7,6 +7,7 @@
 #include <memory>
 #include <string>
 #include <unordered_map>
+#include <vector>
 
 #include "Common/CommonTypes.h"
 #include "Common/EnumMap.h"
@@ -40,9 +41,31 @@ NativeVertexFormat* GetOrCreateMatchingFormat(const PortableVertexDeclaration& d
 // offsets set to the unused attributes.
 NativeVertexFormat* GetUberVertexFormat(const PortableVertexDeclaration& decl);
 
-// Returns -1 if buf_size is insufficient, else the amount of bytes consumed
+// Vertices decoded by RunVertices, which can be drawn again with RunDecodedVertices instead of
+// decoding the same source data again.
+struct DecodedVertices
+{
+  u32 count = 0;
+  std::vector<u8> data;
+
+  // The zfreeze and emboss caches that decoding the vertices left behind.
+  std::array<std::array<float, 4>, 3> position_cache{};
+  std::array<u32, 3> position_matrix_index_cache{};
+  std::array<float, 4> tangent_cache{};
+  std::array<float, 4> binormal_cache{};
+};
+
+// Returns -1 if buf_size is insufficient, else the amount of bytes consumed.
+// If decoded is not null, and the decoded vertices only depend on the source data (i.e. there are
+// no indexed components), they are also stored there. Otherwise, decoded->count is left at 0.
 template <bool IsPreprocess = false>
-int RunVertices(int vtx_attr_group, OpcodeDecoder::Primitive primitive, int count, const u8* src);
+int RunVertices(int vtx_attr_group, OpcodeDecoder::Primitive primitive, int count, const u8* src,
+                DecodedVertices* decoded = nullptr);
+
+// Draws vertices stored by RunVertices. The vertex format of vtx_attr_group must be the same as
+// when they were decoded.
+void RunDecodedVertices(int vtx_attr_group, OpcodeDecoder::Primitive primitive,
+                        const DecodedVertices& decoded);
 
 namespace detail
 {
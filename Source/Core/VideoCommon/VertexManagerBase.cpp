@@ -108,6 +108,30 @@ static bool IsNormalProjection(const Projection::Raw& projection, const Viewport
          config.widescreen_heuristic_aspect_ratio_slop;
 }
 
+// Sets dirty if any of the written constant registers changed since the last upload.
+template <typename T>
+static void ResolveConstants(const T& constants, ConstantDirtyRanges<T>& dirty_ranges, bool& dirty)
+{
+  if (dirty)
+  {
+    // The whole buffer is uploaded anyway.
+    dirty_ranges.Reset(constants);
+    ADDSTAT(g_stats.this_frame.bytes_uniform_changed, sizeof(T));
+    return;
+  }
+  if (!dirty_ranges.HasWrites())
+    return;
+
+  const u32 changed = dirty_ranges.Resolve(constants);
+  if (changed == 0)
+  {
+    INCSTAT(g_stats.this_frame.num_uniform_uploads_skipped);
+    return;
+  }
+  ADDSTAT(g_stats.this_frame.bytes_uniform_changed, changed);
+  dirty = true;
+}
+
 VertexManagerBase::VertexManagerBase()
     : m_cpu_vertex_buffer(MAXVBUFFERSIZE), m_cpu_index_buffer(MAXIBUFFERSIZE)
 {
@@ -193,6 +217,7 @@ DataReader VertexManagerBase::PrepareForAdditionalData(OpcodeDecoder::Primitive
     {
       ResetBuffer(stride);
     }
+    m_draw_buffer_reuse.BeginBatch();
 
     remaining_index_generator_indices = m_index_generator.GetRemainingIndices(primitive);
     remaining_indices = GetRemainingIndices(primitive);
@@ -225,6 +250,7 @@ DataReader VertexManagerBase::DisableCullAll(u32 stride)
   {
     m_cull_all = false;
     ResetBuffer(stride);
+    m_draw_buffer_reuse.BeginBatch();
   }
   return DataReader(m_cur_buffer_pointer, m_end_buffer_pointer);
 }
@@ -234,6 +260,17 @@ void VertexManagerBase::FlushData(u32 count, u32 stride)
   m_cur_buffer_pointer += count * stride;
 }
 
+void VertexManagerBase::IdentifyVertices(std::span<const u8> state, std::span<const u8> source)
+{
+  if (m_can_reuse_committed_buffers)
+    m_draw_buffer_reuse.AddVertices(state, source);
+}
+
+void VertexManagerBase::IdentifyUnknownVertices()
+{
+  m_draw_buffer_reuse.AddUnknownVertices();
+}
+
 u32 VertexManagerBase::GetRemainingIndices(OpcodeDecoder::Primitive primitive) const
 {
   const u32 index_len = MAXIBUFFERSIZE - m_index_generator.GetIndexLen();
@@ -344,6 +381,11 @@ void VertexManagerBase::CommitBuffer(u32 num_vertices, u32 vertex_stride, u32 nu
   *out_base_index = 0;
 }
 
+bool VertexManagerBase::ReuseCommittedBuffer(u32 vertex_stride)
+{
+  return false;
+}
+
 void VertexManagerBase::DrawCurrentBatch(u32 base_index, u32 num_indices, u32 base_vertex)
 {
   // If bounding box is enabled, we need to flush any changes first, then invalidate what we have.
@@ -358,6 +400,21 @@ void VertexManagerBase::DrawCurrentBatch(u32 base_index, u32 num_indices, u32 ba
 
 void VertexManagerBase::UploadUniforms()
 {
+  // Backends without uniform buffers still count what they would upload, so that the statistics
+  // can be compared between backends.
+  auto& system = Core::System::GetInstance();
+  auto& vertex_shader_manager = system.GetVertexShaderManager();
+  auto& geometry_shader_manager = system.GetGeometryShaderManager();
+  auto& pixel_shader_manager = system.GetPixelShaderManager();
+  if (vertex_shader_manager.dirty)
+    ADDSTAT(g_stats.this_frame.bytes_uniform_streamed, sizeof(VertexShaderConstants));
+  if (geometry_shader_manager.dirty)
+    ADDSTAT(g_stats.this_frame.bytes_uniform_streamed, sizeof(GeometryShaderConstants));
+  if (pixel_shader_manager.dirty)
+    ADDSTAT(g_stats.this_frame.bytes_uniform_streamed, sizeof(PixelShaderConstants));
+  vertex_shader_manager.dirty = false;
+  geometry_shader_manager.dirty = false;
+  pixel_shader_manager.dirty = false;
 }
 
 void VertexManagerBase::InvalidateConstants()
@@ -382,6 +439,9 @@ void VertexManagerBase::UploadUtilityVertices(const void* vertices, u32 vertex_s
   // The GX vertex list should be flushed before any utility draws occur.
   ASSERT(m_is_flushed);
 
+  // The backend only tracks the last commit, which won't be the last GX batch anymore.
+  m_draw_buffer_reuse.Invalidate();
+
   // Copy into the buffers usually used for GX drawing.
   ResetBuffer(std::max(vertex_stride, 1u));
   if (vertices)
@@ -550,6 +610,7 @@ void VertexManagerBase::Flush()
     const double seconds_elapsed =
         static_cast<double>(m_ticks_elapsed) / system.GetSystemTimers().GetTicksPerSecond();
     pixel_shader_manager.constants.time_ms = seconds_elapsed * 1000;
+    pixel_shader_manager.MarkDirty(pixel_shader_manager.constants.time_ms);
   }
 
   CalculateBinormals(VertexLoaderManager::GetCurrentVertexFormat());
@@ -916,6 +977,7 @@ void VertexManagerBase::OnConfigChange()
 {
   // Reload index generator function tables in case VS expand config changed
   m_index_generator.Init();
+  m_draw_buffer_reuse.Invalidate();
 }
 
 void VertexManagerBase::OnDraw()
@@ -1068,14 +1130,19 @@ void VertexManagerBase::RenderDrawCall(
     pixel_shader_manager.custom_constants_dirty = true;
   }
   pixel_shader_manager.custom_constants = custom_pixel_shader_uniforms;
+  ResolveConstants(pixel_shader_manager.constants, pixel_shader_manager.dirty_ranges,
+                   pixel_shader_manager.dirty);
+  auto& vertex_shader_manager = Core::System::GetInstance().GetVertexShaderManager();
+  ResolveConstants(vertex_shader_manager.constants, vertex_shader_manager.dirty_ranges,
+                   vertex_shader_manager.dirty);
   UploadUniforms();
 
   g_gfx->SetPipeline(current_pipeline);
 
   u32 base_vertex, base_index;
-  CommitBuffer(m_index_generator.GetNumVerts(),
-               VertexLoaderManager::GetCurrentVertexFormat()->GetVertexStride(),
-               m_index_generator.GetIndexLen(), &base_vertex, &base_index);
+  CommitOrReuseBuffer(m_index_generator.GetNumVerts(),
+                      VertexLoaderManager::GetCurrentVertexFormat()->GetVertexStride(),
+                      m_index_generator.GetIndexLen(), &base_vertex, &base_index);
 
   if (g_ActiveConfig.backend_info.api_type != APIType::D3D &&
       g_ActiveConfig.UseVSForLinePointExpand() &&
@@ -1156,3 +1223,23 @@ const AbstractPipeline* VertexManagerBase::GetCustomPipeline(
 
   return nullptr;
 }
+
+void VertexManagerBase::CommitOrReuseBuffer(u32 num_vertices, u32 vertex_stride, u32 num_indices,
+                                            u32* out_base_vertex, u32* out_base_index)
+{
+  // Games commonly draw the same vertices several times in a row with different state, e.g. for
+  // multi-pass effects. In that case the previous upload can be drawn again.
+  const DrawBufferReuse::CommittedBatch* const batch =
+      m_draw_buffer_reuse.FindReusableBatch(num_vertices, vertex_stride, num_indices);
+  if (batch && ReuseCommittedBuffer(vertex_stride))
+  {
+    *out_base_vertex = batch->base_vertex;
+    *out_base_index = batch->base_index;
+    INCSTAT(g_stats.this_frame.num_reused_draw_buffers);
+    return;
+  }
+
+  CommitBuffer(num_vertices, vertex_stride, num_indices, out_base_vertex, out_base_index);
+  m_draw_buffer_reuse.SetCommitted(num_vertices, vertex_stride, num_indices, *out_base_vertex,
+                                   *out_base_index);
+}
@@ -4,12 +4,15 @@
 #pragma once
 
 #include <memory>
+#include <optional>
+#include <span>
 #include <vector>
 
 #include "Common/BitSet.h"
 #include "Common/CommonTypes.h"
 #include "Common/MathUtil.h"
 #include "VideoCommon/CPUCull.h"
+#include "VideoCommon/DrawBufferReuse.h"
 #include "VideoCommon/IndexGenerator.h"
 #include "VideoCommon/RenderState.h"
 #include "VideoCommon/ShaderCache.h"
@@ -115,6 +118,10 @@ public:
   /// Returns whether cullall was changed (false if cullall was already off)
   DataReader DisableCullAll(u32 stride);
   void FlushData(u32 count, u32 stride);
+  // Identifies the vertices which were just added to the batch, by what they were decoded from.
+  // If the next batch is the same, it's drawn from the buffers of this one.
+  void IdentifyVertices(std::span<const u8> state, std::span<const u8> source);
+  void IdentifyUnknownVertices();
 
   void Flush();
   bool HasSendableVertices() const { return !m_is_flushed && !m_cull_all; }
@@ -180,6 +187,13 @@ protected:
   virtual void CommitBuffer(u32 num_vertices, u32 vertex_stride, u32 num_indices,
                             u32* out_base_vertex, u32* out_base_index);
 
+  // Binds the buffers of the last CommitBuffer() call again instead of committing the current
+  // batch, which contains the same data. Returns false if the backend can't guarantee that data is
+  // still intact when the draw executes, in which case the batch is committed as usual. Backends
+  // which implement this have to set m_can_reuse_committed_buffers, so that the others don't pay
+  // for identifying batches.
+  virtual bool ReuseCommittedBuffer(u32 vertex_stride);
+
   // Uploads uniform buffers for GX draws.
   virtual void UploadUniforms();
 
@@ -216,6 +230,7 @@ protected:
 
   IndexGenerator m_index_generator;
   CPUCull m_cpu_cull;
+  bool m_can_reuse_committed_buffers = false;
 
 private:
   // Minimum number of draws per command buffer when attempting to preempt a readback operation.
@@ -228,6 +243,8 @@ private:
                       const AbstractPipeline* current_pipeline);
   void UpdatePipelineConfig();
   void UpdatePipelineObject();
+  void CommitOrReuseBuffer(u32 num_vertices, u32 vertex_stride, u32 num_indices,
+                           u32* out_base_vertex, u32* out_base_index);
 
   const AbstractPipeline*
   GetCustomPipeline(const CustomPixelShaderContents& custom_pixel_shader_contents,
@@ -238,6 +255,8 @@ private:
   bool m_is_flushed = true;
   FlushStatistics m_flush_statistics = {};
 
+  DrawBufferReuse m_draw_buffer_reuse;
+
   // CPU access tracking
   u32 m_draw_counter = 0;
   u32 m_last_efb_copy_draw_counter = 0;
@@ -170,7 +170,8 @@ void VertexShaderManager::SetConstants(const std::vector<std::string>& textures,
     constants.missing_color_hex = g_ActiveConfig.iMissingColorValue;
     constants.missing_color_value = {r / 255, g / 255, b / 255, a / 255};
 
-    dirty = true;
+    MarkDirty(constants.missing_color_hex);
+    MarkDirty(constants.missing_color_value);
   }
 
   const auto per_vertex_transform_matrix_changes =
@@ -181,7 +182,7 @@ void VertexShaderManager::SetConstants(const std::vector<std::string>& textures,
     int endn = (per_vertex_transform_matrix_changes[1] + 3) / 4;
     memcpy(constants.transformmatrices[startn].data(), &xfmem.posMatrices[startn * 4],
            (endn - startn) * sizeof(float4));
-    dirty = true;
+    MarkDirty(&constants.transformmatrices[startn], (endn - startn) * sizeof(float4));
     xf_state_manager.ResetPerVertexTransformMatrixChanges();
   }
 
@@ -195,7 +196,7 @@ void VertexShaderManager::SetConstants(const std::vector<std::string>& textures,
     {
       memcpy(constants.normalmatrices[i].data(), &xfmem.normalMatrices[3 * i], 12);
     }
-    dirty = true;
+    MarkDirty(&constants.normalmatrices[startn], (endn - startn) * sizeof(float4));
     xf_state_manager.ResetPerVertexNormalMatrixChanges();
   }
 
@@ -206,7 +207,7 @@ void VertexShaderManager::SetConstants(const std::vector<std::string>& textures,
     int endn = (post_transform_matrices_changed[1] + 3) / 4;
     memcpy(constants.posttransformmatrices[startn].data(), &xfmem.postMatrices[startn * 4],
            (endn - startn) * sizeof(float4));
-    dirty = true;
+    MarkDirty(&constants.posttransformmatrices[startn], (endn - startn) * sizeof(float4));
     xf_state_manager.ResetPostTransformMatrixChanges();
   }
 
@@ -267,7 +268,7 @@ void VertexShaderManager::SetConstants(const std::vector<std::string>& textures,
       dstlight.dir[1] = sanitize(static_cast<float>(light.ddir[1] * norm));
       dstlight.dir[2] = sanitize(static_cast<float>(light.ddir[2] * norm));
     }
-    dirty = true;
+    MarkDirty(&constants.lights[istart], (iend - istart) * sizeof(VertexShaderConstants::Light));
 
     xf_state_manager.ResetLightsChanged();
   }
@@ -279,7 +280,7 @@ void VertexShaderManager::SetConstants(const std::vector<std::string>& textures,
     constants.materials[i][1] = (data >> 16) & 0xFF;
     constants.materials[i][2] = (data >> 8) & 0xFF;
     constants.materials[i][3] = data & 0xFF;
-    dirty = true;
+    MarkDirty(constants.materials[i]);
   }
   xf_state_manager.ResetMaterialChanges();
 
@@ -294,7 +295,7 @@ void VertexShaderManager::SetConstants(const std::vector<std::string>& textures,
     memcpy(constants.posnormalmatrix[3].data(), norm, 3 * sizeof(float));
     memcpy(constants.posnormalmatrix[4].data(), norm + 3, 3 * sizeof(float));
     memcpy(constants.posnormalmatrix[5].data(), norm + 6, 3 * sizeof(float));
-    dirty = true;
+    MarkDirty(constants.posnormalmatrix);
   }
 
   if (xf_state_manager.DidTexMatrixAChange())
@@ -311,7 +312,7 @@ void VertexShaderManager::SetConstants(const std::vector<std::string>& textures,
     {
       memcpy(constants.texmatrices[3 * i].data(), pos_matrix_ptrs[i], 3 * sizeof(float4));
     }
-    dirty = true;
+    MarkDirty(&constants.texmatrices[0], 12 * sizeof(float4));
   }
 
   if (xf_state_manager.DidTexMatrixBChange())
@@ -328,7 +329,7 @@ void VertexShaderManager::SetConstants(const std::vector<std::string>& textures,
     {
       memcpy(constants.texmatrices[3 * i + 12].data(), pos_matrix_ptrs[i], 3 * sizeof(float4));
     }
-    dirty = true;
+    MarkDirty(&constants.texmatrices[12], 12 * sizeof(float4));
   }
 
   if (xf_state_manager.DidViewportChange())
@@ -384,7 +385,8 @@ void VertexShaderManager::SetConstants(const std::vector<std::string>& textures,
       }
     }
 
-    dirty = true;
+    MarkDirty(constants.pixelcentercorrection);
+    MarkDirty(constants.viewport);
     BPFunctions::SetScissorAndViewport();
     g_stats.AddScissorRect();
   }
@@ -422,7 +424,7 @@ void VertexShaderManager::SetConstants(const std::vector<std::string>& textures,
     }
 
     memcpy(constants.projection.data(), corrected_matrix.data.data(), 4 * sizeof(float4));
-    dirty = true;
+    MarkDirty(constants.projection);
   }
 
   if (xf_state_manager.DidTexMatrixInfoChange())
@@ -434,7 +436,8 @@ void VertexShaderManager::SetConstants(const std::vector<std::string>& textures,
     for (size_t i = 0; i < std::size(xfmem.postMtxInfo); i++)
       constants.xfmem_pack1[i][1] = xfmem.postMtxInfo[i].hex;
 
-    dirty = true;
+    MarkDirty(constants.xfmem_dualTexInfo);
+    MarkDirty(constants.xfmem_pack1);
   }
 
   if (xf_state_manager.DidLightingConfigChange())
@@ -447,7 +450,8 @@ void VertexShaderManager::SetConstants(const std::vector<std::string>& textures,
       constants.xfmem_pack1[i][3] = xfmem.alpha[i].hex;
     }
     constants.xfmem_numColorChans = xfmem.numChan.numColorChans;
-    dirty = true;
+    MarkDirty(&constants.xfmem_pack1[0], 2 * sizeof(uint4));
+    MarkDirty(constants.xfmem_numColorChans);
   }
 }
 
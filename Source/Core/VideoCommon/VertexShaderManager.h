@@ -10,6 +10,7 @@
 #include "Common/BitSet.h"
 #include "Common/CommonTypes.h"
 #include "Common/Matrix.h"
+#include "VideoCommon/ConstantDirtyRanges.h"
 #include "VideoCommon/ConstantManager.h"
 #include "VideoCommon/NativeVertexFormat.h"
 
@@ -37,7 +38,17 @@ public:
   static bool UseVertexDepthRange();
 
   VertexShaderConstants constants{};
+  // Forces the constants to be uploaded. Writes that may not change anything should be marked in
+  // dirty_ranges instead, VertexManagerBase sets this before drawing if they changed something.
   bool dirty = false;
+  ConstantDirtyRanges<VertexShaderConstants> dirty_ranges;
+
+  template <typename T>
+  void MarkDirty(const T& field)
+  {
+    dirty_ranges.Mark(constants, &field, sizeof(field));
+  }
+  void MarkDirty(const void* field, size_t size) { dirty_ranges.Mark(constants, field, size); }
 
   static DOLPHIN_FORCE_INLINE void UpdateValue(bool* dirty, u32* old_value, u32 new_value)
   {
@@ -46,6 +46,7 @@
 #include "VideoCommon/BoundingBox.h"
 #include "VideoCommon/CPMemory.h"
 #include "VideoCommon/CommandProcessor.h"
+#include "VideoCommon/DisplayListCache.h"
 #include "VideoCommon/Fifo.h"
 #include "VideoCommon/FrameDumper.h"
 #include "VideoCommon/FramebufferManager.h"
@@ -365,6 +366,7 @@ bool VideoBackendBase::InitializeShared(std::unique_ptr<AbstractGfx> gfx,
   g_shader_cache = std::make_unique<VideoCommon::ShaderCache>();
   g_graphics_mod_manager = std::make_unique<GraphicsModManager>();
   g_widescreen = std::make_unique<WidescreenManager>();
+  g_display_list_cache = std::make_unique<DisplayListCache>();
 
   if (!g_vertex_manager->Initialize() || !g_shader_cache->Initialize() ||
       !g_perf_query->Initialize() || !g_presenter->Initialize() ||
@@ -417,6 +419,7 @@ void VideoBackendBase::ShutdownShared()
   g_vertex_manager.reset();
   g_renderer.reset();
   g_widescreen.reset();
+  g_display_list_cache.reset();
   g_presenter.reset();
   g_gfx.reset();
 
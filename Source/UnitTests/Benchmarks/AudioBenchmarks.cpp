@@ -0,0 +1,120 @@
+// Copyright 2024 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <array>
+#include <cstring>
+#include <random>
+#include <vector>
+
+#include "AudioCommon/Mixer.h"
+#include "Common/CommonTypes.h"
+#include "Core/DSP/DSPAccelerator.h"
+#include "Core/HW/StreamADPCM.h"
+
+#include "Benchmark.h"
+
+static std::vector<u8> GetRandomBytes(size_t size)
+{
+  // Fixed seed, so that every run decodes the same data.
+  std::mt19937 generator(1234);
+  std::uniform_int_distribution<int> distribution(0, 255);
+  std::vector<u8> data(size);
+  for (u8& byte : data)
+    byte = static_cast<u8>(distribution(generator));
+  return data;
+}
+
+// Streaming audio (DTK), decoded on the CPU thread. Arg: number of 32 byte blocks.
+static void BM_StreamADPCMDecode(Benchmark::State& state)
+{
+  const size_t blocks = static_cast<size_t>(state.range(0));
+  const std::vector<u8> adpcm = GetRandomBytes(blocks * StreamADPCM::ONE_BLOCK_SIZE);
+  std::vector<s16> pcm(StreamADPCM::SAMPLES_PER_BLOCK * 2);
+  StreamADPCM::ADPCMDecoder decoder;
+  for (auto _ : state)
+  {
+    for (size_t i = 0; i < blocks; ++i)
+      decoder.DecodeBlock(pcm.data(), &adpcm[i * StreamADPCM::ONE_BLOCK_SIZE]);
+    Benchmark::DoNotOptimize(pcm.data());
+    Benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * blocks * StreamADPCM::SAMPLES_PER_BLOCK);
+}
+BENCHMARK(BM_StreamADPCMDecode)->Arg(1)->Arg(1024);
+
+namespace
+{
+class BenchmarkAccelerator final : public DSP::Accelerator
+{
+public:
+  explicit BenchmarkAccelerator(std::vector<u8> aram) : m_aram(std::move(aram)) {}
+
+protected:
+  void OnEndException() override {}
+  u8 ReadMemory(u32 address) override { return m_aram[address % m_aram.size()]; }
+  void WriteMemory(u32 address, u8 value) override {}
+
+private:
+  std::vector<u8> m_aram;
+};
+}  // namespace
+
+// The ADPCM decoding of the DSP accelerator, used by the HLE AX ucode for every voice. Arg: number
+// of 8 byte frames (of 14 samples each).
+static void BM_DSPAcceleratorADPCM(Benchmark::State& state)
+{
+  const u32 frames = static_cast<u32>(state.range(0));
+  BenchmarkAccelerator accelerator(GetRandomBytes(frames * 8));
+
+  std::array<s16, 16> coefs;
+  std::mt19937 generator(5678);
+  std::uniform_int_distribution<int> distribution(-0x1000, 0x1000);
+  for (s16& coef : coefs)
+    coef = static_cast<s16>(distribution(generator));
+
+  // Addresses are in nibbles. Don't let the sample reach the end address, as reads stop there.
+  const u32 start_address = 2;
+  accelerator.SetSampleFormat(0x00);
+  accelerator.SetStartAddress(0);
+  accelerator.SetEndAddress(frames * 16 + 0x107);
+
+  const u32 samples = frames * 14;
+  for (auto _ : state)
+  {
+    accelerator.SetCurrentAddress(start_address);
+    accelerator.SetPredScale(0);
+    accelerator.SetYn1(0);
+    accelerator.SetYn2(0);
+    u32 sum = 0;
+    for (u32 i = 0; i < samples; ++i)
+      sum += accelerator.Read(coefs.data());
+    Benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(state.iterations() * samples);
+}
+BENCHMARK(BM_DSPAcceleratorADPCM)->Arg(16)->Arg(1024);
+
+// Resamples and mixes 5 ms of DMA (32 kHz) and streaming (48 kHz) audio per iteration, like the
+// audio backends do from their own thread.
+static void BM_MixerMix(Benchmark::State& state)
+{
+  constexpr u32 OUTPUT_SAMPLE_RATE = 48000;
+  constexpr u32 DMA_SAMPLES = 32000 / 200;
+  constexpr u32 STREAMING_SAMPLES = 48000 / 200;
+  constexpr u32 OUTPUT_SAMPLES = OUTPUT_SAMPLE_RATE / 200;
+
+  const std::vector<u8> random = GetRandomBytes(STREAMING_SAMPLES * 2 * sizeof(s16));
+  std::vector<s16> input(STREAMING_SAMPLES * 2);
+  std::memcpy(input.data(), random.data(), random.size());
+  std::vector<s16> output(OUTPUT_SAMPLES * 2);
+
+  Mixer mixer(OUTPUT_SAMPLE_RATE);
+  for (auto _ : state)
+  {
+    mixer.PushSamples(input.data(), DMA_SAMPLES);
+    mixer.PushStreamingSamples(input.data(), STREAMING_SAMPLES);
+    Benchmark::DoNotOptimize(mixer.Mix(output.data(), OUTPUT_SAMPLES));
+  }
+  state.SetItemsProcessed(state.iterations() * OUTPUT_SAMPLES);
+}
+BENCHMARK(BM_MixerMix);
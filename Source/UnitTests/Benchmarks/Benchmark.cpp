@@ -0,0 +1,468 @@
+// Copyright 2024 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "Benchmark.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <optional>
+#include <regex>
+#include <string_view>
+#include <utility>
+
+#include <fmt/chrono.h>
+#include <fmt/format.h>
+#include <picojson.h>
+
+#include "Common/CPUDetect.h"
+#include "Common/FileUtil.h"
+#include "Common/StringUtil.h"
+#include "Common/Thread.h"
+#include "Common/Version.h"
+
+namespace Benchmark
+{
+State::State(u64 max_iterations, std::vector<s64> ranges)
+    : m_max_iterations(max_iterations), m_ranges(std::move(ranges))
+{
+}
+
+void State::StartRunning()
+{
+  m_started = true;
+  m_start_cpu_time = Common::GetCurrentThreadCPUTime();
+  m_start_time = Clock::now();
+}
+
+void State::FinishRunning()
+{
+  if (!m_paused)
+    PauseTiming();
+  m_finished = true;
+}
+
+void State::PauseTiming()
+{
+  m_real_time += Clock::now() - m_start_time;
+  m_cpu_time += Common::GetCurrentThreadCPUTime() - m_start_cpu_time;
+  m_paused = true;
+}
+
+void State::ResumeTiming()
+{
+  m_paused = false;
+  m_start_cpu_time = Common::GetCurrentThreadCPUTime();
+  m_start_time = Clock::now();
+}
+
+Definition::Definition(std::string name, Function function)
+    : m_name(std::move(name)), m_function(std::move(function))
+{
+}
+
+Definition* Definition::Arg(s64 arg)
+{
+  m_args.push_back({arg});
+  return this;
+}
+
+Definition* Definition::Args(std::vector<s64> args)
+{
+  m_args.push_back(std::move(args));
+  return this;
+}
+
+Definition* Definition::ArgList(const std::vector<s64>& args)
+{
+  for (const s64 arg : args)
+    Arg(arg);
+  return this;
+}
+
+static std::vector<std::unique_ptr<Definition>>& GetRegistry()
+{
+  // Function-local, since benchmarks are registered during static initialization.
+  static std::vector<std::unique_ptr<Definition>> registry;
+  return registry;
+}
+
+Definition* Register(std::string name, Function function)
+{
+  auto& registry = GetRegistry();
+  registry.push_back(std::make_unique<Definition>(std::move(name), std::move(function)));
+  return registry.back().get();
+}
+
+const std::vector<std::unique_ptr<Definition>>& GetRegisteredBenchmarks()
+{
+  return GetRegistry();
+}
+
+void detail::UseCharPointer(const volatile char*)
+{
+}
+
+namespace
+{
+struct Options
+{
+  std::optional<std::regex> filter;
+  double min_time = 0.5;
+  int repetitions = 3;
+  bool json_to_stdout = false;
+  std::string out_path;
+  bool list_only = false;
+};
+
+struct Run
+{
+  std::string name;
+  std::vector<s64> args;
+  const Definition* definition;
+};
+
+struct Result
+{
+  std::string name;
+  u64 iterations = 0;
+  // Per iteration, over all repetitions.
+  std::vector<double> real_times_ns;
+  std::vector<double> cpu_times_ns;
+  double items_per_iteration = 0;
+  double bytes_per_iteration = 0;
+  std::string label;
+  std::string error;
+};
+
+constexpr u64 MAX_ITERATIONS = 1000000000;
+
+void PrintUsage()
+{
+  std::fputs("usage: DolphinBenchmarks [options]\n"
+             "  --benchmark_filter=<regex>     Only run the benchmarks whose name matches\n"
+             "  --benchmark_min_time=<seconds> Minimum time of each repetition (default 0.5)\n"
+             "  --benchmark_repetitions=<n>    Repetitions of each benchmark (default 3)\n"
+             "  --benchmark_format=<console|json>\n"
+             "                                 Format of the results printed to stdout\n"
+             "  --benchmark_out=<file>         Also write the results to a file, as JSON\n"
+             "  --benchmark_list_tests         Only list the benchmarks\n",
+             stderr);
+}
+
+std::optional<Options> ParseOptions(int argc, char** argv)
+{
+  Options options;
+  for (int i = 1; i < argc; ++i)
+  {
+    const std::string_view arg = argv[i];
+    const size_t equals = arg.find('=');
+    const std::string_view key = arg.substr(0, equals);
+    const std::string value(equals == std::string_view::npos ? "" : arg.substr(equals + 1));
+
+    if (key == "--benchmark_filter")
+    {
+      try
+      {
+        options.filter = std::regex(value);
+      }
+      catch (const std::regex_error&)
+      {
+        fmt::print(stderr, "Invalid filter: {}\n", value);
+        return std::nullopt;
+      }
+    }
+    else if (key == "--benchmark_min_time")
+    {
+      if (!TryParse(value, &options.min_time) || options.min_time <= 0)
+        return std::nullopt;
+    }
+    else if (key == "--benchmark_repetitions")
+    {
+      if (!TryParse(value, &options.repetitions) || options.repetitions <= 0)
+        return std::nullopt;
+    }
+    else if (key == "--benchmark_format")
+    {
+      if (value != "console" && value != "json")
+        return std::nullopt;
+      options.json_to_stdout = value == "json";
+    }
+    else if (key == "--benchmark_out")
+    {
+      options.out_path = value;
+    }
+    else if (key == "--benchmark_list_tests")
+    {
+      options.list_only = true;
+    }
+    else
+    {
+      return std::nullopt;
+    }
+  }
+  return options;
+}
+
+std::vector<Run> GetRuns(const Options& options)
+{
+  std::vector<Run> runs;
+  for (const auto& definition : GetRegisteredBenchmarks())
+  {
+    const auto add_run = [&](std::vector<s64> args) {
+      std::string name = definition->GetName();
+      for (const s64 arg : args)
+        name += fmt::format("/{}", arg);
+      if (options.filter && !std::regex_search(name, *options.filter))
+        return;
+      runs.push_back({std::move(name), std::move(args), definition.get()});
+    };
+
+    if (definition->GetArgs().empty())
+      add_run({});
+    for (const std::vector<s64>& args : definition->GetArgs())
+      add_run(args);
+  }
+  return runs;
+}
+
+Result RunBenchmark(const Run& run, const Options& options)
+{
+  Result result;
+  result.name = run.name;
+
+  // Increase the number of iterations until a run takes long enough to be measured precisely.
+  u64 iterations = 1;
+  while (true)
+  {
+    State state(iterations, run.args);
+    run.definition->GetFunction()(state);
+    if (!state.GetError().empty() || !state.HasRun())
+    {
+      result.error =
+          state.GetError().empty() ? "The benchmark loop was not run" : state.GetError();
+      return result;
+    }
+
+    const double seconds = std::chrono::duration<double>(state.GetRealTime()).count();
+    if (seconds >= options.min_time || iterations >= MAX_ITERATIONS)
+      break;
+
+    // Aim a bit higher than the minimum time, so that the next run is likely the last one.
+    const double multiplier =
+        seconds / options.min_time > 0.1 ? options.min_time * 1.4 / seconds : 10.0;
+    iterations = std::clamp<u64>(static_cast<u64>(std::ceil(iterations * multiplier)),
+                                 iterations + 1, MAX_ITERATIONS);
+  }
+
+  result.iterations = iterations;
+  for (int i = 0; i < options.repetitions; ++i)
+  {
+    State state(iterations, run.args);
+    run.definition->GetFunction()(state);
+
+    const double real_seconds = std::chrono::duration<double>(state.GetRealTime()).count();
+    result.real_times_ns.push_back(real_seconds * 1e9 / iterations);
+    result.cpu_times_ns.push_back(std::chrono::duration<double>(state.GetCPUTime()).count() *
+                                  1e9 / iterations);
+    result.items_per_iteration = static_cast<double>(state.GetItemsProcessed()) / iterations;
+    result.bytes_per_iteration = static_cast<double>(state.GetBytesProcessed()) / iterations;
+    result.label = state.GetLabel();
+  }
+  return result;
+}
+
+double Median(std::vector<double> values)
+{
+  std::sort(values.begin(), values.end());
+  const size_t middle = values.size() / 2;
+  return values.size() % 2 != 0 ? values[middle] : (values[middle - 1] + values[middle]) / 2;
+}
+
+// Based on the median time, like the other statistics that are reported.
+double PerSecond(const Result& result, double per_iteration)
+{
+  const double time_ns = Median(result.real_times_ns);
+  return time_ns > 0 ? per_iteration * 1e9 / time_ns : 0;
+}
+
+double StandardDeviation(const std::vector<double>& values)
+{
+  if (values.size() < 2)
+    return 0;
+
+  double mean = 0;
+  for (const double value : values)
+    mean += value;
+  mean /= values.size();
+
+  double variance = 0;
+  for (const double value : values)
+    variance += (value - mean) * (value - mean);
+  return std::sqrt(variance / (values.size() - 1));
+}
+
+std::string FormatRate(double per_second, std::string_view unit)
+{
+  static constexpr std::array<const char*, 5> prefixes = {"", "k", "M", "G", "T"};
+  size_t prefix = 0;
+  const double base = unit == "B" ? 1024.0 : 1000.0;
+  while (per_second >= base && prefix + 1 < prefixes.size())
+  {
+    per_second /= base;
+    ++prefix;
+  }
+  return fmt::format("{:.2f}{}{}{}/s", per_second, prefixes[prefix],
+                     unit == "B" && prefix != 0 ? "i" : "", unit);
+}
+
+void PrintConsoleHeader(size_t name_width)
+{
+  const std::string header = fmt::format("{:<{}} {:>14} {:>14} {:>12}", "Benchmark", name_width,
+                                         "Time", "CPU", "Iterations");
+  fmt::print("{}\n{}\n", header, std::string(header.size(), '-'));
+}
+
+void PrintConsoleResult(const Result& result, size_t name_width)
+{
+  if (!result.error.empty())
+  {
+    fmt::print("{:<{}} ERROR: {}\n", result.name, name_width, result.error);
+    return;
+  }
+
+  std::string line = fmt::format("{:<{}} {:>11.1f} ns {:>11.1f} ns {:>12}", result.name,
+                                 name_width, Median(result.real_times_ns),
+                                 Median(result.cpu_times_ns), result.iterations);
+  if (result.bytes_per_iteration > 0)
+    line += ' ' + FormatRate(PerSecond(result, result.bytes_per_iteration), "B");
+  if (result.items_per_iteration > 0)
+    line += ' ' + FormatRate(PerSecond(result, result.items_per_iteration), "items");
+  if (!result.label.empty())
+    line += ' ' + result.label;
+  fmt::print("{}\n", line);
+}
+
+picojson::value GetContext()
+{
+  picojson::object context;
+
+  const std::time_t now = std::time(nullptr);
+  std::tm local_time{};
+#ifdef _WIN32
+  localtime_s(&local_time, &now);
+#else
+  localtime_r(&now, &local_time);
+#endif
+  context["date"] = picojson::value(fmt::format("{:%Y-%m-%dT%H:%M:%S}", local_time));
+  context["version"] = picojson::value(Common::GetScmDescStr());
+  context["revision"] = picojson::value(Common::GetScmRevStr());
+  context["cpu"] = picojson::value(cpu_info.model_name);
+  context["num_cpus"] = picojson::value(static_cast<double>(cpu_info.num_cores));
+#ifdef _DEBUG
+  context["build_type"] = picojson::value("debug");
+#else
+  context["build_type"] = picojson::value("release");
+#endif
+  return picojson::value(std::move(context));
+}
+
+std::string GetJSON(const std::vector<Result>& results, const Options& options)
+{
+  picojson::array benchmarks;
+  for (const Result& result : results)
+  {
+    picojson::object benchmark;
+    benchmark["name"] = picojson::value(result.name);
+    if (!result.error.empty())
+    {
+      benchmark["error_occurred"] = picojson::value(true);
+      benchmark["error_message"] = picojson::value(result.error);
+      benchmarks.emplace_back(std::move(benchmark));
+      continue;
+    }
+
+    benchmark["iterations"] = picojson::value(static_cast<double>(result.iterations));
+    benchmark["repetitions"] = picojson::value(static_cast<double>(result.real_times_ns.size()));
+    benchmark["real_time"] = picojson::value(Median(result.real_times_ns));
+    benchmark["real_time_min"] = picojson::value(
+        *std::min_element(result.real_times_ns.begin(), result.real_times_ns.end()));
+    benchmark["real_time_stddev"] = picojson::value(StandardDeviation(result.real_times_ns));
+    benchmark["cpu_time"] = picojson::value(Median(result.cpu_times_ns));
+    benchmark["time_unit"] = picojson::value("ns");
+    if (result.bytes_per_iteration > 0)
+    {
+      benchmark["bytes_per_second"] =
+          picojson::value(PerSecond(result, result.bytes_per_iteration));
+    }
+    if (result.items_per_iteration > 0)
+    {
+      benchmark["items_per_second"] =
+          picojson::value(PerSecond(result, result.items_per_iteration));
+    }
+    if (!result.label.empty())
+      benchmark["label"] = picojson::value(result.label);
+    benchmarks.emplace_back(std::move(benchmark));
+  }
+
+  picojson::object root;
+  root["context"] = GetContext();
+  root["min_time"] = picojson::value(options.min_time);
+  root["benchmarks"] = picojson::value(std::move(benchmarks));
+  return picojson::value(std::move(root)).serialize(true);
+}
+}  // namespace
+
+int RunBenchmarks(int argc, char** argv)
+{
+  const std::optional<Options> options = ParseOptions(argc, argv);
+  if (!options)
+  {
+    PrintUsage();
+    return EXIT_FAILURE;
+  }
+
+  const std::vector<Run> runs = GetRuns(*options);
+  if (options->list_only)
+  {
+    for (const Run& run : runs)
+      fmt::print("{}\n", run.name);
+    return EXIT_SUCCESS;
+  }
+
+  size_t name_width = 10;
+  for (const Run& run : runs)
+    name_width = std::max(name_width, run.name.size());
+
+  if (!options->json_to_stdout)
+    PrintConsoleHeader(name_width);
+
+  std::vector<Result> results;
+  bool any_error = false;
+  for (const Run& run : runs)
+  {
+    results.push_back(RunBenchmark(run, *options));
+    any_error |= !results.back().error.empty();
+    if (!options->json_to_stdout)
+    {
+      PrintConsoleResult(results.back(), name_width);
+      std::fflush(stdout);
+    }
+  }
+
+  const std::string json = GetJSON(results, *options) + '\n';
+  if (options->json_to_stdout)
+    fmt::print("{}", json);
+
+  if (!options->out_path.empty() && !File::WriteStringToFile(options->out_path, json))
+  {
+    fmt::print(stderr, "Failed to write the results to {}\n", options->out_path);
+    return EXIT_FAILURE;
+  }
+
+  return any_error ? EXIT_FAILURE : EXIT_SUCCESS;
+}
+}  // namespace Benchmark
@@ -0,0 +1,177 @@
+// Copyright 2024 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+// A small microbenchmark framework, modelled after Google Benchmark:
+//
+//   static void BM_Something(Benchmark::State& state)
+//   {
+//     const Fixture fixture(state.range(0));
+//     for (auto _ : state)
+//       Benchmark::DoNotOptimize(fixture.Run());
+//     state.SetItemsProcessed(state.iterations() * state.range(0));
+//   }
+//   BENCHMARK(BM_Something)->Arg(64)->Arg(4096);
+//
+// Everything that is set up outside of the loop is not timed.
+
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "Common/CommonTypes.h"
+
+namespace Benchmark
+{
+class State final
+{
+public:
+  State(u64 max_iterations, std::vector<s64> ranges);
+
+  State(const State&) = delete;
+  State& operator=(const State&) = delete;
+
+  struct Iterator
+  {
+    struct [[maybe_unused]] Value
+    {
+    };
+
+    Value operator*() const { return {}; }
+    Iterator& operator++()
+    {
+      --remaining;
+      return *this;
+    }
+    bool operator!=(const Iterator&) const
+    {
+      if (remaining != 0) [[likely]]
+        return true;
+      state->FinishRunning();
+      return false;
+    }
+
+    State* state;
+    u64 remaining;
+  };
+
+  Iterator begin()
+  {
+    StartRunning();
+    return {this, m_max_iterations};
+  }
+  Iterator end() { return {this, 0}; }
+
+  // Excludes the time between the two calls from the measurement, for work that has to be redone
+  // every iteration. Both calls cost about as much as reading the clock twice.
+  void PauseTiming();
+  void ResumeTiming();
+
+  s64 range(size_t index = 0) const { return m_ranges.at(index); }
+  u64 iterations() const { return m_max_iterations; }
+
+  void SetItemsProcessed(u64 items) { m_items_processed = items; }
+  void SetBytesProcessed(u64 bytes) { m_bytes_processed = bytes; }
+  void SetLabel(std::string label) { m_label = std::move(label); }
+  // Skips the benchmark (the loop must not be entered after this).
+  void SkipWithError(std::string error) { m_error = std::move(error); }
+
+  std::chrono::nanoseconds GetRealTime() const { return m_real_time; }
+  std::chrono::nanoseconds GetCPUTime() const { return m_cpu_time; }
+  u64 GetItemsProcessed() const { return m_items_processed; }
+  u64 GetBytesProcessed() const { return m_bytes_processed; }
+  const std::string& GetLabel() const { return m_label; }
+  const std::string& GetError() const { return m_error; }
+  bool HasRun() const { return m_finished; }
+
+private:
+  using Clock = std::chrono::steady_clock;
+
+  void StartRunning();
+  void FinishRunning();
+
+  const u64 m_max_iterations;
+  const std::vector<s64> m_ranges;
+
+  bool m_started = false;
+  bool m_finished = false;
+  bool m_paused = false;
+  Clock::time_point m_start_time;
+  std::chrono::nanoseconds m_start_cpu_time{};
+  std::chrono::nanoseconds m_real_time{};
+  std::chrono::nanoseconds m_cpu_time{};
+
+  u64 m_items_processed = 0;
+  u64 m_bytes_processed = 0;
+  std::string m_label;
+  std::string m_error;
+};
+
+using Function = std::function<void(State&)>;
+
+class Definition final
+{
+public:
+  Definition(std::string name, Function function);
+
+  // Registers one run of the benchmark with the given argument(s), which are available as
+  // State::range(). Without any, the benchmark is run once without arguments.
+  Definition* Arg(s64 arg);
+  Definition* Args(std::vector<s64> args);
+  // Shortcut for registering a run for each of the given arguments.
+  Definition* ArgList(const std::vector<s64>& args);
+
+  const std::string& GetName() const { return m_name; }
+  const Function& GetFunction() const { return m_function; }
+  const std::vector<std::vector<s64>>& GetArgs() const { return m_args; }
+
+private:
+  std::string m_name;
+  Function m_function;
+  std::vector<std::vector<s64>> m_args;
+};
+
+Definition* Register(std::string name, Function function);
+const std::vector<std::unique_ptr<Definition>>& GetRegisteredBenchmarks();
+
+// Runs the benchmarks selected by the command line, returns the process exit code.
+int RunBenchmarks(int argc, char** argv);
+
+namespace detail
+{
+void UseCharPointer(const volatile char*);
+}
+
+// Forces the compiler to compute the value, without an observable cost.
+template <typename T>
+inline void DoNotOptimize(const T& value)
+{
+#ifdef _MSC_VER
+  detail::UseCharPointer(&reinterpret_cast<const volatile char&>(value));
+  _ReadWriteBarrier();
+#else
+  asm volatile("" : : "r,m"(value) : "memory");
+#endif
+}
+
+// Forces all pending memory writes to be done.
+inline void ClobberMemory()
+{
+#ifdef _MSC_VER
+  _ReadWriteBarrier();
+#else
+  asm volatile("" : : : "memory");
+#endif
+}
+}  // namespace Benchmark
+
+#define BENCHMARK_CONCAT_IMPL(a, b) a##b
+#define BENCHMARK_CONCAT(a, b) BENCHMARK_CONCAT_IMPL(a, b)
+
+#define BENCHMARK(function)                                                                        \
+  [[maybe_unused]] static ::Benchmark::Definition* BENCHMARK_CONCAT(s_benchmark_, __LINE__) =      \
+      ::Benchmark::Register(#function, function)
@@ -0,0 +1,27 @@
+// Copyright 2024 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <cstdio>
+#include <fmt/format.h>
+
+#include "Common/MsgHandler.h"
+#include "Core/Core.h"
+
+#include "Benchmark.h"
+
+namespace
+{
+bool BenchmarkMsgHandler(const char* caption, const char* text, bool yes_no, Common::MsgType style)
+{
+  fmt::print(stderr, "{}\n", text);
+  return true;
+}
+}  // namespace
+
+int main(int argc, char** argv)
+{
+  Common::RegisterMsgAlertHandler(BenchmarkMsgHandler);
+  Core::DeclareAsHostThread();
+
+  return Benchmark::RunBenchmarks(argc, argv);
+}
@@ -0,0 +1,84 @@
+// Copyright 2024 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <random>
+#include <vector>
+
+#include "Common/CommonTypes.h"
+#include "Common/Hash.h"
+#ifdef _M_X86_64
+#include "Common/x64Emitter.h"
+#endif
+
+#include "Benchmark.h"
+
+static std::vector<u8> GetRandomBytes(size_t size)
+{
+  // Fixed seed, so that every run hashes the same data.
+  std::mt19937 generator(size);
+  std::uniform_int_distribution<int> distribution(0, 255);
+  std::vector<u8> data(size);
+  for (u8& byte : data)
+    byte = static_cast<u8>(distribution(generator));
+  return data;
+}
+
+// Args: size in bytes, samples (0 hashes everything, like the texture cache does by default).
+static void BM_GetHash64(Benchmark::State& state)
+{
+  const std::vector<u8> data = GetRandomBytes(static_cast<size_t>(state.range(0)));
+  const u32 size = static_cast<u32>(data.size());
+  const u32 samples = static_cast<u32>(state.range(1));
+  for (auto _ : state)
+    Benchmark::DoNotOptimize(Common::GetHash64(data.data(), size, samples));
+  // With sampling, only part of the data is read.
+  if (samples == 0)
+    state.SetBytesProcessed(state.iterations() * data.size());
+}
+BENCHMARK(BM_GetHash64)
+    ->Args({64, 0})
+    ->Args({4096, 0})
+    ->Args({256 * 1024, 0})
+    ->Args({4 * 1024 * 1024, 0})
+    ->Args({4 * 1024 * 1024, 128});
+
+#ifdef _M_X86_64
+// Encodes a mix of instructions resembling what Jit64 emits for a block: loads and stores with
+// various addressing modes, ALU operations, SSE arithmetic and branches.
+static void BM_x64EmitterEncoding(Benchmark::State& state)
+{
+  using namespace Gen;
+
+  constexpr int BLOCKS = 64;
+  constexpr int INSTRUCTIONS_PER_BLOCK = 16;
+
+  std::vector<u8> buffer(BLOCKS * INSTRUCTIONS_PER_BLOCK * 16);
+  XEmitter emitter;
+  for (auto _ : state)
+  {
+    emitter.SetCodePtr(buffer.data(), buffer.data() + buffer.size());
+    for (int i = 0; i < BLOCKS; ++i)
+    {
+      emitter.MOV(32, R(EAX), MDisp(RBP, i * 4));
+      emitter.MOV(32, R(ECX), MComplex(RBX, RAX, SCALE_1, 0x1234));
+      emitter.BSWAP(32, ECX);
+      emitter.ADD(32, R(ECX), Imm32(0x12345678));
+      emitter.SHL(32, R(ECX), Imm8(3));
+      emitter.AND(32, R(EAX), Imm8(0x7f));
+      emitter.LEA(64, RDX, MComplex(RAX, RCX, SCALE_4, 8));
+      emitter.MOVZX(32, 16, R8, MatR(RDX));
+      emitter.MOVSD(XMM0, MDisp(RBP, 0x100 + i * 8));
+      emitter.ADDSD(XMM0, R(XMM1));
+      emitter.CVTSD2SS(XMM2, R(XMM0));
+      emitter.MOVAPS(XMM3, R(XMM2));
+      emitter.CMP(32, R(EAX), R(ECX));
+      const FixupBranch branch = emitter.J_CC(CC_NZ);
+      emitter.MOV(32, MDisp(RBP, i * 4), R(ECX));
+      emitter.SetJumpTarget(branch);
+    }
+    Benchmark::DoNotOptimize(emitter.GetCodePtr());
+  }
+  state.SetItemsProcessed(state.iterations() * BLOCKS * INSTRUCTIONS_PER_BLOCK);
+}
+BENCHMARK(BM_x64EmitterEncoding);
+#endif
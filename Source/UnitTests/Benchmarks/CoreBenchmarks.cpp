@@ -0,0 +1,266 @@
+// Copyright 2024 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <algorithm>
+#include <array>
+#include <random>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include <fmt/format.h>
+
+#include "Common/CommonTypes.h"
+#include "Common/Config/Config.h"
+#include "Common/FileUtil.h"
+#include "Core/ConfigManager.h"
+#include "Core/Core.h"
+#include "Core/CoreTiming.h"
+#include "Core/HW/Memmap.h"
+#include "Core/PowerPC/JitCommon/JitCache.h"
+#include "Core/PowerPC/PPCAnalyst.h"
+#include "Core/PowerPC/PowerPC.h"
+#include "Core/System.h"
+#include "UICommon/UICommon.h"
+
+#if defined(_M_X86_64)
+#include "Core/PowerPC/Jit64/Jit.h"
+#elif defined(_M_ARM_64)
+#include "Core/PowerPC/JitArm64/Jit.h"
+#endif
+
+#include "Benchmark.h"
+
+namespace
+{
+// The binary heap CoreTiming used before the timing wheel, as a baseline.
+class HeapEventQueue
+{
+public:
+  size_t size() const { return m_heap.size(); }
+  void Push(const CoreTiming::Event& event)
+  {
+    m_heap.push_back(event);
+    std::push_heap(m_heap.begin(), m_heap.end(), Later);
+  }
+  const CoreTiming::Event& Top() const { return m_heap.front(); }
+  void Pop()
+  {
+    std::pop_heap(m_heap.begin(), m_heap.end(), Later);
+    m_heap.pop_back();
+  }
+  void RemoveEvents(const CoreTiming::EventType* event_type)
+  {
+    std::erase_if(m_heap, [&](const CoreTiming::Event& e) { return e.type == event_type; });
+    std::make_heap(m_heap.begin(), m_heap.end(), Later);
+  }
+
+private:
+  static bool Later(const CoreTiming::Event& a, const CoreTiming::Event& b)
+  {
+    return std::tie(a.time, a.fifo_order) > std::tie(b.time, b.fifo_order);
+  }
+
+  std::vector<CoreTiming::Event> m_heap;
+};
+
+// Mimics the scheduling pattern of the emulated hardware: pending events mostly within a few
+// slices, some far in the future (e.g. VI and DVD), a few into the past and the occasional
+// RemoveEvent. Every iteration runs the earliest event, which schedules another one.
+template <typename Queue>
+void RunEventQueue(Benchmark::State& state)
+{
+  constexpr int OPERATIONS = 1024;
+  const size_t pending_events = static_cast<size_t>(state.range(0));
+
+  std::array<CoreTiming::EventType, 8> types{};
+  std::mt19937_64 rng(42);
+  Queue queue;
+  s64 now = 0;
+  u64 fifo_order = 0;
+  const auto schedule = [&] {
+    s64 delay;
+    const u64 kind = rng() % 16;
+    if (kind == 0)
+      delay = static_cast<s64>(rng() % 10'000'000);
+    else if (kind == 1)
+      delay = -static_cast<s64>(rng() % 1000);
+    else
+      delay = static_cast<s64>(rng() % 40'000);
+    CoreTiming::EventType* const type = &types[rng() % types.size()];
+    queue.Push(CoreTiming::Event{now + delay, fifo_order, fifo_order, type});
+    ++fifo_order;
+  };
+
+  for (auto _ : state)
+  {
+    for (int i = 0; i < OPERATIONS; ++i)
+    {
+      if (queue.size() < pending_events)
+      {
+        schedule();
+      }
+      else if (rng() % 512 == 0)
+      {
+        queue.RemoveEvents(&types[rng() % types.size()]);
+      }
+      else
+      {
+        const CoreTiming::Event event = queue.Top();
+        queue.Pop();
+        now = std::max(now, event.time);
+        Benchmark::DoNotOptimize(event.userdata);
+        schedule();
+      }
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * OPERATIONS);
+}
+
+#if defined(_M_X86_64) || defined(_M_ARM_64)
+#if defined(_M_X86_64)
+using HostJit = Jit64;
+#else
+using HostJit = JitArm64;
+#endif
+
+constexpr u32 BLOCK_ADDRESS = 0x00003100;
+
+// A leaf function which every dataflow pass has something to do in: constants which are built
+// again, stack slots which are loaded back and CR0 updates which are overwritten before being read.
+constexpr std::array<u32, 13> DATAFLOW_BLOCK = {
+    0x3c608034,  // lis r3, 0x8034
+    0x60631234,  // ori r3, r3, 0x1234
+    0x90610008,  // stw r3, 8(r1)
+    0x38800006,  // li r4, 6
+    0x7ca41a15,  // add. r5, r4, r3
+    0x80c10008,  // lwz r6, 8(r1)
+    0x7ce62a15,  // add. r7, r6, r5
+    0x3c608034,  // lis r3, 0x8034
+    0x60631234,  // ori r3, r3, 0x1234
+    0x80810008,  // lwz r4, 8(r1)
+    0x7d043a15,  // add. r8, r4, r7
+    0x9101000c,  // stw r8, 12(r1)
+    0x4e800020,  // blr
+};
+
+// Sets up the parts of the emulated system that the JIT needs to compile from guest memory, which
+// is accessed untranslated.
+class JitEnvironment final
+{
+public:
+  JitEnvironment()
+  {
+    m_profile_path = File::CreateTempDir();
+    Core::DeclareAsCPUThread();
+    UICommon::SetUserDirectory(m_profile_path);
+    Config::Init();
+    SConfig::Init();
+    m_system.GetMemory().Init();
+    m_system.GetPowerPC().Init(PowerPC::CPUCore::Interpreter);
+    m_system.GetCoreTiming().Init();
+  }
+
+  ~JitEnvironment()
+  {
+    // Also unregisters the events of PowerPC::Init, so that the next run can register them again.
+    m_system.GetCoreTiming().Shutdown();
+    m_system.GetPowerPC().Shutdown();
+    m_system.GetMemory().Shutdown();
+    SConfig::Shutdown();
+    Config::Shutdown();
+    Core::UndeclareAsCPUThread();
+    File::DeleteDirRecursively(m_profile_path);
+  }
+
+  JitEnvironment(const JitEnvironment&) = delete;
+  JitEnvironment& operator=(const JitEnvironment&) = delete;
+
+  Core::System& GetSystem() const { return m_system; }
+
+private:
+  Core::System& m_system = Core::System::GetInstance();
+  std::string m_profile_path;
+};
+
+// Compiles single blocks outside of the CPU loop, so that the host code emitted for them can be
+// measured.
+class BlockCompiler final : public HostJit
+{
+public:
+  explicit BlockCompiler(Core::System& system) : HostJit(system) {}
+
+  void SetDataflowEnabled(bool enabled)
+  {
+    if (enabled)
+      analyzer.SetOption(PPCAnalyst::PPCAnalyzer::OPTION_DATAFLOW);
+    else
+      analyzer.ClearOption(PPCAnalyst::PPCAnalyzer::OPTION_DATAFLOW);
+  }
+
+  // Compiles the block at the address from scratch. The result is valid until the next call.
+  const JitBlock* Compile(u32 address)
+  {
+    ClearCache();
+    // The quick tier of tiered compilation skips the dataflow passes.
+    js.tierUpAddresses.insert(address);
+    Jit(address);
+    return GetBlockCache()->GetBlockFromStartAddress(address, m_ppc_state.feature_flags);
+  }
+};
+#endif
+}  // namespace
+
+// Args: number of pending events.
+static void BM_CoreTimingEventQueue(Benchmark::State& state)
+{
+  RunEventQueue<CoreTiming::EventQueue>(state);
+}
+BENCHMARK(BM_CoreTimingEventQueue)->Arg(32)->Arg(256);
+
+static void BM_CoreTimingHeapBaseline(Benchmark::State& state)
+{
+  RunEventQueue<HeapEventQueue>(state);
+}
+BENCHMARK(BM_CoreTimingHeapBaseline)->Arg(32)->Arg(256);
+
+// Args: whether the dataflow passes of the PPC analyzer are enabled.
+static void BM_JitDataflowBlock(Benchmark::State& state)
+{
+#if defined(_M_X86_64) || defined(_M_ARM_64)
+  const JitEnvironment environment;
+  Core::System& system = environment.GetSystem();
+  u32 address = BLOCK_ADDRESS;
+  for (const u32 instruction : DATAFLOW_BLOCK)
+  {
+    system.GetMemory().Write_U32(instruction, address);
+    address += 4;
+  }
+
+  BlockCompiler jit(system);
+  jit.Init();
+  jit.SetDataflowEnabled(state.range(0) != 0);
+
+  const JitBlock* block = jit.Compile(BLOCK_ADDRESS);
+  if (!block || block->originalSize == 0)
+  {
+    jit.Shutdown();
+    state.SkipWithError("The block was not compiled");
+    return;
+  }
+  const size_t code_size =
+      (block->near_end - block->near_begin) + (block->far_end - block->far_begin);
+  const u32 guest_instructions = block->originalSize;
+
+  for (auto _ : state)
+    Benchmark::DoNotOptimize(jit.Compile(BLOCK_ADDRESS));
+
+  state.SetItemsProcessed(state.iterations() * guest_instructions);
+  state.SetLabel(fmt::format("{:.1f} host bytes per guest instruction",
+                             static_cast<double>(code_size) / guest_instructions));
+  jit.Shutdown();
+#else
+  state.SkipWithError("There is no JIT for this architecture");
+#endif
+}
+BENCHMARK(BM_JitDataflowBlock)->Arg(0)->Arg(1);
@@ -0,0 +1,513 @@
+// Copyright 2024 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <array>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <fmt/format.h>
+
+#include "Common/BitUtils.h"
+#include "Common/CommonTypes.h"
+#include "Common/IOFile.h"
+#include "Common/Swap.h"
+#include "Core/System.h"
+#include "VideoCommon/BPMemory.h"
+#include "VideoCommon/CPMemory.h"
+#include "VideoCommon/CPUCull.h"
+#include "VideoCommon/GXPipelineTypes.h"
+#include "VideoCommon/IndexGenerator.h"
+#include "VideoCommon/OpcodeDecoding.h"
+#include "VideoCommon/PixelShaderGen.h"
+#include "VideoCommon/ShaderGenCommon.h"
+#include "VideoCommon/TextureAddressIndex.h"
+#include "VideoCommon/TextureDecoder.h"
+#include "VideoCommon/UberShaderPixel.h"
+#include "VideoCommon/UberShaderVertex.h"
+#include "VideoCommon/VertexLoaderBase.h"
+#include "VideoCommon/VertexLoaderManager.h"
+#include "VideoCommon/VertexShaderGen.h"
+#include "VideoCommon/XFMemory.h"
+#include "VideoCommon/XFStateManager.h"
+
+#include "Benchmark.h"
+
+namespace
+{
+std::vector<u8> GetRandomBytes(size_t size, u32 seed)
+{
+  // Fixed seeds, so that every run processes the same data.
+  std::mt19937 generator(seed);
+  std::uniform_int_distribution<int> distribution(0, 255);
+  std::vector<u8> data(size);
+  for (u8& byte : data)
+    byte = static_cast<u8>(distribution(generator));
+  return data;
+}
+
+struct VertexFormat
+{
+  const char* name;
+  void (*setup)(TVtxDesc& desc, VAT& vat);
+};
+
+void SetupPositionFloat(TVtxDesc& desc, VAT& vat)
+{
+  desc.low.Position = VertexComponentFormat::Direct;
+  vat.g0.PosElements = CoordComponentCount::XYZ;
+  vat.g0.PosFormat = ComponentFormat::Float;
+}
+
+// The most common layout of game geometry: quantized position, normal and texture coordinate.
+void SetupQuantized(TVtxDesc& desc, VAT& vat)
+{
+  desc.low.Position = VertexComponentFormat::Direct;
+  desc.low.Normal = VertexComponentFormat::Direct;
+  desc.high.Tex0Coord = VertexComponentFormat::Direct;
+  vat.g0.PosElements = CoordComponentCount::XYZ;
+  vat.g0.PosFormat = ComponentFormat::Short;
+  vat.g0.PosFrac = 8;
+  vat.g0.NormalElements = NormalComponentCount::N;
+  vat.g0.NormalFormat = ComponentFormat::Byte;
+  vat.g0.Tex0CoordElements = TexComponentCount::ST;
+  vat.g0.Tex0CoordFormat = ComponentFormat::Short;
+  vat.g0.Tex0Frac = 10;
+  vat.g0.ByteDequant = true;
+}
+
+void SetupIndexed(TVtxDesc& desc, VAT& vat)
+{
+  desc.low.Position = VertexComponentFormat::Index16;
+  desc.low.Normal = VertexComponentFormat::Index16;
+  desc.low.Color0 = VertexComponentFormat::Index16;
+  desc.high.Tex0Coord = VertexComponentFormat::Index16;
+  vat.g0.PosElements = CoordComponentCount::XYZ;
+  vat.g0.PosFormat = ComponentFormat::Float;
+  vat.g0.NormalElements = NormalComponentCount::N;
+  vat.g0.NormalFormat = ComponentFormat::Float;
+  vat.g0.Color0Elements = ColorComponentCount::RGBA;
+  vat.g0.Color0Comp = ColorFormat::RGBA8888;
+  vat.g0.Tex0CoordElements = TexComponentCount::ST;
+  vat.g0.Tex0CoordFormat = ComponentFormat::Float;
+}
+
+// Skinned models: a position matrix index per vertex and indexed 8-bit attributes.
+void SetupSkinned(TVtxDesc& desc, VAT& vat)
+{
+  desc.low.PosMatIdx = 1;
+  desc.low.Tex0MatIdx = 1;
+  desc.low.Position = VertexComponentFormat::Index8;
+  desc.low.Normal = VertexComponentFormat::Index8;
+  desc.low.Color0 = VertexComponentFormat::Direct;
+  desc.high.Tex0Coord = VertexComponentFormat::Index8;
+  vat.g0.PosElements = CoordComponentCount::XYZ;
+  vat.g0.PosFormat = ComponentFormat::Short;
+  vat.g0.PosFrac = 6;
+  vat.g0.NormalElements = NormalComponentCount::N;
+  vat.g0.NormalFormat = ComponentFormat::Short;
+  vat.g0.Color0Elements = ColorComponentCount::RGBA;
+  vat.g0.Color0Comp = ColorFormat::RGBA6666;
+  vat.g0.Tex0CoordElements = TexComponentCount::ST;
+  vat.g0.Tex0CoordFormat = ComponentFormat::UShort;
+  vat.g0.Tex0Frac = 12;
+}
+
+constexpr std::array<VertexFormat, 4> VERTEX_FORMATS = {{
+    {"PositionFloat", SetupPositionFloat},
+    {"Quantized", SetupQuantized},
+    {"Indexed16Float", SetupIndexed},
+    {"Skinned", SetupSkinned},
+}};
+
+constexpr u32 NUM_VERTICES = 3072;
+
+// Array data for indexed attributes. The indices themselves are random, so they may point anywhere
+// in there, which is realistic enough.
+std::vector<u8> s_array_data = GetRandomBytes(256 * 1024, 1);
+
+std::unique_ptr<VertexLoaderBase> CreateLoader(const VertexFormat& format)
+{
+  TVtxDesc desc;
+  VAT vat;
+  format.setup(desc, vat);
+
+  for (size_t i = 0; i < NUM_VERTEX_COMPONENT_ARRAYS; ++i)
+  {
+    VertexLoaderManager::cached_arraybases[static_cast<CPArray>(i)] = s_array_data.data();
+    g_main_cp_state.array_strides[static_cast<CPArray>(i)] = 16;
+  }
+
+  return VertexLoaderBase::CreateVertexLoader(desc, vat);
+}
+}  // namespace
+
+// Arg: index into VERTEX_FORMATS.
+static void BM_VertexLoader(Benchmark::State& state)
+{
+  const VertexFormat& format = VERTEX_FORMATS.at(state.range(0));
+  state.SetLabel(format.name);
+
+  const std::unique_ptr<VertexLoaderBase> loader = CreateLoader(format);
+  std::vector<u8> src = GetRandomBytes(NUM_VERTICES * loader->m_vertex_size, 2);
+  // Keep the indices within the arrays, and the positions within a sensible range.
+  if (format.setup == SetupIndexed)
+  {
+    for (u32 i = 0; i < NUM_VERTICES * 4; ++i)
+      src[i * 2] &= 0x3f;
+  }
+  std::vector<u8> dst(NUM_VERTICES * loader->m_native_vtx_decl.stride);
+
+  for (auto _ : state)
+    Benchmark::DoNotOptimize(loader->RunVertices(src.data(), dst.data(), NUM_VERTICES));
+  state.SetItemsProcessed(state.iterations() * NUM_VERTICES);
+  state.SetBytesProcessed(state.iterations() * src.size());
+}
+BENCHMARK(BM_VertexLoader)->ArgList({0, 1, 2, 3});
+
+// Arg: texture format. All textures are 256x256, the C formats use an RGB5A3 palette.
+static void BM_TextureDecoder(Benchmark::State& state)
+{
+  constexpr int SIZE = 256;
+  const TextureFormat format = static_cast<TextureFormat>(state.range(0));
+  state.SetLabel(fmt::to_string(format));
+
+  const std::vector<u8> src =
+      GetRandomBytes(TexDecoder_GetTextureSizeInBytes(SIZE, SIZE, format), 3);
+  const std::vector<u8> tlut = GetRandomBytes(TexDecoder_GetPaletteSize(format), 4);
+  std::vector<u8> dst(SIZE * SIZE * 4);
+
+  for (auto _ : state)
+  {
+    TexDecoder_Decode(dst.data(), src.data(), SIZE, SIZE, format, tlut.data(), TLUTFormat::RGB5A3);
+    Benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * SIZE * SIZE);
+  state.SetBytesProcessed(state.iterations() * src.size());
+}
+BENCHMARK(BM_TextureDecoder)
+    ->ArgList({static_cast<s64>(TextureFormat::I4), static_cast<s64>(TextureFormat::I8),
+               static_cast<s64>(TextureFormat::IA4), static_cast<s64>(TextureFormat::IA8),
+               static_cast<s64>(TextureFormat::RGB565), static_cast<s64>(TextureFormat::RGB5A3),
+               static_cast<s64>(TextureFormat::RGBA8), static_cast<s64>(TextureFormat::C4),
+               static_cast<s64>(TextureFormat::C8), static_cast<s64>(TextureFormat::C14X2),
+               static_cast<s64>(TextureFormat::CMPR)});
+
+// Arg: primitive type. Adds 64 draws of 96 vertices each.
+static void BM_IndexGenerator(Benchmark::State& state)
+{
+  constexpr u32 DRAWS = 64;
+  constexpr u32 VERTICES_PER_DRAW = 96;
+  const auto primitive = static_cast<OpcodeDecoder::Primitive>(state.range(0));
+  state.SetLabel(fmt::to_string(primitive));
+
+  IndexGenerator generator;
+  generator.Init();
+  // Enough for any primitive type, with or without primitive restart.
+  std::vector<u16> indices(DRAWS * VERTICES_PER_DRAW * 4);
+
+  for (auto _ : state)
+  {
+    generator.Start(indices.data());
+    for (u32 i = 0; i < DRAWS; ++i)
+      generator.AddIndices(primitive, VERTICES_PER_DRAW);
+    Benchmark::DoNotOptimize(generator.GetIndexLen());
+    Benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * DRAWS * VERTICES_PER_DRAW);
+}
+BENCHMARK(BM_IndexGenerator)
+    ->ArgList({static_cast<s64>(OpcodeDecoder::Primitive::GX_DRAW_QUADS),
+               static_cast<s64>(OpcodeDecoder::Primitive::GX_DRAW_TRIANGLES),
+               static_cast<s64>(OpcodeDecoder::Primitive::GX_DRAW_TRIANGLE_STRIP),
+               static_cast<s64>(OpcodeDecoder::Primitive::GX_DRAW_TRIANGLE_FAN),
+               static_cast<s64>(OpcodeDecoder::Primitive::GX_DRAW_LINES),
+               static_cast<s64>(OpcodeDecoder::Primitive::GX_DRAW_LINE_STRIP),
+               static_cast<s64>(OpcodeDecoder::Primitive::GX_DRAW_POINTS)});
+
+// Positions of counter-clockwise primitives, which are all culled with back face culling.
+static std::vector<float> GetCullPositions(OpcodeDecoder::Primitive primitive, float x_offset)
+{
+  std::vector<float> positions(NUM_VERTICES * 3);
+  std::mt19937 generator(5);
+  std::uniform_real_distribution<float> on_screen(-0.5f, 0.5f);
+  constexpr float SIZE = 0.25f;
+  std::array<float, 2> origin{};
+  for (u32 i = 0; i < NUM_VERTICES; ++i)
+  {
+    float x = 0.0f;
+    float y = 0.0f;
+    switch (primitive)
+    {
+    case OpcodeDecoder::Primitive::GX_DRAW_QUADS:
+    {
+      if (i % 4 == 0)
+        origin = {on_screen(generator), on_screen(generator)};
+      constexpr std::array<std::array<float, 2>, 4> corners = {{{0, 0}, {1, 0}, {1, 1}, {0, 1}}};
+      x = origin[0] + corners[i % 4][0] * SIZE;
+      y = origin[1] + corners[i % 4][1] * SIZE;
+      break;
+    }
+    case OpcodeDecoder::Primitive::GX_DRAW_TRIANGLE_STRIP:
+      x = -1.0f + (i / 2) * (2.0f / NUM_VERTICES);
+      y = (i % 2 == 0) ? SIZE : 0.0f;
+      break;
+    case OpcodeDecoder::Primitive::GX_DRAW_TRIANGLE_FAN:
+    {
+      const float angle = i * (6.0f / NUM_VERTICES);
+      x = (i == 0) ? 0.0f : std::cos(angle) * 0.9f;
+      y = (i == 0) ? 0.0f : std::sin(angle) * 0.9f;
+      break;
+    }
+    default:
+    {
+      if (i % 3 == 0)
+        origin = {on_screen(generator), on_screen(generator)};
+      constexpr std::array<std::array<float, 2>, 3> corners = {{{0, 0}, {1, 0}, {0, 1}}};
+      x = origin[0] + corners[i % 3][0] * SIZE;
+      y = origin[1] + corners[i % 3][1] * SIZE;
+      break;
+    }
+    }
+    positions[i * 3 + 0] = x + x_offset;
+    positions[i * 3 + 1] = y;
+    positions[i * 3 + 2] = 0.5f;
+  }
+  return positions;
+}
+
+// Args: primitive type, and whether the draw is off screen. Draws that are on screen but face away
+// from the camera are the worst case, since every primitive has to be transformed and checked.
+// Off screen draws are rejected by their bounding box.
+static void BM_CPUCull(Benchmark::State& state)
+{
+  const auto primitive = static_cast<OpcodeDecoder::Primitive>(state.range(0));
+  const bool off_screen = state.range(1) != 0;
+  state.SetLabel(fmt::format("{}{}", primitive, off_screen ? " off screen" : ""));
+
+  const std::unique_ptr<VertexLoaderBase> loader = CreateLoader(VERTEX_FORMATS[0]);
+  const std::vector<float> positions = GetCullPositions(primitive, off_screen ? 3.0f : 0.0f);
+  // The vertex loader expects big endian data.
+  std::vector<u8> src(positions.size() * sizeof(float));
+  for (size_t i = 0; i < positions.size(); ++i)
+  {
+    const u32 value = Common::swap32(Common::BitCast<u32>(positions[i]));
+    std::memcpy(&src[i * sizeof(u32)], &value, sizeof(u32));
+  }
+  std::vector<u8> vertices(NUM_VERTICES * loader->m_native_vtx_decl.stride);
+  loader->RunVertices(src.data(), vertices.data(), NUM_VERTICES);
+
+  // Identity position matrix and orthographic projection, with back face culling.
+  xfmem.posMatrices[0] = 1.0f;
+  xfmem.posMatrices[5] = 1.0f;
+  xfmem.posMatrices[10] = 1.0f;
+  g_main_cp_state.matrix_index_a.PosNormalMtxIdx = 0;
+  xfmem.projection.type = ProjectionType::Orthographic;
+  xfmem.projection.rawProjection = {1.0f, 0.0f, 1.0f, 0.0f, -1.0f, 0.0f};
+  xfmem.viewport.ht = 0.0f;
+  bpmem.genMode.cullmode = CullMode::Back;
+  Core::System::GetInstance().GetXFStateManager().SetProjectionChanged();
+
+  CPUCull cull;
+  cull.Init();
+  if (!cull.AreAllVerticesCulled(loader.get(), primitive, vertices.data(), NUM_VERTICES))
+  {
+    state.SkipWithError("Draw was not culled");
+    return;
+  }
+  for (auto _ : state)
+  {
+    Benchmark::DoNotOptimize(
+        cull.AreAllVerticesCulled(loader.get(), primitive, vertices.data(), NUM_VERTICES));
+  }
+  state.SetItemsProcessed(state.iterations() * NUM_VERTICES);
+}
+BENCHMARK(BM_CPUCull)
+    ->Args({static_cast<s64>(OpcodeDecoder::Primitive::GX_DRAW_QUADS), 0})
+    ->Args({static_cast<s64>(OpcodeDecoder::Primitive::GX_DRAW_TRIANGLES), 0})
+    ->Args({static_cast<s64>(OpcodeDecoder::Primitive::GX_DRAW_TRIANGLE_STRIP), 0})
+    ->Args({static_cast<s64>(OpcodeDecoder::Primitive::GX_DRAW_TRIANGLE_FAN), 0})
+    ->Args({static_cast<s64>(OpcodeDecoder::Primitive::GX_DRAW_TRIANGLES), 1});
+
+using VideoCommon::GX_PIPELINE_UID_VERSION;
+using VideoCommon::SerializedGXPipelineUid;
+
+// Reads the pipelines of a .uidcache file, as written by the shader cache of a game.
+static std::vector<SerializedGXPipelineUid> ReadPipelineUIDCache(const std::string& filename)
+{
+  constexpr u32 CACHE_FILE_MAGIC = 0x44495550;  // PUID
+  constexpr size_t CACHE_HEADER_SIZE = sizeof(u32) + sizeof(u32);
+  File::IOFile file(filename, "rb");
+  u32 magic;
+  u32 version;
+  if (!file.ReadBytes(&magic, sizeof(magic)) || !file.ReadBytes(&version, sizeof(version)) ||
+      magic != CACHE_FILE_MAGIC || version != GX_PIPELINE_UID_VERSION)
+  {
+    return {};
+  }
+
+  const u64 file_size = file.GetSize();
+  std::vector<SerializedGXPipelineUid> uids(
+      static_cast<size_t>(file_size - CACHE_HEADER_SIZE) / sizeof(SerializedGXPipelineUid));
+  if (uids.size() * sizeof(SerializedGXPipelineUid) + CACHE_HEADER_SIZE != file_size ||
+      !file.ReadArray(uids.data(), uids.size()))
+  {
+    return {};
+  }
+  return uids;
+}
+
+// Generates the vertex and pixel shaders of every pipeline in the .uidcache file given by the
+// DOLPHIN_BENCHMARK_UIDCACHE environment variable, as a game's shader compilation would.
+static void BM_ShaderGen(Benchmark::State& state)
+{
+  const char* filename = std::getenv("DOLPHIN_BENCHMARK_UIDCACHE");
+  if (!filename)
+  {
+    state.SkipWithError("DOLPHIN_BENCHMARK_UIDCACHE is not set");
+    return;
+  }
+  std::vector<SerializedGXPipelineUid> uids = ReadPipelineUIDCache(filename);
+  if (uids.empty())
+  {
+    state.SkipWithError(fmt::format("{} is not a valid UID cache", filename));
+    return;
+  }
+
+  const ShaderHostConfig host_config = ShaderHostConfig::GetCurrent();
+  for (SerializedGXPipelineUid& uid : uids)
+    ClearUnusedPixelShaderUidBits(APIType::Vulkan, host_config, &uid.ps_uid);
+
+  size_t bytes = 0;
+  for (auto _ : state)
+  {
+    bytes = 0;
+    for (const SerializedGXPipelineUid& uid : uids)
+    {
+      bytes += GenerateVertexShaderCode(APIType::Vulkan, host_config, uid.vs_uid.GetUidData())
+                   .GetBuffer()
+                   .size();
+      bytes += GeneratePixelShaderCode(APIType::Vulkan, host_config, uid.ps_uid.GetUidData(), {})
+                   .GetBuffer()
+                   .size();
+    }
+    Benchmark::DoNotOptimize(bytes);
+  }
+  state.SetItemsProcessed(state.iterations() * uids.size() * 2);
+  state.SetBytesProcessed(state.iterations() * bytes);
+}
+BENCHMARK(BM_ShaderGen);
+
+// Generates every uber shader. Unlike the specialized shaders, these don't depend on the game.
+static void BM_UberShaderGen(Benchmark::State& state)
+{
+  const ShaderHostConfig host_config = ShaderHostConfig::GetCurrent();
+  std::vector<UberShader::VertexShaderUid> vs_uids;
+  std::vector<UberShader::PixelShaderUid> ps_uids;
+  UberShader::EnumerateVertexShaderUids(
+      [&](const UberShader::VertexShaderUid& uid) { vs_uids.push_back(uid); });
+  UberShader::EnumeratePixelShaderUids([&](const UberShader::PixelShaderUid& uid) {
+    UberShader::PixelShaderUid cleared_uid = uid;
+    UberShader::ClearUnusedPixelShaderUidBits(APIType::Vulkan, host_config, &cleared_uid);
+    ps_uids.push_back(cleared_uid);
+  });
+
+  size_t bytes = 0;
+  for (auto _ : state)
+  {
+    bytes = 0;
+    for (const UberShader::VertexShaderUid& uid : vs_uids)
+    {
+      bytes += UberShader::GenVertexShader(APIType::Vulkan, host_config, uid.GetUidData())
+                   .GetBuffer()
+                   .size();
+    }
+    for (const UberShader::PixelShaderUid& uid : ps_uids)
+    {
+      bytes += UberShader::GenPixelShader(APIType::Vulkan, host_config, uid.GetUidData(), {})
+                   .GetBuffer()
+                   .size();
+    }
+    Benchmark::DoNotOptimize(bytes);
+  }
+  state.SetItemsProcessed(state.iterations() * (vs_uids.size() + ps_uids.size()));
+  state.SetBytesProcessed(state.iterations() * bytes);
+}
+BENCHMARK(BM_UberShaderGen);
+
+namespace
+{
+struct CachedTexture
+{
+  u32 addr;
+  u32 size;
+};
+
+// Textures and EFB copies spread over the 24 MiB of GameCube RAM, in sizes typical for games.
+std::vector<CachedTexture> GetCachedTextures(u32 count, u32 seed)
+{
+  constexpr std::array<u32, 6> sizes = {0x800, 0x2000, 0x8000, 0x20000, 0xa5000, 0x14a000};
+  std::mt19937 generator(seed);
+  std::uniform_int_distribution<u32> address(0, 0x1800000 / 32 - 1);
+  std::uniform_int_distribution<size_t> size(0, sizes.size() - 1);
+  std::vector<CachedTexture> textures(count);
+  for (CachedTexture& texture : textures)
+    texture = {address(generator) * 32, sizes[size(generator)]};
+  return textures;
+}
+}  // namespace
+
+// Arg: whether the texture cache's page index is used, instead of looking at every texture that
+// starts up to the maximum texture size before the range. Looks up the textures overlapping 1024
+// EFB copies in a cache of 2048 textures, as every EFB copy and partial texture update does.
+static void BM_TextureOverlap(Benchmark::State& state)
+{
+  const bool use_index = state.range(0) != 0;
+  state.SetLabel(use_index ? "page index" : "address map");
+
+  using AddressMap = std::multimap<u32, std::shared_ptr<CachedTexture>>;
+  AddressMap textures_by_address;
+  TextureAddressIndex<AddressMap::iterator> textures_by_page;
+  for (const CachedTexture& texture : GetCachedTextures(2048, 6))
+  {
+    const auto iter =
+        textures_by_address.emplace(texture.addr, std::make_shared<CachedTexture>(texture));
+    textures_by_page.Add(texture.addr, texture.size, iter);
+  }
+  const std::vector<CachedTexture> copies = GetCachedTextures(1024, 7);
+
+  std::vector<AddressMap::iterator> found;
+  for (auto _ : state)
+  {
+    u32 overlapping = 0;
+    for (const CachedTexture& copy : copies)
+    {
+      const auto overlaps = [&copy](const CachedTexture& texture) {
+        return texture.addr < copy.addr + copy.size && copy.addr < texture.addr + texture.size;
+      };
+      if (use_index)
+      {
+        found.clear();
+        textures_by_page.Find(copy.addr, copy.size, &found);
+        for (const AddressMap::iterator iter : found)
+          overlapping += overlaps(*iter->second);
+      }
+      else
+      {
+        constexpr u32 max_texture_size = 1024 * 1024 * 4;
+        const u32 lower_addr = copy.addr > max_texture_size ? copy.addr - max_texture_size : 0;
+        const auto end = textures_by_address.upper_bound(copy.addr + copy.size);
+        for (auto iter = textures_by_address.lower_bound(lower_addr); iter != end; ++iter)
+          overlapping += overlaps(*iter->second);
+      }
+    }
+    Benchmark::DoNotOptimize(overlapping);
+  }
+  state.SetItemsProcessed(state.iterations() * copies.size());
+}
+BENCHMARK(BM_TextureOverlap)->ArgList({0, 1});
@@ -3,9 +3,13 @@
 
 #include <gtest/gtest.h>
 
+#include <algorithm>
 #include <array>
 #include <bitset>
+#include <random>
 #include <string>
+#include <tuple>
+#include <vector>
 
 #include "Common/Config/Config.h"
 #include "Common/FileUtil.h"
@@ -401,3 +405,139 @@ TEST(CoreTiming, Overclocking)
   Config::SetCurrent(Config::MAIN_OVERCLOCK, 1.0f);
   AdvanceAndCheck(system, 4, MAX_SLICE_LENGTH);
 }
+
+namespace
+{
+// The binary heap CoreTiming used before the timing wheel, as a reference for the event order.
+class ReferenceEventQueue
+{
+public:
+  bool empty() const { return m_heap.empty(); }
+  size_t size() const { return m_heap.size(); }
+  void Push(const CoreTiming::Event& event)
+  {
+    m_heap.push_back(event);
+    std::push_heap(m_heap.begin(), m_heap.end(), Later);
+  }
+  const CoreTiming::Event& Top() const { return m_heap.front(); }
+  void Pop()
+  {
+    std::pop_heap(m_heap.begin(), m_heap.end(), Later);
+    m_heap.pop_back();
+  }
+  void RemoveEvents(const CoreTiming::EventType* event_type)
+  {
+    std::erase_if(m_heap, [&](const CoreTiming::Event& e) { return e.type == event_type; });
+    std::make_heap(m_heap.begin(), m_heap.end(), Later);
+  }
+
+private:
+  static bool Later(const CoreTiming::Event& a, const CoreTiming::Event& b)
+  {
+    return std::tie(a.time, a.fifo_order) > std::tie(b.time, b.fifo_order);
+  }
+
+  std::vector<CoreTiming::Event> m_heap;
+};
+
+// Mimics the scheduling pattern of the emulated hardware: a few dozen pending events, mostly
+// within a few slices, some far in the future (e.g. VI and DVD), a few into the past and the
+// occasional RemoveEvent.
+template <typename Queue>
+std::vector<u64> RunEventWorkload(Queue& queue, std::array<CoreTiming::EventType, 8>& types,
+                                  int operations, u64 seed)
+{
+  std::mt19937_64 rng(seed);
+  std::vector<u64> order;
+  order.reserve(operations);
+
+  s64 now = 0;
+  u64 fifo_order = 0;
+  const auto schedule = [&] {
+    s64 delay;
+    const u64 kind = rng() % 16;
+    if (kind == 0)
+      delay = static_cast<s64>(rng() % 10'000'000);
+    else if (kind == 1)
+      delay = -static_cast<s64>(rng() % 1000);
+    else if (kind == 2)
+      delay = 0;
+    else
+      delay = static_cast<s64>(rng() % 40'000);
+    queue.Push(CoreTiming::Event{now + delay, fifo_order, fifo_order, &types[rng() % types.size()]});
+    ++fifo_order;
+  };
+
+  for (int i = 0; i < 32; ++i)
+    schedule();
+
+  for (int i = 0; i < operations; ++i)
+  {
+    if (queue.size() < 32 && rng() % 2 == 0)
+    {
+      schedule();
+    }
+    else if (rng() % 512 == 0)
+    {
+      queue.RemoveEvents(&types[rng() % types.size()]);
+    }
+    else
+    {
+      const CoreTiming::Event event = queue.Top();
+      queue.Pop();
+      now = std::max(now, event.time);
+      order.push_back(event.userdata);
+      schedule();
+    }
+  }
+
+  while (!queue.empty())
+  {
+    order.push_back(queue.Top().userdata);
+    queue.Pop();
+  }
+  return order;
+}
+}  // namespace
+
+TEST(CoreTiming, EventQueueOrder)
+{
+  std::array<CoreTiming::EventType, 8> types{};
+
+  for (u64 seed = 0; seed < 8; ++seed)
+  {
+    ReferenceEventQueue reference;
+    CoreTiming::EventQueue wheel;
+    EXPECT_EQ(RunEventWorkload(reference, types, 20000, seed),
+              RunEventWorkload(wheel, types, 20000, seed));
+    EXPECT_TRUE(wheel.empty());
+  }
+}
+
+TEST(CoreTiming, EventQueueSameTime)
+{
+  std::array<CoreTiming::EventType, 1> type{};
+  CoreTiming::EventQueue queue;
+
+  // Events at the same time must come out in the order they were scheduled, no matter where they
+  // are stored.
+  for (u64 i = 0; i < 4; ++i)
+    queue.Push(CoreTiming::Event{100'000'000, i, i, &type[0]});
+  for (u64 i = 4; i < 8; ++i)
+    queue.Push(CoreTiming::Event{100, i, i, &type[0]});
+
+  for (u64 i = 4; i < 8; ++i)
+  {
+    EXPECT_EQ(queue.Top().fifo_order, i);
+    queue.Pop();
+  }
+  queue.Push(CoreTiming::Event{50, 8, 8, &type[0]});
+  EXPECT_EQ(queue.Top().fifo_order, 8u);
+  queue.Pop();
+  for (u64 i = 0; i < 4; ++i)
+  {
+    EXPECT_EQ(queue.Top().fifo_order, i);
+    queue.Pop();
+  }
+  EXPECT_TRUE(queue.empty());
+}
@@ -138,3 +138,66 @@ TEST_F(MappingTest, ReadWriteComplex)
   EXPECT_TRUE(read_called);
   EXPECT_TRUE(write_called);
 }
+
+TEST_F(MappingTest, ReadWriteDirectWithFallback)
+{
+  u16 target = 0x1234;
+  const u16* target_ptr = nullptr;
+  u32 fallback_calls = 0;
+
+  m_mapping->Register(0x0C001234,
+                      MMIO::DirectReadWithFallback<u16>(&target_ptr, 0xFF00,
+                                                        [&fallback_calls](Core::System&, u32 addr) {
+                                                          EXPECT_EQ(0x0C001234u, addr);
+                                                          ++fallback_calls;
+                                                          return u16(0x5678);
+                                                        }),
+                      MMIO::DirectWrite<u16>(&target));
+
+  EXPECT_EQ(0x5678, m_mapping->Read<u16>(*m_system, 0x0C001234));
+  EXPECT_EQ(1u, fallback_calls);
+
+  target_ptr = &target;
+  EXPECT_EQ(0x1200, m_mapping->Read<u16>(*m_system, 0x0C001234));
+  m_mapping->Write(*m_system, 0x0C001234, u16(0xABCD));
+  EXPECT_EQ(0xAB00, m_mapping->Read<u16>(*m_system, 0x0C001234));
+  EXPECT_EQ(1u, fallback_calls);
+}
+
+// Converters over Direct handlers must read the same bits as the handlers they combine, whether
+// or not they manage to merge them.
+TEST_F(MappingTest, SizeConvertersOverDirect)
+{
+  u32 merged = 0x12345678;
+  u16 split_high = 0x9ABC;
+  u16 split_low = 0xDEF0;
+
+  m_mapping->Register(0x0C001000, MMIO::DirectRead<u32>(&merged), MMIO::DirectWrite<u32>(&merged));
+  m_mapping->Register(0x0C001000, MMIO::ReadToLarger<u16>(m_mapping.get(), 0x0C001000, 16),
+                      MMIO::InvalidWrite<u16>());
+  m_mapping->Register(0x0C001002, MMIO::ReadToLarger<u16>(m_mapping.get(), 0x0C001000, 0),
+                      MMIO::InvalidWrite<u16>());
+  EXPECT_EQ(0x1234, m_mapping->Read<u16>(*m_system, 0x0C001000));
+  EXPECT_EQ(0x5678, m_mapping->Read<u16>(*m_system, 0x0C001002));
+
+  m_mapping->Register(0x0C001010, MMIO::DirectRead<u16>(MMIO::Utils::HighPart(&merged), 0x00FF),
+                      MMIO::DirectWrite<u16>(MMIO::Utils::HighPart(&merged)));
+  m_mapping->Register(0x0C001012, MMIO::DirectRead<u16>(MMIO::Utils::LowPart(&merged)),
+                      MMIO::DirectWrite<u16>(MMIO::Utils::LowPart(&merged), 0xFFF0));
+  m_mapping->Register(0x0C001010, MMIO::ReadToSmaller<u32>(m_mapping.get(), 0x0C001010, 0x0C001012),
+                      MMIO::WriteToSmaller<u32>(m_mapping.get(), 0x0C001010, 0x0C001012));
+  EXPECT_EQ(0x00345678u, m_mapping->Read<u32>(*m_system, 0x0C001010));
+  m_mapping->Write(*m_system, 0x0C001010, u32(0xCAFEBABF));
+  EXPECT_EQ(0xCAFEBAB0u, merged);
+
+  m_mapping->Register(0x0C001020, MMIO::DirectRead<u16>(&split_high),
+                      MMIO::DirectWrite<u16>(&split_high));
+  m_mapping->Register(0x0C001022, MMIO::DirectRead<u16>(&split_low),
+                      MMIO::DirectWrite<u16>(&split_low));
+  m_mapping->Register(0x0C001020, MMIO::ReadToSmaller<u32>(m_mapping.get(), 0x0C001020, 0x0C001022),
+                      MMIO::WriteToSmaller<u32>(m_mapping.get(), 0x0C001020, 0x0C001022));
+  EXPECT_EQ(0x9ABCDEF0u, m_mapping->Read<u32>(*m_system, 0x0C001020));
+  m_mapping->Write(*m_system, 0x0C001020, u32(0x11223344));
+  EXPECT_EQ(0x1122, split_high);
+  EXPECT_EQ(0x3344, split_low);
+}
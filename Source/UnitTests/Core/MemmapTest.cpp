@@ -0,0 +1,454 @@
+// Copyright 2024 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "Common/ChunkFile.h"
+#include "Common/CommonTypes.h"
+#include "Common/Config/Config.h"
+#include "Common/FileUtil.h"
+#include "Common/IOFile.h"
+#include "Core/ConfigManager.h"
+#include "Core/Core.h"
+#include "Core/HW/Memmap.h"
+#include "Core/MemTools.h"
+#include "Core/System.h"
+#include "UICommon/UICommon.h"
+
+namespace
+{
+constexpr u32 BLOCK_SIZE = 0x10000;
+
+// Snapshots leave guest memory out of a save state and write-protect it instead, so these tests
+// write to it through the real exception handler.
+class MemorySnapshotTest : public testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    if (!EMM::IsExceptionHandlerSupported() || !EMM::IsExceptionHandlerProcessWide())
+      GTEST_SKIP() << "Snapshots need an exception handler which sees every thread.";
+
+    m_profile_path = File::CreateTempDir();
+    ASSERT_FALSE(m_profile_path.empty());
+
+    Core::DeclareAsCPUThread();
+    UICommon::SetUserDirectory(m_profile_path);
+    Config::Init();
+    SConfig::Init();
+    m_memory.Init();
+    EMM::InstallExceptionHandler();
+    m_memory.SetExceptionHandlerInstalled(true);
+  }
+
+  void TearDown() override
+  {
+    if (m_profile_path.empty())
+      return;
+
+    m_memory.SetExceptionHandlerInstalled(false);
+    EMM::UninstallExceptionHandler();
+    m_memory.Shutdown();
+    SConfig::Shutdown();
+    Config::Shutdown();
+    Core::UndeclareAsCPUThread();
+    File::DeleteDirRecursively(m_profile_path);
+  }
+
+  // Saves the memory state like State::SaveAs does, leaving guest memory to the snapshot.
+  std::vector<Memory::SnapshotHole> TakeSnapshot()
+  {
+    if (!m_memory.RequestSnapshot())
+      return {};
+
+    u8* ptr = nullptr;
+    PointerWrap p_measure(&ptr, 0, PointerWrap::Mode::Measure);
+    m_memory.DoState(p_measure);
+    m_state.resize(reinterpret_cast<size_t>(ptr) - m_memory.GetSnapshotSize());
+
+    ptr = m_state.data();
+    PointerWrap p(&ptr, m_state.size(), PointerWrap::Mode::Write);
+    m_memory.DoState(p);
+    EXPECT_TRUE(p.IsWriteMode());
+    return m_memory.TakeSnapshotHoles(m_state.data());
+  }
+
+  // Reads the part of the snapshot that covers RAM, which comes first in the shared memory.
+  std::vector<u8> ReadRAMSnapshot(const std::vector<Memory::SnapshotHole>& holes)
+  {
+    std::vector<u8> ram;
+    for (const Memory::SnapshotHole& hole : holes)
+    {
+      if (hole.shm_position != 0)
+        continue;
+      ram.resize(hole.size);
+      m_memory.ReadSnapshot(ram.data(), hole.shm_position, hole.size);
+    }
+    return ram;
+  }
+
+  Core::System& m_system = Core::System::GetInstance();
+  Memory::MemoryManager& m_memory = m_system.GetMemory();
+  std::string m_profile_path;
+  std::vector<u8> m_state;
+};
+
+// Dirty page tracking uses the same exception handler as snapshots.
+using DirtyPageTest = MemorySnapshotTest;
+
+constexpr u32 WATCHED_ADDRESS = 0x4000;
+constexpr u32 WATCHED_SIZE = 0x100;
+constexpr u32 WATCH_PAGE_SIZE = 0x4000;
+
+constexpr u32 RESIDENT_ADDRESS = 0x2000;
+constexpr u32 RESIDENT_SIZE = 0x100;
+std::atomic<u32> s_write_backs = 0;
+
+// Stands in for the texture cache, writing a lazy EFB copy to memory.
+void WriteBackResidentRange(u32 address, u32 size)
+{
+  if (address >= RESIDENT_ADDRESS + RESIDENT_SIZE || address + size <= RESIDENT_ADDRESS)
+    return;
+
+  ++s_write_backs;
+  auto& memory = Core::System::GetInstance().GetMemory();
+  std::memset(memory.GetPointer(RESIDENT_ADDRESS), 0x5a, RESIDENT_SIZE);
+  memory.RemoveGPUResidentRange(RESIDENT_ADDRESS, RESIDENT_SIZE);
+}
+
+// GPU resident memory needs the same exception handler as snapshots, and the fastmem arena.
+class GPUResidencyTest : public MemorySnapshotTest
+{
+protected:
+  void SetUp() override
+  {
+    MemorySnapshotTest::SetUp();
+    if (IsSkipped() || HasFatalFailure())
+      return;
+
+    if (!m_memory.InitFastmemArena())
+      GTEST_SKIP() << "The fastmem arena is unavailable.";
+    s_write_backs = 0;
+    m_memory.SetWriteBackFunction(WriteBackResidentRange);
+    m_memory.SetGPUResidencySupported(true);
+  }
+
+  void TearDown() override
+  {
+    if (!m_profile_path.empty())
+    {
+      m_memory.SetWriteBackFunction(nullptr);
+      m_memory.SetGPUResidencySupported(false);
+      m_memory.ShutdownFastmemArena();
+    }
+    MemorySnapshotTest::TearDown();
+  }
+
+  u8 ReadFastmem(u32 address) const
+  {
+    return *static_cast<volatile const u8*>(m_memory.GetPhysicalBase() + address);
+  }
+};
+}  // namespace
+
+TEST_F(MemorySnapshotTest, KeepsContentsFromBeforeWrites)
+{
+  u8* ram = m_memory.GetRAM();
+  std::memset(ram, 0x11, BLOCK_SIZE * 2);
+
+  const std::vector<Memory::SnapshotHole> holes = TakeSnapshot();
+  ASSERT_FALSE(holes.empty());
+
+  // Both writes fault, the second one into a block which was already preserved.
+  ram[0x10] = 0x22;
+  ram[0x20] = 0x33;
+  std::memset(ram + BLOCK_SIZE, 0x44, BLOCK_SIZE);
+
+  const std::vector<u8> snapshot = ReadRAMSnapshot(holes);
+  m_memory.EndSnapshot();
+
+  ASSERT_GE(snapshot.size(), BLOCK_SIZE * 2);
+  EXPECT_EQ(0x11, snapshot[0x10]);
+  EXPECT_EQ(0x11, snapshot[0x20]);
+  EXPECT_EQ(0x11, snapshot[BLOCK_SIZE]);
+  EXPECT_EQ(0x22, ram[0x10]);
+  EXPECT_EQ(0x33, ram[0x20]);
+  EXPECT_EQ(0x44, ram[BLOCK_SIZE]);
+
+  // Guest memory is writable again without faulting.
+  ram[0x30] = 0x55;
+  EXPECT_EQ(0x55, ram[0x30]);
+}
+
+TEST_F(MemorySnapshotTest, WritesFromOtherThreadsWhileReading)
+{
+  u8* ram = m_memory.GetRAM();
+  const u32 ram_size = m_memory.GetRamSize();
+  std::memset(ram, 0, ram_size);
+  for (u32 i = 0; i < ram_size; i += BLOCK_SIZE)
+    ram[i] = static_cast<u8>(i / BLOCK_SIZE);
+
+  const std::vector<Memory::SnapshotHole> holes = TakeSnapshot();
+  ASSERT_FALSE(holes.empty());
+
+  // Several threads race for the same blocks while the snapshot is read.
+  std::vector<std::thread> writers;
+  for (int t = 0; t < 4; ++t)
+  {
+    writers.emplace_back([ram, ram_size, t] {
+      for (u32 i = 0; i < ram_size; i += BLOCK_SIZE)
+        ram[i + 1 + t] = 0xff;
+    });
+  }
+  const std::vector<u8> snapshot = ReadRAMSnapshot(holes);
+  for (std::thread& writer : writers)
+    writer.join();
+  m_memory.EndSnapshot();
+
+  ASSERT_GE(snapshot.size(), ram_size);
+  for (u32 i = 0; i < ram_size; i += BLOCK_SIZE)
+  {
+    EXPECT_EQ(static_cast<u8>(i / BLOCK_SIZE), snapshot[i]);
+    EXPECT_EQ(0, snapshot[i + 1]);
+    EXPECT_EQ(0xff, ram[i + 1]);
+  }
+}
+
+TEST_F(MemorySnapshotTest, HostWritesArePreparedForSystemCalls)
+{
+  const std::string path = m_profile_path + "/data.bin";
+  const std::vector<u8> data(0x100, 0x66);
+  {
+    File::IOFile file(path, "wb");
+    ASSERT_TRUE(file.WriteBytes(data.data(), data.size()));
+  }
+
+  u8* ram = m_memory.GetRAM();
+  std::memset(ram, 0x11, BLOCK_SIZE);
+  const std::vector<Memory::SnapshotHole> holes = TakeSnapshot();
+  ASSERT_FALSE(holes.empty());
+
+  // The kernel can't write to write-protected memory, and the read would fail.
+  m_memory.PrepareHostWrite(0x80, static_cast<u32>(data.size()));
+  File::IOFile file(path, "rb");
+  EXPECT_TRUE(file.ReadBytes(m_memory.GetPointer(0x80), data.size()));
+
+  const std::vector<u8> snapshot = ReadRAMSnapshot(holes);
+  m_memory.EndSnapshot();
+
+  EXPECT_EQ(0x11, snapshot[0x80]);
+  EXPECT_EQ(0x66, ram[0x80]);
+}
+
+TEST_F(MemorySnapshotTest, UninstallingTheHandlerWaitsForTheSnapshot)
+{
+  const std::vector<Memory::SnapshotHole> holes = TakeSnapshot();
+  ASSERT_FALSE(holes.empty());
+
+  std::atomic<bool> ended = false;
+  std::thread save_worker([&] {
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    ReadRAMSnapshot(holes);
+    ended = true;
+    m_memory.EndSnapshot();
+  });
+
+  m_memory.SetExceptionHandlerInstalled(false);
+  EXPECT_TRUE(ended);
+  save_worker.join();
+
+  // No more snapshots can be taken without the handler.
+  EXPECT_FALSE(m_memory.RequestSnapshot());
+  m_memory.GetRAM()[0] = 0x77;
+  EXPECT_EQ(0x77, m_memory.GetRAM()[0]);
+}
+
+TEST_F(DirtyPageTest, WritesAreNoticed)
+{
+  const std::optional<u64> generation = m_memory.WatchForWrites(WATCHED_ADDRESS, WATCHED_SIZE);
+  ASSERT_TRUE(generation);
+  EXPECT_TRUE(m_memory.IsUnwrittenSince(WATCHED_ADDRESS, WATCHED_SIZE, *generation));
+
+  // Only the watched pages matter.
+  u8* ram = m_memory.GetRAM();
+  ram[WATCHED_ADDRESS + WATCH_PAGE_SIZE] = 0x12;
+  EXPECT_TRUE(m_memory.IsUnwrittenSince(WATCHED_ADDRESS, WATCHED_SIZE, *generation));
+
+  // Writes next to the range share its page.
+  ram[WATCHED_ADDRESS + WATCHED_SIZE] = 0x34;
+  EXPECT_FALSE(m_memory.IsUnwrittenSince(WATCHED_ADDRESS, WATCHED_SIZE, *generation));
+  EXPECT_EQ(0x34, ram[WATCHED_ADDRESS + WATCHED_SIZE]);
+
+  // Watching again only covers writes from then on.
+  const std::optional<u64> new_generation = m_memory.WatchForWrites(WATCHED_ADDRESS, WATCHED_SIZE);
+  ASSERT_TRUE(new_generation);
+  EXPECT_TRUE(m_memory.IsUnwrittenSince(WATCHED_ADDRESS, WATCHED_SIZE, *new_generation));
+  EXPECT_FALSE(m_memory.IsUnwrittenSince(WATCHED_ADDRESS, WATCHED_SIZE, *generation));
+}
+
+TEST_F(DirtyPageTest, HostWritesAreNoticed)
+{
+  const std::optional<u64> generation = m_memory.WatchForWrites(WATCHED_ADDRESS, WATCHED_SIZE);
+  ASSERT_TRUE(generation);
+
+  m_memory.PrepareHostWrite(WATCHED_ADDRESS + 0x10, 4);
+  EXPECT_FALSE(m_memory.IsUnwrittenSince(WATCHED_ADDRESS, WATCHED_SIZE, *generation));
+  m_memory.Write_U32(0x12345678, WATCHED_ADDRESS + 0x10);
+  EXPECT_EQ(0x12345678u, m_memory.Read_U32(WATCHED_ADDRESS + 0x10));
+}
+
+TEST_F(DirtyPageTest, WatchingOutlivesSnapshots)
+{
+  const std::optional<u64> generation = m_memory.WatchForWrites(WATCHED_ADDRESS, WATCHED_SIZE);
+  ASSERT_TRUE(generation);
+
+  const std::vector<Memory::SnapshotHole> holes = TakeSnapshot();
+  ASSERT_FALSE(holes.empty());
+  ReadRAMSnapshot(holes);
+  m_memory.EndSnapshot();
+  EXPECT_TRUE(m_memory.IsUnwrittenSince(WATCHED_ADDRESS, WATCHED_SIZE, *generation));
+
+  // The page is still write-protected after the snapshot ended.
+  m_memory.GetRAM()[WATCHED_ADDRESS] = 0x56;
+  EXPECT_FALSE(m_memory.IsUnwrittenSince(WATCHED_ADDRESS, WATCHED_SIZE, *generation));
+}
+
+TEST_F(DirtyPageTest, UninstallingTheHandlerStopsWatching)
+{
+  const std::optional<u64> generation = m_memory.WatchForWrites(WATCHED_ADDRESS, WATCHED_SIZE);
+  ASSERT_TRUE(generation);
+
+  m_memory.SetExceptionHandlerInstalled(false);
+  EXPECT_FALSE(m_memory.IsUnwrittenSince(WATCHED_ADDRESS, WATCHED_SIZE, *generation));
+  EXPECT_FALSE(m_memory.WatchForWrites(WATCHED_ADDRESS, WATCHED_SIZE));
+}
+
+TEST_F(DirtyPageTest, WrittenRangesAreKeptPerGeneration)
+{
+  const std::optional<u64> first = m_memory.WatchAllForWrites();
+  ASSERT_TRUE(first);
+  EXPECT_TRUE(m_memory.GetWrittenRangesSince(*first).empty());
+
+  // Writes to neighbouring pages are merged into one range.
+  u8* ram = m_memory.GetRAM();
+  ram[WATCH_PAGE_SIZE * 2] = 0x12;
+  ram[WATCH_PAGE_SIZE * 3 + 0x10] = 0x34;
+
+  // Watching again doesn't affect a user that is still at the first generation.
+  const std::optional<u64> second = m_memory.WatchAllForWrites();
+  ASSERT_TRUE(second);
+  const u8 value = 0x56;
+  m_memory.CopyToEmu(WATCH_PAGE_SIZE * 8 + 4, &value, sizeof(value));
+
+  const std::vector<Memory::WrittenRange> since_first = m_memory.GetWrittenRangesSince(*first);
+  ASSERT_EQ(2u, since_first.size());
+  EXPECT_EQ(WATCH_PAGE_SIZE * 2, since_first[0].physical_address);
+  EXPECT_EQ(WATCH_PAGE_SIZE * 2, since_first[0].size);
+  EXPECT_EQ(WATCH_PAGE_SIZE * 8, since_first[1].physical_address);
+  EXPECT_EQ(WATCH_PAGE_SIZE, since_first[1].size);
+
+  const std::vector<Memory::WrittenRange> since_second = m_memory.GetWrittenRangesSince(*second);
+  ASSERT_EQ(1u, since_second.size());
+  EXPECT_EQ(WATCH_PAGE_SIZE * 8, since_second[0].physical_address);
+  EXPECT_EQ(0x56, ram[WATCH_PAGE_SIZE * 8 + 4]);
+}
+
+TEST_F(DirtyPageTest, StateMemoryBufferOnlyCopiesWrittenPages)
+{
+  // Saves or loads the memory state like the snapshots of the rollback network mode.
+  Memory::StateMemoryBuffer buffer;
+  const auto do_state = [&](PointerWrap::Mode mode) {
+    m_memory.SetStateMemoryBuffer(&buffer);
+    if (mode == PointerWrap::Mode::Write)
+    {
+      u8* ptr = nullptr;
+      PointerWrap p_measure(&ptr, 0, PointerWrap::Mode::Measure);
+      m_memory.DoState(p_measure);
+      m_state.resize(reinterpret_cast<size_t>(ptr));
+    }
+    u8* ptr = m_state.data();
+    PointerWrap p(&ptr, m_state.size(), mode);
+    m_memory.DoState(p);
+    EXPECT_FALSE(p.IsMeasureMode());
+    m_memory.SetStateMemoryBuffer(nullptr);
+  };
+
+  u8* ram = m_memory.GetRAM();
+  ram[WATCH_PAGE_SIZE * 2] = 0x12;
+  do_state(PointerWrap::Mode::Write);
+  ASSERT_TRUE(buffer.write_generation);
+  EXPECT_EQ(0x12, buffer.data[WATCH_PAGE_SIZE * 2]);
+
+  // Saving again only copies the pages written since. RAM comes first in the buffer.
+  buffer.data[WATCH_PAGE_SIZE * 4] = 0x9a;
+  ram[WATCH_PAGE_SIZE * 2] = 0x34;
+  do_state(PointerWrap::Mode::Write);
+  EXPECT_EQ(0x34, buffer.data[WATCH_PAGE_SIZE * 2]);
+  EXPECT_EQ(0x9a, buffer.data[WATCH_PAGE_SIZE * 4]);
+  buffer.data[WATCH_PAGE_SIZE * 4] = ram[WATCH_PAGE_SIZE * 4];
+
+  // Loading only restores the pages written since the save.
+  const u8 unwritten_value = ram[WATCH_PAGE_SIZE * 6];
+  ram[WATCH_PAGE_SIZE * 2] = 0x56;
+  ram[WATCH_PAGE_SIZE * 3 + 0x10] = 0x78;
+  do_state(PointerWrap::Mode::Read);
+  EXPECT_EQ(0x34, ram[WATCH_PAGE_SIZE * 2]);
+  EXPECT_EQ(buffer.data[WATCH_PAGE_SIZE * 3 + 0x10], ram[WATCH_PAGE_SIZE * 3 + 0x10]);
+  EXPECT_EQ(unwritten_value, ram[WATCH_PAGE_SIZE * 6]);
+  ASSERT_EQ(1u, buffer.restored_ranges.size());
+  EXPECT_EQ(WATCH_PAGE_SIZE * 2, buffer.restored_ranges[0].physical_address);
+  EXPECT_EQ(WATCH_PAGE_SIZE * 2, buffer.restored_ranges[0].size);
+
+  // Guest memory matches the buffer again, and the restored pages count as written for others.
+  do_state(PointerWrap::Mode::Read);
+  EXPECT_TRUE(buffer.restored_ranges.empty());
+}
+
+TEST_F(GPUResidencyTest, FastmemAccessWritesBack)
+{
+  ASSERT_TRUE(m_memory.AddGPUResidentRange(RESIDENT_ADDRESS, RESIDENT_SIZE));
+  EXPECT_EQ(0u, s_write_backs);
+
+  EXPECT_EQ(0x5a, ReadFastmem(RESIDENT_ADDRESS + 0x10));
+  EXPECT_EQ(1u, s_write_backs);
+
+  // The page is given back to the CPU along with the range.
+  EXPECT_EQ(0x5a, ReadFastmem(RESIDENT_ADDRESS + 0x20));
+  EXPECT_EQ(1u, s_write_backs);
+}
+
+TEST_F(GPUResidencyTest, HostAccessWritesBack)
+{
+  ASSERT_TRUE(m_memory.AddGPUResidentRange(RESIDENT_ADDRESS, RESIDENT_SIZE));
+
+  // Other threads don't have their faults handled, so they have to prepare their accesses.
+  std::thread host_thread([this] { m_memory.PrepareHostAccess(RESIDENT_ADDRESS + 0x10, 4); });
+  host_thread.join();
+  EXPECT_EQ(1u, s_write_backs);
+  EXPECT_EQ(0x5a, m_memory.GetPointer(RESIDENT_ADDRESS)[0x10]);
+
+  EXPECT_EQ(0x5a, ReadFastmem(RESIDENT_ADDRESS + 0x10));
+  EXPECT_EQ(1u, s_write_backs);
+
+  // Memory which isn't GPU resident isn't written back.
+  m_memory.PrepareHostAccess(RESIDENT_ADDRESS, RESIDENT_SIZE);
+  EXPECT_EQ(1u, s_write_backs);
+}
+
+TEST_F(GPUResidencyTest, UnsupportedResidencyWritesBackExistingRanges)
+{
+  ASSERT_TRUE(m_memory.AddGPUResidentRange(RESIDENT_ADDRESS, RESIDENT_SIZE));
+
+  m_memory.SetGPUResidencySupported(false);
+  EXPECT_EQ(1u, s_write_backs);
+  EXPECT_FALSE(m_memory.AddGPUResidentRange(RESIDENT_ADDRESS, RESIDENT_SIZE));
+  EXPECT_EQ(0x5a, ReadFastmem(RESIDENT_ADDRESS));
+}
@@ -0,0 +1,161 @@
+// Copyright 2024 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+#include "Core/NetPlayRollback.h"
+#include "InputCommon/GCPadStatus.h"
+
+using NetPlay::RollbackSession;
+
+namespace
+{
+constexpr int LOCAL_PAD = 0;
+constexpr int REMOTE_PAD = 1;
+constexpr u32 MAX_FRAMES = 3;
+
+GCPadStatus Buttons(u16 buttons)
+{
+  GCPadStatus status;
+  status.button = buttons;
+  return status;
+}
+
+RollbackSession CreateSession()
+{
+  return RollbackSession(MAX_FRAMES, {false, true, false, false});
+}
+
+// Simulates one frame the way NetPlayClient does, with the frame number as the snapshot.
+GCPadStatus RunFrame(RollbackSession& session)
+{
+  session.BeginFrame();
+  if (session.IsNewFrame())
+    session.AddInput(LOCAL_PAD, Buttons(0));
+
+  session.GetInput(LOCAL_PAD);
+  const GCPadStatus remote = session.GetInput(REMOTE_PAD);
+
+  if (session.ShouldTakeSnapshot())
+  {
+    RollbackSession::SavedState state = session.TakeSnapshotBuffer();
+    state.state.assign(1, static_cast<u8>(session.GetCurrentFrame()));
+    session.AddSnapshot(std::move(state));
+  }
+  return remote;
+}
+}  // namespace
+
+TEST(NetPlayRollback, LockstepUntilFirstSnapshot)
+{
+  RollbackSession session = CreateSession();
+  EXPECT_TRUE(session.MustWaitForInput());
+
+  session.AddInput(REMOTE_PAD, Buttons(PAD_BUTTON_A));
+  ASSERT_FALSE(session.MustWaitForInput());
+  EXPECT_EQ(RunFrame(session).button, PAD_BUTTON_A);
+
+  // The remote player may now lag behind by up to MAX_FRAMES frames.
+  for (u32 i = 0; i < MAX_FRAMES; ++i)
+  {
+    ASSERT_FALSE(session.MustWaitForInput());
+    RunFrame(session);
+  }
+  EXPECT_TRUE(session.MustWaitForInput());
+  EXPECT_FALSE(session.HasMisprediction());
+}
+
+TEST(NetPlayRollback, CorrectPredictionDoesNotRollBack)
+{
+  RollbackSession session = CreateSession();
+  session.AddInput(REMOTE_PAD, Buttons(PAD_BUTTON_A));
+  RunFrame(session);
+  EXPECT_EQ(RunFrame(session).button, PAD_BUTTON_A);
+  EXPECT_EQ(RunFrame(session).button, PAD_BUTTON_A);
+
+  session.AddInput(REMOTE_PAD, Buttons(PAD_BUTTON_A));
+  session.AddInput(REMOTE_PAD, Buttons(PAD_BUTTON_A));
+  EXPECT_FALSE(session.HasMisprediction());
+  EXPECT_EQ(session.BeginRollback(), nullptr);
+  EXPECT_EQ(session.GetStats().rollbacks, 0u);
+}
+
+TEST(NetPlayRollback, MispredictionRollsBackToPreviousSnapshot)
+{
+  RollbackSession session = CreateSession();
+  session.AddInput(REMOTE_PAD, Buttons(PAD_BUTTON_A));
+  for (int i = 0; i < 4; ++i)
+    RunFrame(session);
+  ASSERT_EQ(session.GetCurrentFrame(), 4u);
+
+  // The input of frame 2 differs from the prediction.
+  session.AddInput(REMOTE_PAD, Buttons(PAD_BUTTON_B));
+  ASSERT_TRUE(session.HasMisprediction());
+
+  const RollbackSession::SavedState* state = session.BeginRollback();
+  ASSERT_NE(state, nullptr);
+  EXPECT_EQ(state->state, std::vector<u8>{1});
+  EXPECT_EQ(session.GetCurrentFrame(), 1u);
+  EXPECT_TRUE(session.IsResimulating());
+
+  // Frames 2 to 4 are simulated again, frame 2 with the real input and the others with the new
+  // prediction.
+  EXPECT_EQ(RunFrame(session).button, PAD_BUTTON_B);
+  EXPECT_EQ(RunFrame(session).button, PAD_BUTTON_B);
+  EXPECT_EQ(RunFrame(session).button, PAD_BUTTON_B);
+  EXPECT_TRUE(session.IsResimulating());
+
+  RunFrame(session);
+  EXPECT_TRUE(session.IsNewFrame());
+  EXPECT_EQ(session.GetCurrentFrame(), 5u);
+
+  const RollbackSession::Stats stats = session.GetStats();
+  EXPECT_EQ(stats.frames, 5u);
+  EXPECT_EQ(stats.rollbacks, 1u);
+  EXPECT_EQ(stats.resimulated_frames, 3u);
+  EXPECT_EQ(stats.max_rollback_frames, 3u);
+  EXPECT_EQ(stats.rollback_frames_histogram[3], 1u);
+  EXPECT_EQ(stats.rollbacks_last_frame, 1u);
+}
+
+TEST(NetPlayRollback, InputsOfFutureFramesAreNotMispredictions)
+{
+  RollbackSession session = CreateSession();
+  session.AddInput(REMOTE_PAD, Buttons(PAD_BUTTON_A));
+  RunFrame(session);
+
+  // Received before the frames were simulated.
+  session.AddInput(REMOTE_PAD, Buttons(PAD_BUTTON_A));
+  session.AddInput(REMOTE_PAD, Buttons(PAD_BUTTON_B));
+  EXPECT_FALSE(session.HasMisprediction());
+  EXPECT_FALSE(session.MustWaitForInput());
+
+  EXPECT_EQ(RunFrame(session).button, PAD_BUTTON_A);
+  EXPECT_EQ(RunFrame(session).button, PAD_BUTTON_B);
+  EXPECT_FALSE(session.HasMisprediction());
+}
+
+TEST(NetPlayRollback, RemoteAheadDoesNotWait)
+{
+  RollbackSession session = CreateSession();
+  for (u32 i = 0; i < MAX_FRAMES + 3; ++i)
+    session.AddInput(REMOTE_PAD, Buttons(PAD_BUTTON_A));
+
+  // The remote player stays ahead of every local frame, including the ones after the first
+  // snapshot.
+  for (u32 i = 0; i < MAX_FRAMES + 3; ++i)
+  {
+    ASSERT_FALSE(session.MustWaitForInput());
+    EXPECT_EQ(RunFrame(session).button, PAD_BUTTON_A);
+  }
+
+  // Only once the local frames have caught up and fallen too far behind is waiting required.
+  for (u32 i = 0; i < MAX_FRAMES; ++i)
+  {
+    ASSERT_FALSE(session.MustWaitForInput());
+    RunFrame(session);
+  }
+  EXPECT_TRUE(session.MustWaitForInput());
+}
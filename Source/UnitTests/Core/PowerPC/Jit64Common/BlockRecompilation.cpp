@@ -0,0 +1,191 @@
+// Copyright 2024 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <initializer_list>
+#include <string>
+
+#include "Common/CommonTypes.h"
+#include "Common/Config/Config.h"
+#include "Common/FileUtil.h"
+#include "Core/Config/MainSettings.h"
+#include "Core/ConfigManager.h"
+#include "Core/Core.h"
+#include "Core/CoreTiming.h"
+#include "Core/HW/Memmap.h"
+#include "Core/PowerPC/JitCommon/JitBase.h"
+#include "Core/PowerPC/JitCommon/JitCache.h"
+#include "Core/PowerPC/JitInterface.h"
+#include "Core/PowerPC/PowerPC.h"
+#include "Core/System.h"
+#include "UICommon/UICommon.h"
+
+// include order is important
+#include <gtest/gtest.h>  // NOLINT
+
+namespace
+{
+constexpr u32 BLOCK_ADDRESS = 0x00003200;
+
+// Compiles blocks from guest memory, which is accessed untranslated, with Jit64. The compiled code
+// isn't run. Instead, the tests do what the code of a block does once its entries counted down.
+class BlockRecompilationTest : public testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    m_profile_path = File::CreateTempDir();
+    ASSERT_FALSE(m_profile_path.empty());
+
+    Core::DeclareAsCPUThread();
+    UICommon::SetUserDirectory(m_profile_path);
+    Config::Init();
+    SConfig::Init();
+    m_system.GetMemory().Init();
+  }
+
+  void TearDown() override
+  {
+    if (m_jit)
+    {
+      // Also unregisters the events of PowerPC::Init, which would be registered twice otherwise.
+      m_system.GetCoreTiming().Shutdown();
+      m_system.GetPowerPC().Shutdown();
+    }
+    m_system.GetMemory().Shutdown();
+    SConfig::Shutdown();
+    Config::Shutdown();
+    Core::UndeclareAsCPUThread();
+    File::DeleteDirRecursively(m_profile_path);
+  }
+
+  // Must be called after the JIT settings of the test are set.
+  void StartJit()
+  {
+    m_system.GetPowerPC().Init(PowerPC::CPUCore::JIT64);
+    m_system.GetCoreTiming().Init();
+    m_jit = static_cast<JitBase*>(m_system.GetJitInterface().GetCore());
+    ASSERT_NE(m_jit, nullptr);
+  }
+
+  void Write(u32 address, std::initializer_list<u32> instructions)
+  {
+    for (const u32 hex : instructions)
+    {
+      m_system.GetMemory().Write_U32(hex, address);
+      address += 4;
+    }
+  }
+
+  // Three branches in a row, which are more than branch following normally follows.
+  void WriteBranchChain()
+  {
+    Write(BLOCK_ADDRESS, {0x48000100});          // b +0x100
+    Write(BLOCK_ADDRESS + 0x100, {0x48000100});  // b +0x100
+    Write(BLOCK_ADDRESS + 0x200, {0x48000100});  // b +0x100
+    Write(BLOCK_ADDRESS + 0x300, {
+                                     0x38600001,  // li r3, 1
+                                     0x4e800020,  // blr
+                                 });
+  }
+
+  const JitBlock* GetBlock(u32 address) const
+  {
+    return m_jit->GetBlockCache()->GetBlockFromStartAddress(
+        address, m_system.GetPPCState().feature_flags);
+  }
+
+  const JitBlock* Compile(u32 address)
+  {
+    m_jit->Jit(address);
+    return GetBlock(address);
+  }
+
+  // What the code of a block calls once its hotness countdown reaches zero.
+  void CountDownToZero(u32 address, JitInterface::ExceptionType type)
+  {
+    m_system.GetPPCState().pc = address;
+    m_system.GetJitInterface().CompileExceptionCheck(type);
+  }
+
+  Core::System& m_system = Core::System::GetInstance();
+  JitBase* m_jit = nullptr;
+  std::string m_profile_path;
+};
+}  // namespace
+
+TEST_F(BlockRecompilationTest, TruncatedBlockBecomesSuperblockWhenHot)
+{
+  Config::SetCurrent(Config::MAIN_JIT_SUPERBLOCKS, true);
+  Config::SetCurrent(Config::MAIN_JIT_TIERED_COMPILATION, false);
+  StartJit();
+  WriteBranchChain();
+
+  // Branch following stopped at the third branch, so the block counts its entries.
+  const JitBlock* block = Compile(BLOCK_ADDRESS);
+  ASSERT_NE(block, nullptr);
+  EXPECT_EQ(3u, block->originalSize);
+  EXPECT_NE(0u, block->hotness_countdown);
+
+  CountDownToZero(BLOCK_ADDRESS, JitInterface::ExceptionType::Superblock);
+  EXPECT_TRUE(m_jit->js.superblockAddresses.contains(BLOCK_ADDRESS));
+  EXPECT_EQ(GetBlock(BLOCK_ADDRESS), nullptr);
+
+  // The superblock follows every branch, and isn't promoted again.
+  block = Compile(BLOCK_ADDRESS);
+  ASSERT_NE(block, nullptr);
+  EXPECT_EQ(5u, block->originalSize);
+  EXPECT_EQ(0u, block->hotness_countdown);
+}
+
+TEST_F(BlockRecompilationTest, BlockWithoutTruncationIsNotCounted)
+{
+  Config::SetCurrent(Config::MAIN_JIT_SUPERBLOCKS, true);
+  Config::SetCurrent(Config::MAIN_JIT_TIERED_COMPILATION, false);
+  StartJit();
+  WriteBranchChain();
+
+  // A superblock wouldn't include anything more than the block at the last branch does.
+  const JitBlock* block = Compile(BLOCK_ADDRESS + 0x200);
+  ASSERT_NE(block, nullptr);
+  EXPECT_EQ(3u, block->originalSize);
+  EXPECT_EQ(0u, block->hotness_countdown);
+}
+
+TEST_F(BlockRecompilationTest, QuickTierIsRecompiledOnlyWhenHot)
+{
+  Config::SetCurrent(Config::MAIN_JIT_SUPERBLOCKS, false);
+  Config::SetCurrent(Config::MAIN_JIT_TIERED_COMPILATION, true);
+  StartJit();
+  WriteBranchChain();
+
+  // The quick tier doesn't follow branches, and counts the entries of the block.
+  const JitBlock* block = Compile(BLOCK_ADDRESS);
+  ASSERT_NE(block, nullptr);
+  EXPECT_EQ(1u, block->originalSize);
+  EXPECT_NE(0u, block->hotness_countdown);
+
+  // Compiling the block again before it got hot, e.g. after it was invalidated, keeps the tier.
+  m_system.GetJitInterface().InvalidateICache(BLOCK_ADDRESS, 4, true);
+  ASSERT_EQ(GetBlock(BLOCK_ADDRESS), nullptr);
+  block = Compile(BLOCK_ADDRESS);
+  ASSERT_NE(block, nullptr);
+  EXPECT_EQ(1u, block->originalSize);
+  EXPECT_NE(0u, block->hotness_countdown);
+
+  CountDownToZero(BLOCK_ADDRESS, JitInterface::ExceptionType::TierUp);
+  EXPECT_TRUE(m_jit->js.tierUpAddresses.contains(BLOCK_ADDRESS));
+  EXPECT_EQ(GetBlock(BLOCK_ADDRESS), nullptr);
+
+  // The full analysis follows branches, and the block isn't counted anymore.
+  block = Compile(BLOCK_ADDRESS);
+  ASSERT_NE(block, nullptr);
+  EXPECT_EQ(3u, block->originalSize);
+  EXPECT_EQ(0u, block->hotness_countdown);
+
+  // New code at the address starts over at the quick tier.
+  m_system.GetJitInterface().InvalidateICache(BLOCK_ADDRESS, 4, false);
+  EXPECT_FALSE(m_jit->js.tierUpAddresses.contains(BLOCK_ADDRESS));
+  block = Compile(BLOCK_ADDRESS);
+  ASSERT_NE(block, nullptr);
+  EXPECT_EQ(1u, block->originalSize);
+}
@@ -0,0 +1,152 @@
+// Copyright 2024 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <string>
+
+#include <gtest/gtest.h>
+
+#include "Common/CommonTypes.h"
+#include "Common/Config/Config.h"
+#include "Common/FileUtil.h"
+#include "Core/ConfigManager.h"
+#include "Core/Core.h"
+#include "Core/CoreTiming.h"
+#include "Core/HW/Memmap.h"
+#include "Core/PowerPC/Gekko.h"
+#include "Core/PowerPC/MMU.h"
+#include "Core/PowerPC/PowerPC.h"
+#include "Core/System.h"
+#include "UICommon/UICommon.h"
+
+namespace
+{
+constexpr u32 VSID = 0x123;
+constexpr u32 PAGE_TABLE_ADDRESS = 0x00100000;
+
+// Translations are looked up in the emulated TLB first, then in the page walk cache, and only then
+// in the page table in guest memory.
+class PageTableTest : public testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    m_profile_path = File::CreateTempDir();
+    ASSERT_FALSE(m_profile_path.empty());
+
+    Core::DeclareAsCPUThread();
+    UICommon::SetUserDirectory(m_profile_path);
+    Config::Init();
+    SConfig::Init();
+    m_system.GetMemory().Init();
+    m_system.GetPowerPC().Init(PowerPC::CPUCore::Interpreter);
+    m_system.GetCoreTiming().Init();
+
+    // A 64 KiB page table with segment 0 pointing at it, and data translation on.
+    auto& ppc_state = m_system.GetPPCState();
+    ppc_state.spr[SPR_SDR] = PAGE_TABLE_ADDRESS;
+    m_system.GetMMU().SDRUpdated();
+    ppc_state.sr[0] = VSID;
+    ppc_state.msr.DR = 1;
+    m_system.GetMMU().ResetTLBStats();
+  }
+
+  void TearDown() override
+  {
+    m_system.GetCoreTiming().Shutdown();
+    m_system.GetPowerPC().Shutdown();
+    m_system.GetMemory().Shutdown();
+    SConfig::Shutdown();
+    Config::Shutdown();
+    Core::UndeclareAsCPUThread();
+    File::DeleteDirRecursively(m_profile_path);
+  }
+
+  // Maps the page of an effective address in segment 0 to a physical page, through the primary
+  // hash function.
+  void MapPage(u32 effective_address, u32 physical_address)
+  {
+    const u32 page_index = (effective_address >> 12) & 0xffff;
+    const u32 pteg_address = (((VSID ^ page_index) & 0x3ff) << 6) | PAGE_TABLE_ADDRESS;
+
+    UPTE_Lo pte1;
+    pte1.API = page_index >> 10;
+    pte1.VSID = VSID;
+    pte1.V = 1;
+    UPTE_Hi pte2;
+    pte2.RPN = physical_address >> 12;
+    pte2.PP = 2;
+
+    auto& memory = m_system.GetMemory();
+    memory.Write_U32(pte1.Hex, pteg_address);
+    memory.Write_U32(pte2.Hex, pteg_address + 4);
+  }
+
+  u32 Read(u32 effective_address) { return m_system.GetMMU().Read_U32(effective_address); }
+  PowerPC::MMU::TLBStats Stats() const { return m_system.GetMMU().GetTLBStats(); }
+
+  Core::System& m_system = Core::System::GetInstance();
+  std::string m_profile_path;
+};
+}  // namespace
+
+TEST_F(PageTableTest, RepeatedReadsHitTheTLB)
+{
+  MapPage(0x00004000, 0x00200000);
+  m_system.GetMemory().Write_U32(0x12345678, 0x00200010);
+
+  EXPECT_EQ(0x12345678u, Read(0x00004010));
+  EXPECT_EQ(1u, Stats().page_walks);
+  EXPECT_EQ(0u, Stats().tlb_hits);
+
+  EXPECT_EQ(0x12345678u, Read(0x00004010));
+  EXPECT_EQ(1u, Stats().page_walks);
+  EXPECT_EQ(1u, Stats().tlb_hits);
+}
+
+TEST_F(PageTableTest, EvictedTranslationsHitThePageWalkCache)
+{
+  // The TLB has two ways per set, and these three pages all fall into the same set.
+  MapPage(0x00004000, 0x00200000);
+  MapPage(0x00044000, 0x00201000);
+  MapPage(0x00084000, 0x00202000);
+  m_system.GetMemory().Write_U32(0xcafef00d, 0x00200000);
+
+  Read(0x00004000);
+  Read(0x00044000);
+  Read(0x00084000);
+  EXPECT_EQ(3u, Stats().page_walks);
+
+  EXPECT_EQ(0xcafef00du, Read(0x00004000));
+  EXPECT_EQ(3u, Stats().page_walks);
+  EXPECT_EQ(1u, Stats().page_walk_cache_hits);
+}
+
+TEST_F(PageTableTest, TlbieDropsThePageWalkCache)
+{
+  MapPage(0x00004000, 0x00200000);
+  Read(0x00004000);
+
+  // Remap the page, as a game would before tlbie.
+  MapPage(0x00004000, 0x00203000);
+  m_system.GetMemory().Write_U32(0x0badc0de, 0x00203000);
+  m_system.GetMMU().InvalidateTLBEntry(0x00004000);
+
+  EXPECT_EQ(0x0badc0deu, Read(0x00004000));
+  EXPECT_EQ(2u, Stats().page_walks);
+  EXPECT_EQ(0u, Stats().page_walk_cache_hits);
+}
+
+TEST_F(PageTableTest, SDRUpdatesDropThePageWalkCache)
+{
+  MapPage(0x00004000, 0x00200000);
+  MapPage(0x00044000, 0x00201000);
+  MapPage(0x00084000, 0x00202000);
+  Read(0x00004000);
+  Read(0x00044000);
+  Read(0x00084000);
+
+  m_system.GetMMU().SDRUpdated();
+  Read(0x00004000);
+  EXPECT_EQ(4u, Stats().page_walks);
+  EXPECT_EQ(0u, Stats().page_walk_cache_hits);
+}
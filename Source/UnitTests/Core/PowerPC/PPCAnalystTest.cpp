@@ -0,0 +1,357 @@
+// Copyright 2024 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <algorithm>
+#include <initializer_list>
+#include <string>
+
+#include <gtest/gtest.h>
+
+#include "Common/CommonTypes.h"
+#include "Common/Config/Config.h"
+#include "Common/FileUtil.h"
+#include "Core/ConfigManager.h"
+#include "Core/Core.h"
+#include "Core/CoreTiming.h"
+#include "Core/HW/Memmap.h"
+#include "Core/PowerPC/PPCAnalyst.h"
+#include "Core/PowerPC/PPCTables.h"
+#include "Core/PowerPC/PowerPC.h"
+#include "Core/System.h"
+#include "UICommon/UICommon.h"
+
+namespace
+{
+class OptimizeBlockTest : public testing::Test
+{
+protected:
+  OptimizeBlockTest()
+  {
+    m_block.m_stats = &m_stats;
+    m_block.m_gpa = &m_gpa;
+    m_block.m_fpa = &m_fpa;
+  }
+
+  void Optimize(std::initializer_list<u32> instructions)
+  {
+    m_code.clear();
+    u32 address = 0x80003100;
+    for (const u32 hex : instructions)
+    {
+      PPCAnalyst::CodeOp op;
+      op.inst = hex;
+      op.opinfo = PPCTables::GetOpInfo(op.inst, address);
+      op.address = address;
+      m_analyzer.SetInstructionStats(&m_block, &op, op.opinfo);
+      m_code.push_back(op);
+      address += 4;
+    }
+    m_block.m_num_instructions = static_cast<u32>(m_code.size());
+
+    m_analyzer.OptimizeBlock(&m_block, m_code.data());
+  }
+
+  // Every guest instruction that is not skipped gets host code emitted for it.
+  std::size_t EmittedCount() const
+  {
+    return std::count_if(m_code.begin(), m_code.end(),
+                         [](const PPCAnalyst::CodeOp& op) { return !op.skip; });
+  }
+
+  PPCAnalyst::PPCAnalyzer m_analyzer;
+  PPCAnalyst::BlockStats m_stats{};
+  PPCAnalyst::BlockRegStats m_gpa{};
+  PPCAnalyst::BlockRegStats m_fpa{};
+  PPCAnalyst::CodeBlock m_block;
+  PPCAnalyst::CodeBuffer m_code;
+};
+
+constexpr u32 POLL_ADDRESS = 0x00003000;
+constexpr u32 LOOP_ADDRESS = 0x00003100;
+
+// Idle loop detection reads the call before the block and the callee from guest memory, which is
+// accessed untranslated here.
+class PollingCallLoopTest : public OptimizeBlockTest
+{
+protected:
+  void SetUp() override
+  {
+    m_profile_path = File::CreateTempDir();
+    ASSERT_FALSE(m_profile_path.empty());
+
+    Core::DeclareAsCPUThread();
+    UICommon::SetUserDirectory(m_profile_path);
+    Config::Init();
+    SConfig::Init();
+    m_system.GetMemory().Init();
+    m_system.GetPowerPC().Init(PowerPC::CPUCore::Interpreter);
+    m_system.GetCoreTiming().Init();
+  }
+
+  void TearDown() override
+  {
+    // Also unregisters the events of PowerPC::Init, which would be registered twice otherwise.
+    m_system.GetCoreTiming().Shutdown();
+    m_system.GetPowerPC().Shutdown();
+    m_system.GetMemory().Shutdown();
+    SConfig::Shutdown();
+    Config::Shutdown();
+    Core::UndeclareAsCPUThread();
+    File::DeleteDirRecursively(m_profile_path);
+  }
+
+  void Write(u32 address, std::initializer_list<u32> instructions)
+  {
+    for (const u32 hex : instructions)
+    {
+      m_system.GetMemory().Write_U32(hex, address);
+      address += 4;
+    }
+  }
+
+  // Writes a call to the poll function followed by a loop back to it, and analyzes the block after
+  // the call. Returns whether the loop's branch was detected as an idle loop.
+  bool IsIdleLoop(u32 call)
+  {
+    Write(LOOP_ADDRESS, {
+                            call,
+                            0x2c030000,  // cmpwi r3, 0
+                            0x4082fff8,  // bne -8
+                            0x4e800020,  // blr
+                        });
+
+    m_code.resize(8);
+    m_analyzer.Analyze(LOOP_ADDRESS + 4, &m_block, &m_code, m_code.size());
+    return m_code[1].branchIsIdleLoop;
+  }
+
+  Core::System& m_system = Core::System::GetInstance();
+  std::string m_profile_path;
+};
+
+// bl -0x100, from the loop to the poll function.
+constexpr u32 CALL_POLL = 0x4bffff01;
+
+// Branch following reads the followed code from guest memory as well.
+using BranchFollowingTest = PollingCallLoopTest;
+
+constexpr u32 SUPERBLOCK_ADDRESS = 0x00003200;
+}  // namespace
+
+TEST_F(OptimizeBlockTest, RedundantConstantsAreSkipped)
+{
+  Optimize({
+      0x3c608034,  // lis r3, 0x8034
+      0x60631234,  // ori r3, r3, 0x1234
+      0x38830010,  // addi r4, r3, 0x10
+      0x60000000,  // nop
+      0x3c608034,  // lis r3, 0x8034
+      0x60631234,  // ori r3, r3, 0x1234
+      0x38830010,  // addi r4, r3, 0x10
+      0x4e800020,  // blr
+  });
+
+  // The second lis changes r3, so it and the ori are needed again, but r4 is already up to date.
+  EXPECT_EQ(6u, EmittedCount());
+  EXPECT_TRUE(m_code[3].skip);
+  EXPECT_FALSE(m_code[4].skip);
+  EXPECT_FALSE(m_code[5].skip);
+  EXPECT_TRUE(m_code[6].skip);
+}
+
+TEST_F(OptimizeBlockTest, StackLoadsAreForwarded)
+{
+  Optimize({
+      0x90610008,  // stw r3, 8(r1)
+      0x80810008,  // lwz r4, 8(r1)
+      0x80610008,  // lwz r3, 8(r1)
+      0x4e800020,  // blr
+  });
+
+  EXPECT_EQ(3u, EmittedCount());
+  EXPECT_EQ(0x7c641b78u, m_code[1].inst.hex);  // mr r4, r3
+  EXPECT_FALSE(m_code[1].canCauseException);
+  EXPECT_TRUE(m_code[2].skip);
+}
+
+TEST_F(OptimizeBlockTest, SkippedInstructionsDontDiscardRegisters)
+{
+  Optimize({
+      0x90610008,  // stw r3, 8(r1)
+      0x38800006,  // li r4, 6
+      0x7ca41a14,  // add r5, r4, r3
+      0x38800006,  // li r4, 6
+      0x80610008,  // lwz r3, 8(r1)
+      0x7cc41a14,  // add r6, r4, r3
+      0x4e800020,  // blr
+  });
+  m_analyzer.AnalyzeRegisterUsage(&m_block, m_code.data());
+
+  EXPECT_TRUE(m_code[3].skip);
+  EXPECT_TRUE(m_code[4].skip);
+  // The skipped instructions rely on r3 and r4 keeping their values, so the registers must stay
+  // live across the add before them.
+  EXPECT_FALSE(m_code[2].gprDiscardable[3]);
+  EXPECT_FALSE(m_code[2].gprDiscardable[4]);
+  EXPECT_TRUE(m_code[3].gprInUse[4]);
+  EXPECT_TRUE(m_code[4].gprInUse[3]);
+}
+
+TEST_F(OptimizeBlockTest, AliasingStoresBlockForwarding)
+{
+  Optimize({
+      0x90610008,  // stw r3, 8(r1)
+      0x90a40008,  // stw r5, 8(r4)
+      0x80810008,  // lwz r4, 8(r1)
+      0x90610008,  // stw r3, 8(r1)
+      0x98a1000a,  // stb r5, 10(r1)
+      0x80810008,  // lwz r4, 8(r1)
+      0x4e800020,  // blr
+  });
+
+  EXPECT_EQ(7u, EmittedCount());
+  EXPECT_EQ(0x80810008u, m_code[2].inst.hex);
+  EXPECT_EQ(0x80810008u, m_code[5].inst.hex);
+}
+
+TEST_F(OptimizeBlockTest, StringLoadsClobberEveryRegister)
+{
+  Optimize({
+      0x38800006,  // li r4, 6
+      0x90810008,  // stw r4, 8(r1)
+      0x7c6544aa,  // lswi r3, r5, 8
+      0x38800006,  // li r4, 6
+      0x80c10008,  // lwz r6, 8(r1)
+      0x4e800020,  // blr
+  });
+
+  // The lswi loads r3 and r4, so neither the constant nor the stack slot in r4 survive it.
+  EXPECT_EQ(6u, EmittedCount());
+  EXPECT_FALSE(m_code[3].skip);
+  EXPECT_EQ(0x80c10008u, m_code[4].inst.hex);
+}
+
+TEST_F(OptimizeBlockTest, DeadCR0UpdatesAreRemoved)
+{
+  Optimize({
+      0x7c642a15,  // add. r3, r4, r5
+      0x7cc42a15,  // add. r6, r4, r5
+      0x41820008,  // beq +8
+      0x7c642a15,  // add. r3, r4, r5
+      0x80810008,  // lwz r4, 8(r1)
+      0x7cc42a15,  // add. r6, r4, r5
+      0x4e800020,  // blr
+  });
+
+  EXPECT_FALSE(m_code[0].inst.Rc);
+  EXPECT_FALSE(m_code[0].crOut[0]);
+  EXPECT_TRUE(m_code[1].inst.Rc);
+  // The load may raise an exception, after which CR0 is visible to the guest.
+  EXPECT_TRUE(m_code[3].inst.Rc);
+  EXPECT_TRUE(m_code[5].inst.Rc);
+}
+
+TEST_F(PollingCallLoopTest, PollThroughLeafFunctionIsIdle)
+{
+  Write(POLL_ADDRESS, {
+                          0x80640000,  // lwz r3, 0(r4)
+                          0x4e800020,  // blr
+                      });
+
+  EXPECT_TRUE(IsIdleLoop(CALL_POLL));
+  // The block has to be invalidated if the call or the callee change.
+  EXPECT_EQ(1u, m_block.m_physical_addresses.count(LOOP_ADDRESS));
+  EXPECT_EQ(1u, m_block.m_physical_addresses.count(POLL_ADDRESS));
+}
+
+TEST_F(PollingCallLoopTest, CalleeWithStoreIsNotIdle)
+{
+  Write(POLL_ADDRESS, {
+                          0x80640000,  // lwz r3, 0(r4)
+                          0x90a40004,  // stw r5, 4(r4)
+                          0x4e800020,  // blr
+                      });
+
+  EXPECT_FALSE(IsIdleLoop(CALL_POLL));
+  EXPECT_EQ(0u, m_block.m_physical_addresses.count(POLL_ADDRESS));
+}
+
+TEST_F(PollingCallLoopTest, CalleeWithCounterIsNotIdle)
+{
+  Write(POLL_ADDRESS, {
+                          0x38a50001,  // addi r5, r5, 1
+                          0x80640000,  // lwz r3, 0(r4)
+                          0x4e800020,  // blr
+                      });
+
+  EXPECT_FALSE(IsIdleLoop(CALL_POLL));
+}
+
+TEST_F(PollingCallLoopTest, LoopWithoutCallIsNotIdle)
+{
+  Write(POLL_ADDRESS, {
+                          0x80640000,  // lwz r3, 0(r4)
+                          0x4e800020,  // blr
+                      });
+
+  EXPECT_FALSE(IsIdleLoop(0x60000000));  // nop
+}
+
+TEST_F(BranchFollowingTest, SuperblockMergesAcrossUnconditionalBranches)
+{
+  Write(SUPERBLOCK_ADDRESS, {0x48000100});          // b +0x100
+  Write(SUPERBLOCK_ADDRESS + 0x100, {0x48000100});  // b +0x100
+  Write(SUPERBLOCK_ADDRESS + 0x200, {0x48000100});  // b +0x100
+  Write(SUPERBLOCK_ADDRESS + 0x300, {
+                                        0x38600001,  // li r3, 1
+                                        0x4e800020,  // blr
+                                    });
+  m_analyzer.SetOption(PPCAnalyst::PPCAnalyzer::OPTION_BRANCH_FOLLOW);
+  m_analyzer.SetBranchFollowingEnabled(true);
+  m_code.resize(16);
+
+  // The default threshold stops at the third branch, which makes the block worth promoting.
+  m_analyzer.Analyze(SUPERBLOCK_ADDRESS, &m_block, &m_code, m_code.size());
+  EXPECT_EQ(3u, m_block.m_num_instructions);
+  EXPECT_TRUE(m_block.m_branch_following_truncated);
+
+  m_analyzer.SetBranchFollowingThreshold(PPCAnalyst::SUPERBLOCK_BRANCH_FOLLOWING_THRESHOLD);
+  m_analyzer.Analyze(SUPERBLOCK_ADDRESS, &m_block, &m_code, m_code.size());
+  ASSERT_EQ(5u, m_block.m_num_instructions);
+  EXPECT_FALSE(m_block.m_branch_following_truncated);
+  EXPECT_EQ(SUPERBLOCK_ADDRESS + 0x300, m_code[3].address);
+  EXPECT_EQ(SUPERBLOCK_ADDRESS + 0x304, m_code[4].address);
+  EXPECT_EQ(1u, m_block.m_physical_addresses.count(SUPERBLOCK_ADDRESS + 0x300));
+}
+
+TEST_F(BranchFollowingTest, SuperblockEndsAfterSideExit)
+{
+  Write(SUPERBLOCK_ADDRESS, {
+                                0x48000101,  // bl +0x100
+                                0x38a00001,  // li r5, 1
+                                0x4e800020,  // blr
+                            });
+  Write(SUPERBLOCK_ADDRESS + 0x100, {
+                                        0x2c030000,  // cmpwi r3, 0
+                                        0x41820040,  // beq +0x40
+                                        0x38800001,  // li r4, 1
+                                        0x4e800020,  // blr
+                                    });
+  m_analyzer.SetOption(PPCAnalyst::PPCAnalyzer::OPTION_BRANCH_FOLLOW);
+  m_analyzer.SetOption(PPCAnalyst::PPCAnalyzer::OPTION_CONDITIONAL_CONTINUE);
+  m_analyzer.SetBranchFollowingEnabled(true);
+  m_analyzer.SetBranchFollowingThreshold(PPCAnalyst::SUPERBLOCK_BRANCH_FOLLOWING_THRESHOLD);
+  m_code.resize(16);
+  m_analyzer.Analyze(SUPERBLOCK_ADDRESS, &m_block, &m_code, m_code.size());
+
+  // The conditional branch leaves the block at its target, and the callee's return can't be
+  // inlined after it, so the block ends there instead of continuing after the call.
+  ASSERT_EQ(5u, m_block.m_num_instructions);
+  EXPECT_EQ(SUPERBLOCK_ADDRESS + 0x104, m_code[2].address);
+  EXPECT_EQ(SUPERBLOCK_ADDRESS + 0x144, m_code[2].branchTo);
+  EXPECT_EQ(SUPERBLOCK_ADDRESS + 0x10c, m_code[4].address);
+  EXPECT_FALSE(m_code[4].skip);
+  EXPECT_FALSE(m_block.m_branch_following_truncated);
+  EXPECT_EQ(0u, m_block.m_physical_addresses.count(SUPERBLOCK_ADDRESS + 4));
+  EXPECT_EQ(0u, m_block.m_physical_addresses.count(SUPERBLOCK_ADDRESS + 0x144));
+}
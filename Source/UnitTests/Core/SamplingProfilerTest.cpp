@@ -0,0 +1,234 @@
+// Copyright 2024 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <algorithm>
+#include <chrono>
+#include <iterator>
+#include <set>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "Common/CommonTypes.h"
+#include "Common/Config/Config.h"
+#include "Common/FileUtil.h"
+#include "Common/SymbolDB.h"
+#include "Core/ConfigManager.h"
+#include "Core/Core.h"
+#include "Core/Debugger/SamplingProfiler.h"
+#include "Core/PowerPC/PPCSymbolDB.h"
+#include "Core/System.h"
+#include "UICommon/UICommon.h"
+
+namespace
+{
+constexpr u32 MAIN_ADDRESS = 0x80003000;
+constexpr u32 UPDATE_ADDRESS = 0x80004000;
+constexpr u32 DRAW_ADDRESS = 0x80005000;
+constexpr u32 UNKNOWN_ADDRESS = 0x80006000;
+constexpr u32 SYMBOL_SIZE = 0x100;
+
+// Just enough of the protobuf wire format to read back the exported profile.
+struct ProtoField
+{
+  u32 number;
+  u64 value;
+  std::string_view bytes;
+};
+
+class ProtoReader
+{
+public:
+  explicit ProtoReader(std::string_view data) : m_data(data) {}
+
+  std::vector<ProtoField> ReadFields()
+  {
+    std::vector<ProtoField> fields;
+    while (m_position < m_data.size())
+    {
+      const u64 key = ReadVarint();
+      ProtoField field{static_cast<u32>(key >> 3), 0, {}};
+      switch (key & 7)
+      {
+      case WIRE_VARINT:
+        field.value = ReadVarint();
+        break;
+      case WIRE_LENGTH_DELIMITED:
+      {
+        const u64 size = ReadVarint();
+        EXPECT_LE(m_position + size, m_data.size());
+        field.bytes = m_data.substr(m_position, size);
+        m_position += field.bytes.size();
+        break;
+      }
+      default:
+        ADD_FAILURE() << "Unexpected wire type " << (key & 7);
+        return fields;
+      }
+      fields.push_back(field);
+    }
+    return fields;
+  }
+
+  std::vector<u64> ReadPacked()
+  {
+    std::vector<u64> values;
+    while (m_position < m_data.size())
+      values.push_back(ReadVarint());
+    return values;
+  }
+
+private:
+  static constexpr u64 WIRE_VARINT = 0;
+  static constexpr u64 WIRE_LENGTH_DELIMITED = 2;
+
+  u64 ReadVarint()
+  {
+    u64 value = 0;
+    for (u32 shift = 0; m_position < m_data.size(); shift += 7)
+    {
+      const u8 byte = static_cast<u8>(m_data[m_position++]);
+      value |= u64(byte & 0x7f) << shift;
+      if ((byte & 0x80) == 0)
+        break;
+    }
+    return value;
+  }
+
+  std::string_view m_data;
+  std::size_t m_position = 0;
+};
+
+std::vector<ProtoField> GetFields(const std::vector<ProtoField>& fields, u32 number)
+{
+  std::vector<ProtoField> result;
+  std::copy_if(fields.begin(), fields.end(), std::back_inserter(result),
+               [number](const ProtoField& field) { return field.number == number; });
+  return result;
+}
+
+// The exporters look up the game ID and symbols, which need the config and a CPU thread guard.
+class SamplingProfilerTest : public testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    m_profile_path = File::CreateTempDir();
+    ASSERT_FALSE(m_profile_path.empty());
+
+    Core::DeclareAsCPUThread();
+    UICommon::SetUserDirectory(m_profile_path);
+    Config::Init();
+    SConfig::Init();
+
+    const Core::CPUThreadGuard guard(m_system);
+    m_symbol_db.AddKnownSymbol(guard, MAIN_ADDRESS, SYMBOL_SIZE, "main",
+                               Common::Symbol::Type::Data);
+    m_symbol_db.AddKnownSymbol(guard, UPDATE_ADDRESS, SYMBOL_SIZE, "update",
+                               Common::Symbol::Type::Data);
+    m_symbol_db.AddKnownSymbol(guard, DRAW_ADDRESS, SYMBOL_SIZE, "draw;list",
+                               Common::Symbol::Type::Data);
+
+    // Two samples in draw which only differ by the PC, a leaf call in update, one in code without
+    // a symbol, and one with a stale LR in update.
+    m_profiler.AddSample({DRAW_ADDRESS + 0x10, UPDATE_ADDRESS + 0x20, MAIN_ADDRESS + 0x30}, 3);
+    m_profiler.AddSample({DRAW_ADDRESS + 0x40, UPDATE_ADDRESS + 0x20, MAIN_ADDRESS + 0x30}, 2);
+    m_profiler.AddSample({UPDATE_ADDRESS + 0x50, MAIN_ADDRESS + 0x30});
+    m_profiler.AddSample({UNKNOWN_ADDRESS, MAIN_ADDRESS + 0x30});
+    m_profiler.AddSample({UPDATE_ADDRESS + 0x60, UPDATE_ADDRESS + 0x10, MAIN_ADDRESS + 0x30});
+  }
+
+  void TearDown() override
+  {
+    if (m_profile_path.empty())
+      return;
+
+    SConfig::Shutdown();
+    Config::Shutdown();
+    Core::UndeclareAsCPUThread();
+    File::DeleteDirRecursively(m_profile_path);
+  }
+
+  Core::System& m_system = Core::System::GetInstance();
+  Core::SamplingProfiler m_profiler{m_system};
+  PPCSymbolDB m_symbol_db;
+  std::string m_profile_path;
+};
+}  // namespace
+
+TEST_F(SamplingProfilerTest, FoldedStacksMergeSymbolizedStacks)
+{
+  EXPECT_EQ(8u, m_profiler.GetSampleCount());
+  EXPECT_EQ("main;80006000 1\n"
+            "main;update 2\n"
+            "main;update;draw:list 5\n",
+            m_profiler.ExportFoldedStacks(m_symbol_db));
+}
+
+TEST_F(SamplingProfilerTest, PprofHasASampleForEveryStack)
+{
+  enum : u32
+  {
+    PROFILE_SAMPLE = 2,
+    PROFILE_LOCATION = 4,
+    PROFILE_FUNCTION = 5,
+    PROFILE_STRING_TABLE = 6,
+    PROFILE_DURATION_NANOS = 10,
+    SAMPLE_LOCATION_ID = 1,
+    SAMPLE_VALUE = 2,
+    LOCATION_ADDRESS = 3,
+  };
+
+  const std::string pprof = m_profiler.ExportPprof(m_symbol_db);
+  const std::vector<ProtoField> profile = ProtoReader(pprof).ReadFields();
+
+  const u64 period_ns = std::chrono::nanoseconds(m_profiler.GetInterval()).count();
+  const std::vector<ProtoField> samples = GetFields(profile, PROFILE_SAMPLE);
+  ASSERT_EQ(5u, samples.size());
+  u64 total_count = 0;
+  std::multiset<std::size_t> depths;
+  for (const ProtoField& sample : samples)
+  {
+    const std::vector<ProtoField> fields = ProtoReader(sample.bytes).ReadFields();
+    const std::vector<ProtoField> location_ids = GetFields(fields, SAMPLE_LOCATION_ID);
+    const std::vector<ProtoField> values = GetFields(fields, SAMPLE_VALUE);
+    ASSERT_EQ(1u, location_ids.size());
+    ASSERT_EQ(1u, values.size());
+
+    depths.insert(ProtoReader(location_ids[0].bytes).ReadPacked().size());
+    const std::vector<u64> value = ProtoReader(values[0].bytes).ReadPacked();
+    ASSERT_EQ(2u, value.size());
+    EXPECT_EQ(value[0] * period_ns, value[1]);
+    total_count += value[0];
+  }
+  EXPECT_EQ(8u, total_count);
+  // The stale LR is dropped from its stack.
+  EXPECT_EQ((std::multiset<std::size_t>{2, 2, 2, 3, 3}), depths);
+
+  // Every distinct address left after symbolization is a location.
+  std::set<u64> addresses;
+  for (const ProtoField& location : GetFields(profile, PROFILE_LOCATION))
+  {
+    for (const ProtoField& field : ProtoReader(location.bytes).ReadFields())
+    {
+      if (field.number == LOCATION_ADDRESS)
+        addresses.insert(field.value);
+    }
+  }
+  EXPECT_EQ((std::set<u64>{DRAW_ADDRESS + 0x10, DRAW_ADDRESS + 0x40, UPDATE_ADDRESS + 0x20,
+                           UPDATE_ADDRESS + 0x50, UPDATE_ADDRESS + 0x60, MAIN_ADDRESS + 0x30,
+                           UNKNOWN_ADDRESS}),
+            addresses);
+  EXPECT_EQ(7u, GetFields(profile, PROFILE_LOCATION).size());
+  EXPECT_EQ(4u, GetFields(profile, PROFILE_FUNCTION).size());
+
+  const std::vector<ProtoField> strings = GetFields(profile, PROFILE_STRING_TABLE);
+  ASSERT_FALSE(strings.empty());
+  EXPECT_EQ("", strings[0].bytes);
+
+  const std::vector<ProtoField> duration = GetFields(profile, PROFILE_DURATION_NANOS);
+  ASSERT_EQ(1u, duration.size());
+  EXPECT_EQ(8 * period_ns, duration[0].value);
+}
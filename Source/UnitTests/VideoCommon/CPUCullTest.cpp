@@ -0,0 +1,267 @@
+// Copyright 2024 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <memory>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "Common/BitUtils.h"
+#include "Common/CPUDetect.h"
+#include "Common/CommonTypes.h"
+#include "Common/Swap.h"
+#include "Core/System.h"
+#include "VideoCommon/BPMemory.h"
+#include "VideoCommon/CPMemory.h"
+#include "VideoCommon/CPUCull.h"
+#include "VideoCommon/OpcodeDecoding.h"
+#include "VideoCommon/Statistics.h"
+#include "VideoCommon/VertexLoaderBase.h"
+#include "VideoCommon/VertexShaderManager.h"
+#include "VideoCommon/XFMemory.h"
+#include "VideoCommon/XFStateManager.h"
+
+using OpcodeDecoder::Primitive;
+
+namespace
+{
+// Enough vertices for the bounding box test and the partial transform.
+constexpr u32 NUM_TRIANGLES = 100;
+
+struct Position
+{
+  float x, y, z;
+};
+
+// Counter-clockwise triangles, which face away from the camera with the projection used below.
+std::vector<Position> GetTriangles(float x_offset)
+{
+  std::vector<Position> positions;
+  for (u32 i = 0; i < NUM_TRIANGLES; ++i)
+  {
+    const float x = -0.9f + i * 0.015f + x_offset;
+    const float y = (i % 10) * 0.1f - 0.5f;
+    positions.push_back({x, y, 0.5f});
+    positions.push_back({x + 0.1f, y, 0.5f});
+    positions.push_back({x, y + 0.1f, 0.5f});
+  }
+  return positions;
+}
+
+// Swaps the winding order of a triangle.
+void FlipTriangle(std::vector<Position>& positions, u32 triangle)
+{
+  std::swap(positions[triangle * 3 + 1], positions[triangle * 3 + 2]);
+}
+}  // namespace
+
+class CPUCullTest : public testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    // Identity position matrix and orthographic projection, with back face culling.
+    for (float& value : xfmem.posMatrices)
+      value = 0.0f;
+    xfmem.posMatrices[0] = 1.0f;
+    xfmem.posMatrices[5] = 1.0f;
+    xfmem.posMatrices[10] = 1.0f;
+    g_main_cp_state.matrix_index_a.PosNormalMtxIdx = 0;
+    xfmem.projection.type = ProjectionType::Orthographic;
+    xfmem.projection.rawProjection = {1.0f, 0.0f, 1.0f, 0.0f, -1.0f, 0.0f};
+    xfmem.viewport.ht = 0.0f;
+    bpmem.genMode.cullmode = CullMode::Back;
+    Core::System::GetInstance().GetXFStateManager().SetProjectionChanged();
+
+    m_cull.Init();
+    g_stats.ResetFrame();
+  }
+
+  // Matrix indices are optional, and are per-vertex position matrix indices if present.
+  bool IsCulled(Primitive primitive, const std::vector<Position>& positions,
+                const std::vector<u8>& matrix_indices = {})
+  {
+    const bool per_vertex_matrix = !matrix_indices.empty();
+    TVtxDesc desc;
+    VAT vat;
+    desc.low.PosMatIdx = per_vertex_matrix;
+    desc.low.Position = VertexComponentFormat::Direct;
+    vat.g0.PosElements = CoordComponentCount::XYZ;
+    vat.g0.PosFormat = ComponentFormat::Float;
+    const std::unique_ptr<VertexLoaderBase> loader =
+        VertexLoaderBase::CreateVertexLoader(desc, vat);
+
+    // The vertex loader expects big endian data.
+    std::vector<u8> src;
+    const auto write_float = [&src](float value) {
+      const u32 swapped = Common::swap32(Common::BitCast<u32>(value));
+      const auto* bytes = reinterpret_cast<const u8*>(&swapped);
+      src.insert(src.end(), bytes, bytes + sizeof(u32));
+    };
+    for (size_t i = 0; i < positions.size(); ++i)
+    {
+      if (per_vertex_matrix)
+        src.push_back(matrix_indices[i]);
+      write_float(positions[i].x);
+      write_float(positions[i].y);
+      write_float(positions[i].z);
+    }
+
+    const u32 count = static_cast<u32>(positions.size());
+    std::vector<u8> vertices(count * loader->m_native_vtx_decl.stride);
+    loader->RunVertices(src.data(), vertices.data(), count);
+    return m_cull.AreAllVerticesCulled(loader.get(), primitive, vertices.data(), count);
+  }
+
+  CPUCull m_cull;
+};
+
+TEST_F(CPUCullTest, BackFacingTrianglesAreCulled)
+{
+  EXPECT_TRUE(IsCulled(Primitive::GX_DRAW_TRIANGLES, GetTriangles(0.0f)));
+  EXPECT_EQ(g_stats.this_frame.num_cpu_cull_draws, 1);
+  EXPECT_EQ(g_stats.this_frame.num_cpu_culled_draws, 1);
+  EXPECT_EQ(g_stats.this_frame.num_cpu_culled_vertices, static_cast<int>(NUM_TRIANGLES * 3));
+  EXPECT_EQ(g_stats.this_frame.num_cpu_cull_bounds_early_outs, 0);
+}
+
+TEST_F(CPUCullTest, FrontFacingTrianglesAreNotCulled)
+{
+  bpmem.genMode.cullmode = CullMode::Front;
+  EXPECT_FALSE(IsCulled(Primitive::GX_DRAW_TRIANGLES, GetTriangles(0.0f)));
+  EXPECT_EQ(g_stats.this_frame.num_cpu_culled_draws, 0);
+}
+
+TEST_F(CPUCullTest, OnScreenDrawIsAcceptedByBoundsWithoutFaceCulling)
+{
+  bpmem.genMode.cullmode = CullMode::None;
+  EXPECT_FALSE(IsCulled(Primitive::GX_DRAW_TRIANGLES, GetTriangles(0.0f)));
+  EXPECT_EQ(g_stats.this_frame.num_cpu_cull_bounds_early_outs, 1);
+}
+
+TEST_F(CPUCullTest, OffScreenDrawIsRejectedByBounds)
+{
+  bpmem.genMode.cullmode = CullMode::None;
+  EXPECT_TRUE(IsCulled(Primitive::GX_DRAW_TRIANGLES, GetTriangles(3.0f)));
+  EXPECT_EQ(g_stats.this_frame.num_cpu_cull_bounds_early_outs, 1);
+  EXPECT_EQ(g_stats.this_frame.num_cpu_culled_draws, 1);
+}
+
+TEST_F(CPUCullTest, VisibleTriangleIsFoundAnywhere)
+{
+  for (const u32 triangle : {0u, 31u, 32u, 63u, 64u, NUM_TRIANGLES - 1})
+  {
+    std::vector<Position> positions = GetTriangles(0.0f);
+    FlipTriangle(positions, triangle);
+    EXPECT_FALSE(IsCulled(Primitive::GX_DRAW_TRIANGLES, positions)) << "triangle " << triangle;
+  }
+}
+
+TEST_F(CPUCullTest, PerVertexMatricesAreUsed)
+{
+  // The second matrix moves the triangles off screen. Its rows start at index 3.
+  xfmem.posMatrices[12] = 1.0f;
+  xfmem.posMatrices[15] = 5.0f;
+  xfmem.posMatrices[17] = 1.0f;
+  xfmem.posMatrices[22] = 1.0f;
+  bpmem.genMode.cullmode = CullMode::None;
+
+  const std::vector<Position> positions = GetTriangles(0.0f);
+  EXPECT_FALSE(IsCulled(Primitive::GX_DRAW_TRIANGLES, positions,
+                        std::vector<u8>(positions.size(), 0)));
+  EXPECT_TRUE(IsCulled(Primitive::GX_DRAW_TRIANGLES, positions,
+                       std::vector<u8>(positions.size(), 3)));
+
+  std::vector<u8> matrix_indices(positions.size(), 3);
+  matrix_indices[150] = 0;
+  matrix_indices[151] = 0;
+  matrix_indices[152] = 0;
+  EXPECT_FALSE(IsCulled(Primitive::GX_DRAW_TRIANGLES, positions, matrix_indices));
+}
+
+#if defined(_M_X86) || defined(_M_X86_64)
+TEST_F(CPUCullTest, WideTransformKernelsMatchTheFMAKernel)
+{
+  if (!cpu_info.bAVX2 || !cpu_info.bFMA)
+    GTEST_SKIP() << "The wide transform kernels need AVX2 and FMA.";
+
+  std::vector<CPUCull::TransformKernel> kernels = {CPUCull::TransformKernel::AVX2};
+  if (cpu_info.bAVX512F)
+    kernels.push_back(CPUCull::TransformKernel::AVX512);
+
+  // Not a multiple of the width of any kernel, so that their tails are covered as well.
+  constexpr u32 count = 67;
+  std::mt19937 rng(1234);
+  std::uniform_real_distribution<float> value(-2.0f, 2.0f);
+  // Every index leaves room for the three rows of its matrix.
+  std::uniform_int_distribution<u32> matrix_index(0, 61);
+
+  for (float& element : xfmem.posMatrices)
+    element = value(rng);
+  g_main_cp_state.matrix_index_a.PosNormalMtxIdx = 6;
+  xfmem.projection.type = ProjectionType::Perspective;
+  for (float& element : xfmem.projection.rawProjection)
+    element = value(rng);
+  auto& system = Core::System::GetInstance();
+  system.GetXFStateManager().SetProjectionChanged();
+  system.GetVertexShaderManager().SetProjectionMatrix(system.GetXFStateManager());
+
+  for (const bool position_has_3_elems : {false, true})
+  {
+    for (const bool per_vertex_pos_mtx : {false, true})
+    {
+      const u32 stride = (per_vertex_pos_mtx ? sizeof(u32) : 0) +
+                         (position_has_3_elems ? 3 : 2) * sizeof(float);
+      // Positions may be loaded as a whole vector, even if they have less elements.
+      std::vector<u8> vertices(count * stride + 4 * sizeof(float));
+      for (u32 i = 0; i < count; ++i)
+      {
+        u8* vertex = vertices.data() + i * stride;
+        if (per_vertex_pos_mtx)
+        {
+          const u32 index = matrix_index(rng);
+          std::memcpy(vertex, &index, sizeof(index));
+          vertex += sizeof(index);
+        }
+        for (u32 j = 0; j < (position_has_3_elems ? 3u : 2u); ++j)
+        {
+          const float element = value(rng);
+          std::memcpy(vertex + j * sizeof(float), &element, sizeof(element));
+        }
+      }
+
+      alignas(64) std::array<CPUCull::TransformedVertex, count> expected;
+      CPUCull::GetTransformKernel(CPUCull::TransformKernel::FMA, position_has_3_elems,
+                                  per_vertex_pos_mtx)(expected.data(), vertices.data(), stride,
+                                                      count);
+      for (const CPUCull::TransformKernel kernel : kernels)
+      {
+        alignas(64) std::array<CPUCull::TransformedVertex, count> actual;
+        CPUCull::GetTransformKernel(kernel, position_has_3_elems, per_vertex_pos_mtx)(
+            actual.data(), vertices.data(), stride, count);
+
+        // The kernels may round differently, as they don't fuse the same operations.
+        for (u32 i = 0; i < count; ++i)
+        {
+          const std::array<float, 4> a = {expected[i].x, expected[i].y, expected[i].z,
+                                          expected[i].w};
+          const std::array<float, 4> b = {actual[i].x, actual[i].y, actual[i].z, actual[i].w};
+          for (size_t j = 0; j < a.size(); ++j)
+          {
+            EXPECT_NEAR(a[j], b[j], 1e-4f * std::max(1.0f, std::abs(a[j])))
+                << "kernel " << static_cast<int>(kernel) << ", 3 elements "
+                << position_has_3_elems << ", per-vertex matrix " << per_vertex_pos_mtx
+                << ", vertex " << i << ", element " << j;
+          }
+        }
+      }
+    }
+  }
+}
+#endif
@@ -0,0 +1,71 @@
+// Copyright 2024 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <array>
+
+#include <gtest/gtest.h>
+
+#include "Common/CommonTypes.h"
+#include "VideoCommon/ConstantDirtyRanges.h"
+#include "VideoCommon/ConstantManager.h"
+
+namespace
+{
+// Spans more than one word of dirty bits.
+struct alignas(16) TestConstants
+{
+  float4 first;
+  std::array<float4, 100> matrices;
+  u32 a;
+  u32 b;
+  u32 pad[2];
+};
+}  // namespace
+
+class ConstantDirtyRangesTest : public testing::Test
+{
+protected:
+  void SetUp() override { m_ranges.Reset(m_constants); }
+
+  TestConstants m_constants{};
+  ConstantDirtyRanges<TestConstants> m_ranges;
+};
+
+TEST_F(ConstantDirtyRangesTest, UnchangedWritesAreDropped)
+{
+  m_ranges.Mark(m_constants, &m_constants.matrices[10], 4 * sizeof(float4));
+  EXPECT_TRUE(m_ranges.HasWrites());
+  EXPECT_EQ(m_ranges.Resolve(m_constants), 0u);
+  EXPECT_FALSE(m_ranges.HasWrites());
+}
+
+TEST_F(ConstantDirtyRangesTest, ChangedRegistersAreCounted)
+{
+  m_constants.matrices[10][2] = 1.0f;
+  m_constants.matrices[70][0] = 1.0f;
+  m_ranges.Mark(m_constants, &m_constants.matrices[0], sizeof(m_constants.matrices));
+  EXPECT_EQ(m_ranges.Resolve(m_constants), 2 * sizeof(float4));
+
+  // The changes were taken over, so writing the same values again changes nothing.
+  m_ranges.Mark(m_constants, &m_constants.matrices[10], sizeof(float4));
+  EXPECT_EQ(m_ranges.Resolve(m_constants), 0u);
+}
+
+TEST_F(ConstantDirtyRangesTest, PartialRegisterWritesMarkWholeRegister)
+{
+  m_constants.b = 5;
+  m_ranges.Mark(m_constants, &m_constants.b, sizeof(m_constants.b));
+  EXPECT_EQ(m_ranges.Resolve(m_constants), sizeof(float4));
+}
+
+TEST_F(ConstantDirtyRangesTest, UnmarkedChangesAreIgnored)
+{
+  m_constants.first[0] = 1.0f;
+  m_constants.a = 1;
+  m_ranges.Mark(m_constants, &m_constants.matrices[99], sizeof(float4));
+  EXPECT_EQ(m_ranges.Resolve(m_constants), 0u);
+
+  m_ranges.Reset(m_constants);
+  m_ranges.Mark(m_constants, &m_constants.first, sizeof(m_constants));
+  EXPECT_EQ(m_ranges.Resolve(m_constants), 0u);
+}
@@ -0,0 +1,193 @@
+// Copyright 2024 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "Common/CommonTypes.h"
+#include "Common/Config/Config.h"
+#include "Common/FileUtil.h"
+#include "Core/ConfigManager.h"
+#include "Core/Core.h"
+#include "Core/HW/Memmap.h"
+#include "Core/MemTools.h"
+#include "Core/System.h"
+#include "UICommon/UICommon.h"
+#include "VideoCommon/CPMemory.h"
+#include "VideoCommon/DisplayListCache.h"
+
+using State = DisplayListCache::Entry::State;
+
+namespace
+{
+constexpr u32 ADDRESS = 0x80001000;
+
+void AddPrimitive(DisplayListCache::Entry& entry, u32 decoded_size)
+{
+  DisplayListCache::Primitive& primitive = entry.primitives.emplace_back();
+  primitive.decoded.emplace().data.resize(decoded_size);
+}
+
+constexpr u32 GUEST_ADDRESS = 0x4000;
+
+// Display lists read straight from guest memory are watched for writes, which needs the real
+// exception handler.
+class DisplayListCacheGuestMemoryTest : public testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    if (!EMM::IsExceptionHandlerSupported() || !EMM::IsExceptionHandlerProcessWide())
+      GTEST_SKIP() << "Watching for writes needs an exception handler which sees every thread.";
+
+    m_profile_path = File::CreateTempDir();
+    ASSERT_FALSE(m_profile_path.empty());
+
+    Core::DeclareAsCPUThread();
+    UICommon::SetUserDirectory(m_profile_path);
+    Config::Init();
+    SConfig::Init();
+    m_memory.Init();
+    EMM::InstallExceptionHandler();
+    m_memory.SetExceptionHandlerInstalled(true);
+  }
+
+  void TearDown() override
+  {
+    if (m_profile_path.empty())
+      return;
+
+    m_memory.SetExceptionHandlerInstalled(false);
+    EMM::UninstallExceptionHandler();
+    m_memory.Shutdown();
+    SConfig::Shutdown();
+    Config::Shutdown();
+    Core::UndeclareAsCPUThread();
+    File::DeleteDirRecursively(m_profile_path);
+  }
+
+  Memory::MemoryManager& m_memory = Core::System::GetInstance().GetMemory();
+  std::string m_profile_path;
+};
+}  // namespace
+
+TEST(DisplayListCache, IsRecordedOnSecondCall)
+{
+  DisplayListCache cache;
+  const std::vector<u8> data(64, 0x61);
+
+  DisplayListCache::Entry& entry = cache.GetEntry(ADDRESS, 64, data.data(), false);
+  EXPECT_EQ(entry.state, State::New);
+  entry.state = State::Seen;
+
+  EXPECT_EQ(&cache.GetEntry(ADDRESS, 64, data.data(), false), &entry);
+  EXPECT_EQ(entry.state, State::Seen);
+  AddPrimitive(entry, 100);
+  cache.FinishRecording(entry);
+  EXPECT_EQ(entry.state, State::Recorded);
+  EXPECT_EQ(cache.GetDecodedSize(), 100u);
+
+  EXPECT_EQ(cache.GetEntry(ADDRESS, 64, data.data(), false).state, State::Recorded);
+}
+
+TEST(DisplayListCache, ChangedContentsResetEntry)
+{
+  DisplayListCache cache;
+  std::vector<u8> data(64, 0x61);
+
+  DisplayListCache::Entry& entry = cache.GetEntry(ADDRESS, 64, data.data(), false);
+  AddPrimitive(entry, 100);
+  cache.FinishRecording(entry);
+
+  data[10] = 0x98;
+  EXPECT_EQ(cache.GetEntry(ADDRESS, 64, data.data(), false).state, State::New);
+  EXPECT_TRUE(entry.primitives.empty());
+  EXPECT_EQ(cache.GetDecodedSize(), 0u);
+
+  // A different size at the same address is a different display list.
+  EXPECT_NE(&cache.GetEntry(ADDRESS, 32, data.data(), false), &entry);
+}
+
+TEST(DisplayListCache, InvalidateRecordsAgain)
+{
+  DisplayListCache cache;
+  const std::vector<u8> data(64, 0x61);
+
+  DisplayListCache::Entry& entry = cache.GetEntry(ADDRESS, 64, data.data(), false);
+  AddPrimitive(entry, 100);
+  cache.FinishRecording(entry);
+  cache.Invalidate(entry);
+
+  EXPECT_EQ(entry.state, State::Seen);
+  EXPECT_TRUE(entry.primitives.empty());
+  EXPECT_EQ(cache.GetDecodedSize(), 0u);
+}
+
+TEST(DisplayListCache, FullCacheKeepsCurrentEntry)
+{
+  DisplayListCache cache;
+  const std::vector<u8> data(64, 0x61);
+
+  DisplayListCache::Entry& first = cache.GetEntry(ADDRESS, 64, data.data(), false);
+  AddPrimitive(first, DisplayListCache::MAX_DECODED_SIZE / 2);
+  cache.FinishRecording(first);
+
+  DisplayListCache::Entry& second = cache.GetEntry(ADDRESS + 64, 64, data.data(), false);
+  AddPrimitive(second, DisplayListCache::MAX_DECODED_SIZE / 2 + 1);
+  cache.FinishRecording(second);
+
+  EXPECT_EQ(cache.GetDecodedSize(), DisplayListCache::MAX_DECODED_SIZE / 2 + 1);
+  EXPECT_EQ(second.state, State::Recorded);
+  EXPECT_EQ(cache.GetEntry(ADDRESS, 64, data.data(), false).state, State::New);
+}
+
+TEST(DisplayListCache, IsSameFormat)
+{
+  DisplayListCache::Primitive primitive;
+  TVtxDesc desc;
+  VAT vat;
+  desc.low.Position = VertexComponentFormat::Direct;
+  vat.g0.PosFormat = ComponentFormat::Float;
+  primitive.SetFormat(desc, vat);
+  EXPECT_TRUE(DisplayListCache::IsSameFormat(primitive, desc, vat));
+
+  vat.g0.PosFormat = ComponentFormat::Short;
+  EXPECT_FALSE(DisplayListCache::IsSameFormat(primitive, desc, vat));
+
+  vat.g0.PosFormat = ComponentFormat::Float;
+  desc.high.Tex0Coord = VertexComponentFormat::Index8;
+  EXPECT_FALSE(DisplayListCache::IsSameFormat(primitive, desc, vat));
+}
+
+TEST_F(DisplayListCacheGuestMemoryTest, IsReusedUntilWritten)
+{
+  DisplayListCache cache;
+  u8* data = m_memory.GetRAM() + GUEST_ADDRESS;
+  std::memset(data, 0x61, 64);
+
+  DisplayListCache::Entry& entry = cache.GetEntry(GUEST_ADDRESS, 64, data, true);
+  EXPECT_EQ(entry.state, State::New);
+  entry.state = State::Seen;
+  ASSERT_EQ(&cache.GetEntry(GUEST_ADDRESS, 64, data, true), &entry);
+  AddPrimitive(entry, 100);
+  cache.FinishRecording(entry);
+
+  // Recorded entries are watched from their next call on, and reused without hashing while the
+  // pages are unwritten.
+  EXPECT_EQ(cache.GetEntry(GUEST_ADDRESS, 64, data, true).state, State::Recorded);
+  ASSERT_TRUE(entry.write_generation.has_value());
+  EXPECT_TRUE(m_memory.IsUnwrittenSince(GUEST_ADDRESS, 64, *entry.write_generation));
+  EXPECT_EQ(cache.GetEntry(GUEST_ADDRESS, 64, data, true).state, State::Recorded);
+  EXPECT_TRUE(entry.write_generation.has_value());
+  EXPECT_EQ(cache.GetDecodedSize(), 100u);
+
+  // A CPU write to the watched pages makes the entry be hashed, and then built, again.
+  data[10] = 0x98;
+  EXPECT_EQ(cache.GetEntry(GUEST_ADDRESS, 64, data, true).state, State::New);
+  EXPECT_FALSE(entry.write_generation.has_value());
+  EXPECT_TRUE(entry.primitives.empty());
+  EXPECT_EQ(cache.GetDecodedSize(), 0u);
+}
@@ -0,0 +1,190 @@
+// Copyright 2024 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <vector>
+
+#include <fmt/format.h>
+#include <gtest/gtest.h>
+
+#include "Common/CommonTypes.h"
+#include "VideoCommon/IndexGenerator.h"
+#include "VideoCommon/OpcodeDecoding.h"
+#include "VideoCommon/VideoConfig.h"
+
+using OpcodeDecoder::Primitive;
+
+namespace
+{
+constexpr u16 RESTART = UINT16_MAX;
+
+// Straightforward versions of the index generation, one primitive at a time.
+class ReferenceIndices
+{
+public:
+  ReferenceIndices(bool primitive_restart) : m_pr(primitive_restart) {}
+
+  void Add(Primitive primitive, u32 num_verts)
+  {
+    switch (primitive)
+    {
+    case Primitive::GX_DRAW_QUADS:
+    case Primitive::GX_DRAW_QUADS_2:
+      AddQuads(num_verts);
+      break;
+    case Primitive::GX_DRAW_TRIANGLES:
+      for (u32 i = 2; i < num_verts; i += 3)
+        Triangle(i - 2, i - 1, i);
+      break;
+    case Primitive::GX_DRAW_TRIANGLE_STRIP:
+      AddStrip(num_verts);
+      break;
+    case Primitive::GX_DRAW_TRIANGLE_FAN:
+      AddFan(num_verts);
+      break;
+    case Primitive::GX_DRAW_LINES:
+      for (u32 i = 1; i < num_verts; i += 2)
+        Write({i - 1, i});
+      break;
+    case Primitive::GX_DRAW_LINE_STRIP:
+      for (u32 i = 1; i < num_verts; ++i)
+        Write({i - 1, i});
+      break;
+    case Primitive::GX_DRAW_POINTS:
+      for (u32 i = 0; i < num_verts; ++i)
+        Write({i});
+      break;
+    }
+    m_base += num_verts;
+  }
+
+  const std::vector<u16>& GetIndices() const { return m_indices; }
+
+private:
+  void Write(std::initializer_list<u32> offsets)
+  {
+    for (const u32 offset : offsets)
+      m_indices.push_back(static_cast<u16>(m_base + offset));
+  }
+
+  void Restart() { m_indices.push_back(RESTART); }
+
+  void Triangle(u32 a, u32 b, u32 c)
+  {
+    Write({a, b, c});
+    if (m_pr)
+      Restart();
+  }
+
+  void AddQuads(u32 num_verts)
+  {
+    u32 i = 3;
+    for (; i < num_verts; i += 4)
+    {
+      if (m_pr)
+      {
+        Write({i - 2, i - 1, i - 3, i});
+        Restart();
+      }
+      else
+      {
+        Triangle(i - 3, i - 2, i - 1);
+        Triangle(i - 3, i - 1, i);
+      }
+    }
+    if (i == num_verts)
+      Triangle(num_verts - 3, num_verts - 2, num_verts - 1);
+  }
+
+  void AddStrip(u32 num_verts)
+  {
+    if (m_pr)
+    {
+      for (u32 i = 0; i < num_verts; ++i)
+        Write({i});
+      Restart();
+      return;
+    }
+
+    bool wind = false;
+    for (u32 i = 2; i < num_verts; ++i)
+    {
+      Triangle(i - 2, i - !wind, i - wind);
+      wind = !wind;
+    }
+  }
+
+  void AddFan(u32 num_verts)
+  {
+    u32 i = 2;
+    if (m_pr)
+    {
+      for (; i + 3 <= num_verts; i += 3)
+      {
+        Write({i - 1, i, 0, i + 1, i + 2});
+        Restart();
+      }
+      for (; i + 2 <= num_verts; i += 2)
+      {
+        Write({i - 1, i, 0, i + 1});
+        Restart();
+      }
+    }
+    for (; i < num_verts; ++i)
+      Triangle(0, i - 1, i);
+  }
+
+  bool m_pr;
+  u32 m_base = 0;
+  std::vector<u16> m_indices;
+};
+
+std::vector<u16> Generate(Primitive primitive, const std::vector<u32>& draws)
+{
+  IndexGenerator generator;
+  generator.Init();
+
+  // Larger than any primitive type can produce, with a guard value after the indices.
+  std::vector<u16> indices(8 * 1024, 0x1234);
+  generator.Start(indices.data());
+  for (const u32 num_verts : draws)
+    generator.AddIndices(primitive, num_verts);
+
+  EXPECT_EQ(indices[generator.GetIndexLen()], 0x1234);
+  indices.resize(generator.GetIndexLen());
+  return indices;
+}
+}  // namespace
+
+class IndexGeneratorTest : public testing::TestWithParam<bool>
+{
+protected:
+  void SetUp() override
+  {
+    g_Config.backend_info.bSupportsPrimitiveRestart = GetParam();
+    g_Config.backend_info.bSupportsVSLinePointExpand = false;
+  }
+};
+
+TEST_P(IndexGeneratorTest, MatchesReference)
+{
+  // Every primitive length up to a few whole blocks, and the remainder after them.
+  for (const Primitive primitive :
+       {Primitive::GX_DRAW_QUADS, Primitive::GX_DRAW_QUADS_2, Primitive::GX_DRAW_TRIANGLES,
+        Primitive::GX_DRAW_TRIANGLE_STRIP, Primitive::GX_DRAW_TRIANGLE_FAN,
+        Primitive::GX_DRAW_LINES, Primitive::GX_DRAW_LINE_STRIP, Primitive::GX_DRAW_POINTS})
+  {
+    for (u32 num_verts = 0; num_verts <= 100; ++num_verts)
+    {
+      // A preceding draw, so that the base index isn't zero.
+      const std::vector<u32> draws = {7, num_verts};
+      ReferenceIndices reference(GetParam());
+      for (const u32 draw : draws)
+        reference.Add(primitive, draw);
+
+      EXPECT_EQ(Generate(primitive, draws), reference.GetIndices())
+          << fmt::to_string(primitive) << " with " << num_verts << " vertices";
+    }
+  }
+}
+
+INSTANTIATE_TEST_SUITE_P(PrimitiveRestart, IndexGeneratorTest, testing::Bool());
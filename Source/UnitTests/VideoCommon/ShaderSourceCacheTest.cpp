@@ -0,0 +1,131 @@
+// Copyright 2024 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <cstddef>
+#include <string>
+
+#include <gtest/gtest.h>
+
+#include "Common/CommonTypes.h"
+#include "VideoCommon/ShaderGenCommon.h"
+#include "VideoCommon/ShaderSourceCache.h"
+
+namespace
+{
+struct TestUidData
+{
+  u32 value;
+};
+
+using TestUid = ShaderUid<TestUidData>;
+using TestCache = ShaderSourceCache<TestUid>;
+
+TestUid MakeUid(u32 value)
+{
+  TestUid uid;
+  uid.GetUidData()->value = value;
+  return uid;
+}
+
+ShaderHostConfig MakeHostConfig(u32 bits)
+{
+  ShaderHostConfig host_config;
+  host_config.bits = bits;
+  return host_config;
+}
+
+// Counts how often the cache generates a source of the given size.
+class CountingGenerator
+{
+public:
+  explicit CountingGenerator(std::size_t size = 16) : m_size(size) {}
+
+  ShaderCode operator()()
+  {
+    ++m_calls;
+    ShaderCode code;
+    code.Write("{}", std::string(m_size, 'x'));
+    return code;
+  }
+
+  u32 GetCalls() const { return m_calls; }
+
+private:
+  std::size_t m_size;
+  u32 m_calls = 0;
+};
+
+template <typename Generator>
+auto Generate(Generator& generator)
+{
+  return [&generator] { return generator(); };
+}
+}  // namespace
+
+TEST(ShaderSourceCache, IdenticalUidIsHit)
+{
+  TestCache cache;
+  CountingGenerator generator;
+  const ShaderHostConfig host_config = MakeHostConfig(1);
+
+  const TestCache::Source first = cache.GetSource(host_config, MakeUid(1), Generate(generator));
+  const TestCache::Source second = cache.GetSource(host_config, MakeUid(1), Generate(generator));
+  EXPECT_EQ(1u, generator.GetCalls());
+  ASSERT_NE(first, nullptr);
+  EXPECT_EQ(first, second);
+  EXPECT_EQ(std::string(16, 'x'), *first);
+}
+
+TEST(ShaderSourceCache, DifferentUidOrHostConfigIsMiss)
+{
+  TestCache cache;
+  CountingGenerator generator;
+
+  const TestCache::Source source =
+      cache.GetSource(MakeHostConfig(1), MakeUid(1), Generate(generator));
+  EXPECT_NE(source, cache.GetSource(MakeHostConfig(1), MakeUid(2), Generate(generator)));
+  EXPECT_EQ(2u, generator.GetCalls());
+
+  // The same UID is generated differently for another host config.
+  EXPECT_NE(source, cache.GetSource(MakeHostConfig(2), MakeUid(1), Generate(generator)));
+  EXPECT_EQ(3u, generator.GetCalls());
+
+  // Both entries stay cached.
+  EXPECT_EQ(source, cache.GetSource(MakeHostConfig(1), MakeUid(1), Generate(generator)));
+  EXPECT_EQ(3u, generator.GetCalls());
+}
+
+TEST(ShaderSourceCache, EvictsWhenFull)
+{
+  TestCache cache;
+  CountingGenerator small_generator;
+  CountingGenerator large_generator(TestCache::MAX_SIZE / 2);
+  const ShaderHostConfig host_config = MakeHostConfig(1);
+
+  cache.GetSource(host_config, MakeUid(1), Generate(small_generator));
+  cache.GetSource(host_config, MakeUid(2), Generate(large_generator));
+  cache.GetSource(host_config, MakeUid(1), Generate(small_generator));
+  EXPECT_EQ(1u, small_generator.GetCalls());
+
+  // The second large source doesn't fit anymore, so everything else is dropped to make room.
+  const TestCache::Source source =
+      cache.GetSource(host_config, MakeUid(3), Generate(large_generator));
+  EXPECT_EQ(2u, large_generator.GetCalls());
+  EXPECT_EQ(TestCache::MAX_SIZE / 2, source->size());
+  cache.GetSource(host_config, MakeUid(1), Generate(small_generator));
+  EXPECT_EQ(2u, small_generator.GetCalls());
+  EXPECT_EQ(source, cache.GetSource(host_config, MakeUid(3), Generate(large_generator)));
+  EXPECT_EQ(2u, large_generator.GetCalls());
+}
+
+TEST(ShaderSourceCache, ClearDropsEverything)
+{
+  TestCache cache;
+  CountingGenerator generator;
+  const ShaderHostConfig host_config = MakeHostConfig(1);
+
+  cache.GetSource(host_config, MakeUid(1), Generate(generator));
+  cache.Clear();
+  cache.GetSource(host_config, MakeUid(1), Generate(generator));
+  EXPECT_EQ(2u, generator.GetCalls());
+}
@@ -0,0 +1,72 @@
+// Copyright 2024 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "Common/CommonTypes.h"
+#include "VideoCommon/TextureAddressIndex.h"
+
+namespace
+{
+constexpr u32 PAGE_SIZE = 1u << TextureAddressIndex<int>::PAGE_SHIFT;
+
+std::vector<int> Find(const TextureAddressIndex<int>& index, u32 addr, u32 size)
+{
+  std::vector<int> result;
+  index.Find(addr, size, &result);
+  return result;
+}
+}  // namespace
+
+TEST(TextureAddressIndex, FindsOverlappingRanges)
+{
+  TextureAddressIndex<int> index;
+  index.Add(0x1000, 0x100, 1);
+  index.Add(0x1100, 0x100, 2);
+  index.Add(0x2000, 0x100, 3);
+
+  EXPECT_EQ(Find(index, 0x1080, 0x10), std::vector<int>({1}));
+  // Ranges which only touch are reported as well.
+  EXPECT_EQ(Find(index, 0x1100, 0x10), std::vector<int>({1, 2}));
+  EXPECT_EQ(Find(index, 0x1800, 0x100), std::vector<int>());
+  EXPECT_EQ(Find(index, 0, 0x10000), std::vector<int>({1, 2, 3}));
+}
+
+TEST(TextureAddressIndex, LargeRangesAreReportedOnce)
+{
+  TextureAddressIndex<int> index;
+  index.Add(PAGE_SIZE - 0x100, 4 * PAGE_SIZE, 1);
+  index.Add(3 * PAGE_SIZE, 0x100, 2);
+
+  EXPECT_EQ(Find(index, 3 * PAGE_SIZE + 0x80, 0x10), std::vector<int>({1, 2}));
+  EXPECT_EQ(Find(index, 0, 8 * PAGE_SIZE), std::vector<int>({1, 2}));
+  EXPECT_EQ(Find(index, 5 * PAGE_SIZE, 0x10), std::vector<int>());
+}
+
+TEST(TextureAddressIndex, OrderedByAddressThenInsertion)
+{
+  TextureAddressIndex<int> index;
+  index.Add(2 * PAGE_SIZE, 0x100, 1);
+  index.Add(0x100, 0x100, 2);
+  index.Add(PAGE_SIZE - 0x100, 2 * PAGE_SIZE, 3);
+  index.Add(0x100, 0x200, 4);
+
+  EXPECT_EQ(Find(index, 0, 4 * PAGE_SIZE), std::vector<int>({2, 4, 3, 1}));
+}
+
+TEST(TextureAddressIndex, Remove)
+{
+  TextureAddressIndex<int> index;
+  index.Add(0x1000, 2 * PAGE_SIZE, 1);
+  index.Add(0x1000, 2 * PAGE_SIZE, 2);
+  index.Add(0x1000, 0, 3);
+
+  index.Remove(0x1000, 2 * PAGE_SIZE, 1);
+  EXPECT_EQ(Find(index, 0x1000, PAGE_SIZE), std::vector<int>({2, 3}));
+
+  index.Remove(0x1000, 2 * PAGE_SIZE, 2);
+  index.Remove(0x1000, 0, 3);
+  EXPECT_TRUE(index.IsEmpty());
+}
@@ -0,0 +1,80 @@
+// Copyright 2024 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <random>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "Common/CommonTypes.h"
+#include "VideoCommon/TextureCacheBase.h"
+#include "VideoCommon/TextureDecoder.h"
+
+namespace
+{
+std::vector<u8> GetRandomTexture(u32 width, u32 height, TextureFormat format)
+{
+  std::vector<u8> data(TexDecoder_GetTextureSizeInBytes(width, height, format));
+  std::mt19937 rng(static_cast<u32>(format));
+  std::uniform_int_distribution<u32> byte(0, 255);
+  for (u8& value : data)
+    value = static_cast<u8>(byte(rng));
+  return data;
+}
+
+std::vector<u8> DecodeWhole(const std::vector<u8>& src, u32 width, u32 height,
+                            TextureFormat format)
+{
+  std::vector<u8> dst(width * height * sizeof(u32));
+  TexDecoder_Decode(dst.data(), src.data(), width, height, format, nullptr, TLUTFormat::IA8);
+  return dst;
+}
+
+std::vector<u8> DecodeInBands(const std::vector<u8>& src, u32 width, u32 height, u32 band_height,
+                              TextureFormat format)
+{
+  std::vector<u8> dst(width * height * sizeof(u32));
+  std::vector<TextureCacheBase::DecodeJob> jobs;
+  TextureCacheBase::AddDecodeJobs(jobs, dst.data(), src.data(), width, height, band_height,
+                                  format, nullptr, TLUTFormat::IA8);
+  EXPECT_EQ((height + band_height - 1) / band_height, jobs.size());
+  for (const TextureCacheBase::DecodeJob& job : jobs)
+  {
+    TexDecoder_Decode(job.dst, job.src, job.width, job.height, job.format, job.tlut,
+                      job.tlut_format);
+  }
+  return dst;
+}
+}  // namespace
+
+// CMPR has 8x8 blocks, which are made of four 4x4 sub-blocks.
+TEST(TextureDecodeJob, CMPRBandsMatchWholeLevel)
+{
+  constexpr u32 width = 32;
+  constexpr u32 height = 40;
+  const std::vector<u8> src = GetRandomTexture(width, height, TextureFormat::CMPR);
+  const std::vector<u8> expected = DecodeWhole(src, width, height, TextureFormat::CMPR);
+
+  // 16 and 24 rows don't divide the height, which leaves a smaller band at the end.
+  for (const u32 band_height : {8u, 16u, 24u, 40u})
+  {
+    EXPECT_EQ(expected, DecodeInBands(src, width, height, band_height, TextureFormat::CMPR))
+        << "band height " << band_height;
+  }
+}
+
+// RGBA8 blocks take 64 bytes, as their AR and GB halves are stored one after another.
+TEST(TextureDecodeJob, RGBA8BandsMatchWholeLevel)
+{
+  constexpr u32 width = 16;
+  constexpr u32 height = 20;
+  const std::vector<u8> src = GetRandomTexture(width, height, TextureFormat::RGBA8);
+  const std::vector<u8> expected = DecodeWhole(src, width, height, TextureFormat::RGBA8);
+
+  // 8 and 12 rows don't divide the height, which leaves a smaller band at the end.
+  for (const u32 band_height : {4u, 8u, 12u, 20u})
+  {
+    EXPECT_EQ(expected, DecodeInBands(src, width, height, band_height, TextureFormat::RGBA8))
+        << "band height " << band_height;
+  }
+}
@@ -0,0 +1,123 @@
+// Copyright 2024 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <span>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "Common/CommonTypes.h"
+#include "Common/FileUtil.h"
+#include "VideoCommon/Assets/TexturePack.h"
+
+using VideoCommon::TexturePack;
+
+class TexturePackTest : public testing::Test
+{
+protected:
+  TexturePackTest() : m_directory(File::CreateTempDir()) {}
+
+  ~TexturePackTest() override
+  {
+    if (!m_directory.empty())
+      File::DeleteDirRecursively(m_directory);
+  }
+
+  void SetUp() override
+  {
+    if (m_directory.empty())
+      FAIL();
+  }
+
+  std::string AddFile(const std::string& path, const std::string& contents)
+  {
+    const std::string full_path = m_directory + "/" + path;
+    File::CreateFullPath(full_path);
+    EXPECT_TRUE(File::WriteStringToFile(full_path, contents));
+    return full_path;
+  }
+
+  static std::string ToString(std::span<const u8> data)
+  {
+    return std::string(data.begin(), data.end());
+  }
+
+  const std::string m_directory;
+};
+
+TEST_F(TexturePackTest, ReadsBackFiles)
+{
+  const std::vector<std::string> files{AddFile("b/tex1_b.dds", "second"),
+                                       AddFile("tex1_a.png", "first"),
+                                       AddFile("a/tex1_c_mip1.dds", std::string(5000, 'c'))};
+  const std::string pack_path = m_directory + "/pack.dtp";
+  ASSERT_TRUE(TexturePack::Write(pack_path, files));
+
+  const std::unique_ptr<TexturePack> pack = TexturePack::Open(pack_path);
+  ASSERT_NE(pack, nullptr);
+
+  const std::vector<std::string_view> names = pack->GetFileNames();
+  EXPECT_EQ(names,
+            std::vector<std::string_view>({"tex1_a.png", "tex1_b.dds", "tex1_c_mip1.dds"}));
+
+  EXPECT_EQ(ToString(*pack->GetFile("tex1_a.png")), "first");
+  EXPECT_EQ(ToString(*pack->GetFile("tex1_b.dds")), "second");
+  const auto large_file = pack->GetFile("tex1_c_mip1.dds");
+  EXPECT_EQ(ToString(*large_file), std::string(5000, 'c'));
+  EXPECT_EQ(reinterpret_cast<uintptr_t>(large_file->data()) % TexturePack::DATA_ALIGNMENT, 0u);
+  pack->Prefetch(*large_file);
+
+  EXPECT_FALSE(pack->GetFile("tex1_b.png").has_value());
+  EXPECT_FALSE(pack->GetFile("tex1_d.dds").has_value());
+}
+
+TEST_F(TexturePackTest, RejectsDuplicateNames)
+{
+  const std::vector<std::string> files{AddFile("a/tex1_a.dds", "a"), AddFile("b/tex1_a.dds", "b")};
+  EXPECT_FALSE(TexturePack::Write(m_directory + "/pack.dtp", files));
+}
+
+TEST_F(TexturePackTest, FailsOnUnreadableFiles)
+{
+  const std::string pack_path = m_directory + "/pack.dtp";
+  const std::vector<std::string> files{AddFile("tex1_a.dds", "a"), m_directory + "/tex1_b.dds"};
+  EXPECT_FALSE(TexturePack::Write(pack_path, files));
+  EXPECT_FALSE(File::Exists(pack_path));
+}
+
+TEST_F(TexturePackTest, RejectsUnsortedIndex)
+{
+  const std::string pack_path = m_directory + "/pack.dtp";
+  ASSERT_TRUE(
+      TexturePack::Write(pack_path, {AddFile("tex1_a.dds", "a"), AddFile("tex1_b.dds", "b")}));
+  std::string data;
+  ASSERT_TRUE(File::ReadFileToString(pack_path, data));
+
+  TexturePack::Header header;
+  std::memcpy(&header, data.data(), sizeof(header));
+  TexturePack::IndexEntry index[2];
+  std::memcpy(index, data.data() + header.index_offset, sizeof(index));
+  std::swap(index[0], index[1]);
+  std::memcpy(data.data() + header.index_offset, index, sizeof(index));
+  EXPECT_EQ(TexturePack::Open(AddFile("unsorted.dtp", data)), nullptr);
+}
+
+TEST_F(TexturePackTest, RejectsInvalidFiles)
+{
+  EXPECT_EQ(TexturePack::Open(m_directory + "/missing.dtp"), nullptr);
+  EXPECT_EQ(TexturePack::Open(AddFile("empty.dtp", "")), nullptr);
+  EXPECT_EQ(TexturePack::Open(AddFile("invalid.dtp", std::string(64, 'x'))), nullptr);
+
+  const std::string pack_path = m_directory + "/pack.dtp";
+  ASSERT_TRUE(TexturePack::Write(pack_path, {AddFile("tex1_a.dds", "a")}));
+  std::string data;
+  ASSERT_TRUE(File::ReadFileToString(pack_path, data));
+  data.resize(data.size() - 4);
+  EXPECT_EQ(TexturePack::Open(AddFile("truncated.dtp", data)), nullptr);
+}